@@ -82,7 +82,161 @@ public:
     STOFF_R_OLE_ERROR /** problem when reading the OLE structure*/,
     STOFF_R_PARSE_ERROR /** problem when parsing the file*/,
     STOFF_R_PASSWORD_MISSMATCH_ERROR /** problem when using the given password*/,
-    STOFF_R_UNKNOWN_ERROR /** unknown error*/
+    STOFF_R_UNKNOWN_ERROR /** unknown error*/,
+    STOFF_R_RESOURCE_LIMIT_ERROR /** a limit set by ParseOptions::m_limits has been exceeded*/,
+    STOFF_R_CANCELED /** the parse has been canceled by the function ParseOptions::m_progressCallback*/
+  };
+  /** a record read while parsing a document, see ParseOptions::m_traceCallback */
+  struct ParseTraceRecord {
+    //! the name of the zone (the OLE stream) which contains the record
+    char const *m_zone;
+    //! the record type, "note" for a debug note
+    char const *m_type;
+    //! the record offset in the zone
+    long m_offset;
+    //! the record length in bytes
+    long m_length;
+    //! the record nesting level (1 for a main record)
+    int m_level;
+    //! the time spent to read the record in seconds (including its sub records)
+    double m_duration;
+    /** the debug note written at m_offset (with a 0 length and a 0 level), only sent by the
+        builds with the debug files (DEBUG_WITH_FILES), nullptr for a record */
+    char const *m_note;
+  };
+  /** the function called each time a record has been read
+     \param record the record, its strings are only valid during the call
+     \param data the data given by ParseOptions::m_traceData */
+  typedef void (*ParseTraceCallback)(ParseTraceRecord const &record, void *data);
+  /** the statistics of a zone or of a main reader function, see ParseOptions::m_statisticsCallback */
+  struct ParseStatistic {
+    //! the zone name (the OLE stream) or the reader function name (Class::function)
+    char const *m_name;
+    //! the number of times the zone or the function has been read
+    unsigned long m_numCalls;
+    //! the total time in seconds
+    double m_duration;
+    //! the number of bytes read
+    unsigned long m_numBytes;
+    //! the number of records read
+    unsigned long m_numRecords;
+    /** the number of large buffers created from the document data: the decoded bitmaps,
+        the decrypted and the decompressed zones (not all the allocations) */
+    unsigned long m_numAllocations;
+    //! the size in bytes of these large buffers
+    unsigned long m_numAllocatedBytes;
+  };
+  /** the function called with each statistic at the end of a parse
+     \param statistic the statistic, its name is only valid during the call
+     \param data the data given by ParseOptions::m_statisticsData */
+  typedef void (*ParseStatisticsCallback)(ParseStatistic const &statistic, void *data);
+  /** the resources which can be used by a parse, see ParseOptions::m_limits. For each limit, 0 means no limit */
+  struct ResourceLimits {
+    //! constructor: no limit
+    ResourceLimits()
+      : m_maxMemory(0)
+      , m_maxImagePixels(0)
+      , m_maxRecordDepth(0)
+      , m_maxCells(0)
+      , m_maxDuration(0)
+    {
+    }
+    //! the maximum number of bytes of the decoded data: the bitmaps, the cells, ...
+    unsigned long m_maxMemory;
+    //! the maximum number of pixels of a bitmap
+    unsigned long m_maxImagePixels;
+    //! the maximum nesting level of the records
+    int m_maxRecordDepth;
+    //! the maximum number of spreadsheet and chart cells
+    unsigned long m_maxCells;
+    //! the maximum duration of a parse in seconds
+    double m_maxDuration;
+  };
+  /** the progression of a parse, see ParseOptions::m_progressCallback */
+  struct ParseProgress {
+    //! the zone name (the OLE stream), "Page" or "Sheet" when the pages or the sheets are sent
+    char const *m_zone;
+    //! the position of the record in the zone, or the page/sheet index
+    long m_position;
+    //! the size of the zone, or the number of pages/sheets
+    long m_size;
+  };
+  /** the function called during a parse to report its progression
+     \param progress the progression, its zone name is only valid during the call
+     \param data the data given by ParseOptions::m_progressData
+     \return false to cancel the parse */
+  typedef bool (*ParseProgressCallback)(ParseProgress const &progress, void *data);
+  /** the options of a parse. Each parse uses its own options, so different documents can
+      be parsed at the same time by different threads with different options.
+
+      \note when threads are used, the trace and the progress functions can be called
+      from several threads at the same time */
+  struct ParseOptions {
+    //! constructor: the default options
+    ParseOptions()
+      : m_firstPage(0)
+      , m_lastPage(0)
+      , m_numThreads(1)
+      , m_convertBitmapsToPNG(true)
+      , m_maxPictureDimension(0)
+      , m_skipPictures(false)
+      , m_drawingResolution(0)
+      , m_traceCallback(nullptr)
+      , m_traceData(nullptr)
+      , m_statisticsCallback(nullptr)
+      , m_statisticsData(nullptr)
+      , m_limits()
+      , m_progressCallback(nullptr)
+      , m_progressData(nullptr)
+    {
+    }
+    /** the first page or slide to convert (1-based), 0 means the first page. Only used by the
+        drawings and the presentations: the content of the other pages is skipped while reading,
+        and only the master pages used by the selected pages are read, useful to create a preview */
+    int m_firstPage;
+    //! the last page or slide to convert (1-based), 0 means the last page
+    int m_lastPage;
+    /** the maximum number of threads, 0 means the number of hardware threads. When it is
+        greater than 1, the embedded charts, drawings, formulas and spreadsheets are read in
+        background threads while the main document is read, and the pages of the drawings
+        and presentations are created in background threads, then sent in order.
+        By default, only the calling thread is used */
+    int m_numThreads;
+    /** if true, the bitmaps are sent as PNG pictures, if not, as PPM pictures.
+        Always false if the library is built without zlib */
+    bool m_convertBitmapsToPNG;
+    /** the maximum width and height of the pictures in pixels, 0 means no limit. The bitmaps
+        which are bigger are reduced, and the embedded drawings, spreadsheets and OLE objects
+        are replaced by their preview when it exists, useful to create a preview */
+    int m_maxPictureDimension;
+    //! if true, the bitmaps and the embedded pictures are not sent, useful to index a document
+    bool m_skipPictures;
+    /** the resolution of the output device in dots per inch, 0 means no simplification. When
+        set, the shapes of the drawing and presentation pages which are outside the page or
+        smaller than a dot are not sent, and the polylines are simplified to this resolution */
+    int m_drawingResolution;
+    /** a function called each time a record has been read, useful to find which part of a
+        document is slow or can not be read without a debug build, nullptr means no trace */
+    ParseTraceCallback m_traceCallback;
+    //! the data given to m_traceCallback
+    void *m_traceData;
+    /** a function called at the end of the parse with the time, the bytes, the records and the
+        large buffers used to read each zone and by the main reader functions (the reading of the item pools, the
+        models, the tables, the bitmaps and the emission of the document), sorted by name,
+        nullptr means that the statistics are not collected */
+    ParseStatisticsCallback m_statisticsCallback;
+    //! the data given to m_statisticsCallback
+    void *m_statisticsData;
+    /** the resources which can be used by the parse, useful to read untrusted documents. When a
+        limit is exceeded, the parse is stopped and returns STOFF_R_RESOURCE_LIMIT_ERROR.
+        The memory only counts the large buffers created from the document data, not all the allocations */
+    ResourceLimits m_limits;
+    /** a function called each time a record is opened and before each page or sheet is sent.
+        If it returns false, the parse is stopped as soon as possible and returns STOFF_R_CANCELED,
+        useful to interrupt a long conversion */
+    ParseProgressCallback m_progressCallback;
+    //! the data given to m_progressCallback
+    void *m_progressData;
   };
 
   /** Analyzes the content of an input stream to see if it can be parsed
@@ -106,6 +260,13 @@ public:
    \note Reserved for future use. Actually, it only returns false */
   static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, char const *password=nullptr);
 
+  /** Parses the input stream content with some options, see ParseOptions.
+     \param input The input stream
+     \param documentInterface A RVNGTextInterface implementation
+     \param options the options of the parse
+     \param password The file password */
+  static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, ParseOptions const &options, char const *password=nullptr);
+
   /** Parses the input stream content. It will make callbacks to the functions provided by a
      librevenge::RVNGDrawingInterface class implementation when needed. This is often commonly called the
      'main parsing routine'.
@@ -116,6 +277,13 @@ public:
      \note Reserved for future use. Actually, it only returns false. */
   static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *documentInterface, char const *password=nullptr);
 
+  /** Parses the input stream content with some options, see ParseOptions.
+     \param input The input stream
+     \param documentInterface A RVNGDrawingInterface implementation
+     \param options the options of the parse, for instance the range of pages to convert
+     \param password The file password */
+  static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *documentInterface, ParseOptions const &options, char const *password=nullptr);
+
   /** Parses the input stream content. It will make callbacks to the functions provided by a
      librevenge::RVNGPresentationInterface class implementation when needed. This is often commonly called the
      'main parsing routine'.
@@ -126,6 +294,13 @@ public:
      \note Reserved for future use. Actually, it only returns false. */
   static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGPresentationInterface *documentInterface, char const *password=nullptr);
 
+  /** Parses the input stream content with some options, see ParseOptions.
+     \param input The input stream
+     \param documentInterface A RVNGPresentationInterface implementation
+     \param options the options of the parse, for instance the range of slides to convert
+     \param password The file password */
+  static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGPresentationInterface *documentInterface, ParseOptions const &options, char const *password=nullptr);
+
   /** Parses the input stream content. It will make callbacks to the functions provided by a
      librevenge::RVNGSpreadsheetInterface class implementation when needed. This is often commonly called the
      'main parsing routine'.
@@ -136,6 +311,67 @@ public:
    \note Can only convert some basic documents: retrieving more cells' contents but no formating. */
   static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGSpreadsheetInterface *documentInterface, char const *password=nullptr);
 
+  /** Parses the input stream content with some options, see ParseOptions.
+     \param input The input stream
+     \param documentInterface A RVNGSpreadsheetInterface implementation
+     \param options the options of the parse
+     \param password The file password */
+  static STOFFLIB Result parse(librevenge::RVNGInputStream *input, librevenge::RVNGSpreadsheetInterface *documentInterface, ParseOptions const &options, char const *password=nullptr);
+
+  /** Parses the input stream content and only retrieves its text: the paragraphs of a text document,
+     the text of the cells of a spreadsheet or the text of the shapes of a drawing/presentation.
+     It will only call startDocument, openParagraph, closeParagraph, insertText, insertTab,
+     insertLineBreak and endDocument of the librevenge::RVNGTextInterface.
+     \param input The input stream
+     \param documentInterface A RVNGTextInterface implementation, typically a RVNGTextTextGenerator
+     \param password The file password
+
+   \note the styles, the page spans, the frames and the fields are ignored */
+  static STOFFLIB Result parseTextContent(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, char const *password=nullptr);
+
+  /** Retrieves the text of the input stream content with some options, see parseTextContent and ParseOptions.
+     \param input The input stream
+     \param documentInterface A RVNGTextInterface implementation, typically a RVNGTextTextGenerator
+     \param options the options of the parse
+     \param password The file password */
+  static STOFFLIB Result parseTextContent(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, ParseOptions const &options, char const *password=nullptr);
+
+  /** Sets the maximum number of StarMath formulas whose MathML conversion is kept in memory.
+     The cache is shared by all the documents parsed by the process, so a formula which
+     appears many times is only converted once.
+     \param numFormulas the maximum number of formulas, 0 disables the cache
+
+   \note by default, the cache is disabled. */
+  static STOFFLIB void setMathFormulaCacheSize(int numFormulas);
+
+  /** Returns the number of StarMath formulas found in the formula cache and the number
+     of formulas which have been converted while the cache was enabled.
+     \param numHits the number of formulas found in the cache
+     \param numMisses the number of formulas not found in the cache */
+  static STOFFLIB void getMathFormulaCacheStatistics(unsigned long &numHits, unsigned long &numMisses);
+
+  /** Sets the maximum number of embedded objects whose conversion is kept in memory.
+     The embedded drawings, spreadsheets and OLE objects are identified by a hash of the
+     content of their OLE streams and of the parse options, so an object which is unchanged
+     is not read again, even if it is stored in another document.
+     \param numObjects the maximum number of objects, 0 disables the memory cache
+
+   \note by default, the cache is disabled. The charts, the formulas and the texts are not cached. */
+  static STOFFLIB void setEmbeddedObjectCacheSize(int numObjects);
+
+  /** Sets a directory where the conversion of the embedded objects is also stored, one
+     file by object, so that the results can be reused by the following processes.
+     \param directory an existing directory, nullptr or an empty string disables the disk cache
+
+   \note the directory is never cleaned by the library */
+  static STOFFLIB void setEmbeddedObjectCacheDirectory(char const *directory);
+
+  /** Returns the number of embedded objects found in the object cache and the number
+     of objects which have been read while the cache was enabled.
+     \param numHits the number of objects found in the cache
+     \param numMisses the number of objects not found in the cache */
+  static STOFFLIB void getEmbeddedObjectCacheStatistics(unsigned long &numHits, unsigned long &numMisses);
+
   // ------------------------------------------------------------
   // decoders of the embedded zones created by libstoff
   // ------------------------------------------------------------
@@ -0,0 +1,304 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+/* a benchmark which parses documents many times with the different
+   parsers of the library and the dummy generators used by the fuzzers,
+   and reports the parse times, the throughput, the allocations and the
+   peak memory */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+#include <librevenge-generators/RVNGDummyDrawingGenerator.h>
+#include <librevenge-generators/RVNGDummyPresentationGenerator.h>
+#include <librevenge-generators/RVNGDummySpreadsheetGenerator.h>
+#include <librevenge-generators/RVNGDummyTextGenerator.h>
+#include <librevenge-stream/librevenge-stream.h>
+
+#include <libstaroffice/libstaroffice.hxx>
+
+#define TOOLNAME "docbench"
+
+//! the number of allocations done by the process
+static std::atomic<unsigned long> s_numAllocations(0);
+
+void *operator new(std::size_t size)
+{
+  ++s_numAllocations;
+  void *ptr=malloc(size ? size : 1);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  free(ptr);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  free(ptr);
+}
+#endif
+
+static int printUsage()
+{
+  printf("`" TOOLNAME "' measures the parsing of StarOffice documents.\n");
+  printf("\n");
+  printf("Usage: " TOOLNAME " [OPTION] INPUT...\n");
+  printf("\n");
+  printf("Each INPUT is parsed by each parser of the library which accepts it:\n");
+  printf("text, spreadsheet, drawing, presentation and text content.\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t-h                show this help message\n");
+  printf("\t-o OUTPUT         also write the results in OUTPUT as JSON lines\n");
+  printf("\t-n NUM            parse each document NUM times (default 20)\n");
+  printf("\t-t NUM            use NUM threads to parse a document (default 1)\n");
+  return -1;
+}
+
+namespace DocBench
+{
+//! the different parse paths
+enum Path { P_Text=0, P_Spreadsheet, P_Drawing, P_Presentation, P_TextContent, P_NumPaths };
+
+//! returns the name of a parse path
+char const *getPathName(Path path)
+{
+  static char const *names[]= {"text", "spreadsheet", "drawing", "presentation", "textContent"};
+  return names[path];
+}
+
+//! parses a document stored in memory with a parse path
+STOFFDocument::Result parse(std::vector<unsigned char> const &data, Path path, STOFFDocument::ParseOptions const &options)
+{
+  librevenge::RVNGStringStream input(data.data(), static_cast<unsigned int>(data.size()));
+  try {
+    switch (path) {
+    case P_Text: {
+      librevenge::RVNGDummyTextGenerator generator;
+      return STOFFDocument::parse(&input, &generator, options);
+    }
+    case P_Spreadsheet: {
+      librevenge::RVNGDummySpreadsheetGenerator generator;
+      return STOFFDocument::parse(&input, &generator, options);
+    }
+    case P_Drawing: {
+      librevenge::RVNGDummyDrawingGenerator generator;
+      return STOFFDocument::parse(&input, &generator, options);
+    }
+    case P_Presentation: {
+      librevenge::RVNGDummyPresentationGenerator generator;
+      return STOFFDocument::parse(&input, &generator, options);
+    }
+    case P_TextContent: {
+      librevenge::RVNGDummyTextGenerator generator;
+      return STOFFDocument::parseTextContent(&input, &generator, options);
+    }
+    case P_NumPaths:
+    default:
+      break;
+    }
+  }
+  catch (...) {
+  }
+  return STOFFDocument::STOFF_R_UNKNOWN_ERROR;
+}
+
+//! returns the peak resident set size of the process in kilobytes
+long getPeakRSS()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)!=0)
+    return 0;
+#ifdef __APPLE__
+  return long(usage.ru_maxrss/1024);
+#else
+  return long(usage.ru_maxrss);
+#endif
+}
+
+//! returns the value at a given percentage of a sorted list
+double getPercentile(std::vector<double> const &sorted, double percent)
+{
+  if (sorted.empty()) return 0;
+  auto pos=size_t(percent*double(sorted.size()-1)/100.+0.5);
+  return sorted[std::min(pos, sorted.size()-1)];
+}
+
+//! the result of a file parsed with a parse path
+struct Result {
+  //! constructor
+  Result()
+    : m_median(0)
+    , m_p95(0)
+    , m_throughput(0)
+    , m_numAllocations(0)
+    , m_peakRSS(0)
+  {
+  }
+  //! the median time in seconds
+  double m_median;
+  //! the 95th percentile time in seconds
+  double m_p95;
+  //! the throughput in MB by second
+  double m_throughput;
+  //! the number of allocations by parse
+  unsigned long m_numAllocations;
+  //! the peak resident set size of the process in kilobytes
+  long m_peakRSS;
+};
+
+//! parses numIterations times a document with a parse path, returns false if the path does not accept the document
+bool benchmark(std::vector<unsigned char> const &data, Path path, STOFFDocument::ParseOptions const &options, int numIterations, Result &result)
+{
+  // a first parse to check the path and to fill the static tables
+  if (parse(data, path, options)!=STOFFDocument::STOFF_R_OK)
+    return false;
+  std::vector<double> times;
+  unsigned long const numAllocations=s_numAllocations;
+  for (int i=0; i<numIterations; ++i) {
+    auto start=std::chrono::steady_clock::now();
+    parse(data, path, options);
+    std::chrono::duration<double> const duration=std::chrono::steady_clock::now()-start;
+    times.push_back(duration.count());
+  }
+  // the allocations done to store the times are negligible
+  result.m_numAllocations=(s_numAllocations-numAllocations)/static_cast<unsigned long>(numIterations);
+  std::sort(times.begin(), times.end());
+  result.m_median=getPercentile(times, 50);
+  result.m_p95=getPercentile(times, 95);
+  result.m_throughput=result.m_median>0 ? double(data.size())/1e6/result.m_median : 0;
+  result.m_peakRSS=getPeakRSS();
+  return true;
+}
+
+//! replaces the characters which can not be stored in a JSON string
+std::string escapeJSON(std::string const &str)
+{
+  std::string res;
+  for (auto c : str) {
+    if (c=='"' || c=='\\')
+      res+='\\';
+    if (static_cast<unsigned char>(c)<0x20)
+      res+=' ';
+    else
+      res+=c;
+  }
+  return res;
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int ch, numIterations=20, numThreads=1;
+  bool printHelp=false;
+  char const *output=nullptr;
+  while ((ch = getopt(argc, argv, "hn:o:t:")) != -1) {
+    switch (ch) {
+    case 'o':
+      output=optarg;
+      break;
+    case 'n':
+      numIterations=atoi(optarg);
+      break;
+    case 't':
+      numThreads=atoi(optarg);
+      break;
+    default:
+    case 'h':
+      printHelp = true;
+      break;
+    }
+  }
+  if (optind>=argc || printHelp || numIterations<=0)
+    return printUsage();
+
+  FILE *json=nullptr;
+  if (output) {
+    json=fopen(output, "w");
+    if (!json) {
+      fprintf(stderr, "ERROR: can not create %s!\n", output);
+      return 1;
+    }
+  }
+  STOFFDocument::ParseOptions options;
+  options.m_numThreads=numThreads;
+  printf("%-32s %-12s %10s %10s %10s %12s %10s\n", "file", "path", "median(ms)", "p95(ms)", "MB/s", "allocations", "RSS(kB)");
+  int numParsed=0;
+  for (int i=optind; i<argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file) {
+      fprintf(stderr, "ERROR: can not open %s!\n", argv[i]);
+      continue;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.empty()) continue;
+    char const *name=strrchr(argv[i], '/');
+    name=name ? name+1 : argv[i];
+    for (int p=0; p<DocBench::P_NumPaths; ++p) {
+      auto path=DocBench::Path(p);
+      DocBench::Result result;
+      if (!DocBench::benchmark(data, path, options, numIterations, result))
+        continue;
+      ++numParsed;
+      printf("%-32.32s %-12s %10.3f %10.3f %10.2f %12lu %10ld\n", name, DocBench::getPathName(path),
+             1000*result.m_median, 1000*result.m_p95, result.m_throughput, result.m_numAllocations, result.m_peakRSS);
+      if (json)
+        fprintf(json, "{\"file\":\"%s\",\"path\":\"%s\",\"size\":%lu,\"iterations\":%d,\"median\":%.6f,\"p95\":%.6f,"
+                "\"throughput\":%.3f,\"allocations\":%lu,\"peakRSS\":%ld}\n",
+                DocBench::escapeJSON(argv[i]).c_str(), DocBench::getPathName(path), static_cast<unsigned long>(data.size()),
+                numIterations, result.m_median, result.m_p95, result.m_throughput, result.m_numAllocations, result.m_peakRSS);
+    }
+  }
+  if (json)
+    fclose(json);
+  return numParsed ? 0 : 1;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
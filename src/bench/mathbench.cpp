@@ -0,0 +1,209 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+/* a small benchmark which converts the StarMath formulas found in the
+   regression files or in text files (one formula by line) many times */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+
+#include "STOFFStarMathToMMLConverter.hxx"
+
+#define TOOLNAME "mathbench"
+
+static int printUsage()
+{
+  printf("`" TOOLNAME "' measures the conversion of StarMath formulas in MathML.\n");
+  printf("\n");
+  printf("Usage: " TOOLNAME " [OPTION] INPUT...\n");
+  printf("\n");
+  printf("The formulas are retrieved from the StarMath annotations of the INPUT files,\n");
+  printf("for example the .raw files of the regression directory.\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t-b                convert all the formulas in one batch\n");
+  printf("\t-c NUM            keep NUM converted formulas in the formula cache\n");
+  printf("\t-h                show this help message\n");
+  printf("\t-l                read a formula by line of INPUT\n");
+  printf("\t-n NUM            convert the formulas NUM times (default 1000)\n");
+  printf("\t-t NUM            use NUM threads to convert a batch (default 1)\n");
+  return -1;
+}
+
+//! replaces the xml entities by their characters
+static std::string unescapeXML(std::string const &str)
+{
+  static char const *entities[]= {"&lt;", "&gt;", "&amp;", "&quot;", "&apos;"};
+  static char const characters[]= {'<', '>', '&', '"', '\''};
+  std::string res;
+  for (size_t i=0; i<str.size(); ++i) {
+    bool found=false;
+    if (str[i]=='&') {
+      for (size_t e=0; e<5; ++e) {
+        if (str.compare(i, strlen(entities[e]), entities[e])!=0) continue;
+        res+=characters[e];
+        i+=strlen(entities[e])-1;
+        found=true;
+        break;
+      }
+    }
+    if (!found)
+      res+=str[i];
+  }
+  return res;
+}
+
+//! retrieves the formulas of a file: the StarMath annotations or each line
+static bool readFormulas(char const *fileName, bool byLine, std::vector<std::string> &formulas)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    fprintf(stderr, "ERROR: can not open %s!\n", fileName);
+    return false;
+  }
+  std::stringstream s;
+  s << file.rdbuf();
+  std::string const content=s.str();
+  if (!byLine) {
+    std::string const begin("<annotation encoding=\"StarMath 5.0\">");
+    for (size_t pos=content.find(begin); pos!=std::string::npos; pos=content.find(begin, pos)) {
+      pos+=begin.size();
+      size_t end=content.find("</annotation>", pos);
+      if (end==std::string::npos) break;
+      formulas.push_back(unescapeXML(content.substr(pos, end-pos)));
+    }
+    return true;
+  }
+  std::istringstream lines(content);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (!line.empty())
+      formulas.push_back(line);
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  int ch, numIterations=1000, cacheSize=0, numThreads=1;
+  bool printHelp=false, byLine=false, batch=false;
+  while ((ch = getopt(argc, argv, "bc:hln:t:")) != -1) {
+    switch (ch) {
+    case 'b':
+      batch=true;
+      break;
+    case 'c':
+      cacheSize=atoi(optarg);
+      break;
+    case 't':
+      numThreads=atoi(optarg);
+      break;
+    case 'l':
+      byLine=true;
+      break;
+    case 'n':
+      numIterations=atoi(optarg);
+      break;
+    default:
+    case 'h':
+      printHelp = true;
+      break;
+    }
+  }
+  if (optind>=argc || printHelp || numIterations<=0)
+    return printUsage();
+
+  std::vector<std::string> formulas;
+  for (int i=optind; i<argc; ++i) {
+    if (!readFormulas(argv[i], byLine, formulas))
+      return 1;
+  }
+  if (formulas.empty()) {
+    fprintf(stderr, "ERROR: can not find any formula!\n");
+    return 1;
+  }
+
+  std::vector<librevenge::RVNGString> starMaths;
+  for (auto const &formula : formulas)
+    starMaths.push_back(librevenge::RVNGString(formula.c_str()));
+  if (cacheSize>0)
+    STOFFStarMathToMMLConverter::setCacheSize(size_t(cacheSize));
+  STOFFStarMathToMMLConverter converter;
+  size_t numConverted=0, numBytes=0;
+  auto start=std::chrono::steady_clock::now();
+  for (int i=0; i<numIterations; ++i) {
+    if (batch) {
+      std::vector<librevenge::RVNGString> mmls;
+      std::vector<bool> oks;
+      STOFFStarMathToMMLConverter::convertStarMathList(starMaths, mmls, oks, numThreads);
+      for (size_t f=0; f<mmls.size(); ++f) {
+        if (!oks[f]) continue;
+        ++numConverted;
+        numBytes+=mmls[f].size();
+      }
+      continue;
+    }
+    for (auto const &starMath : starMaths) {
+      librevenge::RVNGString mml;
+      if (cacheSize>0 ? !STOFFStarMathToMMLConverter::convertStarMath(starMath, mml) : !converter.convert(starMath, mml))
+        continue;
+      ++numConverted;
+      numBytes+=mml.size();
+    }
+  }
+  std::chrono::duration<double> const duration=std::chrono::steady_clock::now()-start;
+  double const numConversions=double(numIterations)*double(starMaths.size());
+  printf("formulas: %lu, iterations: %d, converted: %lu/%.0f\n", static_cast<unsigned long>(starMaths.size()), numIterations,
+         static_cast<unsigned long>(numConverted), numConversions);
+  printf("time: %.3f s, %.3f us by formula, %.2f MB of MathML by second\n", duration.count(),
+         1e6*duration.count()/numConversions, duration.count()>0 ? double(numBytes)/1e6/duration.count() : 0.);
+  if (cacheSize>0) {
+    unsigned long numHits, numMisses;
+    STOFFStarMathToMMLConverter::getCacheStatistics(numHits, numMisses);
+    printf("cache: %lu hits, %lu misses, hit rate %.1f%%\n", numHits, numMisses,
+           numHits+numMisses ? 100.*double(numHits)/double(numHits+numMisses) : 0.);
+  }
+  return numConverted ? 0 : 1;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -0,0 +1,1168 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+
+/* a generator which creates large StarOffice 5 documents stored in an
+   OLE2 file: spreadsheets (a StarCalcDocument) with a configurable
+   number of sheets, rows and columns, drawings (a StarDrawDocument3)
+   with a configurable number of pages and polygons or text documents (a
+   StarWriterDocument) with a configurable number of paragraphs and
+   paragraph styles. It is used to check how the parsers scale with the
+   document size. */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define TOOLNAME "sdgen"
+
+static int printUsage()
+{
+  printf("`" TOOLNAME "' creates a StarOffice 5 spreadsheet, drawing or text document of a given size.\n");
+  printf("\n");
+  printf("Usage: " TOOLNAME " [OPTION] OUTPUT\n");
+  printf("\n");
+  printf("In a spreadsheet, the column i contains numbers if i%%3==0, strings if i%%3==1\n");
+  printf("and formulas (the number in column i-2 multiplied by 2) if i%%3==2.\n");
+  printf("In a drawing, each page contains a grid of star shaped polygons.\n");
+  printf("In a text document, the paragraph i uses the paragraph style i%%NUM_STYLES.\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t-h                show this help message\n");
+  printf("\t-d                create a drawing instead of a spreadsheet\n");
+  printf("\t-w                create a text document instead of a spreadsheet\n");
+  printf("\t-s NUM            create NUM sheets (default 1, maximum 256)\n");
+  printf("\t-r NUM            create NUM rows by sheet (default 1000, maximum 32000)\n");
+  printf("\t-c NUM            create NUM columns by sheet (default 10, maximum 256)\n");
+  printf("\t-p NUM            create NUM pages (default 10, maximum 65000)\n");
+  printf("\t-m NUM            create NUM polygons by page (default 100, maximum 100000)\n");
+  printf("\t-n NUM            create polygons with NUM points (default 10, minimum 3, maximum 10000)\n");
+  printf("\t-P NUM            create NUM paragraphs (default 1000, maximum 20000000)\n");
+  printf("\t-S NUM            create NUM paragraph styles (default 10, maximum 10000)\n");
+  return -1;
+}
+
+namespace SDGen
+{
+//! a buffer which stores the values in little endian
+struct Buffer {
+  //! constructor
+  Buffer()
+    : m_data()
+  {
+  }
+  //! returns the buffer size
+  size_t size() const
+  {
+    return m_data.size();
+  }
+  //! adds a 8-bit value
+  void addU8(unsigned value)
+  {
+    m_data.push_back(static_cast<unsigned char>(value));
+  }
+  //! adds a 16-bit value
+  void addU16(unsigned value)
+  {
+    addU8(value&0xff);
+    addU8((value>>8)&0xff);
+  }
+  //! adds a 32-bit value
+  void addU32(unsigned long value)
+  {
+    addU16(unsigned(value&0xffff));
+    addU16(unsigned((value>>16)&0xffff));
+  }
+  //! adds a double
+  void addDouble(double value)
+  {
+    uint64_t val;
+    memcpy(&val, &value, 8);
+    addU32(static_cast<unsigned long>(val&0xffffffff));
+    addU32(static_cast<unsigned long>(val>>32));
+  }
+  //! adds a string: its size followed by its characters
+  void addString(std::string const &str)
+  {
+    addU16(unsigned(str.size()));
+    m_data.insert(m_data.end(), str.begin(), str.end());
+  }
+  //! adds a buffer
+  void add(Buffer const &buffer)
+  {
+    m_data.insert(m_data.end(), buffer.m_data.begin(), buffer.m_data.end());
+  }
+  //! replaces a 32-bit value
+  void setU32(size_t pos, unsigned long value)
+  {
+    for (size_t i=0; i<4; ++i, value>>=8)
+      m_data[pos+i]=static_cast<unsigned char>(value&0xff);
+  }
+  //! the data
+  std::vector<unsigned char> m_data;
+};
+
+//! the special sector identifiers of the OLE2 files
+static unsigned long const S_Free=0xffffffff, S_EndOfChain=0xfffffffe, S_FAT=0xfffffffd, S_DIFAT=0xfffffffc;
+
+/** a minimal writer of OLE2 files (version 3, 512 bytes sectors).
+
+    The main stream is written directly in the file from the first
+    sector, the other streams are stored in memory and added when the
+    file is closed: after the main stream or in the mini stream if they
+    are small.
+ */
+class OLEWriter
+{
+public:
+  //! constructor
+  explicit OLEWriter(char const *clsid)
+    : m_file()
+    , m_clsid(clsid, clsid+16)
+    , m_mainName()
+    , m_mainSize(0)
+    , m_streamList()
+  {
+  }
+  //! creates the file and starts the main stream
+  bool open(char const *filename, std::string const &mainName)
+  {
+    m_file.open(filename, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!m_file) return false;
+    m_mainName=mainName;
+    m_mainSize=0;
+    // the header is written when the file is closed
+    std::vector<char> header(512, 0);
+    m_file.write(header.data(), 512);
+    return bool(m_file);
+  }
+  //! returns the main stream size
+  uint64_t getMainStreamSize() const
+  {
+    return m_mainSize;
+  }
+  //! appends some data to the main stream
+  bool write(Buffer const &buffer)
+  {
+    if (buffer.m_data.empty()) return true;
+    m_file.write(reinterpret_cast<char const *>(buffer.m_data.data()), std::streamsize(buffer.size()));
+    m_mainSize+=buffer.size();
+    return bool(m_file);
+  }
+  //! replaces a 32-bit value of the main stream
+  bool patch(uint64_t pos, unsigned long value)
+  {
+    Buffer buffer;
+    buffer.addU32(value);
+    m_file.seekp(std::streamoff(512+pos));
+    m_file.write(reinterpret_cast<char const *>(buffer.m_data.data()), 4);
+    m_file.seekp(0, std::ios::end);
+    return bool(m_file);
+  }
+  //! adds a stream which is written when the file is closed
+  void addStream(std::string const &name, Buffer const &data)
+  {
+    m_streamList.push_back(Stream(name, data));
+  }
+  //! writes the mini stream, the directory and the allocation tables
+  bool close();
+
+protected:
+  //! a stream stored in memory
+  struct Stream {
+    //! constructor
+    Stream(std::string const &name, Buffer const &data)
+      : m_name(name)
+      , m_data(data)
+      , m_firstSector(S_EndOfChain)
+    {
+    }
+    //! the stream name
+    std::string m_name;
+    //! the stream content
+    Buffer m_data;
+    //! the first sector or mini sector
+    unsigned long m_firstSector;
+  };
+  //! a directory entry
+  struct Entry {
+    //! constructor
+    Entry(std::string const &name, int type, unsigned long firstSector, uint64_t size)
+      : m_name(name)
+      , m_type(type)
+      , m_firstSector(firstSector)
+      , m_size(size)
+      , m_left(S_Free)
+      , m_right(S_Free)
+      , m_child(S_Free)
+    {
+    }
+    //! the entry name
+    std::string m_name;
+    //! the entry type: 2 for a stream, 5 for the root
+    int m_type;
+    //! the first sector
+    unsigned long m_firstSector;
+    //! the size
+    uint64_t m_size;
+    //! the left, right sibling and the child
+    unsigned long m_left, m_right, m_child;
+  };
+  //! adds a chain of numSectors sectors beginning at first in a table
+  static void addChain(std::vector<unsigned long> &table, unsigned long first, unsigned long numSectors)
+  {
+    for (unsigned long i=0; i<numSectors; ++i)
+      table.push_back(i+1==numSectors ? S_EndOfChain : first+i+1);
+  }
+  //! sorts the stream entries in a binary tree and returns its root
+  static unsigned long createTree(std::vector<Entry> &entries, std::vector<unsigned long> const &sorted, size_t first, size_t last)
+  {
+    if (first>=last) return S_Free;
+    size_t mid=(first+last)/2;
+    auto &entry=entries[sorted[mid]];
+    entry.m_left=createTree(entries, sorted, first, mid);
+    entry.m_right=createTree(entries, sorted, mid+1, last);
+    return sorted[mid];
+  }
+  //! writes a list of sectors, each sector is padded with value
+  bool writeSectors(std::vector<unsigned long> const &values, unsigned long pad)
+  {
+    Buffer buffer;
+    for (auto val : values) buffer.addU32(val);
+    while (buffer.size()%512) buffer.addU32(pad);
+    return writeData(buffer);
+  }
+  //! writes some data and pads the last sector with zeros
+  bool writeData(Buffer const &buffer)
+  {
+    m_file.write(reinterpret_cast<char const *>(buffer.m_data.data()), std::streamsize(buffer.size()));
+    size_t const rem=buffer.size()%512;
+    if (rem) {
+      std::vector<char> zeros(512-rem, 0);
+      m_file.write(zeros.data(), std::streamsize(zeros.size()));
+    }
+    return bool(m_file);
+  }
+
+  //! the file
+  std::fstream m_file;
+  //! the root class id
+  std::vector<char> m_clsid;
+  //! the main stream name
+  std::string m_mainName;
+  //! the main stream size
+  uint64_t m_mainSize;
+  //! the other streams
+  std::vector<Stream> m_streamList;
+};
+
+bool OLEWriter::close()
+{
+  if (!m_file) return false;
+  if (m_mainSize>=0xffffffff) {
+    fprintf(stderr, "ERROR: the main stream is too big\n");
+    return false;
+  }
+  // the streams whose size is less than 4096 must be stored in the mini stream
+  unsigned long numMainSectors=static_cast<unsigned long>((m_mainSize+511)/512);
+  bool mainInMiniStream=m_mainSize<4096;
+  if (mainInMiniStream) {
+    Buffer main;
+    main.m_data.resize(size_t(m_mainSize));
+    m_file.seekg(512);
+    m_file.read(reinterpret_cast<char *>(main.m_data.data()), std::streamsize(m_mainSize));
+    if (!m_file) return false;
+    m_file.seekp(0, std::ios::end);
+    m_streamList.push_back(Stream(m_mainName, main));
+  }
+
+  // the big streams are stored after the main stream, the others in the mini stream
+  unsigned long numSectors=numMainSectors;
+  Buffer miniStream;
+  std::vector<unsigned long> miniFAT;
+  for (auto &stream : m_streamList) {
+    if (stream.m_data.size()>=0xffffffff) {
+      fprintf(stderr, "ERROR: the stream %s is too big\n", stream.m_name.c_str());
+      return false;
+    }
+    if (stream.m_data.m_data.empty()) continue;
+    if (stream.m_data.size()>=4096) {
+      stream.m_firstSector=numSectors;
+      numSectors+=static_cast<unsigned long>((stream.m_data.size()+511)/512);
+      continue;
+    }
+    stream.m_firstSector=static_cast<unsigned long>(miniFAT.size());
+    addChain(miniFAT, stream.m_firstSector, static_cast<unsigned long>((stream.m_data.size()+63)/64));
+    miniStream.add(stream.m_data);
+    while (miniStream.size()%64) miniStream.addU8(0);
+  }
+
+  // the sectors: main stream, big streams, mini FAT, mini stream, directory, FAT and DIFAT
+  unsigned long const firstMiniFATSector=numSectors;
+  auto const numMiniFATSectors=static_cast<unsigned long>((miniFAT.size()+127)/128);
+  unsigned long const firstMiniStreamSector=firstMiniFATSector+numMiniFATSectors;
+  auto const numMiniStreamSectors=static_cast<unsigned long>((miniStream.size()+511)/512);
+  unsigned long const firstDirSector=firstMiniStreamSector+numMiniStreamSectors;
+  auto const numEntries=static_cast<unsigned long>(m_streamList.size()+(mainInMiniStream ? 1 : 2));
+  auto const numDirSectors=(numEntries+3)/4;
+  unsigned long const firstFATSector=firstDirSector+numDirSectors;
+  unsigned long numFATSectors=0, numDIFATSectors=0;
+  while (true) {
+    unsigned long const numSectors=firstFATSector+numFATSectors+numDIFATSectors;
+    unsigned long const newFAT=(numSectors+127)/128;
+    unsigned long const newDIFAT=newFAT>109 ? (newFAT-109+126)/127 : 0;
+    if (newFAT==numFATSectors && newDIFAT==numDIFATSectors) break;
+    numFATSectors=newFAT;
+    numDIFATSectors=newDIFAT;
+  }
+  unsigned long const firstDIFATSector=firstFATSector+numFATSectors;
+
+  // the allocation table
+  std::vector<unsigned long> FAT;
+  if (mainInMiniStream) // the sectors used to store the main stream are now unused
+    FAT.resize(numMainSectors, S_Free);
+  else
+    addChain(FAT, 0, numMainSectors);
+  for (auto const &stream : m_streamList) {
+    if (stream.m_data.size()>=4096)
+      addChain(FAT, stream.m_firstSector, static_cast<unsigned long>((stream.m_data.size()+511)/512));
+  }
+  addChain(FAT, firstMiniFATSector, numMiniFATSectors);
+  addChain(FAT, firstMiniStreamSector, numMiniStreamSectors);
+  addChain(FAT, firstDirSector, numDirSectors);
+  FAT.resize(FAT.size()+numFATSectors, S_FAT);
+  FAT.resize(FAT.size()+numDIFATSectors, S_DIFAT);
+
+  // the directory: the root followed by the streams
+  std::vector<Entry> entries;
+  entries.push_back(Entry("Root Entry", 5, numMiniStreamSectors ? firstMiniStreamSector : S_EndOfChain, miniStream.size()));
+  if (!mainInMiniStream)
+    entries.push_back(Entry(m_mainName, 2, 0, m_mainSize));
+  for (auto const &stream : m_streamList)
+    entries.push_back(Entry(stream.m_name, 2, stream.m_firstSector, stream.m_data.size()));
+  std::vector<unsigned long> sorted;
+  for (unsigned long i=1; i<entries.size(); ++i) sorted.push_back(i);
+  // the siblings are sorted by name length, then by upper case name
+  std::sort(sorted.begin(), sorted.end(), [&entries](unsigned long a, unsigned long b) {
+    std::string const &nameA=entries[a].m_name, &nameB=entries[b].m_name;
+    if (nameA.size()!=nameB.size()) return nameA.size()<nameB.size();
+    for (size_t i=0; i<nameA.size(); ++i) {
+      int cA=toupper(static_cast<unsigned char>(nameA[i])), cB=toupper(static_cast<unsigned char>(nameB[i]));
+      if (cA!=cB) return cA<cB;
+    }
+    return false;
+  });
+  entries[0].m_child=createTree(entries, sorted, 0, sorted.size());
+  Buffer directory;
+  for (size_t i=0; i<4*numDirSectors; ++i) {
+    size_t const pos=directory.size();
+    directory.m_data.resize(pos+128, 0);
+    if (i>=entries.size()) {
+      directory.setU32(pos+68, S_Free);
+      directory.setU32(pos+72, S_Free);
+      directory.setU32(pos+76, S_Free);
+      continue;
+    }
+    auto const &entry=entries[i];
+    for (size_t c=0; c<entry.m_name.size() && c<31; ++c)
+      directory.m_data[pos+2*c]=static_cast<unsigned char>(entry.m_name[c]);
+    directory.m_data[pos+64]=static_cast<unsigned char>(2*(std::min<size_t>(entry.m_name.size(),31)+1));
+    directory.m_data[pos+66]=static_cast<unsigned char>(entry.m_type);
+    directory.m_data[pos+67]=1; // black
+    directory.setU32(pos+68, entry.m_left);
+    directory.setU32(pos+72, entry.m_right);
+    directory.setU32(pos+76, entry.m_child);
+    if (entry.m_type==5)
+      std::copy(m_clsid.begin(), m_clsid.end(), directory.m_data.begin()+long(pos+80));
+    directory.setU32(pos+116, entry.m_firstSector);
+    directory.setU32(pos+120, static_cast<unsigned long>(entry.m_size));
+  }
+
+  // the DIFAT: the first 109 FAT sectors are stored in the header
+  std::vector<unsigned long> DIFAT;
+  for (unsigned long i=109; i<numFATSectors; ++i) {
+    DIFAT.push_back(firstFATSector+i);
+    if (DIFAT.size()%128==127)
+      DIFAT.push_back(firstDIFATSector+static_cast<unsigned long>(DIFAT.size()/128)+1);
+  }
+  if (numDIFATSectors) {
+    DIFAT.resize(128*numDIFATSectors-1, S_Free);
+    DIFAT.push_back(S_EndOfChain);
+  }
+
+  // pad the main stream and write the other sectors
+  if (m_mainSize%512) {
+    std::vector<char> zeros(512-size_t(m_mainSize%512), 0);
+    m_file.write(zeros.data(), std::streamsize(zeros.size()));
+  }
+  for (auto const &stream : m_streamList) {
+    if (stream.m_data.size()>=4096 && !writeData(stream.m_data))
+      return false;
+  }
+  if (!writeSectors(miniFAT, S_Free) || !writeData(miniStream) || !writeData(directory) ||
+      !writeSectors(FAT, S_Free) || !writeSectors(DIFAT, S_Free))
+    return false;
+
+  // finally the header
+  Buffer header;
+  static unsigned char const signature[]= {0xd0, 0xcf, 0x11, 0xe0, 0xa1, 0xb1, 0x1a, 0xe1};
+  header.m_data.assign(signature, signature+8);
+  header.m_data.resize(24, 0);
+  header.addU16(0x3e); // minor version
+  header.addU16(3); // major version
+  header.addU16(0xfffe); // byte order
+  header.addU16(9); // sector shift
+  header.addU16(6); // mini sector shift
+  header.m_data.resize(40, 0);
+  header.addU32(0); // number of directory sectors
+  header.addU32(numFATSectors);
+  header.addU32(firstDirSector);
+  header.addU32(0); // transaction
+  header.addU32(4096); // mini stream cutoff
+  header.addU32(numMiniFATSectors ? firstMiniFATSector : S_EndOfChain);
+  header.addU32(numMiniFATSectors);
+  header.addU32(numDIFATSectors ? firstDIFATSector : S_EndOfChain);
+  header.addU32(numDIFATSectors);
+  for (unsigned long i=0; i<109; ++i)
+    header.addU32(i<numFATSectors ? firstFATSector+i : S_Free);
+  m_file.seekp(0);
+  m_file.write(reinterpret_cast<char const *>(header.m_data.data()), 512);
+  m_file.close();
+  return !m_file.fail();
+}
+
+//! adds the CompObj stream which gives the class and the type of the document
+static void addCompObj(OLEWriter &ole, char const *clsid, std::string const &userType, std::string const &clipName)
+{
+  Buffer compObj;
+  compObj.addU16(1);
+  compObj.addU16(0xfffe);
+  compObj.addU32(0xa03);
+  compObj.addU32(0xffffffff);
+  compObj.m_data.insert(compObj.m_data.end(), clsid, clsid+16);
+  compObj.addU32(static_cast<unsigned long>(userType.size()+1));
+  compObj.m_data.insert(compObj.m_data.end(), userType.c_str(), userType.c_str()+userType.size()+1);
+  compObj.addU32(static_cast<unsigned long>(clipName.size()+1));
+  compObj.m_data.insert(compObj.m_data.end(), clipName.c_str(), clipName.c_str()+clipName.size()+1);
+  compObj.addU32(0);
+  ole.addStream("\001CompObj", compObj);
+}
+
+//! the generator of a StarCalc document
+class CalcGenerator
+{
+public:
+  //! constructor
+  CalcGenerator(int numSheets, int numRows, int numCols)
+    : m_numSheets(numSheets)
+    , m_numRows(numRows)
+    , m_numCols(numCols)
+  {
+  }
+  //! creates the document
+  bool generate(char const *filename) const;
+protected:
+  //! the document version (StarCalc 5)
+  enum { Version=0x205, MaxRow=31999 };
+  //! returns the number stored in a cell
+  static double getValue(int sheet, int row, int col)
+  {
+    return double(1000*row+col)/8.+sheet;
+  }
+  //! adds a record: its identifier followed by its size and its content
+  static void addRecord(Buffer &buffer, unsigned id, Buffer const &content)
+  {
+    buffer.addU16(id);
+    buffer.addU32(static_cast<unsigned long>(content.size()));
+    buffer.add(content);
+  }
+  //! adds a multi record: its size, its content and the table of the size of each sub content
+  static void addMultiRecord(Buffer &buffer, Buffer const &content, std::vector<unsigned long> const &sizes)
+  {
+    buffer.addU32(static_cast<unsigned long>(content.size()));
+    buffer.add(content);
+    buffer.addU16(0x4200);
+    buffer.addU32(static_cast<unsigned long>(4*sizes.size()));
+    for (auto size : sizes) buffer.addU32(size);
+  }
+  //! adds the document flags
+  static void addDocumentFlags(Buffer &buffer);
+  //! adds a sheet
+  void addSheet(Buffer &buffer, int sheet) const;
+  //! adds the cells of a column
+  void addColumn(Buffer &buffer, int sheet, int col) const;
+  //! adds a formula cell: value(col-2)*2
+  static void addFormula(Buffer &buffer, int sheet, int row, int col);
+
+  //! the number of sheets
+  int m_numSheets;
+  //! the number of rows
+  int m_numRows;
+  //! the number of columns
+  int m_numCols;
+};
+
+bool CalcGenerator::generate(char const *filename) const
+{
+  // the StarCalc 5 class id
+  static char const clsid[]= {'\x61', '\xb8', '\xa5', '\xc6', '\xd6', '\x85', '\xd1', '\x11',
+                              '\x89', '\xcb', '\x00', '\x80', '\x29', '\xe4', '\xb0', '\xb1'
+                             };
+  OLEWriter ole(clsid);
+  if (!ole.open(filename, "StarCalcDocument")) {
+    fprintf(stderr, "ERROR: can not create %s\n", filename);
+    return false;
+  }
+  // sc_document.cxx ScDocument::Save: a record whose size is known at the end
+  Buffer buffer;
+  buffer.addU16(0x422d);
+  buffer.addU32(0);
+  addDocumentFlags(buffer);
+  if (!ole.write(buffer)) return false;
+  for (int sheet=0; sheet<m_numSheets; ++sheet) {
+    buffer.m_data.clear();
+    addSheet(buffer, sheet);
+    if (!ole.write(buffer)) return false;
+  }
+  uint64_t const size=ole.getMainStreamSize()-6;
+  if (size>0xffffffff || !ole.patch(2, static_cast<unsigned long>(size))) {
+    fprintf(stderr, "ERROR: the document is too big\n");
+    return false;
+  }
+
+  addCompObj(ole, clsid, "Spreadsheet", "StarCalc 5.0");
+  return ole.close();
+}
+
+void CalcGenerator::addDocumentFlags(Buffer &buffer)
+{
+  Buffer content;
+  content.addU16(Version);
+  content.addString("Standard"); // page style
+  content.addU8(0); // protected
+  content.addString(""); // password
+  content.addU16(0x409); // language
+  content.addU8(1); // auto calc
+  content.addU16(0); // visible tab
+  content.addU16(Version);
+  content.addU16(MaxRow);
+  addRecord(buffer, 0x4221, content);
+}
+
+void CalcGenerator::addSheet(Buffer &buffer, int sheet) const
+{
+  // sc_table2.cxx ScTable::Save
+  Buffer table, columns, content;
+  std::vector<unsigned long> sizes;
+  for (int col=0; col<m_numCols; ++col) {
+    columns.addU8(unsigned(col));
+    size_t const pos=columns.size();
+    addColumn(columns, sheet, col);
+    sizes.push_back(static_cast<unsigned long>(columns.size()-pos));
+  }
+  table.addU16(0x4240);
+  addMultiRecord(table, columns, sizes);
+
+  // the columns width and the rows height
+  content.addU16(256);
+  content.addU16(0x40c);
+  content.addU16(256);
+  content.addU8(0);
+  content.addU16(MaxRow+1);
+  content.addU16(0x10a);
+  content.addU16(MaxRow+1);
+  content.addU8(0);
+  addRecord(table, 0x4241, content);
+
+  // the table options: name, scenario, comment, protected, password, outline
+  content.m_data.clear();
+  content.addString("Sheet"+std::to_string(sheet+1));
+  content.addU8(0);
+  content.addString("");
+  content.addU8(0);
+  content.addString("");
+  content.addU8(0);
+  addRecord(table, 0x4242, content);
+
+  addRecord(buffer, 0x4222, table);
+}
+
+void CalcGenerator::addColumn(Buffer &buffer, int sheet, int col) const
+{
+  // sc_column2.cxx ScColumn::SaveData
+  Buffer data, formula;
+  std::vector<unsigned long> sizes;
+  data.addU16(unsigned(m_numRows));
+  for (int row=0; row<m_numRows; ++row) {
+    data.addU16(unsigned(row));
+    switch (col%3) {
+    case 0:
+      data.addU8(1);
+      data.addU8(0);
+      data.addDouble(getValue(sheet, row, col));
+      break;
+    case 1:
+      data.addU8(2);
+      data.addU8(0);
+      data.addString("S"+std::to_string(sheet+1)+"R"+std::to_string(row+1)+"C"+std::to_string(col+1));
+      break;
+    default:
+      data.addU8(3);
+      formula.m_data.clear();
+      addFormula(formula, sheet, row, col);
+      sizes.push_back(static_cast<unsigned long>(formula.size()));
+      data.add(formula);
+      break;
+    }
+  }
+  buffer.addU16(0x4250);
+  addMultiRecord(buffer, data, sizes);
+}
+
+void CalcGenerator::addFormula(Buffer &buffer, int sheet, int row, int col)
+{
+  // sc_cell.cxx ScFormulaCell::Save
+  buffer.addU8(0); // data
+  buffer.addU8(8); // flags: has a numeric value
+  buffer.addU16(0x10); // format type: number
+  buffer.addDouble(2*getValue(sheet, row, col-2));
+  // sc_token.cxx ScTokenArray::Store
+  buffer.addU8(0xd0); // flags: has references, tokens, rpn
+  buffer.addU8(1); // mode
+  buffer.addU16(1); // number of references
+  buffer.addU16(3); // number of tokens
+  // the cell reference: column, row, sheet and relative flags
+  buffer.addU16(0);
+  buffer.addU8(3);
+  buffer.addU16(unsigned(col-2));
+  buffer.addU16(unsigned(row));
+  buffer.addU16(unsigned(sheet));
+  buffer.addU8(0x15);
+  // the operator *
+  buffer.addU16(23);
+  buffer.addU8(0);
+  buffer.addU8(0);
+  // the constant 2
+  buffer.addU16(0);
+  buffer.addU8(1);
+  buffer.addDouble(2);
+  // the rpn: reference, 2, *
+  buffer.addU16(3);
+  buffer.addU8(0);
+  buffer.addU8(2);
+  buffer.addU8(1);
+}
+
+//! the generator of a StarDraw document
+class DrawGenerator
+{
+public:
+  //! constructor
+  DrawGenerator(int numPages, int numPolygons, int numPoints)
+    : m_numPages(numPages)
+    , m_numPolygons(numPolygons)
+    , m_numPoints(numPoints)
+  {
+  }
+  //! creates the document
+  bool generate(char const *filename) const;
+protected:
+  //! the records version (StarDraw 5) and the page dimensions
+  enum { Version=16, Width=21000, Height=29700, Border=1000 };
+  //! adds a SDR record: its magic, its version, its size and its content
+  static void addSdrRecord(Buffer &buffer, char const *magic, Buffer const &content)
+  {
+    buffer.m_data.insert(buffer.m_data.end(), magic, magic+4);
+    buffer.addU16(Version);
+    buffer.addU32(static_cast<unsigned long>(content.size()+10));
+    buffer.add(content);
+  }
+  //! adds a record: its size (which includes itself) followed by its content
+  static void addRecord(Buffer &buffer, Buffer const &content)
+  {
+    buffer.addU32(static_cast<unsigned long>(content.size()+4));
+    buffer.add(content);
+  }
+  //! adds the model data: the model info, the statistic, the format and the units
+  static void addModelData(Buffer &buffer);
+  //! adds a page or a master page
+  void addPage(Buffer &buffer, int page, bool master) const;
+  //! adds a polygon
+  void addPolygon(Buffer &buffer, int page, int polygon) const;
+
+  //! the number of pages
+  int m_numPages;
+  //! the number of polygons by page
+  int m_numPolygons;
+  //! the number of points by polygon
+  int m_numPoints;
+};
+
+bool DrawGenerator::generate(char const *filename) const
+{
+  // the StarDraw 5 class id
+  static char const clsid[]= {'\xa0', '\x05', '\x89', '\x2e', '\xbd', '\x85', '\xd1', '\x11',
+                              '\x89', '\xd0', '\x00', '\x80', '\x29', '\xe4', '\xb0', '\xb1'
+                             };
+  OLEWriter ole(clsid);
+  if (!ole.open(filename, "StarDrawDocument3")) {
+    fprintf(stderr, "ERROR: can not create %s\n", filename);
+    return false;
+  }
+  // svx_svdmodel.cxx SdrModel::WriteData: the model header and its main record whose sizes are known at the end
+  Buffer buffer;
+  buffer.m_data.insert(buffer.m_data.end(), "DrMd", "DrMd"+4);
+  buffer.addU16(Version);
+  buffer.addU32(0);
+  buffer.addU32(0);
+  buffer.m_data.insert(buffer.m_data.end(), "JoeM", "JoeM"+4);
+  addModelData(buffer);
+  // the handout and the standard master pages
+  for (int i=0; i<2; ++i)
+    addPage(buffer, i, true);
+  if (!ole.write(buffer)) return false;
+  for (int page=0; page<m_numPages; ++page) {
+    buffer.m_data.clear();
+    addPage(buffer, page, false);
+    if (!ole.write(buffer)) return false;
+  }
+  buffer.m_data.clear();
+  buffer.m_data.insert(buffer.m_data.end(), "DrXX", "DrXX"+4);
+  if (!ole.write(buffer)) return false;
+  uint64_t const size=ole.getMainStreamSize();
+  if (size>0xffffffff || !ole.patch(6, static_cast<unsigned long>(size)) ||
+      !ole.patch(10, static_cast<unsigned long>(size-10))) {
+    fprintf(stderr, "ERROR: the document is too big\n");
+    return false;
+  }
+
+  /* sfx_styl.cxx SfxStyleSheetBasePool::Store: an empty item pool
+     followed by an empty secondary pool, so that all the objects
+     share the same pool */
+  Buffer styles;
+  styles.addU16(0xbbbb);
+  styles.addU8(2); // major version
+  styles.addU8(0); // minor version
+  styles.addU16(0xffff); // loading version
+  styles.addU32(0);
+  for (int i=0; i<2; ++i)
+    styles.addU32(1); // an empty record of type 1
+  ole.addStream("SfxStyleSheets", styles);
+  addCompObj(ole, clsid, "Drawing", "StarDraw 5.0");
+  return ole.close();
+}
+
+void DrawGenerator::addModelData(Buffer &buffer)
+{
+  Buffer content, record;
+  // svx_svdmodel.cxx operator<<(SdrModelInfo): the creation, modification, read and print dates
+  for (int i=0; i<3; ++i) {
+    record.addU32(20000101); // date
+    record.addU32(0); // time
+    record.addU8(1); // encoding
+    for (int j=0; j<3; ++j) record.addU8(0); // gui, cpu, system
+  }
+  record.addU32(0);
+  record.addU32(0);
+  addRecord(content, record);
+  record.m_data.clear();
+  addRecord(content, record); // the statistic
+  record.addU16(0);
+  record.addU16(0xffff); // the stream format
+  addRecord(content, record);
+  content.addU32(1); // object unit
+  content.addU32(1);
+  content.addU16(0); // 1/100 mm
+  content.addU16(0);
+  content.addU8(0); // page valid
+  content.addU8(0);
+  for (int i=0; i<6; ++i)
+    content.addString(""); // table, dash, line end, hash, gradient and bitmap names
+  content.addU32(1); // UI unit
+  content.addU32(1);
+  content.addU16(2); // cm
+  content.addU32(847); // default text height
+  content.addU32(1250); // default tabulation
+  content.addU16(1); // start page
+  addRecord(buffer, content);
+}
+
+void DrawGenerator::addPage(Buffer &buffer, int page, bool master) const
+{
+  // svx_svdpage.cxx SdrPage::WriteData: the dimensions, the master page descriptors and the objects
+  Buffer content, data;
+  content.m_data.insert(content.m_data.end(), "JoeM", "JoeM"+4);
+  data.addU32(Width);
+  data.addU32(Height);
+  for (int i=0; i<4; ++i)
+    data.addU32(Border);
+  data.addU16(0);
+  addRecord(content, data);
+  if (!master) {
+    // the standard master page with all its layers visible
+    Buffer desc;
+    desc.addU16(1);
+    for (int i=0; i<32; ++i)
+      desc.addU8(0xff);
+    data.m_data.clear();
+    data.addU16(1);
+    addSdrRecord(data, "DrMD", desc);
+    addSdrRecord(content, "DrML", data);
+    for (int polygon=0; polygon<m_numPolygons; ++polygon)
+      addPolygon(content, page, polygon);
+  }
+  content.m_data.insert(content.m_data.end(), "DrXX", "DrXX"+4);
+  content.addU8(0); // no background
+  data.m_data.clear();
+  addRecord(data, content);
+  addSdrRecord(buffer, master ? "DrMP" : "DrPg", data);
+}
+
+void DrawGenerator::addPolygon(Buffer &buffer, int page, int polygon) const
+{
+  // the polygons are stars placed on a grid, rotated depending on the page and the polygon
+  int const numCols=int(std::ceil(std::sqrt(double(m_numPolygons))));
+  int const numRows=(m_numPolygons+numCols-1)/numCols;
+  int const cellSize[]= {(Width-2*Border)/numCols, (Height-2*Border)/numRows};
+  int const center[]= {Border+(polygon%numCols)*cellSize[0]+cellSize[0]/2,
+                       Border+(polygon/numCols)*cellSize[1]+cellSize[1]/2
+                      };
+  double const radius=0.45*std::min(cellSize[0], cellSize[1]);
+  double const angle=0.1*double(page+polygon);
+  std::vector<int> points;
+  int box[]= {center[0], center[1], center[0], center[1]};
+  for (int pt=0; pt<m_numPoints; ++pt) {
+    double const r=(pt%2) ? radius/2 : radius, a=angle+2*M_PI*pt/m_numPoints;
+    int const coord[]= {center[0]+int(r*std::cos(a)), center[1]+int(r*std::sin(a))};
+    for (int c=0; c<2; ++c) {
+      points.push_back(coord[c]);
+      box[c]=std::min(box[c], coord[c]);
+      box[c+2]=std::max(box[c+2], coord[c]);
+    }
+  }
+
+  Buffer object, record, path;
+  object.m_data.insert(object.m_data.end(), "SVDr", "SVDr"+4);
+  object.addU16(8); // closed polygon
+  // svx_svdobj.cxx SdrObject::WriteData: the bounding box, the layer, the anchor and the flags
+  for (auto c : box) record.addU32(static_cast<unsigned long>(c));
+  record.addU16(0);
+  record.addU32(0);
+  record.addU32(0);
+  for (int i=0; i<6; ++i) record.addU8(0);
+  record.addU8(0); // no glue points
+  record.addU8(0); // no user data
+  addRecord(object, record);
+  // svx_svdoattr.cxx SdrAttrObj::WriteData: no item sets and no style
+  record.m_data.clear();
+  for (int i=0; i<6; ++i) record.addU16(0xfff0);
+  record.addString("");
+  addRecord(object, record);
+  // svx_svdotext.cxx SdrTextObj::WriteData: no text
+  record.m_data.clear();
+  record.addU8(0);
+  for (auto c : box) record.addU32(static_cast<unsigned long>(c));
+  record.addU32(0); // rotation
+  record.addU32(0); // shear
+  record.addU8(0); // no paragraph
+  record.addU8(0); // no bound
+  addRecord(object, record);
+  // svx_svdopath.cxx SdrPathObj::WriteData: one polygon, its points and its flags
+  path.addU16(1);
+  path.addU16(unsigned(m_numPoints));
+  for (auto c : points) path.addU32(static_cast<unsigned long>(c));
+  for (int pt=0; pt<m_numPoints; ++pt) path.addU8(0);
+  record.m_data.clear();
+  addRecord(record, path);
+  addRecord(object, record);
+  addSdrRecord(buffer, "DrOb", object);
+}
+
+//! the generator of a StarWriter document
+class WriterGenerator
+{
+public:
+  //! constructor
+  WriterGenerator(int numParagraphs, int numStyles)
+    : m_numParagraphs(numParagraphs)
+    , m_numStyles(numStyles)
+  {
+  }
+  //! creates the document
+  bool generate(char const *filename) const;
+protected:
+  //! the document version (StarWriter 5) and the maximal size of a record
+  enum { Version=0x217, MaxRecordSize=0xffffff };
+  //! returns the name of a paragraph style
+  static std::string getStyleName(int style)
+  {
+    return "Style"+std::to_string(style+1);
+  }
+  //! adds a record: its type and its size (which includes the header) followed by its content
+  static void addRecord(Buffer &buffer, char type, Buffer const &content)
+  {
+    buffer.addU32(static_cast<unsigned long>(static_cast<unsigned char>(type))|
+                  (static_cast<unsigned long>(content.size()+4)<<8));
+    buffer.add(content);
+  }
+  //! adds the header: the recPos field is at position 16
+  static void addHeader(Buffer &buffer);
+  //! adds a paragraph
+  void addParagraph(Buffer &buffer, int paragraph) const;
+  //! adds the paragraph styles
+  void addStyles(Buffer &buffer) const;
+
+  //! the number of paragraphs
+  int m_numParagraphs;
+  //! the number of paragraph styles
+  int m_numStyles;
+};
+
+bool WriterGenerator::generate(char const *filename) const
+{
+  // the StarWriter 5 class id
+  static char const clsid[]= {'\xd1', '\xf9', '\x0c', '\xc2', '\xae', '\x85', '\xd1', '\x11',
+                              '\xaa', '\xb4', '\x00', '\x60', '\x97', '\xda', '\x56', '\x1a'
+                             };
+  OLEWriter ole(clsid);
+  if (!ole.open(filename, "StarWriterDocument")) {
+    fprintf(stderr, "ERROR: can not create %s\n", filename);
+    return false;
+  }
+  // sw_sw3doc.cxx Sw3IoImp::SaveDocContents: the header, the style names pool and the contents
+  Buffer buffer, content;
+  addHeader(buffer);
+  content.addU8(1); // encoding
+  content.addU16(unsigned(m_numStyles));
+  for (int style=0; style<m_numStyles; ++style) {
+    content.addU16(0xffff); // no pool id
+    content.addString(getStyleName(style));
+  }
+  addRecord(buffer, '!', content);
+  // sw_sw3sectn.cxx Sw3IoImp::OutContents: a record whose size is known at the end
+  uint64_t const contentsPos=ole.getMainStreamSize()+buffer.size();
+  buffer.addU32(0);
+  buffer.addU8(0x04); // flag: 4 bytes of data
+  buffer.addU32(static_cast<unsigned long>(m_numParagraphs));
+  if (!ole.write(buffer)) return false;
+  for (int paragraph=0; paragraph<m_numParagraphs; ++paragraph) {
+    buffer.m_data.clear();
+    addParagraph(buffer, paragraph);
+    if (!ole.write(buffer)) return false;
+  }
+  uint64_t const contentsSize=ole.getMainStreamSize()-contentsPos;
+  buffer.m_data.clear();
+  addRecord(buffer, 'Z', Buffer());
+  if (contentsSize<MaxRecordSize) {
+    if (!ole.patch(contentsPos, static_cast<unsigned long>('N')|(static_cast<unsigned long>(contentsSize)<<8)))
+      return false;
+  }
+  else {
+    // sw_sw3imp.cxx Sw3IoImp::OutRecSizes: the size of the big records is stored at the end
+    uint64_t const recSizesPos=ole.getMainStreamSize()+buffer.size();
+    if (recSizesPos>0xffffffff) {
+      fprintf(stderr, "ERROR: the document is too big\n");
+      return false;
+    }
+    content.m_data.clear();
+    content.addU8(0x04); // flag: 4 bytes of data
+    content.addU32(1);
+    content.addU32(static_cast<unsigned long>(contentsPos));
+    content.addU32(static_cast<unsigned long>(contentsSize));
+    addRecord(buffer, '%', content);
+    if (!ole.patch(contentsPos, static_cast<unsigned long>('N')|(static_cast<unsigned long>(MaxRecordSize)<<8)) ||
+        !ole.patch(16, static_cast<unsigned long>(recSizesPos)))
+      return false;
+  }
+  if (!ole.write(buffer)) return false;
+
+  Buffer styles;
+  addStyles(styles);
+  ole.addStream("SfxStyleSheets", styles);
+  addCompObj(ole, clsid, "Text", "StarWriter 5.0");
+  return ole.close();
+}
+
+void WriterGenerator::addHeader(Buffer &buffer)
+{
+  // sw_sw3doc.cxx Sw3IoImp::OutHeader
+  buffer.m_data.insert(buffer.m_data.end(), "SW5HDR", "SW5HDR"+7);
+  buffer.addU8(0x2e); // header size
+  buffer.addU16(Version);
+  buffer.addU16(0); // file flags
+  buffer.addU32(0); // document flags
+  buffer.addU32(0); // the position of the record sizes
+  for (int i=0; i<6; ++i) buffer.addU8(0);
+  buffer.addU8(0); // redline mode
+  buffer.addU8(0); // compatibility version
+  for (int i=0; i<16; ++i) buffer.addU8(0); // no password
+  buffer.addU8(1); // encoding
+  buffer.addU8(0);
+  buffer.addU32(20000101); // date
+  buffer.addU32(0); // time
+}
+
+void WriterGenerator::addParagraph(Buffer &buffer, int paragraph) const
+{
+  // sw_sw3nodes.cxx Sw3IoImp::OutTxtNode: the style, the conditional style and the text
+  Buffer content;
+  content.addU8(0x04); // flag: 4 bytes of data
+  content.addU16(unsigned(paragraph%m_numStyles));
+  content.addU16(0); // no conditional style
+  content.addString("Paragraph "+std::to_string(paragraph+1)+" of a generated document, written with "+
+                    getStyleName(paragraph%m_numStyles)+".");
+  addRecord(buffer, 'T', content);
+}
+
+void WriterGenerator::addStyles(Buffer &buffer) const
+{
+  /* sfx_styl.cxx SfxStyleSheetBasePool::Store: an empty item pool
+     followed by the style sheets stored in the old format */
+  buffer.addU16(0xbbbb);
+  buffer.addU8(2); // major version
+  buffer.addU8(0); // minor version
+  buffer.addU16(0xffff); // loading version
+  buffer.addU32(0);
+  buffer.addU32(1); // an empty record of type 1
+  buffer.addU16(50); // the help ids are stored in 32 bits
+  buffer.addU16(1); // encoding
+  buffer.addU16(unsigned(m_numStyles));
+  for (int style=0; style<m_numStyles; ++style) {
+    buffer.addString(getStyleName(style));
+    buffer.addString(""); // parent
+    buffer.addString(""); // follow
+    buffer.addU16(2); // paragraph family
+    buffer.addU16(0); // mask
+    buffer.addString(""); // help file
+    buffer.addU32(0); // help id
+    // the item set: a font size between 10pt and 17pt and a normal or a bold weight
+    buffer.addU16(2);
+    buffer.addU16(8); // font size
+    buffer.addU16(0); // slot
+    buffer.addU16(0xffff); // direct
+    buffer.addU16(2); // version
+    buffer.addU32(6);
+    buffer.addU16(unsigned(20*(10+style%8))); // in twip
+    buffer.addU16(100); // proportion
+    buffer.addU16(9); // twip
+    buffer.addU16(15); // weight
+    buffer.addU16(0);
+    buffer.addU16(0xffff);
+    buffer.addU16(0);
+    buffer.addU32(1);
+    buffer.addU8((style%2) ? 8 : 5); // bold or normal
+    // sw_sw3style.cxx SwStyleSheet::Store: the pool id, the outline level, no conditions and the flags
+    buffer.addU16(6); // version
+    buffer.addU32(6);
+    buffer.addU16(0);
+    buffer.addU8(201); // no outline level
+    buffer.addU16(0);
+    buffer.addU8(0);
+  }
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int ch, numSheets=1, numRows=1000, numCols=10, numPages=10, numPolygons=100, numPoints=10;
+  int numParagraphs=1000, numStyles=10;
+  bool printHelp=false, drawing=false, text=false;
+  while ((ch = getopt(argc, argv, "hdws:r:c:p:m:n:P:S:")) != -1) {
+    switch (ch) {
+    case 'd':
+      drawing=true;
+      break;
+    case 'w':
+      text=true;
+      break;
+    case 's':
+      numSheets=atoi(optarg);
+      break;
+    case 'r':
+      numRows=atoi(optarg);
+      break;
+    case 'c':
+      numCols=atoi(optarg);
+      break;
+    case 'p':
+      numPages=atoi(optarg);
+      break;
+    case 'm':
+      numPolygons=atoi(optarg);
+      break;
+    case 'n':
+      numPoints=atoi(optarg);
+      break;
+    case 'P':
+      numParagraphs=atoi(optarg);
+      break;
+    case 'S':
+      numStyles=atoi(optarg);
+      break;
+    default:
+    case 'h':
+      printHelp = true;
+      break;
+    }
+  }
+  if (optind+1!=argc || printHelp || numSheets<=0 || numSheets>256 ||
+      numRows<=0 || numRows>32000 || numCols<=0 || numCols>256 ||
+      numPages<=0 || numPages>65000 || numPolygons<=0 || numPolygons>100000 ||
+      numPoints<3 || numPoints>10000 || numParagraphs<=0 || numParagraphs>20000000 ||
+      numStyles<=0 || numStyles>10000 || (drawing && text))
+    return printUsage();
+
+  if (drawing) {
+    SDGen::DrawGenerator generator(numPages, numPolygons, numPoints);
+    return generator.generate(argv[optind]) ? 0 : 1;
+  }
+  if (text) {
+    SDGen::WriterGenerator generator(numParagraphs, numStyles);
+    return generator.generate(argv[optind]) ? 0 : 1;
+  }
+  SDGen::CalcGenerator generator(numSheets, numRows, numCols);
+  if (!generator.generate(argv[optind]))
+    return 1;
+  return 0;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -0,0 +1,128 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+/* a small benchmark which measures the cost of the debug traces in a
+   release build: it simulates a record reader which stores some strings
+   and traces them eagerly or with STOFF_DEBUG_TRACE */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+
+#include "libstaroffice_internal.hxx"
+#include "STOFFDebug.hxx"
+
+#define TOOLNAME "tracebench"
+
+static int printUsage()
+{
+  printf("`" TOOLNAME "' measures the cost of the debug traces in a release build.\n");
+  printf("\n");
+  printf("Usage: " TOOLNAME " [OPTION]\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t-h                show this help message\n");
+  printf("\t-l NUM            use strings of NUM characters (default 32)\n");
+  printf("\t-n NUM            read NUM records (default 1000000)\n");
+  return -1;
+}
+
+//! simulates the reading of a record: retrieves a string and traces it
+static size_t readRecord(std::vector<uint32_t> const &data, size_t pos, size_t length, bool lazy, std::vector<uint32_t> &text)
+{
+  libstoff::DebugFile ascFile;
+  libstoff::DebugStream f;
+  f << "Entries(Record):";
+  text.assign(data.begin()+long(pos), data.begin()+long(pos+length));
+  if (lazy)
+    STOFF_DEBUG_TRACE(f << "name=" << libstoff::getString(text).cstr() << ",");
+  else
+    f << "name=" << libstoff::getString(text).cstr() << ",";
+  ascFile.addPos(long(pos));
+  ascFile.addNote(f.str().c_str());
+  return text.size();
+}
+
+//! reads numRecords records and returns the elapsed time
+static double readRecords(std::vector<uint32_t> const &data, size_t length, int numRecords, bool lazy, size_t &numChars)
+{
+  std::vector<uint32_t> text;
+  size_t const numPositions=data.size()-length+1;
+  auto start=std::chrono::steady_clock::now();
+  for (int i=0; i<numRecords; ++i)
+    numChars+=readRecord(data, size_t(i)%numPositions, length, lazy, text);
+  std::chrono::duration<double> const duration=std::chrono::steady_clock::now()-start;
+  return duration.count();
+}
+
+int main(int argc, char *argv[])
+{
+  int ch, numRecords=1000000, length=32;
+  bool printHelp=false;
+  while ((ch = getopt(argc, argv, "hl:n:")) != -1) {
+    switch (ch) {
+    case 'l':
+      length=atoi(optarg);
+      break;
+    case 'n':
+      numRecords=atoi(optarg);
+      break;
+    default:
+    case 'h':
+      printHelp = true;
+      break;
+    }
+  }
+  if (optind!=argc || printHelp || numRecords<=0 || length<=0)
+    return printUsage();
+
+  std::vector<uint32_t> data;
+  for (int i=0; i<length+256; ++i)
+    data.push_back(uint32_t(i%3==0 ? 0xe9 : 'a'+i%26));
+  size_t numChars=0;
+  double const eager=readRecords(data, size_t(length), numRecords, false, numChars);
+  double const lazy=readRecords(data, size_t(length), numRecords, true, numChars);
+  printf("records: %d, string length: %d, characters: %lu\n", numRecords, length, static_cast<unsigned long>(numChars));
+  printf("eager traces: %.3f s, %.3f us by record\n", eager, 1e6*eager/double(numRecords));
+  printf("lazy traces: %.3f s, %.3f us by record\n", lazy, 1e6*lazy/double(numRecords));
+  if (lazy>0)
+    printf("speedup: %.2fx\n", eager/lazy);
+  return 0;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -31,9 +31,11 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include <cstring>
+#include <string>
 
 #include <librevenge/librevenge.h>
 #include <librevenge-generators/librevenge-generators.h>
@@ -62,8 +64,12 @@ static int printUsage()
   printf("\n");
   printf("Options:\n");
   printf("\t-c                 display the call graph nesting level\n");
+  printf("\t-C DIRECTORY       store the embedded objects in DIRECTORY and reuse them\n");
   printf("\t-h                 show this help message\n");
+  printf("\t-j NUM             use NUM threads to parse the document (0: one by core)\n");
   printf("\t-p PASSWORD        set password to open the file\n");
+  printf("\t-s                 print the time, the bytes and the buffers used by each zone in the error stream\n");
+  printf("\t-t                 print the records read in the error stream (JSON lines)\n");
   printf("\t-v                 show version information\n");
   printf("\n");
   printf("Report bugs to <https://github.com/fosnola/libstaroffice/issues>.\n");
@@ -76,18 +82,95 @@ static int printVersion()
   return 0;
 }
 
+//! appends a string in a JSON string
+static void appendJSONString(std::string &res, char const *str)
+{
+  res+='"';
+  for (; str && *str; ++str) {
+    auto c=static_cast<unsigned char>(*str);
+    if (c=='"' || c=='\\') {
+      res+='\\';
+      res+=char(c);
+    }
+    else if (c<0x20) {
+      char buffer[10];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      res+=buffer;
+    }
+    else
+      res+=char(c);
+  }
+  res+='"';
+}
+
+//! prints a record read by the library as a JSON line
+static void printParseTrace(STOFFDocument::ParseTraceRecord const &record, void *)
+{
+  std::string line("{\"zone\":");
+  appendJSONString(line, record.m_zone);
+  line+=",\"type\":";
+  appendJSONString(line, record.m_type);
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer), ",\"offset\":%ld,\"length\":%ld,\"level\":%d,\"duration\":%.6f",
+           record.m_offset, record.m_length, record.m_level, record.m_duration);
+  line+=buffer;
+  if (record.m_note) {
+    line+=",\"note\":";
+    appendJSONString(line, record.m_note);
+  }
+  line+="}\n";
+  // one call, so that the lines written by several threads are not mixed
+  fputs(line.c_str(), stderr);
+}
+
+//! stores the time, the bytes and the records used by a zone or a reader function in a string
+static void storeParseStatistic(STOFFDocument::ParseStatistic const &statistic, void *data)
+{
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer), "%-36s %8lu %12.3f %12lu %10lu %8lu %12lu\n", statistic.m_name, statistic.m_numCalls,
+           1000*statistic.m_duration, statistic.m_numBytes, statistic.m_numRecords,
+           statistic.m_numAllocations, statistic.m_numAllocatedBytes);
+  *static_cast<std::string *>(data)+=buffer;
+}
+
+//! prints the parse statistics in the error stream
+static void printParseStatistics(std::string const &statistics)
+{
+  fprintf(stderr, "%-36s %8s %12s %12s %10s %8s %12s\n", "zone/function", "calls", "time(ms)", "bytes", "records",
+          "buffers", "buffer bytes");
+  fputs(statistics.c_str(), stderr);
+}
+
 int main(int argc, char *argv[])
 {
-  bool printIndentLevel = false, printHelp = false;
+  bool printIndentLevel = false, printHelp = false, printStatistics = false;
+  // the regression outputs store the bitmaps as PPM pictures, they do not depend on zlib
+  STOFFDocument::ParseOptions options;
+  options.m_convertBitmapsToPNG=false;
+  std::string statistics;
   char *file = nullptr;
   char const *password=nullptr;
   int ch;
 
-  while ((ch = getopt(argc, argv, "chvp:")) != -1) {
+  while ((ch = getopt(argc, argv, "cC:hj:vp:st")) != -1) {
     switch (ch) {
     case 'c':
       printIndentLevel = true;
       break;
+    case 'C':
+      STOFFDocument::setEmbeddedObjectCacheDirectory(optarg);
+      break;
+    case 'j':
+      options.m_numThreads=atoi(optarg);
+      break;
+    case 's':
+      printStatistics = true;
+      options.m_statisticsCallback=storeParseStatistic;
+      options.m_statisticsData=&statistics;
+      break;
+    case 't':
+      options.m_traceCallback=printParseTrace;
+      break;
     case 'v':
       printVersion();
       return 0;
@@ -125,19 +208,19 @@ int main(int argc, char *argv[])
   try {
     if (kind == STOFFDocument::STOFF_K_DRAW || kind == STOFFDocument::STOFF_K_GRAPHIC) {
       librevenge::RVNGRawDrawingGenerator documentGenerator(printIndentLevel);
-      error=STOFFDocument::parse(&input, &documentGenerator,password);
+      error=STOFFDocument::parse(&input, &documentGenerator, options, password);
     }
     else if (kind == STOFFDocument::STOFF_K_SPREADSHEET || kind == STOFFDocument::STOFF_K_DATABASE) {
       librevenge::RVNGRawSpreadsheetGenerator documentGenerator(printIndentLevel);
-      error=STOFFDocument::parse(&input, &documentGenerator,password);
+      error=STOFFDocument::parse(&input, &documentGenerator, options, password);
     }
     else if (kind == STOFFDocument::STOFF_K_PRESENTATION) {
       librevenge::RVNGRawPresentationGenerator documentGenerator(printIndentLevel);
-      error=STOFFDocument::parse(&input, &documentGenerator,password);
+      error=STOFFDocument::parse(&input, &documentGenerator, options, password);
     }
     else {
       librevenge::RVNGRawTextGenerator documentGenerator(printIndentLevel);
-      error=STOFFDocument::parse(&input, &documentGenerator,password);
+      error=STOFFDocument::parse(&input, &documentGenerator, options, password);
     }
   }
   catch (STOFFDocument::Result const &err) {
@@ -147,6 +230,8 @@ int main(int argc, char *argv[])
     error = STOFFDocument::STOFF_R_UNKNOWN_ERROR;
   }
 
+  if (printStatistics)
+    printParseStatistics(statistics);
   if (error == STOFFDocument::STOFF_R_FILE_ACCESS_ERROR)
     fprintf(stderr, "ERROR: File Exception!\n");
   else if (error == STOFFDocument::STOFF_R_PARSE_ERROR)
@@ -155,6 +240,10 @@ int main(int argc, char *argv[])
     fprintf(stderr, "ERROR: File is an OLE document!\n");
   else if (error == STOFFDocument::STOFF_R_PASSWORD_MISSMATCH_ERROR)
     fprintf(stderr, "ERROR: Bad password!\n");
+  else if (error == STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR)
+    fprintf(stderr, "ERROR: Resource limit exceeded!\n");
+  else if (error == STOFFDocument::STOFF_R_CANCELED)
+    fprintf(stderr, "ERROR: Parse canceled!\n");
   else if (error != STOFFDocument::STOFF_R_OK)
     fprintf(stderr, "ERROR: Unknown Error!\n");
 
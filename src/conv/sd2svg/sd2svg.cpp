@@ -69,6 +69,7 @@ static int printUsage()
   printf("\t-o OUTPUT          write ouput to OUTPUT\n");
   printf("\t-N                 Output the number of sheets\n");
   printf("\t-n NUM             choose the page to convert (1: means first page)\n");
+  printf("\t-r DPI             simplify the shapes for an output of DPI dots per inch\n");
   printf("\t-v                 show version information\n");
   printf("\n");
   printf("Report bugs to <https://github.com/fosnola/libstaroffice/issues>.\n");
@@ -89,9 +90,9 @@ int main(int argc, char *argv[])
   char const *output = nullptr;
   bool printHelp=false;
   bool printNumberOfPages=false;
-  int ch, pageToConvert=0;
+  int ch, pageToConvert=0, resolution=0;
 
-  while ((ch = getopt(argc, argv, "ho:n:vN")) != -1) {
+  while ((ch = getopt(argc, argv, "ho:n:r:vN")) != -1) {
     switch (ch) {
     case 'o':
       output=optarg;
@@ -105,6 +106,9 @@ int main(int argc, char *argv[])
     case 'N':
       printNumberOfPages=true;
       break;
+    case 'r':
+      resolution=std::atoi(optarg);
+      break;
     default:
     case 'h':
       printHelp = true;
@@ -116,6 +120,12 @@ int main(int argc, char *argv[])
     printUsage();
     return -1;
   }
+  STOFFDocument::ParseOptions options;
+  options.m_drawingResolution=resolution;
+  // the regression outputs store the bitmaps as PPM pictures, they do not depend on zlib
+  options.m_convertBitmapsToPNG=false;
+  // only read the page to convert
+  options.m_firstPage=options.m_lastPage=(printNumberOfPages || pageToConvert<0) ? 0 : pageToConvert;
   librevenge::RVNGFileStream input(argv[optind]);
 
   STOFFDocument::Kind kind;
@@ -137,11 +147,11 @@ int main(int argc, char *argv[])
   try {
     if (kind == STOFFDocument::STOFF_K_DRAW) {
       librevenge::RVNGSVGDrawingGenerator listener(vec, "");
-      error = STOFFDocument::parse(&input, &listener);
+      error = STOFFDocument::parse(&input, &listener, options);
     }
     else if (kind == STOFFDocument::STOFF_K_PRESENTATION) {
       librevenge::RVNGSVGPresentationGenerator listener(vec);
-      error = STOFFDocument::parse(&input, &listener);
+      error = STOFFDocument::parse(&input, &listener, options);
     }
     else {
       fprintf(stderr,"ERROR: not a graphic/presentation document!\n");
@@ -162,6 +172,10 @@ int main(int argc, char *argv[])
     fprintf(stderr, "ERROR: Parse Exception!\n");
   else if (error == STOFFDocument::STOFF_R_OLE_ERROR)
     fprintf(stderr, "ERROR: File is an OLE document!\n");
+  else if (error == STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR)
+    fprintf(stderr, "ERROR: Resource limit exceeded!\n");
+  else if (error == STOFFDocument::STOFF_R_CANCELED)
+    fprintf(stderr, "ERROR: Parse canceled!\n");
   else if (error != STOFFDocument::STOFF_R_OK)
     fprintf(stderr, "ERROR: Unknown Error!\n");
 
@@ -173,23 +187,23 @@ int main(int argc, char *argv[])
     return 0;
   }
 
-  unsigned page=pageToConvert>0 ? unsigned(pageToConvert-1) : 0;
-  if (page>=vec.size()) {
-    fprintf(stderr, "ERROR: can not find page %d!\n", int(page));
+  // the other pages are not read
+  if (vec.empty()) {
+    fprintf(stderr, "ERROR: can not find page %d!\n", pageToConvert);
     return 1;
   }
   if (!output) {
     std::cout << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
     std::cout << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"";
     std::cout << " \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n";
-    std::cout << vec[page].cstr() << std::endl;
+    std::cout << vec[0].cstr() << std::endl;
   }
   else {
     std::ofstream out(output);
     out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
     out << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"";
     out << " \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n";
-    out << vec[page].cstr() << std::endl;
+    out << vec[0].cstr() << std::endl;
   }
   return 0;
 }
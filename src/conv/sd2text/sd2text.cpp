@@ -61,6 +61,7 @@ static int printUsage()
   printf("\t-h                show this help message\n");
   printf("\t-o OUTPUT         write ouput to OUTPUT\n");
   printf("\t-p PASSWORD       set password to open the file\n");
+  printf("\t-t                only retrieve the text content (faster)\n");
   printf("\t-v                show version information\n");
   printf("\n");
   printf("Report bugs to <https://github.com/fosnola/libstaroffice/issues>.\n");
@@ -81,10 +82,11 @@ int main(int argc, char *argv[])
   char const *output = nullptr;
   char const *password=nullptr;
   bool isInfo = false;
+  bool onlyText = false;
   bool printHelp=false;
   int ch;
 
-  while ((ch = getopt(argc, argv, "hio:p:v")) != -1) {
+  while ((ch = getopt(argc, argv, "hio:p:tv")) != -1) {
     switch (ch) {
     case 'i':
       isInfo=true;
@@ -95,6 +97,9 @@ int main(int argc, char *argv[])
     case 'p':
       password=optarg;
       break;
+    case 't':
+      onlyText=true;
+      break;
     case 'v':
       printVersion();
       return 0;
@@ -130,7 +135,11 @@ int main(int argc, char *argv[])
   bool useStringVector=false;
   auto error = STOFFDocument::STOFF_R_OK;
   try {
-    if (kind == STOFFDocument::STOFF_K_DRAW || kind == STOFFDocument::STOFF_K_GRAPHIC) {
+    if (onlyText && !isInfo && kind != STOFFDocument::STOFF_K_GRAPHIC && kind != STOFFDocument::STOFF_K_DATABASE) {
+      librevenge::RVNGTextTextGenerator documentGenerator(document, false);
+      error=STOFFDocument::parseTextContent(&input, &documentGenerator, password);
+    }
+    else if (kind == STOFFDocument::STOFF_K_DRAW || kind == STOFFDocument::STOFF_K_GRAPHIC) {
       if (isInfo) {
         printf("ERROR: can not print info concerning a graphic document!\n");
         return 1;
@@ -185,6 +194,10 @@ int main(int argc, char *argv[])
     fprintf(stderr, "ERROR: File is an OLE document!\n");
   else if (error == STOFFDocument::STOFF_R_PASSWORD_MISSMATCH_ERROR)
     fprintf(stderr, "ERROR: Bad password!\n");
+  else if (error == STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR)
+    fprintf(stderr, "ERROR: Resource limit exceeded!\n");
+  else if (error == STOFFDocument::STOFF_R_CANCELED)
+    fprintf(stderr, "ERROR: Parse canceled!\n");
   else if (error != STOFFDocument::STOFF_R_OK)
     fprintf(stderr, "ERROR: Unknown Error!\n");
 
@@ -73,6 +73,7 @@ static int printUsage()
   printf("\t-N           print the number of sheets\n");
   printf("\t-n NUM       choose the sheet to convert (1: means first sheet)\n");
   printf("\t-o OUTPUT    write ouput to OUTPUT\n");
+  printf("\t-s           print the time, the bytes and the buffers used by each zone in the error stream\n");
   printf("\t-v           show version information\n");
   printf("\n");
   printf("Examples:\n");
@@ -91,18 +92,39 @@ static int printVersion()
   return 0;
 }
 
+//! stores the time, the bytes and the records used by a zone or a reader function in a string
+static void storeParseStatistic(STOFFDocument::ParseStatistic const &statistic, void *data)
+{
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer), "%-36s %8lu %12.3f %12lu %10lu %8lu %12lu\n", statistic.m_name, statistic.m_numCalls,
+           1000*statistic.m_duration, statistic.m_numBytes, statistic.m_numRecords,
+           statistic.m_numAllocations, statistic.m_numAllocatedBytes);
+  *static_cast<std::string *>(data)+=buffer;
+}
+
+//! prints the parse statistics in the error stream
+static void printParseStatistics(std::string const &statistics)
+{
+  fprintf(stderr, "%-36s %8s %12s %12s %10s %8s %12s\n", "zone/function", "calls", "time(ms)", "bytes", "records",
+          "buffers", "buffer bytes");
+  fputs(statistics.c_str(), stderr);
+}
+
 int main(int argc, char *argv[])
 {
   bool printHelp=false;
   bool printNumberOfSheet=false;
   bool generateFormula=false;
+  bool printStatistics=false;
+  STOFFDocument::ParseOptions options;
+  std::string statistics;
   int sheetToConvert=0;
   char const *output = nullptr;
   int ch;
   char decSeparator='.', fieldSeparator=',', textSeparator='"';
   std::string dateFormat("%m/%d/%y"), timeFormat("%H:%M:%S");
 
-  while ((ch = getopt(argc, argv, "hvo:d:f:t:D:FNn:T:")) != -1) {
+  while ((ch = getopt(argc, argv, "hvo:d:f:st:D:FNn:T:")) != -1) {
     switch (ch) {
     case 'D':
       dateFormat=optarg;
@@ -131,6 +153,11 @@ int main(int argc, char *argv[])
     case 'o':
       output=optarg;
       break;
+    case 's':
+      printStatistics=true;
+      options.m_statisticsCallback=storeParseStatistic;
+      options.m_statisticsData=&statistics;
+      break;
     case 'v':
       printVersion();
       return 0;
@@ -171,7 +198,7 @@ int main(int argc, char *argv[])
     librevenge::RVNGCSVSpreadsheetGenerator listenerImpl(vec, generateFormula);
     listenerImpl.setSeparators(fieldSeparator, textSeparator, decSeparator);
     listenerImpl.setDTFormats(dateFormat.c_str(),timeFormat.c_str());
-    error= STOFFDocument::parse(&input, &listenerImpl);
+    error= STOFFDocument::parse(&input, &listenerImpl, options);
   }
   catch (STOFFDocument::Result const &err) {
     error=err;
@@ -179,12 +206,18 @@ int main(int argc, char *argv[])
   catch (...) {
     error=STOFFDocument::STOFF_R_UNKNOWN_ERROR;
   }
+  if (printStatistics)
+    printParseStatistics(statistics);
   if (error == STOFFDocument::STOFF_R_FILE_ACCESS_ERROR)
     fprintf(stderr, "ERROR: File Exception!\n");
   else if (error == STOFFDocument::STOFF_R_PARSE_ERROR)
     fprintf(stderr, "ERROR: Parse Exception!\n");
   else if (error == STOFFDocument::STOFF_R_OLE_ERROR)
     fprintf(stderr, "ERROR: File is an OLE document!\n");
+  else if (error == STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR)
+    fprintf(stderr, "ERROR: Resource limit exceeded!\n");
+  else if (error == STOFFDocument::STOFF_R_CANCELED)
+    fprintf(stderr, "ERROR: Parse canceled!\n");
   else if (error != STOFFDocument::STOFF_R_OK)
     fprintf(stderr, "ERROR: Unknown Error!\n");
 
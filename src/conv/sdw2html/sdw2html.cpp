@@ -137,6 +137,10 @@ int main(int argc, char *argv[])
     fprintf(stderr, "ERROR: File is an OLE document!\n");
   else if (error == STOFFDocument::STOFF_R_PASSWORD_MISSMATCH_ERROR)
     fprintf(stderr, "ERROR: Bad password!\n");
+  else if (error == STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR)
+    fprintf(stderr, "ERROR: Resource limit exceeded!\n");
+  else if (error == STOFFDocument::STOFF_R_CANCELED)
+    fprintf(stderr, "ERROR: Parse canceled!\n");
   else if (error != STOFFDocument::STOFF_R_OK)
     fprintf(stderr, "ERROR: Unknown Error!\n");
   if (error != STOFFDocument::STOFF_R_OK)
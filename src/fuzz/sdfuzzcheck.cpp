@@ -0,0 +1,294 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2017 David Tardon (dtardon@redhat.com)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+/* a tool which parses some inputs (some files or some directories, for
+   instance the corpus of a fuzzer) like the fuzzers and reports the
+   inputs whose parse is slow or needs too much memory, so that the slow
+   paths and the denial of service inputs can be found, not only the
+   crashes. Each input is parsed in a child process, so that its peak
+   memory can be measured and a crash or a hang does not stop the tool. */
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+#include <librevenge-generators/RVNGDummyDrawingGenerator.h>
+#include <librevenge-generators/RVNGDummyPresentationGenerator.h>
+#include <librevenge-generators/RVNGDummySpreadsheetGenerator.h>
+#include <librevenge-generators/RVNGDummyTextGenerator.h>
+#include <librevenge-stream/librevenge-stream.h>
+
+#include <libstaroffice/libstaroffice.hxx>
+
+static int printUsage()
+{
+  printf("Usage: sdfuzzcheck [OPTION] <File or Directory>...\n");
+  printf("\n");
+  printf("Parses each input in a child process and reports the inputs which crash,\n");
+  printf("which are slow or which need too much memory.\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t-h                print this help message\n");
+  printf("\t-p PATH           use the text, spreadsheet, drawing or presentation parser\n");
+  printf("\t                  (default: the parser corresponding to the document kind)\n");
+  printf("\t-t SECONDS        report the inputs whose parse is longer (default 1)\n");
+  printf("\t-m MB             report the inputs whose peak memory is greater (default 256)\n");
+  printf("\t-k SECONDS        kill the parses which are longer (default 60)\n");
+  printf("\t-v                also report the inputs which are ok\n");
+  return -1;
+}
+
+namespace SDFuzzCheck
+{
+//! the different parse paths, the ones used by the fuzzers
+enum Path { P_Default=0, P_Text, P_Spreadsheet, P_Drawing, P_Presentation };
+
+//! returns the parse path of an input: the path given by the user or the path corresponding to the document kind
+Path getPath(librevenge::RVNGInputStream &input, Path path)
+{
+  if (path!=P_Default)
+    return path;
+  STOFFDocument::Kind kind;
+  if (STOFFDocument::isFileFormatSupported(&input, kind)==STOFFDocument::STOFF_C_NONE)
+    return P_Text;
+  switch (kind) {
+  case STOFFDocument::STOFF_K_SPREADSHEET:
+  case STOFFDocument::STOFF_K_DATABASE:
+    return P_Spreadsheet;
+  case STOFFDocument::STOFF_K_PRESENTATION:
+    return P_Presentation;
+  case STOFFDocument::STOFF_K_BITMAP:
+  case STOFFDocument::STOFF_K_CHART:
+  case STOFFDocument::STOFF_K_DRAW:
+  case STOFFDocument::STOFF_K_GRAPHIC:
+    return P_Drawing;
+  case STOFFDocument::STOFF_K_MATH:
+  case STOFFDocument::STOFF_K_TEXT:
+  case STOFFDocument::STOFF_K_UNKNOWN:
+  default:
+    break;
+  }
+  return P_Text;
+}
+
+//! parses an input like the fuzzers
+void parse(std::vector<unsigned char> const &data, Path path)
+{
+  librevenge::RVNGStringStream input(data.data(), static_cast<unsigned int>(data.size()));
+  switch (getPath(input, path)) {
+  case P_Spreadsheet: {
+    librevenge::RVNGDummySpreadsheetGenerator generator;
+    STOFFDocument::parse(&input, &generator);
+    break;
+  }
+  case P_Drawing: {
+    librevenge::RVNGDummyDrawingGenerator generator;
+    STOFFDocument::parse(&input, &generator);
+    break;
+  }
+  case P_Presentation: {
+    librevenge::RVNGDummyPresentationGenerator generator;
+    STOFFDocument::parse(&input, &generator);
+    break;
+  }
+  case P_Default:
+  case P_Text:
+  default: {
+    librevenge::RVNGDummyTextGenerator generator;
+    STOFFDocument::parse(&input, &generator);
+    break;
+  }
+  }
+}
+
+//! adds a file or the files of a directory to the list of inputs
+void addInputs(std::string const &name, std::vector<std::string> &inputs)
+{
+  struct stat status;
+  if (stat(name.c_str(), &status)!=0) {
+    fprintf(stderr, "ERROR: can not find %s!\n", name.c_str());
+    return;
+  }
+  if (!S_ISDIR(status.st_mode)) {
+    inputs.push_back(name);
+    return;
+  }
+  DIR *dir=opendir(name.c_str());
+  if (!dir) {
+    fprintf(stderr, "ERROR: can not open %s!\n", name.c_str());
+    return;
+  }
+  std::vector<std::string> files;
+  while (struct dirent *entry=readdir(dir)) {
+    std::string const path=name+"/"+entry->d_name;
+    if (entry->d_name[0]!='.' && stat(path.c_str(), &status)==0 && S_ISREG(status.st_mode))
+      files.push_back(path);
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+  inputs.insert(inputs.end(), files.begin(), files.end());
+}
+
+//! the result of a parse done by a child process
+struct Result {
+  //! constructor
+  Result()
+    : m_duration(0)
+    , m_peakRSS(0)
+    , m_signal(0)
+  {
+  }
+  //! the parse duration in seconds
+  double m_duration;
+  //! the peak resident set size in kilobytes
+  long m_peakRSS;
+  //! the signal which has stopped the child (or 0)
+  int m_signal;
+};
+
+//! parses an input in a child process, returns false if the child can not be created
+bool check(std::vector<unsigned char> const &data, Path path, int killTime, Result &result)
+{
+  auto const start=std::chrono::steady_clock::now();
+  pid_t const pid=fork();
+  if (pid<0)
+    return false;
+  if (pid==0) {
+    alarm(unsigned(killTime));
+    parse(data, path);
+    _exit(0);
+  }
+  int status=0;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage)!=pid)
+    return false;
+  result.m_duration=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+#ifdef __APPLE__
+  result.m_peakRSS=long(usage.ru_maxrss/1024);
+#else
+  result.m_peakRSS=long(usage.ru_maxrss);
+#endif
+  result.m_signal=WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+  return true;
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int ch, killTime=60;
+  double maxTime=1, maxMemory=256;
+  bool printHelp=false, verbose=false;
+  auto path=SDFuzzCheck::P_Default;
+  while ((ch = getopt(argc, argv, "hk:m:p:t:v")) != -1) {
+    switch (ch) {
+    case 'k':
+      killTime=atoi(optarg);
+      break;
+    case 'm':
+      maxMemory=atof(optarg);
+      break;
+    case 'p':
+      if (strcmp(optarg, "text")==0)
+        path=SDFuzzCheck::P_Text;
+      else if (strcmp(optarg, "spreadsheet")==0)
+        path=SDFuzzCheck::P_Spreadsheet;
+      else if (strcmp(optarg, "drawing")==0)
+        path=SDFuzzCheck::P_Drawing;
+      else if (strcmp(optarg, "presentation")==0)
+        path=SDFuzzCheck::P_Presentation;
+      else
+        printHelp=true;
+      break;
+    case 't':
+      maxTime=atof(optarg);
+      break;
+    case 'v':
+      verbose=true;
+      break;
+    default:
+    case 'h':
+      printHelp = true;
+      break;
+    }
+  }
+  if (optind>=argc || printHelp || killTime<=0 || maxTime<=0 || maxMemory<=0)
+    return printUsage();
+
+  std::vector<std::string> inputs;
+  for (int i=optind; i<argc; ++i)
+    SDFuzzCheck::addInputs(argv[i], inputs);
+  int numReported=0;
+  for (auto const &name : inputs) {
+    std::ifstream file(name.c_str(), std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.eof() && !file) {
+      fprintf(stderr, "ERROR: can not read %s!\n", name.c_str());
+      continue;
+    }
+    SDFuzzCheck::Result result;
+    if (!SDFuzzCheck::check(data, path, killTime, result)) {
+      fprintf(stderr, "ERROR: can not create a process to parse %s!\n", name.c_str());
+      return 1;
+    }
+    char const *problem=nullptr;
+    if (result.m_signal==SIGALRM)
+      problem="timeout";
+    else if (result.m_signal)
+      problem="crash";
+    else if (result.m_duration>maxTime)
+      problem="slow";
+    else if (double(result.m_peakRSS)>1024*maxMemory)
+      problem="memory";
+    if (problem)
+      ++numReported;
+    else if (verbose)
+      problem="ok";
+    else
+      continue;
+    printf("%-8s %10.3fs %10ldkB %s\n", problem, result.m_duration, result.m_peakRSS, name.c_str());
+  }
+  printf("%d/%d inputs reported\n", numReported, int(inputs.size()));
+  return numReported ? 1 : 0;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -0,0 +1,513 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2017 David Tardon (dtardon@redhat.com)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+/* the code shared by the fuzzers: the initialization of the library and
+   a structure-aware mutator. The mutator reads the OLE2 container, finds
+   the record headers used by StarZone in one of its streams, mutates a
+   record (its content, its header, or duplicates or removes it), updates
+   the sizes of the records which contain it and rebuilds the container,
+   so that most mutations reach the readers instead of being rejected by
+   the OLE2 parser. */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <libstaroffice/libstaroffice.hxx>
+
+//! the libFuzzer mutator, it is not defined by all the fuzzing engines
+extern "C" size_t LLVMFuzzerMutate(uint8_t *data, size_t size, size_t maxSize) __attribute__((weak));
+
+namespace SDFuzz
+{
+//! a free sector
+static uint32_t const S_Free=0xffffffff;
+//! the end of a sector chain
+static uint32_t const S_EndOfChain=0xfffffffe;
+//! a sector used by the FAT
+static uint32_t const S_FAT=0xfffffffd;
+//! the minimal size of the streams which are not stored in the mini stream
+static size_t const S_MiniStreamCutoff=4096;
+
+//! reads a little endian 16 bits value
+static uint32_t read16(uint8_t const *ptr)
+{
+  return uint32_t(ptr[0])|(uint32_t(ptr[1])<<8);
+}
+
+//! reads a little endian 32 bits value
+static uint32_t read32(uint8_t const *ptr)
+{
+  return uint32_t(ptr[0])|(uint32_t(ptr[1])<<8)|(uint32_t(ptr[2])<<16)|(uint32_t(ptr[3])<<24);
+}
+
+//! writes a little endian 16 bits value
+static void write16(uint8_t *ptr, uint32_t value)
+{
+  ptr[0]=uint8_t(value);
+  ptr[1]=uint8_t(value>>8);
+}
+
+//! writes a little endian 32 bits value
+static void write32(uint8_t *ptr, uint32_t value)
+{
+  for (int i=0; i<4; ++i, value>>=8)
+    ptr[i]=uint8_t(value);
+}
+
+//! the OLE2 signature
+static uint8_t const s_signature[]= {0xd0, 0xcf, 0x11, 0xe0, 0xa1, 0xb1, 0x1a, 0xe1};
+
+//! returns the sectors of a chain, returns false if the chain is bad
+static bool getChain(std::vector<uint32_t> const &table, uint32_t first, std::vector<uint32_t> &chain)
+{
+  chain.clear();
+  for (uint32_t id=first; id!=S_EndOfChain;) {
+    if (id>=table.size() || chain.size()>=table.size())
+      return false;
+    chain.push_back(id);
+    id=table[id];
+  }
+  return true;
+}
+
+//! mutates some bytes, returns the new size
+static size_t mutateBytes(uint8_t *data, size_t size, size_t maxSize, std::minstd_rand &rng)
+{
+  if (LLVMFuzzerMutate)
+    return LLVMFuzzerMutate(data, size, maxSize);
+  if (!size)
+    return 0;
+  auto const numBytes=1+rng()%4;
+  for (unsigned i=0; i<numBytes; ++i)
+    data[rng()%size]=uint8_t(rng());
+  return size;
+}
+
+//! mutates the content of a buffer, its size can be increased by at most maxIncrease bytes
+static void mutateBytes(std::vector<uint8_t> &buffer, size_t maxIncrease, std::minstd_rand &rng)
+{
+  size_t const size=buffer.size();
+  buffer.resize(size+maxIncrease);
+  buffer.resize(mutateBytes(buffer.data(), size, buffer.size(), rng));
+}
+
+//! an OLE2 file: its directory entries and the content of its streams
+struct OLEFile {
+  //! constructor
+  OLEFile()
+    : m_entries()
+    , m_streams()
+  {
+  }
+  //! tries to read an OLE2 file
+  bool read(uint8_t const *data, size_t size);
+  //! writes the file with 512 bytes sectors, returns false if the file is too big
+  bool write(std::vector<uint8_t> &output) const;
+
+  //! the directory entries (128 bytes by entry)
+  std::vector<std::vector<uint8_t> > m_entries;
+  //! the content of the streams (empty for the other entries)
+  std::vector<std::vector<uint8_t> > m_streams;
+};
+
+bool OLEFile::read(uint8_t const *data, size_t size)
+{
+  if (size<512 || std::memcmp(data, s_signature, 8)!=0)
+    return false;
+  uint32_t const shift=read16(data+30);
+  if ((shift!=9 && shift!=12) || read16(data+32)!=6)
+    return false;
+  size_t const sectorSize=size_t(1)<<shift;
+  size_t const numSectors=size/sectorSize-1;
+  // the first sector begins after the header, ie. at sectorSize
+  auto sector=[data, sectorSize, numSectors](uint32_t id) -> uint8_t const * {
+    return id<numSectors ? data+sectorSize*(size_t(id)+1) : nullptr;
+  };
+  uint32_t const numFATSectors=read32(data+44);
+  if (numFATSectors>numSectors)
+    return false;
+  std::vector<uint32_t> fatSectors;
+  for (size_t i=0; i<109 && fatSectors.size()<numFATSectors; ++i)
+    fatSectors.push_back(read32(data+76+4*i));
+  uint32_t difat=read32(data+68);
+  size_t const numIdsBySector=sectorSize/4;
+  for (uint32_t i=0; i<read32(data+72) && fatSectors.size()<numFATSectors; ++i) {
+    auto ptr=sector(difat);
+    if (!ptr) return false;
+    for (size_t j=0; j+1<numIdsBySector && fatSectors.size()<numFATSectors; ++j)
+      fatSectors.push_back(read32(ptr+4*j));
+    difat=read32(ptr+4*(numIdsBySector-1));
+  }
+  if (fatSectors.size()!=numFATSectors)
+    return false;
+  std::vector<uint32_t> fat;
+  for (auto id : fatSectors) {
+    auto ptr=sector(id);
+    if (!ptr) return false;
+    for (size_t j=0; j<numIdsBySector; ++j)
+      fat.push_back(read32(ptr+4*j));
+  }
+  // reads the content of a chain of sectors
+  std::vector<uint32_t> chain;
+  auto readChain=[&](uint32_t first, std::vector<uint8_t> &content) {
+    content.clear();
+    if (!getChain(fat, first, chain))
+      return false;
+    for (auto id : chain) {
+      auto ptr=sector(id);
+      if (!ptr) return false;
+      content.insert(content.end(), ptr, ptr+sectorSize);
+    }
+    return true;
+  };
+  std::vector<uint8_t> directory, miniFATData, miniStream;
+  if (!readChain(read32(data+48), directory) || directory.size()<128 ||
+      !readChain(read32(data+60), miniFATData))
+    return false;
+  std::vector<uint32_t> miniFAT;
+  for (size_t i=0; i+4<=miniFATData.size(); i+=4)
+    miniFAT.push_back(read32(miniFATData.data()+i));
+  // the root entry stores the mini stream
+  if (directory[66]==5 && !readChain(read32(directory.data()+116), miniStream))
+    return false;
+
+  size_t const cutoff=read32(data+56);
+  size_t const numEntries=directory.size()/128;
+  m_entries.resize(numEntries);
+  m_streams.resize(numEntries);
+  for (size_t e=0; e<numEntries; ++e) {
+    uint8_t const *entry=directory.data()+128*e;
+    m_entries[e].assign(entry, entry+128);
+    if (entry[66]!=2) continue;
+    size_t const length=read32(entry+120);
+    auto &stream=m_streams[e];
+    if (length>=cutoff) {
+      if (!readChain(read32(entry+116), stream) || stream.size()<length)
+        return false;
+    }
+    else if (length) {
+      if (!getChain(miniFAT, read32(entry+116), chain))
+        return false;
+      for (auto id : chain) {
+        if (64*(size_t(id)+1)>miniStream.size())
+          return false;
+        stream.insert(stream.end(), miniStream.begin()+long(64*id), miniStream.begin()+long(64*(id+1)));
+      }
+      if (stream.size()<length)
+        return false;
+    }
+    stream.resize(length);
+  }
+  return true;
+}
+
+bool OLEFile::write(std::vector<uint8_t> &output) const
+{
+  if (m_entries.empty() || m_entries.size()!=m_streams.size())
+    return false;
+  // adds some data in a buffer of blocks, returns the first block of the chain
+  auto addChain=[](std::vector<uint8_t> &buffer, std::vector<uint32_t> &table, size_t blockSize,
+  uint8_t const *content, size_t length) -> uint32_t {
+    if (!length) return S_EndOfChain;
+    auto const first=uint32_t(table.size());
+    size_t const numBlocks=(length+blockSize-1)/blockSize;
+    for (size_t b=1; b<numBlocks; ++b)
+      table.push_back(uint32_t(table.size()+1));
+    table.push_back(S_EndOfChain);
+    buffer.insert(buffer.end(), content, content+length);
+    buffer.resize(table.size()*blockSize, 0);
+    return first;
+  };
+  std::vector<uint8_t> sectors, miniStream;
+  std::vector<uint32_t> fat, miniFAT;
+  auto entries=m_entries;
+  for (size_t e=0; e<entries.size(); ++e) {
+    if (entries[e][66]!=2) continue;
+    auto const &stream=m_streams[e];
+    if (stream.size()>=0x80000000)
+      return false;
+    uint32_t first;
+    if (stream.size()<S_MiniStreamCutoff)
+      first=addChain(miniStream, miniFAT, 64, stream.data(), stream.size());
+    else
+      first=addChain(sectors, fat, 512, stream.data(), stream.size());
+    write32(entries[e].data()+116, first);
+    write32(entries[e].data()+120, uint32_t(stream.size()));
+    write32(entries[e].data()+124, 0);
+  }
+  if (entries[0][66]==5) {
+    write32(entries[0].data()+116, addChain(sectors, fat, 512, miniStream.data(), miniStream.size()));
+    write32(entries[0].data()+120, uint32_t(miniStream.size()));
+    write32(entries[0].data()+124, 0);
+  }
+  std::vector<uint8_t> miniFATData(4*((miniFAT.size()+127)/128*128), 0xff);
+  for (size_t i=0; i<miniFAT.size(); ++i)
+    write32(miniFATData.data()+4*i, miniFAT[i]);
+  uint32_t const miniFATStart=addChain(sectors, fat, 512, miniFATData.data(), miniFATData.size());
+  std::vector<uint8_t> directory;
+  for (auto const &entry : entries)
+    directory.insert(directory.end(), entry.begin(), entry.end());
+  while (directory.size()%512) {
+    // an empty entry: no name and no sibling/child
+    std::vector<uint8_t> empty(128, 0);
+    for (size_t i=68; i<80; ++i) empty[i]=0xff;
+    directory.insert(directory.end(), empty.begin(), empty.end());
+  }
+  uint32_t const directoryStart=addChain(sectors, fat, 512, directory.data(), directory.size());
+  // the FAT sectors are stored at the end, 127 data sectors need at most one FAT sector
+  auto const numData=uint32_t(fat.size());
+  uint32_t const numFAT=(numData+126)/127;
+  if (numFAT>109)
+    return false;
+  for (uint32_t i=0; i<numFAT; ++i)
+    fat.push_back(S_FAT);
+  fat.resize(128*size_t(numFAT), S_Free);
+
+  output.assign(512, 0);
+  std::memcpy(output.data(), s_signature, 8);
+  write16(output.data()+24, 0x3e);
+  write16(output.data()+26, 3);
+  write16(output.data()+28, 0xfffe);
+  write16(output.data()+30, 9);
+  write16(output.data()+32, 6);
+  write32(output.data()+44, numFAT);
+  write32(output.data()+48, directoryStart);
+  write32(output.data()+56, uint32_t(S_MiniStreamCutoff));
+  write32(output.data()+60, miniFATStart);
+  write32(output.data()+64, uint32_t(miniFATData.size()/512));
+  write32(output.data()+68, S_EndOfChain);
+  for (uint32_t i=0; i<109; ++i)
+    write32(output.data()+76+4*i, i<numFAT ? numData+i : S_Free);
+  output.insert(output.end(), sectors.begin(), sectors.end());
+  size_t const fatPos=output.size();
+  output.resize(fatPos+4*fat.size());
+  for (size_t i=0; i<fat.size(); ++i)
+    write32(output.data()+fatPos+4*i, fat[i]);
+  return true;
+}
+
+//! the different record headers read by StarZone
+enum RecordKind {
+  R_Record /** openRecord: a 32 bits size which includes the header */,
+  R_SCRecord /** openSCRecord: a 32 bits size which does not include the header */,
+  R_SWRecord /** openSWRecord: a type byte and a 24 bits size which includes the header */,
+  R_SfxRecord /** openSfxRecord: a type byte and a 24 bits size which does not include the header */,
+  R_NumKinds
+};
+
+//! a record found in a stream
+struct Record {
+  //! the position of the header
+  size_t m_begin;
+  //! the end position
+  size_t m_end;
+  //! the header kind
+  RecordKind m_kind;
+};
+
+//! returns the end of a record whose header begins at pos, or 0 if the header is not valid
+static size_t getRecordEnd(std::vector<uint8_t> const &stream, size_t pos, RecordKind kind)
+{
+  uint32_t const value=read32(stream.data()+pos);
+  size_t end=0;
+  switch (kind) {
+  case R_Record:
+    end=pos+value;
+    break;
+  case R_SCRecord:
+    end=pos+4+value;
+    break;
+  case R_SWRecord:
+    if ((value&0xff)==0 || (value>>8)==0xffffff) return 0;
+    end=pos+(value>>8);
+    break;
+  case R_SfxRecord:
+    end=pos+4+(value>>8);
+    break;
+  case R_NumKinds:
+  default:
+    return 0;
+  }
+  // only keep the records which contain some data
+  return (end>pos+4 && end<=stream.size()) ? end : 0;
+}
+
+/** finds the probable records of a stream: as the readers may store some
+    data between the records, a header can begin at any position, so only
+    the candidates which end at the end of the stream, before another
+    candidate of the same kind or at the end of a candidate which contains
+    them are kept */
+static std::vector<Record> findRecords(std::vector<uint8_t> const &stream)
+{
+  std::vector<Record> candidates;
+  // for each position, the kinds of the candidates which begin at this position (one bit by kind)
+  std::vector<uint8_t> beginKinds(stream.size()+1, 0);
+  // for each position, the first candidate which ends at this position
+  std::vector<size_t> endToFirstBegin(stream.size()+1, stream.size());
+  for (size_t pos=0; pos+4<=stream.size(); ++pos) {
+    for (int k=0; k<R_NumKinds; ++k) {
+      Record record;
+      record.m_begin=pos;
+      record.m_kind=RecordKind(k);
+      record.m_end=getRecordEnd(stream, pos, record.m_kind);
+      if (!record.m_end) continue;
+      candidates.push_back(record);
+      beginKinds[pos]=uint8_t(beginKinds[pos]|(1<<k));
+      endToFirstBegin[record.m_end]=std::min(endToFirstBegin[record.m_end], pos);
+    }
+  }
+  std::vector<Record> records;
+  for (auto const &record : candidates) {
+    if (record.m_end==stream.size() || (beginKinds[record.m_end]&(1<<int(record.m_kind))) ||
+        endToFirstBegin[record.m_end]<record.m_begin)
+      records.push_back(record);
+  }
+  return records;
+}
+
+/** adds diff to the size of the records which contain a record (and to the
+    record size if withChild is set), returns false if a size overflows */
+static bool updateSizes(std::vector<uint8_t> &stream, std::vector<Record> const &records, Record const &child, long diff, bool withChild)
+{
+  for (auto const &record : records) {
+    bool const isChild=record.m_begin==child.m_begin && record.m_kind==child.m_kind;
+    if ((isChild && !withChild) || (!isChild && (record.m_begin>=child.m_begin || record.m_end<child.m_end)))
+      continue;
+    uint8_t *ptr=stream.data()+record.m_begin;
+    uint32_t const value=read32(ptr);
+    if (record.m_kind==R_Record || record.m_kind==R_SCRecord) {
+      long const size=long(value)+diff;
+      if (size<4 || size>=0x7fffffff) return false;
+      write32(ptr, uint32_t(size));
+    }
+    else {
+      long const size=long(value>>8)+diff;
+      if (size<4 || size>=0xffffff) return false;
+      write32(ptr, (value&0xff)|(uint32_t(size)<<8));
+    }
+  }
+  return true;
+}
+
+//! mutates a stream, its size can be increased by at most maxIncrease bytes
+static void mutateStream(std::vector<uint8_t> &stream, size_t maxIncrease, std::minstd_rand &rng)
+{
+  auto const records=findRecords(stream);
+  if (records.empty() || rng()%8==0) {
+    mutateBytes(stream, maxIncrease, rng);
+    return;
+  }
+  Record const &record=records[rng()%records.size()];
+  size_t const length=record.m_end-record.m_begin;
+  auto const original=stream;
+  bool ok=true;
+  switch (rng()%8) {
+  case 0: { // duplicates the record
+    if (length>maxIncrease) return;
+    std::vector<uint8_t> copy(stream.begin()+long(record.m_begin), stream.begin()+long(record.m_end));
+    ok=updateSizes(stream, records, record, long(length), false);
+    stream.insert(stream.begin()+long(record.m_end), copy.begin(), copy.end());
+    break;
+  }
+  case 1: // removes the record
+    ok=updateSizes(stream, records, record, -long(length), false);
+    stream.erase(stream.begin()+long(record.m_begin), stream.begin()+long(record.m_end));
+    break;
+  case 2: // changes the record type or the identifier which precedes the size
+    if (record.m_kind==R_SWRecord || record.m_kind==R_SfxRecord)
+      stream[record.m_begin]=uint8_t(1+rng()%255);
+    else if (record.m_begin>=2)
+      write16(stream.data()+record.m_begin-2, uint32_t(rng()));
+    break;
+  default: { // mutates the record content
+    std::vector<uint8_t> content(stream.begin()+long(record.m_begin+4), stream.begin()+long(record.m_end));
+    mutateBytes(content, std::min<size_t>(maxIncrease, 1024), rng);
+    ok=updateSizes(stream, records, record, long(content.size())-long(length-4), true);
+    if (!ok) break;
+    stream.erase(stream.begin()+long(record.m_begin+4), stream.begin()+long(record.m_end));
+    stream.insert(stream.begin()+long(record.m_begin+4), content.begin(), content.end());
+    break;
+  }
+  }
+  if (!ok)
+    stream=original;
+}
+
+/** mutates a document: if it is an OLE2 file, mutates one of its streams,
+    returns false if the document can not be mutated */
+static bool mutateDocument(uint8_t *data, size_t size, size_t maxSize, std::minstd_rand &rng, std::vector<uint8_t> &output)
+{
+  OLEFile file;
+  if (!file.read(data, size))
+    return false;
+  // chooses a stream, the big streams are chosen more often
+  size_t totalSize=0;
+  for (auto const &stream : file.m_streams)
+    totalSize+=stream.size();
+  if (!totalSize)
+    return false;
+  size_t pos=size_t(rng())%totalSize;
+  for (auto &stream : file.m_streams) {
+    if (pos>=stream.size()) {
+      pos-=stream.size();
+      continue;
+    }
+    mutateStream(stream, maxSize>size ? maxSize-size : 0, rng);
+    break;
+  }
+  return file.write(output) && output.size()<=maxSize;
+}
+}
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+  // all the inputs are parsed by the same process: checks that no parse reuses the data of a previous parse
+  STOFFDocument::setMathFormulaCacheSize(0);
+  STOFFDocument::setEmbeddedObjectCacheSize(0);
+  return 0;
+}
+
+extern "C" size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t size, size_t maxSize, unsigned int seed)
+{
+  std::minstd_rand rng(seed);
+  std::vector<uint8_t> output;
+  // sometimes, mutates the container
+  if (rng()%16 && SDFuzz::mutateDocument(data, size, maxSize, rng, output)) {
+    std::memcpy(data, output.data(), output.size());
+    return output.size();
+  }
+  return SDFuzz::mutateBytes(data, size, maxSize, rng);
+}
+
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -41,6 +41,8 @@
 
 #include "STOFFGraphicListener.hxx"
 #include "STOFFOLEParser.hxx"
+#include "STOFFParseTrace.hxx"
+#include "STOFFTextExtractor.hxx"
 
 #include "StarFileManager.hxx"
 #include "StarObjectDraw.hxx"
@@ -75,12 +77,17 @@ SDAParser::SDAParser(STOFFInputStreamPtr input, STOFFHeader *header)
   : STOFFGraphicParser(input, header)
   , m_password(nullptr)
   , m_oleParser()
+  , m_oleReader()
   , m_state(new SDAParserInternal::State)
 {
 }
 
 SDAParser::~SDAParser()
 {
+  // wait for the background threads, then break the cycles: ole directory -> object -> ole parser
+  m_oleReader.reset();
+  if (m_oleParser)
+    m_oleParser->resetDirectoryTasks();
 }
 
 ////////////////////////////////////////////////////////////
@@ -98,6 +105,8 @@ void SDAParser::parse(librevenge::RVNGDrawingInterface *docInterface)
       createDocument(docInterface);
       if (m_state->m_mainGraphic)
         m_state->m_mainGraphic->sendPages(getGraphicListener());
+      // wait for the background threads
+      m_oleReader.reset();
 #ifdef DEBUG
       StarFileManager::checkUnparsed(getInput(), m_oleParser, m_password);
 #endif
@@ -108,6 +117,8 @@ void SDAParser::parse(librevenge::RVNGDrawingInterface *docInterface)
     STOFF_DEBUG_MSG(("SDAParser::parse: exception catched when parsing\n"));
     ok = false;
   }
+  // the background threads use the resource governor of the parse
+  m_oleReader.reset();
 
   resetGraphicListener();
   if (!ok) throw(libstoff::ParseException());
@@ -125,6 +136,8 @@ void SDAParser::parse(librevenge::RVNGPresentationInterface *docInterface)
       createDocument(docInterface);
       if (m_state->m_mainGraphic)
         m_state->m_mainGraphic->sendPages(getGraphicListener());
+      // wait for the background threads
+      m_oleReader.reset();
 #ifdef DEBUG
       StarFileManager::checkUnparsed(getInput(), m_oleParser, m_password);
 #endif
@@ -135,15 +148,43 @@ void SDAParser::parse(librevenge::RVNGPresentationInterface *docInterface)
     STOFF_DEBUG_MSG(("SDAParser::parse: exception catched when parsing\n"));
     ok = false;
   }
+  // the background threads use the resource governor of the parse
+  m_oleReader.reset();
 
   resetGraphicListener();
   if (!ok) throw(libstoff::ParseException());
 }
 
-bool SDAParser::createZones()
+void SDAParser::parseTextContent(librevenge::RVNGTextInterface *docInterface)
 {
+  if (!getInput().get() || !checkHeader(nullptr) || !docInterface)  throw(libstoff::ParseException());
+  bool ok = true;
+  try {
+    checkHeader(nullptr);
+    ok = createZones(false);
+    if (ok) {
+      STOFFTextExtractor extractor(docInterface);
+      extractor.startDocument();
+      if (m_state->m_mainGraphic)
+        m_state->m_mainGraphic->sendTextContent(extractor);
+      extractor.endDocument();
+    }
+    ascii().reset();
+  }
+  catch (...) {
+    STOFF_DEBUG_MSG(("SDAParser::parseTextContent: exception catched when parsing\n"));
+    ok = false;
+  }
+  if (!ok) throw(libstoff::ParseException());
+}
+
+bool SDAParser::createZones(bool readEmbeddedObjects)
+{
+  libstoff::ParseStatisticsScope statistics("SDAParser::createZones", nullptr);
   m_oleParser.reset(new STOFFOLEParser);
   m_oleParser->parse(getInput());
+  if (readEmbeddedObjects)
+    m_oleReader.reset(new StarFileManager::BackgroundReader(m_oleParser));
 
   auto mainOle=m_oleParser->getDirectory("/");
   if (!mainOle) {
@@ -157,6 +198,9 @@ bool SDAParser::createZones()
     return false;
   }
   m_state->m_mainGraphic.reset(new StarObjectDraw(mainObject, false));
+  int firstPage, lastPage;
+  if (getPageRange(firstPage, lastPage))
+    m_state->m_mainGraphic->setPageRange(firstPage, lastPage);
   return m_state->m_mainGraphic->parse();
 }
 
@@ -46,6 +46,8 @@
 
 #include "STOFFParser.hxx"
 
+#include "StarFileManager.hxx"
+
 namespace SDAParserInternal
 {
 struct State;
@@ -80,6 +82,8 @@ public:
   void parse(librevenge::RVNGDrawingInterface *documentInterface) final;
   // the main presentation parse function
   void parse(librevenge::RVNGPresentationInterface *documentInterface) final;
+  //! try to retrieve only the text content of the document, ie. without any formatting
+  void parseTextContent(librevenge::RVNGTextInterface *documentInterface);
 
 protected:
   //! creates the listener which will be associated to the document
@@ -87,8 +91,10 @@ protected:
   //! creates the listener which will be associated to the document
   void createDocument(librevenge::RVNGPresentationInterface *documentInterface);
 
-  //! parses the different OLE, ...
-  bool createZones();
+  /** parses the different OLE, ...
+
+      If readEmbeddedObjects is set, starts reading the embedded objects in background threads */
+  bool createZones(bool readEmbeddedObjects=true);
 
   //
   // low level
@@ -102,6 +108,8 @@ protected:
   char const *m_password;
   //! the ole parser
   std::shared_ptr<STOFFOLEParser> m_oleParser;
+  //! the reader of the embedded objects
+  std::shared_ptr<StarFileManager::BackgroundReader> m_oleReader;
   //! the state
   std::shared_ptr<SDAParserInternal::State> m_state;
 private:
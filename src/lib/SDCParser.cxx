@@ -40,7 +40,9 @@
 #include <librevenge/librevenge.h>
 
 #include "STOFFOLEParser.hxx"
+#include "STOFFParseTrace.hxx"
 #include "STOFFSpreadsheetListener.hxx"
+#include "STOFFTextExtractor.hxx"
 
 #include "StarFileManager.hxx"
 #include "StarObjectSpreadsheet.hxx"
@@ -75,12 +77,17 @@ SDCParser::SDCParser(STOFFInputStreamPtr input, STOFFHeader *header)
   : STOFFSpreadsheetParser(input, header)
   , m_password(nullptr)
   , m_oleParser()
+  , m_oleReader()
   , m_state(new SDCParserInternal::State)
 {
 }
 
 SDCParser::~SDCParser()
 {
+  // wait for the background threads, then break the cycles: ole directory -> object -> ole parser
+  m_oleReader.reset();
+  if (m_oleParser)
+    m_oleParser->resetDirectoryTasks();
 }
 
 ////////////////////////////////////////////////////////////
@@ -97,6 +104,8 @@ void SDCParser::parse(librevenge::RVNGSpreadsheetInterface *docInterface)
     if (ok) {
       createDocument(docInterface);
       sendSpreadsheet();
+      // wait for the background threads
+      m_oleReader.reset();
 #ifdef DEBUG
       StarFileManager::checkUnparsed(getInput(), m_oleParser, m_password);
 #endif
@@ -107,16 +116,44 @@ void SDCParser::parse(librevenge::RVNGSpreadsheetInterface *docInterface)
     STOFF_DEBUG_MSG(("SDCParser::parse: exception catched when parsing\n"));
     ok = false;
   }
+  // the background threads use the resource governor of the parse
+  m_oleReader.reset();
 
   resetSpreadsheetListener();
   if (!ok) throw(libstoff::ParseException());
 }
 
+void SDCParser::parseTextContent(librevenge::RVNGTextInterface *docInterface)
+{
+  if (!getInput().get() || !checkHeader(nullptr) || !docInterface)  throw(libstoff::ParseException());
+  bool ok = true;
+  try {
+    checkHeader(nullptr);
+    ok = createZones(false);
+    if (ok) {
+      STOFFTextExtractor extractor(docInterface);
+      extractor.startDocument();
+      if (m_state->m_mainSpreadsheet)
+        m_state->m_mainSpreadsheet->sendTextContent(extractor);
+      extractor.endDocument();
+    }
+    ascii().reset();
+  }
+  catch (...) {
+    STOFF_DEBUG_MSG(("SDCParser::parseTextContent: exception catched when parsing\n"));
+    ok = false;
+  }
+  if (!ok) throw(libstoff::ParseException());
+}
+
 
-bool SDCParser::createZones()
+bool SDCParser::createZones(bool readEmbeddedObjects)
 {
+  libstoff::ParseStatisticsScope statistics("SDCParser::createZones", nullptr);
   m_oleParser.reset(new STOFFOLEParser);
   m_oleParser->parse(getInput());
+  if (readEmbeddedObjects)
+    m_oleReader.reset(new StarFileManager::BackgroundReader(m_oleParser));
 
   auto mainOle=m_oleParser->getDirectory("/");
   if (!mainOle) {
@@ -157,6 +194,7 @@ void SDCParser::createDocument(librevenge::RVNGSpreadsheetInterface *documentInt
 
 bool SDCParser::sendSpreadsheet()
 {
+  libstoff::ParseStatisticsScope statistics("SDCParser::sendSpreadsheet", nullptr);
   STOFFSpreadsheetListenerPtr listener=getSpreadsheetListener();
   if (!listener || !m_state->m_mainSpreadsheet) {
     STOFF_DEBUG_MSG(("SDCParser::sendSpreadsheet: can not find the main spreadsheet\n"));
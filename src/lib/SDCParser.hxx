@@ -46,6 +46,8 @@
 
 #include "STOFFParser.hxx"
 
+#include "StarFileManager.hxx"
+
 namespace SDCParserInternal
 {
 struct State;
@@ -78,13 +80,17 @@ public:
 
   // the main parse function
   void parse(librevenge::RVNGSpreadsheetInterface *documentInterface) override;
+  //! try to retrieve only the text content of the document, ie. without any formatting
+  void parseTextContent(librevenge::RVNGTextInterface *documentInterface);
 
 protected:
   //! creates the listener which will be associated to the document
   void createDocument(librevenge::RVNGSpreadsheetInterface *documentInterface);
 
-  //! parses the different OLE, ...
-  bool createZones();
+  /** parses the different OLE, ...
+
+      If readEmbeddedObjects is set, starts reading the embedded objects in background threads */
+  bool createZones(bool readEmbeddedObjects=true);
 
   //! try to send the spreadsheet
   bool sendSpreadsheet();
@@ -101,6 +107,8 @@ protected:
   char const *m_password;
   //! the ole parser
   std::shared_ptr<STOFFOLEParser> m_oleParser;
+  //! the reader of the embedded objects
+  std::shared_ptr<StarFileManager::BackgroundReader> m_oleReader;
   //! the state
   std::shared_ptr<SDCParserInternal::State> m_state;
 private:
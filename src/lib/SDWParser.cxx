@@ -40,6 +40,8 @@
 #include <librevenge/librevenge.h>
 
 #include "STOFFOLEParser.hxx"
+#include "STOFFParseTrace.hxx"
+#include "STOFFTextExtractor.hxx"
 #include "STOFFTextListener.hxx"
 
 #include "StarFileManager.hxx"
@@ -76,12 +78,17 @@ SDWParser::SDWParser(STOFFInputStreamPtr input, STOFFHeader *header)
   : STOFFTextParser(input, header)
   , m_password(nullptr)
   , m_oleParser()
+  , m_oleReader()
   , m_state(new SDWParserInternal::State)
 {
 }
 
 SDWParser::~SDWParser()
 {
+  // wait for the background threads, then break the cycles: ole directory -> object -> ole parser
+  m_oleReader.reset();
+  if (m_oleParser)
+    m_oleParser->resetDirectoryTasks();
 }
 
 ////////////////////////////////////////////////////////////
@@ -99,6 +106,8 @@ void SDWParser::parse(librevenge::RVNGTextInterface *docInterface)
       createDocument(docInterface);
       if (m_state->m_mainText)
         m_state->m_mainText->sendPages(getTextListener());
+      // wait for the background threads
+      m_oleReader.reset();
 #ifdef DEBUG
       StarFileManager::checkUnparsed(getInput(), m_oleParser, m_password);
 #endif
@@ -109,16 +118,44 @@ void SDWParser::parse(librevenge::RVNGTextInterface *docInterface)
     STOFF_DEBUG_MSG(("SDWParser::parse: exception catched when parsing\n"));
     ok = false;
   }
+  // the background threads use the resource governor of the parse
+  m_oleReader.reset();
 
   resetTextListener();
   if (!ok) throw(libstoff::ParseException());
 }
 
+void SDWParser::parseTextContent(librevenge::RVNGTextInterface *docInterface)
+{
+  if (!getInput().get() || !checkHeader(nullptr) || !docInterface)  throw(libstoff::ParseException());
+  bool ok = true;
+  try {
+    checkHeader(nullptr);
+    ok = createZones(false);
+    if (ok) {
+      STOFFTextExtractor extractor(docInterface);
+      extractor.startDocument();
+      if (m_state->m_mainText)
+        m_state->m_mainText->sendTextContent(extractor);
+      extractor.endDocument();
+    }
+    ascii().reset();
+  }
+  catch (...) {
+    STOFF_DEBUG_MSG(("SDWParser::parseTextContent: exception catched when parsing\n"));
+    ok = false;
+  }
+  if (!ok) throw(libstoff::ParseException());
+}
+
 
-bool SDWParser::createZones()
+bool SDWParser::createZones(bool readEmbeddedObjects)
 {
+  libstoff::ParseStatisticsScope statistics("SDWParser::createZones", nullptr);
   m_oleParser.reset(new STOFFOLEParser);
   m_oleParser->parse(getInput());
+  if (readEmbeddedObjects)
+    m_oleReader.reset(new StarFileManager::BackgroundReader(m_oleParser));
   auto mainOle=m_oleParser->getDirectory("/");
   if (!mainOle) {
     STOFF_DEBUG_MSG(("SDWParser::parse: can not find the main ole\n"));
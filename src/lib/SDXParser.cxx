@@ -87,6 +87,9 @@ SDXParser::SDXParser(STOFFInputStreamPtr input, STOFFHeader *header)
 
 SDXParser::~SDXParser()
 {
+  // break the cycles: ole directory -> object -> ole parser
+  if (m_oleParser)
+    m_oleParser->resetDirectoryTasks();
 }
 
 void SDXParser::init()
@@ -36,13 +36,31 @@
 #include <librevenge-stream/librevenge-stream.h>
 
 #include "libstaroffice_internal.hxx"
+#include "STOFFParseTrace.hxx"
 #include "STOFFDebug.hxx"
 
 #if defined(DEBUG_WITH_FILES)
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 namespace libstoff
 {
+namespace Debug
+{
+//! the flag used to know if the traces are enabled
+static std::atomic<bool> s_traceEnabled(true);
+
+bool isTraceEnabled()
+{
+  return s_traceEnabled.load();
+}
+
+void setTraceEnabled(bool enable)
+{
+  s_traceEnabled=enable;
+}
+}
+
 bool DebugFile::open(std::string const &filename)
 {
   m_on=true;
@@ -59,6 +77,11 @@ void DebugFile::addPos(long pos)
 void DebugFile::addNote(char const *note)
 {
   if (!m_on || note == 0L) return;
+  if (libstoff::isParseTraceEnabled()) {
+    libstoff::sendParseTraceNote(m_fileName, m_actOffset, note);
+    m_notesSent=true;
+    return;
+  }
 
   size_t numNotes = m_notes.size();
 
@@ -72,7 +95,7 @@ void DebugFile::addNote(char const *note)
 
 void DebugFile::addDelimiter(long pos, char c)
 {
-  if (!m_on) return;
+  if (!m_on || m_notesSent) return;
   std::string s;
   s+=c;
   m_notes.push_back(NotePos(pos,s,false));
@@ -110,7 +133,7 @@ void DebugFile::sort()
 
 void DebugFile::write()
 {
-  if (!m_on || m_input.get() == 0) return;
+  if (!m_on || m_input.get() == 0 || m_notesSent) return;
 
   auto name=Debug::flattenFileName(m_fileName);
   if (name.empty()) return;
@@ -55,6 +55,10 @@ namespace Debug
 bool dumpFile(librevenge::RVNGBinaryData &data, char const *fileName);
 //! returns a file name from an ole/... name
 std::string flattenFileName(std::string const &name);
+//! returns true if the debug traces must be computed (by default true)
+bool isTraceEnabled();
+//! enables or disables the computation of the debug traces
+void setTraceEnabled(bool enable);
 }
 
 //! a basic stream (if debug_with_files is not defined, does nothing)
@@ -73,6 +77,7 @@ public:
     , m_input(ip)
     , m_actOffset(-1)
     , m_notes()
+    , m_notesSent(false)
     , m_skipZones() { }
 
   //! resets the input
@@ -95,6 +100,7 @@ public:
     m_file.close();
     m_on = false;
     m_notes.resize(0);
+    m_notesSent=false;
     m_skipZones.resize(0);
     m_actOffset = -1;
   }
@@ -102,7 +108,10 @@ public:
   void write();
   //! adds a new position in the file
   void addPos(long pos);
-  //! adds a note in the file, in actual position
+  /** adds a note in the file, in actual position
+
+      \note when the current parse is traced, the note is sent to the trace function
+      instead of being stored, see STOFFDocument::ParseTraceRecord */
   void addNote(char const *note);
   //! adds a not breaking delimiter in position \a pos
   void addDelimiter(long pos, char c);
@@ -171,6 +180,8 @@ protected:
   long m_actOffset;
   //! list of notes
   std::vector<NotePos> m_notes;
+  //! a flag to know if the notes have been sent to the parse trace, then the file is not written
+  bool m_notesSent;
   //! list of skipZone
   std::vector<STOFFVec2<long> > m_skipZones;
 };
@@ -189,6 +200,11 @@ inline std::string flattenFileName(std::string const &name)
 {
   return name;
 }
+inline bool isTraceEnabled()
+{
+  return false;
+}
+inline void setTraceEnabled(bool) {}
 }
 
 class DebugStream
@@ -232,6 +248,18 @@ public:
 }
 #  endif
 
+/** \def STOFF_DEBUG_TRACE(...)
+    executes the debug statements only if the debug files are compiled and
+    if the traces are enabled, for instance
+    \code STOFF_DEBUG_TRACE(f << "name=" << libstoff::getString(text).cstr() << ","); \endcode
+
+    \note in a release build, the arguments are never evaluated */
+#  if defined(DEBUG_WITH_FILES)
+#    define STOFF_DEBUG_TRACE(...) do { if (libstoff::Debug::isTraceEnabled()) { __VA_ARGS__; } } while (false)
+#  else
+#    define STOFF_DEBUG_TRACE(...) do { } while (false)
+#  endif
+
 #endif
 
 // vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -44,8 +44,12 @@
 #include "STOFFHeader.hxx"
 #include "STOFFGraphicDecoder.hxx"
 #include "STOFFParser.hxx"
+#include "STOFFParseTrace.hxx"
 #include "STOFFPropertyHandler.hxx"
+#include "STOFFResourceGovernor.hxx"
 #include "STOFFSpreadsheetDecoder.hxx"
+#include "STOFFStarMathToMMLConverter.hxx"
+#include "StarFileManager.hxx"
 
 #include <libstaroffice/libstaroffice.hxx>
 
@@ -58,6 +62,29 @@ std::shared_ptr<STOFFTextParser> getTextParserFromHeader(STOFFInputStreamPtr &in
 std::shared_ptr<STOFFSpreadsheetParser> getSpreadsheetParserFromHeader(STOFFInputStreamPtr &input, STOFFHeader *header, char const *passwd);
 STOFFHeader *getHeader(STOFFInputStreamPtr &input, bool strict);
 bool checkHeader(STOFFInputStreamPtr &input, STOFFHeader &header, bool strict);
+
+/** calls a parse function with a new resource governor which keeps the parse options,
+    returns STOFF_R_CANCELED if the parse has been canceled and STOFF_R_RESOURCE_LIMIT_ERROR
+    if a limit has been exceeded (even if the exception has been caught by a reader) */
+template <class Function>
+STOFFDocument::Result parseWithOptions(STOFFDocument::ParseOptions const &options, Function const &function)
+{
+  libstoff::ResourceGovernor governor(options);
+  libstoff::ResourceGovernorScope scope(&governor);
+  try {
+    function();
+  }
+  catch (...) {
+    governor.sendParseStatistics();
+    if (!governor.isCanceled() && !governor.isExceeded())
+      throw;
+    return governor.isCanceled() ? STOFFDocument::STOFF_R_CANCELED : STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR;
+  }
+  governor.sendParseStatistics();
+  if (governor.isCanceled())
+    return STOFFDocument::STOFF_R_CANCELED;
+  return governor.isExceeded() ? STOFFDocument::STOFF_R_RESOURCE_LIMIT_ERROR : STOFFDocument::STOFF_R_OK;
+}
 }
 
 STOFFDocument::Confidence STOFFDocument::isFileFormatSupported(librevenge::RVNGInputStream *input, Kind &kind)
@@ -91,6 +118,11 @@ catch (...)
 }
 
 STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *documentInterface, char const *password)
+{
+  return parse(input, documentInterface, ParseOptions(), password);
+}
+
+STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *documentInterface, ParseOptions const &options, char const *password)
 try
 {
   if (!input)
@@ -102,8 +134,10 @@ try
   if (!header.get()) return STOFF_R_UNKNOWN_ERROR;
   auto parser=STOFFDocumentInternal::getGraphicParserFromHeader(ip, header.get(), password);
   if (!parser) return STOFF_R_UNKNOWN_ERROR;
-  parser->parse(documentInterface);
-  return STOFF_R_OK;
+  parser->setPageRange(options.m_firstPage, options.m_lastPage);
+  return STOFFDocumentInternal::parseWithOptions(options, [&]() {
+    parser->parse(documentInterface);
+  });
 }
 catch (libstoff::FileException)
 {
@@ -128,6 +162,11 @@ catch (...)
 }
 
 STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGPresentationInterface *documentInterface, char const *password)
+{
+  return parse(input, documentInterface, ParseOptions(), password);
+}
+
+STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGPresentationInterface *documentInterface, ParseOptions const &options, char const *password)
 try
 {
   if (!input)
@@ -139,8 +178,10 @@ try
   if (!header.get()) return STOFF_R_UNKNOWN_ERROR;
   auto parser=STOFFDocumentInternal::getPresentationParserFromHeader(ip, header.get(), password);
   if (!parser) return STOFF_R_UNKNOWN_ERROR;
-  parser->parse(documentInterface);
-  return STOFF_R_OK;
+  parser->setPageRange(options.m_firstPage, options.m_lastPage);
+  return STOFFDocumentInternal::parseWithOptions(options, [&]() {
+    parser->parse(documentInterface);
+  });
 }
 catch (libstoff::FileException)
 {
@@ -165,6 +206,11 @@ catch (...)
 }
 
 STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGSpreadsheetInterface *documentInterface, char const *password)
+{
+  return parse(input, documentInterface, ParseOptions(), password);
+}
+
+STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGSpreadsheetInterface *documentInterface, ParseOptions const &options, char const *password)
 try
 {
   if (!input)
@@ -176,8 +222,9 @@ try
   if (!header.get()) return STOFF_R_UNKNOWN_ERROR;
   auto parser=STOFFDocumentInternal::getSpreadsheetParserFromHeader(ip, header.get(), password);
   if (!parser) return STOFF_R_UNKNOWN_ERROR;
-  parser->parse(documentInterface);
-  return STOFF_R_OK;
+  return STOFFDocumentInternal::parseWithOptions(options, [&]() {
+    parser->parse(documentInterface);
+  });
 }
 catch (libstoff::FileException)
 {
@@ -202,6 +249,11 @@ catch (...)
 }
 
 STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, char const *password)
+{
+  return parse(input, documentInterface, ParseOptions(), password);
+}
+
+STOFFDocument::Result STOFFDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, ParseOptions const &options, char const *password)
 try
 {
   if (!input)
@@ -213,9 +265,9 @@ try
   if (!header.get()) return STOFF_R_UNKNOWN_ERROR;
   auto parser=STOFFDocumentInternal::getTextParserFromHeader(ip, header.get(), password);
   if (!parser) return STOFF_R_UNKNOWN_ERROR;
-  parser->parse(documentInterface);
-
-  return STOFF_R_OK;
+  return STOFFDocumentInternal::parseWithOptions(options, [&]() {
+    parser->parse(documentInterface);
+  });
 }
 catch (libstoff::FileException)
 {
@@ -239,6 +291,112 @@ catch (...)
   return STOFF_R_UNKNOWN_ERROR;
 }
 
+void STOFFDocument::setMathFormulaCacheSize(int numFormulas)
+{
+  STOFFStarMathToMMLConverter::setCacheSize(numFormulas>0 ? size_t(numFormulas) : 0);
+}
+
+void STOFFDocument::getMathFormulaCacheStatistics(unsigned long &numHits, unsigned long &numMisses)
+{
+  STOFFStarMathToMMLConverter::getCacheStatistics(numHits, numMisses);
+}
+
+void STOFFDocument::setEmbeddedObjectCacheSize(int numObjects)
+{
+  StarFileManager::setObjectCacheSize(numObjects>0 ? size_t(numObjects) : 0);
+}
+
+void STOFFDocument::setEmbeddedObjectCacheDirectory(char const *directory)
+{
+  StarFileManager::setObjectCacheDirectory(directory ? directory : "");
+}
+
+void STOFFDocument::getEmbeddedObjectCacheStatistics(unsigned long &numHits, unsigned long &numMisses)
+{
+  StarFileManager::getObjectCacheStatistics(numHits, numMisses);
+}
+
+STOFFDocument::Result STOFFDocument::parseTextContent(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, char const *password)
+{
+  return parseTextContent(input, documentInterface, ParseOptions(), password);
+}
+
+STOFFDocument::Result STOFFDocument::parseTextContent(librevenge::RVNGInputStream *input, librevenge::RVNGTextInterface *documentInterface, ParseOptions const &options, char const *password)
+try
+{
+  if (!input || !documentInterface)
+    return STOFF_R_UNKNOWN_ERROR;
+
+  STOFFInputStreamPtr ip(new STOFFInputStream(input, false));
+  std::shared_ptr<STOFFHeader> header(STOFFDocumentInternal::getHeader(ip, false));
+
+  if (!header.get()) return STOFF_R_UNKNOWN_ERROR;
+  switch (header->getKind()) {
+  case STOFF_K_TEXT: {
+    SDWParser parser(ip, header.get());
+    if (password) parser.setDocumentPassword(password);
+    auto const result=STOFFDocumentInternal::parseWithOptions(options, [&]() {
+      parser.parseTextContent(documentInterface);
+    });
+    if (result!=STOFF_R_OK) return result;
+    break;
+  }
+  case STOFF_K_SPREADSHEET: {
+    SDCParser parser(ip, header.get());
+    if (password) parser.setDocumentPassword(password);
+    auto const result=STOFFDocumentInternal::parseWithOptions(options, [&]() {
+      parser.parseTextContent(documentInterface);
+    });
+    if (result!=STOFF_R_OK) return result;
+    break;
+  }
+  case STOFF_K_DRAW:
+  case STOFF_K_PRESENTATION: {
+    SDAParser parser(ip, header.get());
+    if (password) parser.setDocumentPassword(password);
+    auto const result=STOFFDocumentInternal::parseWithOptions(options, [&]() {
+      parser.parseTextContent(documentInterface);
+    });
+    if (result!=STOFF_R_OK) return result;
+    break;
+  }
+  case STOFF_K_BITMAP:
+  case STOFF_K_CHART:
+  case STOFF_K_DATABASE:
+  case STOFF_K_GRAPHIC:
+  case STOFF_K_MATH:
+  case STOFF_K_UNKNOWN:
+#if !defined(__clang__)
+  default:
+#endif
+    STOFF_DEBUG_MSG(("STOFFDocument::parseTextContent: unexpected document kind\n"));
+    return STOFF_R_UNKNOWN_ERROR;
+  }
+
+  return STOFF_R_OK;
+}
+catch (libstoff::FileException)
+{
+  STOFF_DEBUG_MSG(("STOFFDocument::parseTextContent: File exception trapped\n"));
+  return STOFF_R_FILE_ACCESS_ERROR;
+}
+catch (libstoff::ParseException)
+{
+  STOFF_DEBUG_MSG(("STOFFDocument::parseTextContent: Parse exception trapped\n"));
+  return STOFF_R_PARSE_ERROR;
+}
+catch (libstoff::WrongPasswordException)
+{
+  STOFF_DEBUG_MSG(("STOFFDocument::parseTextContent: Parse password trapped\n"));
+  return STOFF_R_PASSWORD_MISSMATCH_ERROR;
+}
+catch (...)
+{
+  //fixme: too generic
+  STOFF_DEBUG_MSG(("STOFFDocument::parseTextContent: Unknown exception trapped\n"));
+  return STOFF_R_UNKNOWN_ERROR;
+}
+
 bool STOFFDocument::decodeGraphic(librevenge::RVNGBinaryData const &binary, librevenge::RVNGDrawingInterface *paintInterface)
 try
 {
@@ -44,12 +44,56 @@
 
 #include "STOFFGraphicDecoder.hxx"
 
-void STOFFGraphicDecoder::insertElement(const char *psName)
+//! Internal: namespace used to send the elements to a drawing or a presentation interface
+namespace STOFFGraphicDecoderInternal
+{
+//! starts a page
+static void startPage(librevenge::RVNGDrawingInterface &output, librevenge::RVNGPropertyList const &propList)
+{
+  output.startPage(propList);
+}
+//! starts a page
+static void startPage(librevenge::RVNGPresentationInterface &output, librevenge::RVNGPropertyList const &propList)
+{
+  output.startSlide(propList);
+}
+//! ends a page
+static void endPage(librevenge::RVNGDrawingInterface &output)
+{
+  output.endPage();
+}
+//! ends a page
+static void endPage(librevenge::RVNGPresentationInterface &output)
+{
+  output.endSlide();
+}
+//! starts a master page
+static void startMasterPage(librevenge::RVNGDrawingInterface &output, librevenge::RVNGPropertyList const &propList)
+{
+  output.startMasterPage(propList);
+}
+//! starts a master page
+static void startMasterPage(librevenge::RVNGPresentationInterface &output, librevenge::RVNGPropertyList const &propList)
+{
+  output.startMasterSlide(propList);
+}
+//! ends a master page
+static void endMasterPage(librevenge::RVNGDrawingInterface &output)
+{
+  output.endMasterPage();
+}
+//! ends a master page
+static void endMasterPage(librevenge::RVNGPresentationInterface &output)
+{
+  output.endMasterSlide();
+}
+
+//! sends a simple element to the output
+template <class Output> void insertElement(Output &output, const char *psName)
 {
-  if (!m_output) return;
   int len=psName ? int(strlen(psName)) : 0;
   if (!len) {
-    STOFF_DEBUG_MSG(("STOFFGraphicDecoder::insertElement: called without name\n"));
+    STOFF_DEBUG_MSG(("STOFFGraphicDecoderInternal::insertElement: called without name\n"));
     return;
   }
 
@@ -59,23 +103,23 @@ void STOFFGraphicDecoder::insertElement(const char *psName)
     if (len>=6 && strncmp(psName,"Close",5)==0) {
       psName+=5;
       if (strcmp(psName,"Group")==0)
-        m_output->closeGroup();
+        output.closeGroup();
       else if (strcmp(psName,"Link")==0)
-        m_output->closeLink();
+        output.closeLink();
       else if (strcmp(psName,"ListElement")==0)
-        m_output->closeListElement();
+        output.closeListElement();
       else if (strcmp(psName,"OrderedListLevel")==0)
-        m_output->closeOrderedListLevel();
+        output.closeOrderedListLevel();
       else if (strcmp(psName,"Paragraph")==0)
-        m_output->closeParagraph();
+        output.closeParagraph();
       else if (strcmp(psName,"Span")==0)
-        m_output->closeSpan();
+        output.closeSpan();
       else if (strcmp(psName,"TableCell")==0)
-        m_output->closeTableCell();
+        output.closeTableCell();
       else if (strcmp(psName,"TableRow")==0)
-        m_output->closeTableRow();
+        output.closeTableRow();
       else if (strcmp(psName,"UnorderedListLevel")==0)
-        m_output->closeUnorderedListLevel();
+        output.closeUnorderedListLevel();
       else
         ok=false;
     }
@@ -86,19 +130,19 @@ void STOFFGraphicDecoder::insertElement(const char *psName)
     if (len>=4 && strncmp(psName,"End",3)==0) {
       psName+=3;
       if (strcmp(psName,"Document")==0)
-        m_output->endDocument();
+        output.endDocument();
       else if (strcmp(psName,"EmbeddedGraphics")==0)
-        m_output->endEmbeddedGraphics();
+        output.endEmbeddedGraphics();
       else if (strcmp(psName,"Layer")==0)
-        m_output->endLayer();
+        output.endLayer();
       else if (strcmp(psName,"MasterPage")==0)
-        m_output->endMasterPage();
+        endMasterPage(output);
       else if (strcmp(psName,"Page")==0)
-        m_output->endPage();
+        endPage(output);
       else if (strcmp(psName,"TableObject")==0)
-        m_output->endTableObject();
+        output.endTableObject();
       else if (strcmp(psName,"TextObject")==0)
-        m_output->endTextObject();
+        output.endTextObject();
       else
         ok=false;
     }
@@ -109,11 +153,11 @@ void STOFFGraphicDecoder::insertElement(const char *psName)
     if (len>=7 && strncmp(psName,"Insert",6)==0) {
       psName+=6;
       if (strcmp(psName,"LineBreak")==0)
-        m_output->insertLineBreak();
+        output.insertLineBreak();
       else if (strcmp(psName,"Space")==0)
-        m_output->insertSpace();
+        output.insertSpace();
       else if (strcmp(psName,"Tab")==0)
-        m_output->insertTab();
+        output.insertTab();
       else
         ok=false;
     }
@@ -125,16 +169,16 @@ void STOFFGraphicDecoder::insertElement(const char *psName)
     break;
   }
   if (!ok) {
-    STOFF_DEBUG_MSG(("STOFFGraphicDecoder::insertElement: called with unexpected name %s\n", psName));
+    STOFF_DEBUG_MSG(("STOFFGraphicDecoderInternal::insertElement: called with unexpected name %s\n", psName));
   }
 }
 
-void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RVNGPropertyList &propList)
+//! sends an element with a property list to the output
+template <class Output> void insertElement(Output &output, const char *psName, const librevenge::RVNGPropertyList &propList)
 {
-  if (!m_output) return;
   int len=psName ? int(strlen(psName)) : 0;
   if (!len) {
-    STOFF_DEBUG_MSG(("STOFFGraphicDecoder::insertElement: called without any name\n"));
+    STOFF_DEBUG_MSG(("STOFFGraphicDecoderInternal::insertElement: called without any name\n"));
     return;
   }
 
@@ -144,30 +188,30 @@ void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RV
     if (len>=7 && strncmp(psName,"Define",6)==0) {
       psName+=6;
       if (strcmp(psName,"CharacterStyle")==0)
-        m_output->defineCharacterStyle(propList);
+        output.defineCharacterStyle(propList);
       else if (strcmp(psName,"EmbeddedFont")==0)
-        m_output->defineEmbeddedFont(propList);
+        output.defineEmbeddedFont(propList);
       else if (strcmp(psName,"ParagraphStyle")==0)
-        m_output->defineParagraphStyle(propList);
+        output.defineParagraphStyle(propList);
       else
         ok=false;
     }
     else if (len>=5 && strncmp(psName,"Draw",4)==0) {
       psName+=4;
       if (strcmp(psName,"Connector")==0)
-        m_output->drawConnector(propList);
+        output.drawConnector(propList);
       else if (strcmp(psName,"Ellipse")==0)
-        m_output->drawEllipse(propList);
+        output.drawEllipse(propList);
       else if (strcmp(psName,"GraphicObject")==0)
-        m_output->drawGraphicObject(propList);
+        output.drawGraphicObject(propList);
       else if (strcmp(psName,"Path")==0)
-        m_output->drawPath(propList);
+        output.drawPath(propList);
       else if (strcmp(psName,"Polygon")==0)
-        m_output->drawPolygon(propList);
+        output.drawPolygon(propList);
       else if (strcmp(psName,"Polyline")==0)
-        m_output->drawPolyline(propList);
+        output.drawPolyline(propList);
       else if (strcmp(psName,"Rectangle")==0)
-        m_output->drawRectangle(propList);
+        output.drawRectangle(propList);
       else
         ok=false;
     }
@@ -178,9 +222,9 @@ void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RV
     if (len>=7 && strncmp(psName,"Insert",6)==0) {
       psName+=6;
       if (strcmp(psName,"CoveredTableCell")==0)
-        m_output->insertCoveredTableCell(propList);
+        output.insertCoveredTableCell(propList);
       else if (strcmp(psName,"Field")==0)
-        m_output->insertField(propList);
+        output.insertField(propList);
       else
         ok=false;
     }
@@ -191,23 +235,23 @@ void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RV
     if (len>=5 && strncmp(psName,"Open",4)==0) {
       psName+=4;
       if (strcmp(psName,"Group")==0)
-        m_output->openGroup(propList);
+        output.openGroup(propList);
       else if (strcmp(psName,"Link")==0)
-        m_output->openLink(propList);
+        output.openLink(propList);
       else if (strcmp(psName,"ListElement")==0)
-        m_output->openListElement(propList);
+        output.openListElement(propList);
       else if (strcmp(psName,"OrderedListLevel")==0)
-        m_output->openOrderedListLevel(propList);
+        output.openOrderedListLevel(propList);
       else if (strcmp(psName,"Paragraph")==0)
-        m_output->openParagraph(propList);
+        output.openParagraph(propList);
       else if (strcmp(psName,"Span")==0)
-        m_output->openSpan(propList);
+        output.openSpan(propList);
       else if (strcmp(psName,"TableCell")==0)
-        m_output->openTableCell(propList);
+        output.openTableCell(propList);
       else if (strcmp(psName,"TableRow")==0)
-        m_output->openTableRow(propList);
+        output.openTableRow(propList);
       else if (strcmp(psName,"UnorderedListLevel")==0)
-        m_output->openUnorderedListLevel(propList);
+        output.openUnorderedListLevel(propList);
       else
         ok=false;
     }
@@ -218,28 +262,28 @@ void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RV
     if (len>=4 && strncmp(psName,"Set",3)==0) {
       psName+=3;
       if (strcmp(psName,"DocumentMetaData")==0)
-        m_output->setDocumentMetaData(propList);
+        output.setDocumentMetaData(propList);
       else if (strcmp(psName,"Style")==0)
-        m_output->setStyle(propList);
+        output.setStyle(propList);
       else
         ok=false;
     }
     else if (len>=6 && strncmp(psName,"Start",5)==0) {
       psName+=5;
       if (strcmp(psName,"Document")==0)
-        m_output->startDocument(propList);
+        output.startDocument(propList);
       else if (strcmp(psName,"EmbeddedGraphics")==0)
-        m_output->startEmbeddedGraphics(propList);
+        output.startEmbeddedGraphics(propList);
       else if (strcmp(psName,"Layer")==0)
-        m_output->startLayer(propList);
+        output.startLayer(propList);
       else if (strcmp(psName,"MasterPage")==0)
-        m_output->startMasterPage(propList);
+        startMasterPage(output, propList);
       else if (strcmp(psName,"Page")==0)
-        m_output->startPage(propList);
+        startPage(output, propList);
       else if (strcmp(psName,"TableObject")==0)
-        m_output->startTableObject(propList);
+        output.startTableObject(propList);
       else if (strcmp(psName,"TextObject")==0)
-        m_output->startTextObject(propList);
+        output.startTextObject(propList);
       else
         ok=false;
     }
@@ -251,8 +295,33 @@ void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RV
     break;
   }
   if (!ok) {
-    STOFF_DEBUG_MSG(("STOFFGraphicDecoder::insertElement: called with unexpected name %s\n", psName));
+    STOFF_DEBUG_MSG(("STOFFGraphicDecoderInternal::insertElement: called with unexpected name %s\n", psName));
   }
 }
+}
+
+void STOFFGraphicDecoder::insertElement(const char *psName)
+{
+  if (m_output)
+    STOFFGraphicDecoderInternal::insertElement(*m_output, psName);
+  else if (m_presentationOutput)
+    STOFFGraphicDecoderInternal::insertElement(*m_presentationOutput, psName);
+}
+
+void STOFFGraphicDecoder::insertElement(const char *psName, const librevenge::RVNGPropertyList &propList)
+{
+  if (m_output)
+    STOFFGraphicDecoderInternal::insertElement(*m_output, psName, propList);
+  else if (m_presentationOutput)
+    STOFFGraphicDecoderInternal::insertElement(*m_presentationOutput, psName, propList);
+}
+
+void STOFFGraphicDecoder::characters(const librevenge::RVNGString &sCharacters)
+{
+  if (m_output)
+    m_output->insertText(sCharacters);
+  else if (m_presentationOutput)
+    m_presentationOutput->insertText(sCharacters);
+}
 
 // vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
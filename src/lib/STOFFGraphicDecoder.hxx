@@ -43,7 +43,8 @@
 
 /** main class used to decode a librevenge::RVNGBinaryData created by
     \see STOFFGraphicEncoder (with mimeType="image/stoff-odg") and to send
-    it contents to librevenge::RVNGDrawingInterface
+    it contents to librevenge::RVNGDrawingInterface or to
+    librevenge::RVNGPresentationInterface
 */
 class STOFFGraphicDecoder : public STOFFPropertyHandler
 {
@@ -51,7 +52,13 @@ public:
   /** constructor */
   explicit STOFFGraphicDecoder(librevenge::RVNGDrawingInterface *output)
     : STOFFPropertyHandler()
-    , m_output(output) { }
+    , m_output(output)
+    , m_presentationOutput(nullptr) { }
+  /** constructor used to send the pages to a presentation interface */
+  explicit STOFFGraphicDecoder(librevenge::RVNGPresentationInterface *output)
+    : STOFFPropertyHandler()
+    , m_output(nullptr)
+    , m_presentationOutput(output) { }
   /** destructor */
   ~STOFFGraphicDecoder() override {}
 
@@ -63,11 +70,7 @@ public:
   void insertElement(const char *psName, const librevenge::RVNGPropertyList &xPropList,
                      const librevenge::RVNGPropertyListVector &vector);
   /** insert a sequence of character */
-  void characters(const librevenge::RVNGString &sCharacters) override
-  {
-    if (!m_output) return;
-    m_output->insertText(sCharacters);
-  }
+  void characters(const librevenge::RVNGString &sCharacters) override;
 private:
   /// copy constructor (undefined)
   STOFFGraphicDecoder(STOFFGraphicDecoder const &);
@@ -75,6 +78,8 @@ private:
   STOFFGraphicDecoder operator=(STOFFGraphicDecoder const &);
   /** the interface output */
   librevenge::RVNGDrawingInterface *m_output;
+  /** the presentation interface output */
+  librevenge::RVNGPresentationInterface *m_presentationOutput;
 };
 
 #endif
@@ -38,6 +38,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <librevenge/librevenge.h>
 #include <libstaroffice/libstaroffice.hxx>
@@ -51,14 +52,52 @@
 //! a name space used to define internal data of STOFFGraphicEncoder
 namespace STOFFGraphicEncoderInternal
 {
+//! an element stored by a STOFFGraphicEncoder
+struct Element {
+  //! constructor
+  Element(char const *name, librevenge::RVNGPropertyList const &list, bool hasList)
+    : m_name(name)
+    , m_propertyList(list)
+    , m_hasList(hasList)
+    , m_text()
+  {
+  }
+  //! the element name or nullptr for characters
+  char const *m_name;
+  //! the property list
+  librevenge::RVNGPropertyList m_propertyList;
+  //! a flag to know if the element has a property list
+  bool m_hasList;
+  //! the characters
+  librevenge::RVNGString m_text;
+};
+
 //! the state of a STOFFGraphicEncoder
 struct State {
   //! constructor
-  State() : m_encoder()
+  State() : m_elementList()
+  {
+  }
+  //! inserts a simple element
+  void insertElement(char const *name)
+  {
+    m_elementList.push_back(Element(name, librevenge::RVNGPropertyList(), false));
+  }
+  //! inserts an element with a property list
+  void insertElement(char const *name, librevenge::RVNGPropertyList const &list)
+  {
+    m_elementList.push_back(Element(name, list, true));
+  }
+  //! inserts a list of characters
+  void characters(librevenge::RVNGString const &text)
   {
+    if (text.empty()) return;
+    m_elementList.push_back(Element(nullptr, librevenge::RVNGPropertyList(), false));
+    m_elementList.back().m_text=text;
   }
-  //! the encoder
-  STOFFPropertyHandlerEncoder m_encoder;
+  /** the list of elements: they are stored in memory, so that they can be
+      sent to another interface without losing the property types */
+  std::vector<Element> m_elementList;
 };
 
 }
@@ -75,261 +114,282 @@ STOFFGraphicEncoder::~STOFFGraphicEncoder()
 
 bool STOFFGraphicEncoder::getBinaryResult(STOFFEmbeddedObject &result)
 {
+  STOFFPropertyHandlerEncoder encoder;
+  for (auto const &elt : m_state->m_elementList) {
+    if (!elt.m_name)
+      encoder.characters(elt.m_text);
+    else if (elt.m_hasList)
+      encoder.insertElement(elt.m_name, elt.m_propertyList);
+    else
+      encoder.insertElement(elt.m_name);
+  }
   librevenge::RVNGBinaryData data;
-  if (!m_state->m_encoder.getData(data))
+  if (!encoder.getData(data))
     return false;
   result=STOFFEmbeddedObject(data, "image/stoff-odg");
   return true;
 }
 
+void STOFFGraphicEncoder::sendContent(STOFFPropertyHandler &handler) const
+{
+  for (auto const &elt : m_state->m_elementList) {
+    if (!elt.m_name)
+      handler.characters(elt.m_text);
+    else if (elt.m_hasList)
+      handler.insertElement(elt.m_name, elt.m_propertyList);
+    else
+      handler.insertElement(elt.m_name);
+  }
+}
+
 void STOFFGraphicEncoder::startDocument(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartDocument", list);
+  m_state->insertElement("StartDocument", list);
 }
 
 void STOFFGraphicEncoder::endDocument()
 {
-  m_state->m_encoder.insertElement("EndDocument");
+  m_state->insertElement("EndDocument");
 }
 
 void STOFFGraphicEncoder::setDocumentMetaData(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("SetDocumentMetaData", list);
+  m_state->insertElement("SetDocumentMetaData", list);
 }
 
 void STOFFGraphicEncoder::defineEmbeddedFont(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DefineEmbeddedFont", list);
+  m_state->insertElement("DefineEmbeddedFont", list);
 }
 
 void STOFFGraphicEncoder::startPage(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartPage", list);
+  m_state->insertElement("StartPage", list);
 }
 
 void STOFFGraphicEncoder::endPage()
 {
-  m_state->m_encoder.insertElement("EndPage");
+  m_state->insertElement("EndPage");
 }
 
 void STOFFGraphicEncoder::startMasterPage(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartMasterPage", list);
+  m_state->insertElement("StartMasterPage", list);
 }
 
 void STOFFGraphicEncoder::endMasterPage()
 {
-  m_state->m_encoder.insertElement("EndMasterPage");
+  m_state->insertElement("EndMasterPage");
 }
 
 void STOFFGraphicEncoder::setStyle(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("SetStyle", list);
+  m_state->insertElement("SetStyle", list);
 }
 
 void STOFFGraphicEncoder::startLayer(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartLayer", list);
+  m_state->insertElement("StartLayer", list);
 }
 
 void STOFFGraphicEncoder::endLayer()
 {
-  m_state->m_encoder.insertElement("EndLayer");
+  m_state->insertElement("EndLayer");
 }
 
 void STOFFGraphicEncoder::startEmbeddedGraphics(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartEmbeddedGraphics", list);
+  m_state->insertElement("StartEmbeddedGraphics", list);
 }
 
 void STOFFGraphicEncoder::endEmbeddedGraphics()
 {
-  m_state->m_encoder.insertElement("StartEmbeddedGraphics");
+  m_state->insertElement("StartEmbeddedGraphics");
 }
 
 void STOFFGraphicEncoder::openGroup(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenGroup", list);
+  m_state->insertElement("OpenGroup", list);
 }
 
 void STOFFGraphicEncoder::closeGroup()
 {
-  m_state->m_encoder.insertElement("CloseGroup");
+  m_state->insertElement("CloseGroup");
 }
 
 void STOFFGraphicEncoder::drawRectangle(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DrawRectangle", list);
+  m_state->insertElement("DrawRectangle", list);
 }
 
 void STOFFGraphicEncoder::drawEllipse(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DrawEllipse", list);
+  m_state->insertElement("DrawEllipse", list);
 }
 
 void STOFFGraphicEncoder::drawPolygon(const ::librevenge::RVNGPropertyList &vertices)
 {
-  m_state->m_encoder.insertElement("DrawPolygon", vertices);
+  m_state->insertElement("DrawPolygon", vertices);
 }
 
 void STOFFGraphicEncoder::drawPolyline(const ::librevenge::RVNGPropertyList &vertices)
 {
-  m_state->m_encoder.insertElement("DrawPolyline", vertices);
+  m_state->insertElement("DrawPolyline", vertices);
 }
 
 void STOFFGraphicEncoder::drawPath(const ::librevenge::RVNGPropertyList &path)
 {
-  m_state->m_encoder.insertElement("DrawPath", path);
+  m_state->insertElement("DrawPath", path);
 }
 
 void STOFFGraphicEncoder::drawConnector(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DrawConnector", list);
+  m_state->insertElement("DrawConnector", list);
 }
 
 void STOFFGraphicEncoder::drawGraphicObject(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DrawGraphicObject", list);
+  m_state->insertElement("DrawGraphicObject", list);
 }
 
 void STOFFGraphicEncoder::startTextObject(const ::librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartTextObject", list);
+  m_state->insertElement("StartTextObject", list);
 }
 
 void STOFFGraphicEncoder::endTextObject()
 {
-  m_state->m_encoder.insertElement("EndTextObject");
+  m_state->insertElement("EndTextObject");
 }
 
 void STOFFGraphicEncoder::startTableObject(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("StartTableObject", list);
+  m_state->insertElement("StartTableObject", list);
 }
 
 void STOFFGraphicEncoder::endTableObject()
 {
-  m_state->m_encoder.insertElement("EndTableObject");
+  m_state->insertElement("EndTableObject");
 }
 
 void STOFFGraphicEncoder::openTableRow(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenTableRow", list);
+  m_state->insertElement("OpenTableRow", list);
 }
 
 void STOFFGraphicEncoder::closeTableRow()
 {
-  m_state->m_encoder.insertElement("CloseTableRow");
+  m_state->insertElement("CloseTableRow");
 }
 
 void STOFFGraphicEncoder::openTableCell(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenTableCell", list);
+  m_state->insertElement("OpenTableCell", list);
 }
 
 void STOFFGraphicEncoder::closeTableCell()
 {
-  m_state->m_encoder.insertElement("CloseTableCell");
+  m_state->insertElement("CloseTableCell");
 }
 
 void STOFFGraphicEncoder::insertCoveredTableCell(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("InsertCoveredTableCell", list);
+  m_state->insertElement("InsertCoveredTableCell", list);
 }
 
 void STOFFGraphicEncoder::insertTab()
 {
-  m_state->m_encoder.insertElement("InsertTab");
+  m_state->insertElement("InsertTab");
 }
 
 void STOFFGraphicEncoder::insertSpace()
 {
-  m_state->m_encoder.insertElement("InsertSpace");
+  m_state->insertElement("InsertSpace");
 }
 
 void STOFFGraphicEncoder::insertText(const librevenge::RVNGString &text)
 {
-  m_state->m_encoder.characters(text);
+  m_state->characters(text);
 }
 
 void STOFFGraphicEncoder::insertLineBreak()
 {
-  m_state->m_encoder.insertElement("InsertLineBreak");
+  m_state->insertElement("InsertLineBreak");
 }
 
 void STOFFGraphicEncoder::insertField(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("InsertField", list);
+  m_state->insertElement("InsertField", list);
 }
 
 void STOFFGraphicEncoder::openLink(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenLink", list);
+  m_state->insertElement("OpenLink", list);
 }
 
 void STOFFGraphicEncoder::closeLink()
 {
-  m_state->m_encoder.insertElement("CloseLink");
+  m_state->insertElement("CloseLink");
 }
 
 void STOFFGraphicEncoder::openOrderedListLevel(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenOrderedListLevel", list);
+  m_state->insertElement("OpenOrderedListLevel", list);
 }
 
 void STOFFGraphicEncoder::openUnorderedListLevel(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenUnorderedListLevel", list);
+  m_state->insertElement("OpenUnorderedListLevel", list);
 }
 
 void STOFFGraphicEncoder::closeOrderedListLevel()
 {
-  m_state->m_encoder.insertElement("CloseOrderedListLevel");
+  m_state->insertElement("CloseOrderedListLevel");
 }
 
 void STOFFGraphicEncoder::closeUnorderedListLevel()
 {
-  m_state->m_encoder.insertElement("CloseOrderedListLevel");
+  m_state->insertElement("CloseOrderedListLevel");
 }
 
 void STOFFGraphicEncoder::openListElement(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenListElement", list);
+  m_state->insertElement("OpenListElement", list);
 }
 
 void STOFFGraphicEncoder::closeListElement()
 {
-  m_state->m_encoder.insertElement("CloseListElement");
+  m_state->insertElement("CloseListElement");
 }
 
 void STOFFGraphicEncoder::defineParagraphStyle(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DefineParagraphStyle", list);
+  m_state->insertElement("DefineParagraphStyle", list);
 }
 
 void STOFFGraphicEncoder::openParagraph(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenParagraph", list);
+  m_state->insertElement("OpenParagraph", list);
 }
 
 void STOFFGraphicEncoder::closeParagraph()
 {
-  m_state->m_encoder.insertElement("CloseParagraph");
+  m_state->insertElement("CloseParagraph");
 }
 
 void STOFFGraphicEncoder::defineCharacterStyle(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("DefineCharacterStyle", list);
+  m_state->insertElement("DefineCharacterStyle", list);
 }
 
 void STOFFGraphicEncoder::openSpan(const librevenge::RVNGPropertyList &list)
 {
-  m_state->m_encoder.insertElement("OpenSpan", list);
+  m_state->insertElement("OpenSpan", list);
 }
 
 void STOFFGraphicEncoder::closeSpan()
 {
-  m_state->m_encoder.insertElement("CloseSpan");
+  m_state->insertElement("CloseSpan");
 }
 
 // vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
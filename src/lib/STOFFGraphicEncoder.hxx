@@ -39,7 +39,7 @@
 #include <librevenge/librevenge.h>
 #include "libstaroffice_internal.hxx"
 
-class STOFFPropertyHandlerEncoder;
+class STOFFPropertyHandler;
 
 namespace STOFFGraphicEncoderInternal
 {
@@ -61,6 +61,8 @@ public:
   ~STOFFGraphicEncoder() final;
   /// return the final graphic
   bool getBinaryResult(STOFFEmbeddedObject &result);
+  /// sends the stored elements to a handler, for instance a STOFFGraphicDecoder
+  void sendContent(STOFFPropertyHandler &handler) const;
 
   void startDocument(const ::librevenge::RVNGPropertyList &propList) final;
   void endDocument() final;
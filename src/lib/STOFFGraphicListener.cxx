@@ -35,6 +35,7 @@
 
 #include <cstring>
 #include <iomanip>
+#include <map>
 #include <set>
 #include <sstream>
 
@@ -46,6 +47,8 @@
 #include "STOFFCell.hxx"
 #include "STOFFFont.hxx"
 #include "STOFFFrameStyle.hxx"
+#include "STOFFGraphicDecoder.hxx"
+#include "STOFFGraphicEncoder.hxx"
 #include "STOFFGraphicStyle.hxx"
 #include "STOFFGraphicShape.hxx"
 #include "STOFFInputStream.hxx"
@@ -62,10 +65,40 @@
 //! Internal and low level namespace to define the states of STOFFGraphicListener
 namespace STOFFGraphicListenerInternal
 {
+//! adds a string and a separator to two 64 bits hash: a FNV-1a and a polynomial one
+static void updateHash(char const *str, uint64_t (&hash)[2])
+{
+  for (; *str; ++str) {
+    hash[0]=(hash[0]^uint8_t(*str))*0x100000001b3ULL;
+    hash[1]=hash[1]*31+uint8_t(*str);
+  }
+  // 0xff does not appear in an UTF-8 string
+  hash[0]=(hash[0]^0xff)*0x100000001b3ULL;
+  hash[1]=hash[1]*31+0xff;
+}
+
+//! adds the content of a property list to two hash, used to compare graphic styles
+static void updateHash(librevenge::RVNGPropertyList const &list, uint64_t (&hash)[2])
+{
+  librevenge::RVNGPropertyList::Iter i(list);
+  for (i.rewind(); i.next();) {
+    updateHash(i.key(), hash);
+    if (i.child()) {
+      updateHash("[", hash);
+      librevenge::RVNGPropertyListVector::Iter j(*i.child());
+      for (j.rewind(); j.next();)
+        updateHash(j(), hash);
+      updateHash("]", hash);
+    }
+    else if (i())
+      updateHash(i()->getStr().cstr(), hash);
+  }
+}
+
 /** the global graphic state of STOFFGraphicListener */
 struct GraphicState {
   //! constructor
-  explicit GraphicState(std::vector<STOFFPageSpan> const &pageList)
+  GraphicState(std::vector<STOFFPageSpan> const &pageList, bool shareAutomaticStyles)
     : m_pageList(pageList)
     , m_metaData()
     , m_isDocumentStarted(false)
@@ -80,6 +113,13 @@ struct GraphicState {
     , m_definedFontStyleSet()
     , m_definedGraphicStyleSet()
     , m_definedParagraphStyleSet()
+    , m_isPageContent(false)
+    , m_canInsertPageContent(true)
+    , m_shareAutomaticStyles(shareAutomaticStyles)
+    , m_isAutomaticStyleSent(false)
+    , m_automaticStyleHash(0,0)
+    , m_hashToAutomaticStyleNameMap()
+    , m_numAutomaticStyles(0)
     , m_section()
   {
   }
@@ -87,6 +127,40 @@ struct GraphicState {
   ~GraphicState()
   {
   }
+  /** checks an automatic style (a shape, a picture style) before sending it.
+
+      Returns false if the style is the current style of the interface. If not,
+      the first time a style is found, definition is set to a graphic style
+      "ShapeStyleN" with the same properties, which must be sent before. The
+      style then references this graphic style but keeps its properties, as
+      the SVG generators do not read the parent styles. */
+  bool updateAutomaticStyle(librevenge::RVNGPropertyList &propList, librevenge::RVNGPropertyList &definition)
+  {
+    definition.clear();
+    uint64_t hash[2]= {0xcbf29ce484222325ULL, 0};
+    updateHash(propList, hash);
+    auto const key=std::make_pair(hash[0], hash[1]);
+    if (m_isAutomaticStyleSent && key==m_automaticStyleHash)
+      return false;
+    m_isAutomaticStyleSent=true;
+    m_automaticStyleHash=key;
+    if (!m_shareAutomaticStyles)
+      return true;
+    auto it=m_hashToAutomaticStyleNameMap.find(key);
+    if (it==m_hashToAutomaticStyleNameMap.end()) {
+      // a new graphic style, whose name does not correspond to a document style
+      librevenge::RVNGString name;
+      do {
+        name.sprintf("ShapeStyle%d", ++m_numAutomaticStyles);
+      }
+      while (!m_definedGraphicStyleSet.insert(name).second);
+      it=m_hashToAutomaticStyleNameMap.insert(std::make_pair(key, name)).first;
+      definition=propList;
+      definition.insert("style:display-name", name);
+    }
+    propList.insert("librevenge:parent-display-name", it->second);
+    return true;
+  }
   //! the pages definition
   std::vector<STOFFPageSpan> m_pageList;
   //! the document meta data
@@ -114,10 +188,100 @@ struct GraphicState {
   std::set<librevenge::RVNGString> m_definedGraphicStyleSet;
   //! the set of defined paragraph style
   std::set<librevenge::RVNGString> m_definedParagraphStyleSet;
+  //! true if the listener stores the content of a page, see createPageContentListener
+  bool m_isPageContent;
+  //! false if the stored page content contains some lists
+  bool m_canInsertPageContent;
+  /** true if the automatic styles are defined once as graphic styles, false if
+      the content is stored in a STOFFGraphicEncoder: an embedded object or a page
+      sent in parallel whose styles are shared when it is inserted by the main listener */
+  bool m_shareAutomaticStyles;
+  //! true if the current style of the interface is the last automatic style
+  bool m_isAutomaticStyleSent;
+  //! the hash of the last automatic style
+  std::pair<uint64_t, uint64_t> m_automaticStyleHash;
+  //! a map hash of an automatic style to the graphic style defined to store it
+  std::map<std::pair<uint64_t, uint64_t>, librevenge::RVNGString> m_hashToAutomaticStyleNameMap;
+  //! the number of graphic styles created to store the automatic styles
+  int m_numAutomaticStyles;
   //! am empty section
   STOFFSection m_section;
 };
 
+/** a decoder used to send the content of a page stored in a STOFFGraphicEncoder.
+
+    The styles are checked with the state of the main listener, so that the
+    result is the same as if the page had been sent by the main listener */
+class PageContentDecoder final : public STOFFGraphicDecoder
+{
+public:
+  //! constructor with a drawing interface
+  PageContentDecoder(librevenge::RVNGDrawingInterface *output, GraphicState &state)
+    : STOFFGraphicDecoder(output)
+    , m_state(state)
+  {
+  }
+  //! constructor with a presentation interface
+  PageContentDecoder(librevenge::RVNGPresentationInterface *output, GraphicState &state)
+    : STOFFGraphicDecoder(output)
+    , m_state(state)
+  {
+  }
+  //! insert an element if it is not a document or a page element
+  void insertElement(const char *psName) final
+  {
+    if (!isDocumentElement(psName))
+      STOFFGraphicDecoder::insertElement(psName);
+  }
+  //! insert an element if it is not a document or a page element
+  void insertElement(const char *psName, const librevenge::RVNGPropertyList &propList) final
+  {
+    if (isDocumentElement(psName)) return;
+    if (psName && strcmp(psName, "SetStyle")==0 && !propList["style:display-name"]) {
+      // an automatic style, check it as if it was sent by the main listener
+      librevenge::RVNGPropertyList style(propList), definition;
+      if (!m_state.updateAutomaticStyle(style, definition)) return;
+      if (!definition.empty())
+        STOFFGraphicDecoder::insertElement(psName, definition);
+      STOFFGraphicDecoder::insertElement(psName, style);
+      return;
+    }
+    if (isNewStyle(psName, propList))
+      STOFFGraphicDecoder::insertElement(psName, propList);
+  }
+protected:
+  //! returns false if the element defines a named style already defined by the main listener
+  bool isNewStyle(const char *psName, const librevenge::RVNGPropertyList &propList)
+  {
+    if (!psName) return true;
+    bool const isGraphic=strcmp(psName, "SetStyle")==0;
+    if (!isGraphic && strcmp(psName, "DefineParagraphStyle")!=0)
+      return true;
+    auto const *name=propList["style:display-name"];
+    if (!name)
+      return true;
+    auto &nameSet=isGraphic ? m_state.m_definedGraphicStyleSet : m_state.m_definedParagraphStyleSet;
+    if (!nameSet.insert(name->getStr()).second)
+      return false;
+    if (isGraphic)
+      m_state.m_isAutomaticStyleSent=false;
+    return true;
+  }
+  //! returns true if the element corresponds to the start/end of a document or a page
+  static bool isDocumentElement(const char *psName)
+  {
+    if (!psName) return false;
+    return strcmp(psName, "StartDocument")==0 || strcmp(psName, "EndDocument")==0 ||
+           strcmp(psName, "SetDocumentMetaData")==0 || strcmp(psName, "StartPage")==0 ||
+           strcmp(psName, "EndPage")==0;
+  }
+  //! the state of the main listener
+  GraphicState &m_state;
+private:
+  PageContentDecoder(PageContentDecoder const &) = delete;
+  PageContentDecoder &operator=(PageContentDecoder const &) = delete;
+};
+
 /** the state of a STOFFGraphicListener */
 struct State {
   //! constructor
@@ -213,7 +377,7 @@ State::State()
 
 STOFFGraphicListener::STOFFGraphicListener(STOFFListManagerPtr listManager, std::vector<STOFFPageSpan> const &pageList, librevenge::RVNGDrawingInterface *drawingInterface)
   : STOFFListener(listManager)
-  , m_ds(new STOFFGraphicListenerInternal::GraphicState(pageList))
+  , m_ds(new STOFFGraphicListenerInternal::GraphicState(pageList, dynamic_cast<STOFFGraphicEncoder *>(drawingInterface)==nullptr))
   , m_ps(new STOFFGraphicListenerInternal::State)
   , m_psStack()
   , m_drawingInterface(drawingInterface)
@@ -223,7 +387,7 @@ STOFFGraphicListener::STOFFGraphicListener(STOFFListManagerPtr listManager, std:
 
 STOFFGraphicListener::STOFFGraphicListener(STOFFListManagerPtr listManager, std::vector<STOFFPageSpan> const &pageList, librevenge::RVNGPresentationInterface *presentationInterface)
   : STOFFListener(listManager)
-  , m_ds(new STOFFGraphicListenerInternal::GraphicState(pageList))
+  , m_ds(new STOFFGraphicListenerInternal::GraphicState(pageList, true))
   , m_ps(new STOFFGraphicListenerInternal::State)
   , m_psStack()
   , m_drawingInterface(nullptr)
@@ -254,6 +418,7 @@ void STOFFGraphicListener::defineStyle(STOFFGraphicStyle const &style)
   librevenge::RVNGPropertyList pList(style.m_propertyList);
   STOFFGraphicStyle::checkForDefault(pList);
   STOFFGraphicStyle::checkForPadding(pList);
+  m_ds->m_isAutomaticStyleSent=false;
   if (m_drawingInterface)
     m_drawingInterface->setStyle(pList);
   else
@@ -321,6 +486,22 @@ void STOFFGraphicListener::insertUnicode(uint32_t val)
   libstoff::appendUnicode(val, m_ps->m_textBuffer);
 }
 
+void STOFFGraphicListener::insertUnicodeSpan(uint32_t const *characters, size_t numCharacters)
+{
+  if (!m_ps->isInTextZone()) {
+    STOFF_DEBUG_MSG(("STOFFGraphicListener::insertUnicodeSpan: called outside a text zone\n"));
+    return;
+  }
+  if (!characters || !numCharacters) return;
+  if (!m_ps->m_isSpanOpened) _openSpan();
+  if (libstoff::appendUnicode(characters, numCharacters, m_ps->m_textBuffer)) {
+    static int numErrors=0;
+    if (++numErrors<10) {
+      STOFF_DEBUG_MSG(("STOFFGraphicListener::insertUnicodeSpan: find some odd chars\n"));
+    }
+  }
+}
+
 void STOFFGraphicListener::insertUnicodeString(librevenge::RVNGString const &str)
 {
   if (!m_ps->isInTextZone()) {
@@ -503,7 +684,10 @@ void STOFFGraphicListener::endDocument(bool /*delayed*/)
   else
     m_presentationInterface->endDocument();
   m_ds->m_isDocumentStarted=false;
-  *m_ds=STOFFGraphicListenerInternal::GraphicState(std::vector<STOFFPageSpan>());
+  STOFFGraphicListenerInternal::GraphicState newState(std::vector<STOFFPageSpan>(), m_ds->m_shareAutomaticStyles);
+  newState.m_isPageContent=m_ds->m_isPageContent;
+  newState.m_canInsertPageContent=m_ds->m_canInsertPageContent;
+  *m_ds=newState;
 }
 
 ///////////////////
@@ -566,11 +750,47 @@ bool STOFFGraphicListener::openMasterPage(STOFFPageSpan &masterPage)
   else
     m_presentationInterface->startMasterSlide(propList);
   m_ds->m_isPageSpanOpened = m_ds->m_isMasterPageSpanOpened = true;
+  m_ds->m_isAutomaticStyleSent=false;
 
   // checkme: can we send some header/footer if some exists
   return true;
 }
 
+void STOFFGraphicListener::insertPageContent(STOFFGraphicEncoder const &encoder)
+{
+  if (!m_ds->m_isDocumentStarted) {
+    STOFF_DEBUG_MSG(("STOFFGraphicListener::insertPageContent: the document is not started\n"));
+    return;
+  }
+  if (m_ds->m_isMasterPageSpanOpened) {
+    STOFF_DEBUG_MSG(("STOFFGraphicListener::insertPageContent: can not insert a page in a master page\n"));
+    return;
+  }
+  if (!m_ds->m_isPageSpanOpened)
+    _openPageSpan();
+  if (m_drawingInterface) {
+    STOFFGraphicListenerInternal::PageContentDecoder decoder(m_drawingInterface, *m_ds);
+    encoder.sendContent(decoder);
+  }
+  else {
+    STOFFGraphicListenerInternal::PageContentDecoder decoder(m_presentationInterface, *m_ds);
+    encoder.sendContent(decoder);
+  }
+}
+
+STOFFGraphicListenerPtr STOFFGraphicListener::createPageContentListener(STOFFGraphicEncoder &encoder) const
+{
+  // the page spans, the header and the footer are sent by this listener
+  STOFFGraphicListenerPtr listener(new STOFFGraphicListener(STOFFListManagerPtr(), std::vector<STOFFPageSpan>(1), &encoder));
+  listener->m_ds->m_isPageContent=true;
+  return listener;
+}
+
+bool STOFFGraphicListener::canInsertPageContent() const
+{
+  return m_ds->m_canInsertPageContent;
+}
+
 void STOFFGraphicListener::_openPageSpan(bool sendHeaderFooters)
 {
   if (m_ds->m_isPageSpanOpened)
@@ -613,6 +833,7 @@ void STOFFGraphicListener::_openPageSpan(bool sendHeaderFooters)
       m_presentationInterface->startSlide(propList);
   }
   m_ds->m_isPageSpanOpened = true;
+  m_ds->m_isAutomaticStyleSent=false;
   m_ds->m_pageSpan = currentPage;
 
   // we insert the header footer
@@ -652,6 +873,7 @@ void STOFFGraphicListener::_closePageSpan(bool masterPage)
     _changeList(); // flush the list exterior
   }
   m_ds->m_isPageSpanOpened = m_ds->m_isMasterPageSpanOpened = false;
+  m_ds->m_isAutomaticStyleSent=false;
   if (m_drawingInterface) {
     if (masterPage)
       m_drawingInterface->endMasterPage();
@@ -818,6 +1040,9 @@ void STOFFGraphicListener::_changeList()
   }
 
   if (newLevel) {
+    // the list ids depend on the lists sent before, the main listener must send this page
+    if (m_ds->m_isPageContent)
+      m_ds->m_canInsertPageContent=false;
     std::shared_ptr<STOFFList> theList;
 
     theList=m_listManager->getList(newListId);
@@ -915,34 +1140,35 @@ void STOFFGraphicListener::_closeSpan()
 ///////////////////
 void STOFFGraphicListener::_flushText()
 {
-  if (m_ps->m_textBuffer.len() == 0) return;
+  if (m_ps->m_textBuffer.empty()) return;
 
   // when some many ' ' follows each other, call insertSpace
-  librevenge::RVNGString tmpText("");
-  int numConsecutiveSpaces = 0;
-  librevenge::RVNGString::Iter i(m_ps->m_textBuffer);
-  for (i.rewind(); i.next();) {
-    if (*(i()) == 0x20) // this test is compatible with unicode format
-      numConsecutiveSpaces++;
-    else
-      numConsecutiveSpaces = 0;
-
-    if (numConsecutiveSpaces > 1) {
-      if (tmpText.len() > 0) {
-        if (m_drawingInterface)
-          m_drawingInterface->insertText(tmpText);
-        else
-          m_presentationInterface->insertText(tmpText);
-        tmpText.clear();
-      }
+  // note: as ' ' can not appear in a utf8 multibyte sequence, we can look directly for it in the buffer
+  char const *text=m_ps->m_textBuffer.cstr();
+  size_t const len=size_t(m_ps->m_textBuffer.size());
+  size_t first=0, pos=0;
+  while (pos<len) {
+    auto const *space=static_cast<char const *>(std::memchr(text+pos, ' ', len-pos));
+    if (!space) break;
+    pos=size_t(space-text)+1;
+    if (pos>=len || text[pos]!=' ') continue;
+    // the first space is kept in the text, the following ones are sent with insertSpace
+    if (pos>first) {
+      librevenge::RVNGString tmpText(std::string(text+first, pos-first).c_str());
+      if (m_drawingInterface)
+        m_drawingInterface->insertText(tmpText);
+      else
+        m_presentationInterface->insertText(tmpText);
+    }
+    for (; pos<len && text[pos]==' '; ++pos) {
       if (m_drawingInterface)
         m_drawingInterface->insertSpace();
       else
         m_presentationInterface->insertSpace();
     }
-    else
-      tmpText.append(i());
+    first=pos;
   }
+  librevenge::RVNGString tmpText(text+first);
   if (m_drawingInterface)
     m_drawingInterface->insertText(tmpText);
   else
@@ -1161,10 +1387,7 @@ void STOFFGraphicListener::insertPicture(STOFFFrameStyle const &frame, STOFFEmbe
     _openPageSpan();
   librevenge::RVNGPropertyList list;
   style.addTo(list);
-  if (m_drawingInterface)
-    m_drawingInterface->setStyle(list);
-  else
-    m_presentationInterface->setStyle(list);
+  _sendAutomaticStyle(list);
   list.clear();
   _handleFrameParameters(list, frame, style);
   if (picture.addTo(list)) {
@@ -1194,10 +1417,7 @@ void STOFFGraphicListener::insertEquation(STOFFFrameStyle const &frame, libreven
     _openPageSpan();
   librevenge::RVNGPropertyList list;
   style.addTo(list);
-  if (m_drawingInterface)
-    m_drawingInterface->setStyle(list);
-  else
-    m_presentationInterface->setStyle(list);
+  _sendAutomaticStyle(list);
   list.clear();
   _handleFrameParameters(list, frame, style);
   librevenge::RVNGPropertyList propList;
@@ -1236,8 +1456,8 @@ void STOFFGraphicListener::insertShape(STOFFFrameStyle const &frame, STOFFGraphi
   shape.addTo(shapeProp);
   style.addTo(styleProp);
   STOFFGraphicStyle::checkForDefault(styleProp);
+  _sendAutomaticStyle(styleProp);
   if (m_drawingInterface) {
-    m_drawingInterface->setStyle(styleProp);
     switch (shape.m_command) {
     case STOFFGraphicShape::C_Connector:
       m_drawingInterface->drawConnector(shapeProp);
@@ -1265,7 +1485,6 @@ void STOFFGraphicListener::insertShape(STOFFFrameStyle const &frame, STOFFGraphi
     }
   }
   else {
-    m_presentationInterface->setStyle(styleProp);
     switch (shape.m_command) {
     case STOFFGraphicShape::C_Connector:
       m_presentationInterface->drawConnector(shapeProp);
@@ -1630,6 +1849,23 @@ void  STOFFGraphicListener::closeLayer()
   _popParsingState();
 }
 
+void STOFFGraphicListener::_sendAutomaticStyle(librevenge::RVNGPropertyList &propList)
+{
+  librevenge::RVNGPropertyList definition;
+  if (!m_ds->updateAutomaticStyle(propList, definition))
+    return;
+  if (m_drawingInterface) {
+    if (!definition.empty())
+      m_drawingInterface->setStyle(definition);
+    m_drawingInterface->setStyle(propList);
+  }
+  else {
+    if (!definition.empty())
+      m_presentationInterface->setStyle(definition);
+    m_presentationInterface->setStyle(propList);
+  }
+}
+
 void STOFFGraphicListener::_handleFrameParameters(librevenge::RVNGPropertyList &list, STOFFFrameStyle const &frame, STOFFGraphicStyle const &style)
 {
   if (!m_ds->m_isDocumentStarted)
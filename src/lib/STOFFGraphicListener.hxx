@@ -44,6 +44,7 @@
 
 #include "STOFFListener.hxx"
 
+class STOFFGraphicEncoder;
 class STOFFGraphicShape;
 
 namespace STOFFGraphicListenerInternal
@@ -112,6 +113,16 @@ public:
   {
     _closePageSpan(true);
   }
+  /** inserts in the current page the content of a page stored by a STOFFGraphicEncoder,
+      the document and page elements of the encoder are ignored */
+  void insertPageContent(STOFFGraphicEncoder const &encoder);
+  /** returns a new listener which stores the content of a page in encoder, so that the
+      page can be sent in another thread and then inserted with insertPageContent */
+  STOFFGraphicListenerPtr createPageContentListener(STOFFGraphicEncoder &encoder) const;
+  /** returns false if the content stored by a page content listener can not be inserted
+      with insertPageContent: the page contains some lists, whose ids depend on the lists
+      sent in the previous pages, so it must be sent again by the main listener */
+  bool canInsertPageContent() const;
   /** returns true if a page is opened */
   bool isPageSpanOpened() const final;
   /** returns the current page span
@@ -143,6 +154,9 @@ public:
   /** adds an unicode character.
    *  By convention if \a character=0xfffd(undef), no character is added */
   void insertUnicode(uint32_t character) final;
+  /** adds a run of unicode characters.
+   *  By convention the undef characters(0xfffd) are skipped */
+  void insertUnicodeSpan(uint32_t const *characters, size_t numCharacters) final;
   //! adds a unicode string
   void insertUnicodeString(librevenge::RVNGString const &str) final;
 
@@ -267,6 +281,12 @@ protected:
 
    \note if there is some gradient, first draw a rectangle to print the gradient and them update propList */
   void _handleFrameParameters(librevenge::RVNGPropertyList &propList, STOFFFrameStyle const &frame, STOFFGraphicStyle const &style);
+  /** sends an automatic style (a shape, a picture style) if it is not the current style.
+
+   
+ote the first time a style is found, a graphic style with the same properties is
+   defined and propList is updated to reference it */
+  void _sendAutomaticStyle(librevenge::RVNGPropertyList &propList);
 
   void _openParagraph();
   void _closeParagraph();
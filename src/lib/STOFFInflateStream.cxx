@@ -0,0 +1,330 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef USE_ZIP
+#  include <zlib.h>
+#endif
+
+#include "STOFFInputStream.hxx"
+#include "STOFFResourceGovernor.hxx"
+
+#include "STOFFInflateStream.hxx"
+
+//! internal data of a STOFFInflateStream
+class STOFFInflateStreamPrivate
+{
+public:
+  //! constructor
+  STOFFInflateStreamPrivate(STOFFInputStreamPtr input, long beginPos, long endPos, unsigned long uncompressedSize);
+  //! destructor
+  ~STOFFInflateStreamPrivate();
+  //! (re)starts the decompression
+  bool init();
+  //! try to decompress the data until the buffer contains m_offset+numBytes
+  void decompress(unsigned long numBytes);
+  //! the input stream
+  STOFFInputStreamPtr m_input;
+  //! the begin position of the compressed data
+  long m_beginPos;
+  //! the end position of the compressed data
+  long m_endPos;
+  //! the position of the next compressed data to read
+  long m_readPos;
+  //! the decompressed size
+  long m_size;
+  //! the stream offset
+  long m_offset;
+#ifdef USE_ZIP
+  //! the zlib stream
+  z_stream m_stream;
+#endif
+  //! a flag to know if the zlib stream is initialized
+  bool m_isOpened;
+  //! a flag to know if all the data are decompressed (or if we find an error)
+  bool m_isEnd;
+  //! the compressed data buffer
+  std::vector<unsigned char> m_inputBuffer;
+  //! the decompressed data buffer
+  std::vector<unsigned char> m_buffer;
+  //! the position of the first byte of m_buffer in the decompressed data
+  long m_bufferPos;
+  //! the number of decompressed bytes stored in m_buffer
+  size_t m_bufferSize;
+  //! the size of the compressed data read at each step, and of the part of the decompressed data kept after a read
+  static size_t const s_chunkSize=65536;
+private:
+  STOFFInflateStreamPrivate(const STOFFInflateStreamPrivate &);
+  STOFFInflateStreamPrivate &operator=(const STOFFInflateStreamPrivate &);
+};
+
+STOFFInflateStreamPrivate::STOFFInflateStreamPrivate(STOFFInputStreamPtr input, long beginPos, long endPos, unsigned long uncompressedSize)
+  : m_input(input)
+  , m_beginPos(beginPos)
+  , m_endPos(endPos)
+  , m_readPos(beginPos)
+  , m_size(long(uncompressedSize))
+  , m_offset(0)
+#ifdef USE_ZIP
+  , m_stream()
+#endif
+  , m_isOpened(false)
+  , m_isEnd(true)
+  , m_inputBuffer()
+  , m_buffer()
+  , m_bufferPos(0)
+  , m_bufferSize(0)
+{
+  if (m_size<0) m_size=0;
+  init();
+}
+
+STOFFInflateStreamPrivate::~STOFFInflateStreamPrivate()
+{
+#ifdef USE_ZIP
+  if (m_isOpened)
+    (void)inflateEnd(&m_stream);
+#endif
+}
+
+bool STOFFInflateStreamPrivate::init()
+{
+  m_readPos=m_beginPos;
+  m_bufferPos=0;
+  m_bufferSize=0;
+  m_isEnd=true;
+#ifdef USE_ZIP
+  if (m_isOpened) {
+    (void)inflateEnd(&m_stream);
+    m_isOpened=false;
+  }
+  if (!m_input || m_beginPos<0 || m_endPos<=m_beginPos)
+    return false;
+  m_stream.zalloc = Z_NULL;
+  m_stream.zfree = Z_NULL;
+  m_stream.opaque = Z_NULL;
+  m_stream.avail_in = 0;
+  m_stream.next_in = Z_NULL;
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+  int ret = inflateInit(&m_stream);
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#endif
+  if (ret != Z_OK) {
+    STOFF_DEBUG_MSG(("STOFFInflateStreamPrivate::init: can not init stream\n"));
+    return false;
+  }
+  m_isOpened=true;
+  m_isEnd=false;
+  return true;
+#else
+  STOFF_DEBUG_MSG(("STOFFInflateStreamPrivate::init: can not decompress the data without zlib\n"));
+  return false;
+#endif
+}
+
+void STOFFInflateStreamPrivate::decompress(unsigned long numBytes)
+{
+  if (m_offset<m_bufferPos && !init())
+    return;
+  // remove the data before the actual position, excepted a small part to allow small backward seeks
+  long const keepPos=std::min(m_offset, m_bufferPos+long(m_bufferSize))-1024;
+  if (keepPos>m_bufferPos) {
+    auto const numRemoved=size_t(keepPos-m_bufferPos);
+    if (m_bufferSize>numRemoved)
+      std::memmove(&m_buffer[0], &m_buffer[numRemoved], m_bufferSize-numRemoved);
+    m_bufferSize-=numRemoved;
+    m_bufferPos=keepPos;
+  }
+#ifdef USE_ZIP
+  while (!m_isEnd) {
+    long const bufferEnd=m_bufferPos+long(m_bufferSize);
+    if (bufferEnd>=m_offset+long(numBytes))
+      return;
+    if (bufferEnd<m_offset && m_bufferSize>=s_chunkSize) {
+      // we are skipping some data, we can forget them
+      m_bufferPos=bufferEnd;
+      m_bufferSize=0;
+    }
+    // grow the buffer with the decompressed data, the uncompressed size stored in a file can be wrong
+    size_t const wantedSize=m_bufferSize+std::max(size_t(s_chunkSize), m_bufferSize);
+    if (m_buffer.size()<wantedSize) {
+      libstoff::useMemory(static_cast<unsigned long>(wantedSize-m_buffer.size()));
+      m_buffer.resize(wantedSize);
+    }
+    if (m_stream.avail_in==0) {
+      if (m_readPos>=m_endPos) {
+        STOFF_DEBUG_MSG(("STOFFInflateStreamPrivate::decompress: the compressed data seem truncated\n"));
+        m_isEnd=true;
+        return;
+      }
+      long const actPos=m_input->tell();
+      m_input->seek(m_readPos, librevenge::RVNG_SEEK_SET);
+      unsigned long readBytes=0;
+      uint8_t const *data=m_input->read(size_t(std::min(long(s_chunkSize), m_endPos-m_readPos)), readBytes);
+      if (data && readBytes)
+        m_inputBuffer.assign(data, data+readBytes);
+      m_input->seek(actPos, librevenge::RVNG_SEEK_SET);
+      if (!data || !readBytes) {
+        STOFF_DEBUG_MSG(("STOFFInflateStreamPrivate::decompress: can not read the compressed data\n"));
+        m_isEnd=true;
+        return;
+      }
+      m_readPos+=long(readBytes);
+      m_stream.next_in=&m_inputBuffer[0];
+      m_stream.avail_in=uInt(readBytes);
+    }
+    m_stream.next_out=&m_buffer[m_bufferSize];
+    m_stream.avail_out=uInt(m_buffer.size()-m_bufferSize);
+    int ret=inflate(&m_stream, Z_NO_FLUSH);
+    m_bufferSize=m_buffer.size()-size_t(m_stream.avail_out);
+    if (ret==Z_STREAM_END)
+      m_isEnd=true;
+    else if (ret!=Z_OK) {
+      STOFF_DEBUG_MSG(("STOFFInflateStreamPrivate::decompress: can not decode the stream, err=%d\n", ret));
+      m_isEnd=true;
+    }
+  }
+#else
+  (void)numBytes;
+#endif
+}
+
+STOFFInflateStream::STOFFInflateStream(STOFFInputStreamPtr input, long beginPos, long endPos, unsigned long uncompressedSize) :
+  librevenge::RVNGInputStream(),
+  m_data(new STOFFInflateStreamPrivate(input, beginPos, endPos, uncompressedSize))
+{
+}
+
+STOFFInflateStream::~STOFFInflateStream()
+{
+  if (m_data) delete m_data;
+}
+
+bool STOFFInflateStream::isValid() const
+{
+  return m_data && m_data->m_isOpened;
+}
+
+const unsigned char *STOFFInflateStream::read(unsigned long numBytes, unsigned long &numBytesRead)
+{
+  numBytesRead = 0;
+
+  if (numBytes == 0 || !m_data || m_data->m_offset>=m_data->m_size)
+    return nullptr;
+  numBytes=std::min(numBytes, static_cast<unsigned long>(m_data->m_size-m_data->m_offset));
+  if (m_data->m_offset<m_data->m_bufferPos || m_data->m_offset+long(numBytes)>m_data->m_bufferPos+long(m_data->m_bufferSize))
+    m_data->decompress(numBytes);
+  long const available=m_data->m_bufferPos+long(m_data->m_bufferSize)-m_data->m_offset;
+  if (m_data->m_offset<m_data->m_bufferPos || available<=0)
+    return nullptr;
+  numBytesRead=std::min(numBytes, static_cast<unsigned long>(available));
+  unsigned char const *res=&m_data->m_buffer[size_t(m_data->m_offset-m_data->m_bufferPos)];
+  m_data->m_offset+=long(numBytesRead);
+  return res;
+}
+
+long STOFFInflateStream::tell()
+{
+  return m_data ? m_data->m_offset : 0;
+}
+
+int STOFFInflateStream::seek(long offset, librevenge::RVNG_SEEK_TYPE seekType)
+{
+  if (!m_data) return -1;
+  if (seekType == librevenge::RVNG_SEEK_CUR)
+    m_data->m_offset += offset;
+  else if (seekType == librevenge::RVNG_SEEK_SET)
+    m_data->m_offset = offset;
+  else if (seekType == librevenge::RVNG_SEEK_END)
+    m_data->m_offset = offset+m_data->m_size;
+
+  if (m_data->m_offset < 0) {
+    m_data->m_offset = 0;
+    return -1;
+  }
+  if (m_data->m_offset > m_data->m_size) {
+    m_data->m_offset = m_data->m_size;
+    return -1;
+  }
+
+  return 0;
+}
+
+bool STOFFInflateStream::isEnd()
+{
+  return !m_data || m_data->m_offset >= m_data->m_size;
+}
+
+bool STOFFInflateStream::isStructured()
+{
+  return false;
+}
+
+unsigned STOFFInflateStream::subStreamCount()
+{
+  return 0;
+}
+
+const char *STOFFInflateStream::subStreamName(unsigned)
+{
+  return nullptr;
+}
+
+bool STOFFInflateStream::existsSubStream(const char *)
+{
+  return false;
+}
+
+librevenge::RVNGInputStream *STOFFInflateStream::getSubStreamById(unsigned)
+{
+  return nullptr;
+}
+
+librevenge::RVNGInputStream *STOFFInflateStream::getSubStreamByName(const char *)
+{
+  return nullptr;
+}
+
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
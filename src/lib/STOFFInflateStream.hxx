@@ -0,0 +1,113 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifndef STOFF_INFLATE_STREAM_HXX
+#define STOFF_INFLATE_STREAM_HXX
+
+#include <librevenge-stream/librevenge-stream.h>
+
+#include "libstaroffice_internal.hxx"
+
+class STOFFInflateStreamPrivate;
+
+/** internal class used to create a RVNGInputStream which decompresses
+    a zlib zone stored in another stream.
+
+    The data are decompressed when they are read, only a small window of
+    the decompressed data is kept in memory.
+
+    \note a backward seek outside this window restarts the decompression
+    from the beginning of the zone. This class does not implement the
+    isStructured's protocol, ie. it only returns false.
+ */
+class STOFFInflateStream final: public librevenge::RVNGInputStream
+{
+public:
+  /** constructor: the compressed data are stored in input between beginPos and endPos,
+      uncompressedSize is the size of the decompressed data */
+  STOFFInflateStream(STOFFInputStreamPtr input, long beginPos, long endPos, unsigned long uncompressedSize);
+  //! destructor
+  ~STOFFInflateStream() final;
+
+  //! returns true if the decompression can be initialized
+  bool isValid() const;
+  /**! reads numbytes data.
+
+   * \return a pointer to the read elements
+   */
+  const unsigned char *read(unsigned long numBytes, unsigned long &numBytesRead) final;
+  //! returns actual offset position
+  long tell() final;
+  /*! \brief seeks to a offset position, from actual, beginning or ending position
+   * \return 0 if ok
+   */
+  int seek(long offset, librevenge::RVNG_SEEK_TYPE seekType) final;
+  //! returns true if we are at the end of the section/file
+  bool isEnd() final;
+
+  /** returns true if the stream is ole
+
+   \sa returns always false*/
+  bool isStructured() final;
+  /** returns the number of sub streams.
+
+   \sa returns always 0*/
+  unsigned subStreamCount() final;
+  /** returns the ith sub streams name
+
+   \sa returns always 0*/
+  const char *subStreamName(unsigned) final;
+  /** returns true if a substream with name exists
+
+   \sa returns always false*/
+  bool existsSubStream(const char *name) final;
+  /** return a new stream for a ole zone
+
+   \sa returns always 0 */
+  librevenge::RVNGInputStream *getSubStreamByName(const char *name) final;
+  /** return a new stream for a ole zone
+
+   \sa returns always 0 */
+  librevenge::RVNGInputStream *getSubStreamById(unsigned) final;
+
+private:
+  /// the stream data
+  STOFFInflateStreamPrivate *m_data;
+  STOFFInflateStream(const STOFFInflateStream &); // copy is not allowed
+  STOFFInflateStream &operator=(const STOFFInflateStream &); // assignment is not allowed
+};
+
+#endif
+
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
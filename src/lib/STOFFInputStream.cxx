@@ -48,6 +48,7 @@ STOFFInputStream::STOFFInputStream(std::shared_ptr<librevenge::RVNGInputStream>
   : m_stream(inp)
   , m_streamSize(0)
   , m_inverseRead(inverted)
+  , m_subStreamMutex()
 {
   updateStreamSize();
 }
@@ -56,6 +57,7 @@ STOFFInputStream::STOFFInputStream(librevenge::RVNGInputStream *inp, bool invert
   : m_stream()
   , m_streamSize(0)
   , m_inverseRead(inverted)
+  , m_subStreamMutex()
 {
   if (!inp) return;
 
@@ -531,6 +533,7 @@ std::shared_ptr<STOFFInputStream> STOFFInputStream::getSubStreamByName(std::stri
     return empty;
   }
 
+  std::lock_guard<std::mutex> lock(m_subStreamMutex);
   long actPos = tell();
   seek(0, librevenge::RVNG_SEEK_SET);
   std::shared_ptr<librevenge::RVNGInputStream> res(m_stream->getSubStreamByName(name.c_str()));
@@ -551,6 +554,7 @@ std::shared_ptr<STOFFInputStream> STOFFInputStream::getSubStreamById(unsigned id
     return empty;
   }
 
+  std::lock_guard<std::mutex> lock(m_subStreamMutex);
   long actPos = tell();
   seek(0, librevenge::RVNG_SEEK_SET);
   std::shared_ptr<librevenge::RVNGInputStream> res(m_stream->getSubStreamById(id));
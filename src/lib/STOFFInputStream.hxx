@@ -34,6 +34,7 @@
 #ifndef STOFF_INPUT_STREAM_H
 #define STOFF_INPUT_STREAM_H
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -213,7 +214,9 @@ public:
   //! returns the name of the i^th substream
   std::string subStreamName(unsigned id);
 
-  //! return a new stream for a ole zone
+  /** return a new stream for a ole zone
+
+      \note this function can be called by different threads, see StarFileManager::BackgroundReader */
   std::shared_ptr<STOFFInputStream> getSubStreamByName(std::string const &name);
   //! return a new stream for a ole zone
   std::shared_ptr<STOFFInputStream> getSubStreamById(unsigned id);
@@ -246,6 +249,8 @@ protected:
 
   //! big or normal endian
   bool m_inverseRead;
+  //! a mutex used to protect the substream extraction
+  std::mutex m_subStreamMutex;
 };
 
 #endif
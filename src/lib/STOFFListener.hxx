@@ -110,16 +110,25 @@ public:
   /** adds an unicode character.
    *  By convention if \a character=0xfffd(undef), no character is added */
   virtual void insertUnicode(uint32_t character)=0;
+  /** adds a run of unicode characters.
+   *  By convention the undef characters(0xfffd) are skipped */
+  virtual void insertUnicodeSpan(uint32_t const *characters, size_t numCharacters)=0;
   /** try to insert a list of unicode character */
   void insertUnicodeList(std::vector<uint32_t> const &list)
   {
     if (list.empty() || !canWriteText())
       return;
-    for (unsigned int i : list) {
+    size_t first=0;
+    for (size_t c=0; c<list.size(); ++c) {
+      uint32_t i=list[c];
+      if (i!=0x9 && i!=0xa && i!=0xc)
+        continue;
+      if (c>first) insertUnicodeSpan(&list[first], c-first);
+      first=c+1;
       if (i==0x9) insertTab();
-      else if (i==0xa || i==0xc) insertEOL(); // checkme: use softBreak ?
-      else insertUnicode(i);
+      else insertEOL(); // checkme: use softBreak ?
     }
+    if (list.size()>first) insertUnicodeSpan(&list[first], list.size()-first);
   }
   //! adds a unicode string
   virtual void insertUnicodeString(librevenge::RVNGString const &str)=0;
@@ -78,6 +78,7 @@
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -98,6 +99,8 @@ struct State {
   State()
     : m_oleList()
     , m_unknownOLEs()
+    , m_pictureMutex()
+    , m_nameToPictureMap()
     , m_mapCls()
   {
   }
@@ -113,6 +116,10 @@ struct State {
   std::vector<std::shared_ptr<STOFFOLEParser::OleDirectory> > m_oleList;
   //! list of ole which can not be parsed
   std::vector<std::string> m_unknownOLEs;
+  //! the mutex used to protect the picture map
+  std::mutex m_pictureMutex;
+  //! a map name to decoded picture, see storePicture
+  std::map<std::string, STOFFEmbeddedObject> m_nameToPictureMap;
 protected:
   /** initialise a map CLSId <-> name */
   void initCLSMap();
@@ -247,6 +254,31 @@ std::vector<std::shared_ptr<STOFFOLEParser::OleDirectory> > &STOFFOLEParser::get
   return m_state->m_oleList;
 }
 
+void STOFFOLEParser::resetDirectoryTasks()
+{
+  for (auto &dir : m_state->m_oleList) {
+    if (dir)
+      std::atomic_store(&dir->m_task, std::shared_ptr<StarFileManagerInternal::OLEDirectoryTask>());
+  }
+}
+
+bool STOFFOLEParser::getPicture(std::string const &name, STOFFEmbeddedObject &picture) const
+{
+  std::lock_guard<std::mutex> lock(m_state->m_pictureMutex);
+  auto it=m_state->m_nameToPictureMap.find(name);
+  if (it==m_state->m_nameToPictureMap.end())
+    return false;
+  // the binary data are shared, so this copy is cheap
+  picture=it->second;
+  return true;
+}
+
+void STOFFOLEParser::storePicture(std::string const &name, STOFFEmbeddedObject const &picture)
+{
+  std::lock_guard<std::mutex> lock(m_state->m_pictureMutex);
+  m_state->m_nameToPictureMap[name]=picture;
+}
+
 std::shared_ptr<STOFFOLEParser::OleDirectory> STOFFOLEParser::getDirectory(std::string const &dir)
 {
   std::string dirName(dir);
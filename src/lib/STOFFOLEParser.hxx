@@ -63,6 +63,7 @@
 #ifndef STOFF_OLE_PARSER_H
 #define STOFF_OLE_PARSER_H
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -80,6 +81,11 @@ namespace STOFFOLEParserInternal
 struct State;
 }
 
+namespace StarFileManagerInternal
+{
+struct OLEDirectoryTask;
+}
+
 /** \brief a class used to parse some basic oles
     Tries to read the different ole parts and stores their contents in form of picture.
  */
@@ -102,6 +108,17 @@ public:
   std::vector<std::shared_ptr<OleDirectory> > &getDirectoryList();
   //! returns a OleDirectory corresponding to a dir if found
   std::shared_ptr<OleDirectory> getDirectory(std::string const &dir);
+  /** forgets the results of StarFileManager::readOLEDirectory stored in the directories
+
+      \note must be called by the parser's owner when the parsing is finished: a stored object
+      keeps a reference to this parser */
+  void resetDirectoryTasks();
+  //! returns true and the picture if a picture called name has already been decoded, see storePicture
+  bool getPicture(std::string const &name, STOFFEmbeddedObject &picture) const;
+  /** stores a decoded picture, so that the next references to name do not decode it again
+
+      \note an empty picture can be stored to remember that the decoding has failed */
+  void storePicture(std::string const &name, STOFFEmbeddedObject const &picture);
   //! returns the main compobj program name
   bool getCompObjName(STOFFInputStreamPtr fileInput, std::string &programName);
 
@@ -193,7 +210,8 @@ public:
       , m_clsName("")
       , m_clipName("")
       , m_parsed(false)
-      , m_inUse(false) { }
+      , m_inUse(false)
+      , m_task() { }
     //! add a new base file
     void addNewBase(std::string const &base)
     {
@@ -227,9 +245,13 @@ public:
     /** the compobj clipname */
     std::string m_clipName;
     /** a flag to know if the directory is parsed or not */
-    bool m_parsed;
-    /** a flag to know if the directory is currently used */
-    mutable bool m_inUse;
+    std::atomic<bool> m_parsed;
+    /** a flag to know if the directory is currently used (by any thread) */
+    mutable std::atomic<bool> m_inUse;
+    /** the task which reads the directory and keeps its result, see StarFileManager::readOLEDirectory
+
+        \note it must be accessed with std::atomic_load and std::atomic_compare_exchange_strong */
+    std::shared_ptr<StarFileManagerInternal::OLEDirectoryTask> m_task;
   };
 
 protected:
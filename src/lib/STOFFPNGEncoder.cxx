@@ -0,0 +1,250 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#ifdef USE_ZIP
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "STOFFPNGEncoder.hxx"
+
+STOFFPNGEncoder::STOFFPNGEncoder(librevenge::RVNGBinaryData &data)
+  : m_data(data)
+  , m_stream()
+  , m_isOpened(false)
+  , m_rowSize(0)
+  , m_bytesPerPixel(1)
+  , m_useFilters(false)
+  , m_previousRow()
+  , m_filteredRows()
+  , m_buffer()
+{
+}
+
+STOFFPNGEncoder::~STOFFPNGEncoder()
+{
+  if (m_isOpened)
+    (void)deflateEnd(&m_stream);
+}
+
+bool STOFFPNGEncoder::begin(uint32_t width, uint32_t height, int colorType, int bitDepth, std::vector<STOFFColor> const &palette)
+{
+  int const numChannels=colorType==2 ? 3 : colorType==6 ? 4 : 1;
+  if (m_isOpened || !width || !height || width>0x7fffffff || height>0x7fffffff ||
+      (colorType!=3 && bitDepth!=8) || (colorType==3 && (palette.empty() || palette.size()>size_t(1<<bitDepth)))) {
+    STOFF_DEBUG_MSG(("STOFFPNGEncoder::begin: called with bad arguments\n"));
+    return false;
+  }
+  uint64_t rowSize=(uint64_t(width)*uint64_t(numChannels*bitDepth)+7)/8;
+  if (rowSize>0x7fffffff) {
+    STOFF_DEBUG_MSG(("STOFFPNGEncoder::begin: the rows are too big\n"));
+    return false;
+  }
+  m_rowSize=size_t(rowSize);
+  m_bytesPerPixel=size_t(numChannels);
+  // the filters are useless for palette pictures, see the PNG specification
+  m_useFilters=colorType!=3;
+  m_stream.zalloc = Z_NULL;
+  m_stream.zfree = Z_NULL;
+  m_stream.opaque = Z_NULL;
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+  int ret = deflateInit(&m_stream, Z_DEFAULT_COMPRESSION);
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#endif
+  if (ret != Z_OK) {
+    STOFF_DEBUG_MSG(("STOFFPNGEncoder::begin: can not init stream\n"));
+    return false;
+  }
+  m_isOpened=true;
+  m_buffer.resize(65536);
+  m_stream.next_out=&m_buffer[0];
+  m_stream.avail_out=uInt(m_buffer.size());
+
+  static unsigned char const signature[]= {0x89, 'P', 'N', 'G', 0xd, 0xa, 0x1a, 0xa};
+  m_data.append(signature, sizeof(signature));
+  unsigned char header[13];
+  writeULong(header, width);
+  writeULong(header+4, height);
+  header[8]=static_cast<unsigned char>(bitDepth);
+  header[9]=static_cast<unsigned char>(colorType);
+  header[10]=header[11]=header[12]=0; // deflate, adaptive filtering, no interlace
+  addChunk("IHDR", header, sizeof(header));
+  if (colorType==3) {
+    std::vector<unsigned char> colors;
+    colors.reserve(3*palette.size());
+    for (auto const &c : palette) {
+      uint32_t col=c.value();
+      for (int comp=0, depl=16; comp<3; ++comp, depl-=8)
+        colors.push_back(static_cast<unsigned char>((col>>depl)&0xFF));
+    }
+    addChunk("PLTE", &colors[0], colors.size());
+  }
+  m_previousRow.resize(m_rowSize, 0);
+  m_filteredRows.resize(m_useFilters ? 5*(m_rowSize+1) : m_rowSize+1);
+  return true;
+}
+
+bool STOFFPNGEncoder::addRow(unsigned char const *row)
+{
+  if (!m_isOpened || !row) return false;
+  unsigned char const *res=&m_filteredRows[0];
+  if (!m_useFilters) {
+    m_filteredRows[0]=0;
+    std::memcpy(&m_filteredRows[1], row, m_rowSize);
+  }
+  else {
+    // try each filter and keep the one with the minimum sum of absolute differences
+    unsigned long bestSum=std::numeric_limits<unsigned long>::max();
+    for (int filter=0; filter<5; ++filter) {
+      unsigned char *wPtr=&m_filteredRows[size_t(filter)*(m_rowSize+1)];
+      *(wPtr++)=static_cast<unsigned char>(filter);
+      unsigned long sum=0;
+      for (size_t i=0; i<m_rowSize; ++i) {
+        int const left=i>=m_bytesPerPixel ? row[i-m_bytesPerPixel] : 0;
+        int const up=m_previousRow[i];
+        int const upLeft=i>=m_bytesPerPixel ? m_previousRow[i-m_bytesPerPixel] : 0;
+        int pred=0;
+        switch (filter) {
+        case 1:
+          pred=left;
+          break;
+        case 2:
+          pred=up;
+          break;
+        case 3:
+          pred=(left+up)/2;
+          break;
+        case 4: {
+          int const p=left+up-upLeft;
+          int const pa=std::abs(p-left), pb=std::abs(p-up), pc=std::abs(p-upLeft);
+          pred=(pa<=pb && pa<=pc) ? left : pb<=pc ? up : upLeft;
+          break;
+        }
+        default:
+          break;
+        }
+        auto const val=static_cast<unsigned char>(row[i]-pred);
+        wPtr[i]=val;
+        sum+=val<128 ? val : 256-val;
+      }
+      if (sum<bestSum) {
+        bestSum=sum;
+        res=wPtr-1;
+      }
+    }
+    std::memcpy(&m_previousRow[0], row, m_rowSize);
+  }
+  return compress(res, m_rowSize+1, Z_NO_FLUSH);
+}
+
+bool STOFFPNGEncoder::end()
+{
+  if (!m_isOpened) return false;
+  bool ok=compress(nullptr, 0, Z_FINISH);
+  (void)deflateEnd(&m_stream);
+  m_isOpened=false;
+  if (!ok) {
+    STOFF_DEBUG_MSG(("STOFFPNGEncoder::end: can not compress the data\n"));
+    return false;
+  }
+  addChunk("IEND", nullptr, 0);
+  return true;
+}
+
+void STOFFPNGEncoder::writeULong(unsigned char *ptr, uint32_t value)
+{
+  for (int i=0, depl=24; i<4; ++i, depl-=8)
+    ptr[i]=static_cast<unsigned char>((value>>depl)&0xFF);
+}
+
+void STOFFPNGEncoder::addChunk(char const *type, unsigned char const *data, size_t length)
+{
+  unsigned char buffer[4];
+  writeULong(buffer, uint32_t(length));
+  m_data.append(buffer, 4);
+  auto const *typePtr=reinterpret_cast<unsigned char const *>(type);
+  m_data.append(typePtr, 4);
+  uLong crc=crc32(0L, nullptr, 0);
+  crc=crc32(crc, typePtr, 4);
+  if (length) {
+    m_data.append(data, length);
+    crc=crc32(crc, data, uInt(length));
+  }
+  writeULong(buffer, uint32_t(crc));
+  m_data.append(buffer, 4);
+}
+
+void STOFFPNGEncoder::flushBuffer()
+{
+  size_t const produced=m_buffer.size()-size_t(m_stream.avail_out);
+  if (produced)
+    addChunk("IDAT", &m_buffer[0], produced);
+  m_stream.next_out=&m_buffer[0];
+  m_stream.avail_out=uInt(m_buffer.size());
+}
+
+bool STOFFPNGEncoder::compress(unsigned char const *data, size_t length, int flush)
+{
+  m_stream.next_in=const_cast<Bytef *>(data);
+  m_stream.avail_in=uInt(length);
+  while (true) {
+    int ret=deflate(&m_stream, flush);
+    if (ret==Z_STREAM_ERROR)
+      return false;
+    if (m_stream.avail_out==0) {
+      flushBuffer();
+      continue;
+    }
+    if (flush!=Z_FINISH) // all the input is consumed
+      return true;
+    if (ret==Z_STREAM_END) {
+      flushBuffer();
+      return true;
+    }
+    if (ret!=Z_OK)
+      return false;
+  }
+}
+#endif
+
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
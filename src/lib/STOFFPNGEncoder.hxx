@@ -0,0 +1,105 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifndef STOFF_PNG_ENCODER_HXX
+#define STOFF_PNG_ENCODER_HXX
+
+#ifdef USE_ZIP
+
+#include <vector>
+
+#include <zlib.h>
+
+#include <librevenge/librevenge.h>
+
+#include "libstaroffice_internal.hxx"
+
+/** internal class used to create a PNG picture, the rows are compressed
+    when they are added.
+
+    Each row of a RGB(A) picture is stored with the adaptive filter which
+    gives the minimum sum of absolute differences, the compressed data are
+    stored in IDAT chunks of at most 64k.
+ */
+class STOFFPNGEncoder
+{
+public:
+  //! constructor: the picture is appended to data
+  explicit STOFFPNGEncoder(librevenge::RVNGBinaryData &data);
+  //! destructor
+  ~STOFFPNGEncoder();
+  /** starts the picture
+
+      \note colorType must be 2(rgb), 3(palette) or 6(rgba), bitDepth must be 8 for the rgb(a) pictures */
+  bool begin(uint32_t width, uint32_t height, int colorType, int bitDepth, std::vector<STOFFColor> const &palette);
+  //! adds the next row, the row must contain the packed pixels
+  bool addRow(unsigned char const *row);
+  //! finishes the picture
+  bool end();
+protected:
+  //! writes a big endian 32 bits integer
+  static void writeULong(unsigned char *ptr, uint32_t value);
+  //! adds a chunk: length, type, data and crc
+  void addChunk(char const *type, unsigned char const *data, size_t length);
+  //! sends the compressed data stored in the buffer in a IDAT chunk
+  void flushBuffer();
+  //! compresses some data
+  bool compress(unsigned char const *data, size_t length, int flush);
+
+  //! the result
+  librevenge::RVNGBinaryData &m_data;
+  //! the zlib stream
+  z_stream m_stream;
+  //! a flag to know if the zlib stream is initialized
+  bool m_isOpened;
+  //! the row size (without the filter byte)
+  size_t m_rowSize;
+  //! the number of bytes by pixel
+  size_t m_bytesPerPixel;
+  //! a flag to know if we try to filter the rows
+  bool m_useFilters;
+  //! the previous row
+  std::vector<unsigned char> m_previousRow;
+  //! the rows created by the different filters
+  std::vector<unsigned char> m_filteredRows;
+  //! the compressed data buffer
+  std::vector<Bytef> m_buffer;
+private:
+  STOFFPNGEncoder(STOFFPNGEncoder const &) = delete;
+  STOFFPNGEncoder &operator=(STOFFPNGEncoder const &) = delete;
+};
+#endif
+
+#endif
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
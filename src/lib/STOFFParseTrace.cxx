@@ -0,0 +1,228 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include "STOFFInputStream.hxx"
+#include "STOFFResourceGovernor.hxx"
+
+#include "STOFFParseTrace.hxx"
+
+namespace libstoff
+{
+bool isParseTraceEnabled()
+{
+  auto governor=ResourceGovernor::get();
+  return governor && governor->getOptions().m_traceCallback;
+}
+
+double getParseTraceTime()
+{
+  std::chrono::duration<double> const time=std::chrono::steady_clock::now().time_since_epoch();
+  return time.count();
+}
+
+void sendParseTrace(std::string const &zone, std::string const &type, long offset, long length, int level, double duration)
+{
+  auto governor=ResourceGovernor::get();
+  if (!governor || !governor->getOptions().m_traceCallback) return;
+  STOFFDocument::ParseTraceRecord record;
+  record.m_zone=zone.c_str();
+  record.m_type=type.c_str();
+  record.m_offset=offset;
+  record.m_length=length;
+  record.m_level=level;
+  record.m_duration=duration;
+  record.m_note=nullptr;
+  governor->getOptions().m_traceCallback(record, governor->getOptions().m_traceData);
+}
+
+void sendParseTraceNote(std::string const &zone, long offset, char const *note)
+{
+  auto governor=ResourceGovernor::get();
+  if (!governor || !governor->getOptions().m_traceCallback || !note) return;
+  STOFFDocument::ParseTraceRecord record;
+  record.m_zone=zone.c_str();
+  record.m_type="note";
+  record.m_offset=offset;
+  record.m_length=0;
+  record.m_level=0;
+  record.m_duration=0;
+  record.m_note=note;
+  governor->getOptions().m_traceCallback(record, governor->getOptions().m_traceData);
+}
+
+//! the number of records read by the current thread
+static thread_local unsigned long s_numParseRecords=0;
+//! the number of large buffers created by the current thread
+static thread_local unsigned long s_numParseAllocations=0;
+//! the size of the large buffers created by the current thread
+static thread_local unsigned long s_numParseAllocatedBytes=0;
+
+/** the accumulated parse statistics */
+struct ParseStatistics {
+  //! the statistics of a zone or a reader function
+  struct Entry {
+    //! constructor
+    Entry()
+      : m_numCalls(0)
+      , m_duration(0)
+      , m_numBytes(0)
+      , m_numRecords(0)
+      , m_numAllocations(0)
+      , m_numAllocatedBytes(0)
+    {
+    }
+    //! the number of calls
+    unsigned long m_numCalls;
+    //! the total time
+    double m_duration;
+    //! the number of bytes read
+    unsigned long m_numBytes;
+    //! the number of records read
+    unsigned long m_numRecords;
+    //! the number of large buffers created
+    unsigned long m_numAllocations;
+    //! the size of the large buffers created
+    unsigned long m_numAllocatedBytes;
+  };
+  //! constructor
+  ParseStatistics()
+    : m_mutex()
+    , m_nameToEntryMap()
+  {
+  }
+  //! the mutex
+  std::mutex m_mutex;
+  //! a map name to statistics
+  std::map<std::string, Entry> m_nameToEntryMap;
+};
+
+//! returns the statistics of the parse done by the current thread (or null)
+static ParseStatistics *getCurrentParseStatistics()
+{
+  auto governor=ResourceGovernor::get();
+  return governor ? governor->getParseStatistics() : nullptr;
+}
+
+bool collectParseStatistics()
+{
+  return getCurrentParseStatistics()!=nullptr;
+}
+
+std::shared_ptr<ParseStatistics> createParseStatistics(bool collect)
+{
+  if (!collect)
+    return std::shared_ptr<ParseStatistics>();
+  return std::make_shared<ParseStatistics>();
+}
+
+void countParseRecord()
+{
+  if (getCurrentParseStatistics())
+    ++s_numParseRecords;
+}
+
+void countParseAllocation(unsigned long numBytes)
+{
+  if (!getCurrentParseStatistics()) return;
+  ++s_numParseAllocations;
+  s_numParseAllocatedBytes+=numBytes;
+}
+
+ParseCounters::ParseCounters(STOFFInputStream *input)
+  : m_time(getParseTraceTime())
+  , m_position(input ? input->tell() : 0)
+  , m_numRecords(s_numParseRecords)
+  , m_numAllocations(s_numParseAllocations)
+  , m_numAllocatedBytes(s_numParseAllocatedBytes)
+{
+}
+
+void addParseStatistic(std::string const &name, ParseCounters const &begin, STOFFInputStream *input)
+{
+  auto statistics=getCurrentParseStatistics();
+  if (!statistics) return;
+  ParseCounters const end(input);
+  std::lock_guard<std::mutex> lock(statistics->m_mutex);
+  auto &entry=statistics->m_nameToEntryMap[name];
+  ++entry.m_numCalls;
+  entry.m_duration+=end.m_time-begin.m_time;
+  if (input && end.m_position>begin.m_position) entry.m_numBytes+=static_cast<unsigned long>(end.m_position-begin.m_position);
+  entry.m_numRecords+=end.m_numRecords-begin.m_numRecords;
+  entry.m_numAllocations+=end.m_numAllocations-begin.m_numAllocations;
+  entry.m_numAllocatedBytes+=end.m_numAllocatedBytes-begin.m_numAllocatedBytes;
+}
+
+void sendParseStatistics(ParseStatistics &statistics, STOFFDocument::ParseStatisticsCallback callback, void *data)
+{
+  if (!callback) return;
+  std::map<std::string, ParseStatistics::Entry> nameToEntryMap;
+  {
+    std::lock_guard<std::mutex> lock(statistics.m_mutex);
+    nameToEntryMap=statistics.m_nameToEntryMap;
+  }
+  for (auto const &it : nameToEntryMap) {
+    STOFFDocument::ParseStatistic statistic;
+    statistic.m_name=it.first.c_str();
+    statistic.m_numCalls=it.second.m_numCalls;
+    statistic.m_duration=it.second.m_duration;
+    statistic.m_numBytes=it.second.m_numBytes;
+    statistic.m_numRecords=it.second.m_numRecords;
+    statistic.m_numAllocations=it.second.m_numAllocations;
+    statistic.m_numAllocatedBytes=it.second.m_numAllocatedBytes;
+    callback(statistic, data);
+  }
+}
+
+ParseStatisticsScope::ParseStatisticsScope(char const *name, STOFFInputStream *input)
+  : m_name(getCurrentParseStatistics() ? name : nullptr)
+  , m_input(input)
+  , m_begin(m_name ? input : nullptr)
+{
+}
+
+ParseStatisticsScope::~ParseStatisticsScope()
+{
+  if (!m_name) return;
+  try {
+    addParseStatistic(m_name, m_begin, m_input);
+  }
+  catch (...) {
+  }
+}
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -0,0 +1,126 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifndef STOFF_PARSE_TRACE
+#  define STOFF_PARSE_TRACE
+
+#include <memory>
+#include <string>
+
+#include <libstaroffice/libstaroffice.hxx>
+
+#include "libstaroffice_internal.hxx"
+
+/** the structured parse trace: when the options of the current parse
+    define a trace function, see STOFFDocument::ParseOptions, each record
+    read by a StarZone is reported with its zone, its type, its position
+    and its duration.
+
+    \note when no function is set, the readers only check the options of the current parse */
+namespace libstoff
+{
+//! returns true if the current parse has a parse trace callback
+bool isParseTraceEnabled();
+//! returns the current time in seconds, used to compute the record durations
+double getParseTraceTime();
+//! sends a record to the parse trace callback of the current parse (if it is set)
+void sendParseTrace(std::string const &zone, std::string const &type, long offset, long length, int level, double duration);
+//! sends a debug note to the parse trace callback of the current parse (if it is set)
+void sendParseTraceNote(std::string const &zone, long offset, char const *note);
+}
+
+/** the parse statistics: when the options of a parse define a statistics
+    function, the parse creates its statistics (kept by its resource governor,
+    so that they are shared with its background threads), then the time, the
+    bytes and the records used by each zone and by the main reader functions
+    are accumulated in them. When the parse is finished, they are sent to
+    the statistics function. */
+namespace libstoff
+{
+struct ParseStatistics;
+
+//! returns true if the current parse collects the parse statistics
+bool collectParseStatistics();
+//! creates the statistics of a new parse, returns null if the statistics are not collected
+std::shared_ptr<ParseStatistics> createParseStatistics(bool collect);
+//! increases the number of records read by the current thread (if the current parse collects the statistics)
+void countParseRecord();
+//! increases the number of large buffers created by the current thread (if the current parse collects the statistics)
+void countParseAllocation(unsigned long numBytes);
+
+/** the time, the input position and the counters of the current thread
+    when a zone or a reader function begins */
+struct ParseCounters {
+  //! constructor: the current values
+  explicit ParseCounters(STOFFInputStream *input);
+  //! the time
+  double m_time;
+  //! the input position
+  long m_position;
+  //! the number of records read by the thread
+  unsigned long m_numRecords;
+  //! the number of large buffers created by the thread
+  unsigned long m_numAllocations;
+  //! the size of the large buffers created by the thread
+  unsigned long m_numAllocatedBytes;
+};
+//! adds a call of a zone or of a reader function which has begun with begin and has read input to the statistics of the current parse
+void addParseStatistic(std::string const &name, ParseCounters const &begin, STOFFInputStream *input);
+//! calls callback for each zone and reader function of a parse, sorted by name
+void sendParseStatistics(ParseStatistics &statistics, STOFFDocument::ParseStatisticsCallback callback, void *data);
+
+/** a class used to add the time, the bytes and the records used by a
+    reader function to the parse statistics, for instance
+    \code libstoff::ParseStatisticsScope statistics("StarItemPool::read", zone.input().get()); \endcode */
+class ParseStatisticsScope
+{
+public:
+  //! constructor: given the function name and the input (can be null)
+  ParseStatisticsScope(char const *name, STOFFInputStream *input);
+  //! destructor: adds the function call to the statistics
+  ~ParseStatisticsScope();
+protected:
+  //! the function name, null if the statistics are not collected
+  char const *m_name;
+  //! the input
+  STOFFInputStream *m_input;
+  //! the counters at the beginning of the call
+  ParseCounters m_begin;
+private:
+  ParseStatisticsScope(ParseStatisticsScope const &) = delete;
+  ParseStatisticsScope &operator=(ParseStatisticsScope const &) = delete;
+};
+}
+#endif
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
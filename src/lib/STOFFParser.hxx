@@ -213,13 +213,37 @@ public:
   virtual void parse(librevenge::RVNGDrawingInterface *documentInterface);
   //! virtual function used to parse the input
   virtual void parse(librevenge::RVNGPresentationInterface *documentInterface);
+  //! sets the range of pages to read (1-based), 0 means no limit
+  void setPageRange(int firstPage, int lastPage)
+  {
+    m_pageRange[0]=firstPage>0 ? firstPage : 0;
+    m_pageRange[1]=lastPage>0 ? lastPage : 0;
+  }
 protected:
   //! constructor (protected)
-  STOFFGraphicParser(STOFFInputStreamPtr input, STOFFHeader *header) : STOFFParser(STOFFParserState::Graphic, input, header) {}
+  STOFFGraphicParser(STOFFInputStreamPtr input, STOFFHeader *header)
+    : STOFFParser(STOFFParserState::Graphic, input, header)
+    , m_pageRange{0,0}
+  {
+  }
   //! constructor using a state
-  explicit STOFFGraphicParser(STOFFParserStatePtr state) : STOFFParser(state) {}
+  explicit STOFFGraphicParser(STOFFParserStatePtr state)
+    : STOFFParser(state)
+    , m_pageRange{0,0}
+  {
+  }
   //! destructor
   ~STOFFGraphicParser() override;
+  //! returns the range of pages to read, returns false if all the pages must be read
+  bool getPageRange(int &firstPage, int &lastPage) const
+  {
+    firstPage=m_pageRange[0];
+    lastPage=m_pageRange[1];
+    return firstPage>0 || lastPage>0;
+  }
+private:
+  //! the range of pages to read: 0 means no limit
+  int m_pageRange[2];
 };
 
 /** virtual class which defines the ancestor of all spreadsheet zone parser */
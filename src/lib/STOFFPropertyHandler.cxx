@@ -30,14 +30,15 @@
 * in which case the provisions of the LGPLv2+ are applicable
 * instead of those above.
 */
-
 /* This header contains code specific to a small picture
  */
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <sstream>
-#include <string.h>
-
-#include <stack>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
 
 #include "libstaroffice_internal.hxx"
 
@@ -47,49 +48,121 @@
 
 #include "STOFFPropertyHandler.hxx"
 
+/** Internal: the structures of a STOFFPropertyHandler */
+namespace STOFFPropertyHandlerInternal
+{
+//! the header of the encoded data: a null byte, "STF" and the format version
+static unsigned char const s_header[]= {0, 'S', 'T', 'F', 1};
+
+//! the types of property which are stored with a typed tag
+enum PropertyType { P_Bool, P_Int, P_Double, P_Other };
+
+//! returns the type of a property
+PropertyType getPropertyType(librevenge::RVNGProperty const &prop)
+{
+  // librevenge does not export its property classes, so compare with properties created by the factory
+  static std::unique_ptr<librevenge::RVNGProperty const> const boolProp(librevenge::RVNGPropertyFactory::newBoolProp(false));
+  static std::unique_ptr<librevenge::RVNGProperty const> const intProp(librevenge::RVNGPropertyFactory::newIntProp(0));
+  static std::unique_ptr<librevenge::RVNGProperty const> const doubleProps[]= {
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newDoubleProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newInchProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newPercentProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newPointProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newTwipProp(0))
+  };
+  auto const &type=typeid(prop);
+  if (type==typeid(*boolProp)) return P_Bool;
+  if (type==typeid(*intProp)) return P_Int;
+  for (auto const &doubleProp : doubleProps) {
+    if (type==typeid(*doubleProp)) return P_Double;
+  }
+  return P_Other;
+}
+}
+
 ////////////////////////////////////////////////////
 //
 // STOFFPropertyHandlerEncoder
 //
 ////////////////////////////////////////////////////
 STOFFPropertyHandlerEncoder::STOFFPropertyHandlerEncoder()
-  : m_f(std::ios::in | std::ios::out | std::ios::binary)
+  : m_data(STOFFPropertyHandlerInternal::s_header, sizeof(STOFFPropertyHandlerInternal::s_header))
+  , m_keyToIdMap()
 {
 }
 
 void STOFFPropertyHandlerEncoder::insertElement(const char *psName)
 {
-  m_f << 'E';
-  writeString(psName);
+  m_data.append('E');
+  writeKey(psName);
 }
 
 void STOFFPropertyHandlerEncoder::insertElement
 (const char *psName, const librevenge::RVNGPropertyList &xPropList)
 {
-  m_f << 'S';
-  writeString(psName);
+  m_data.append('S');
+  writeKey(psName);
   writePropertyList(xPropList);
 }
 
 void STOFFPropertyHandlerEncoder::characters(librevenge::RVNGString const &sCharacters)
 {
   if (sCharacters.len()==0) return;
-  m_f << 'T';
+  m_data.append('T');
   writeString(sCharacters);
 }
 
+void STOFFPropertyHandlerEncoder::writeULong(unsigned long val)
+{
+  unsigned char buffer[10];
+  unsigned long len=0;
+  while (val>=0x80) {
+    buffer[len++]=static_cast<unsigned char>((val&0x7F)|0x80);
+    val>>=7;
+  }
+  buffer[len++]=static_cast<unsigned char>(val);
+  m_data.append(buffer, len);
+}
+
+void STOFFPropertyHandlerEncoder::writeLong(long val)
+{
+  writeULong(val<0 ? ((static_cast<unsigned long>(-(val+1)))<<1)|1 : static_cast<unsigned long>(val)<<1);
+}
+
+void STOFFPropertyHandlerEncoder::writeDouble(double val)
+{
+  uint64_t value;
+  static_assert(sizeof(value)==sizeof(val), "unexpected double size");
+  std::memcpy(&value, &val, sizeof(value));
+  unsigned char buffer[8];
+  for (auto &c : buffer) {
+    c=static_cast<unsigned char>(value&0xFF);
+    value>>=8;
+  }
+  m_data.append(buffer, 8);
+}
+
 void STOFFPropertyHandlerEncoder::writeString(const librevenge::RVNGString &string)
 {
   unsigned long sz = string.size()+1;
-  writeLong(long(sz));
-  m_f.write(string.cstr(), int(sz));
+  writeULong(sz);
+  m_data.append(reinterpret_cast<unsigned char const *>(string.cstr()), sz);
 }
 
-void STOFFPropertyHandlerEncoder::writeLong(long val)
+void STOFFPropertyHandlerEncoder::writeKey(const char *key)
 {
-  auto value=static_cast<int32_t>(val);
-  unsigned char const allValue[]= {static_cast<unsigned char>(value&0xFF), static_cast<unsigned char>((value>>8)&0xFF), static_cast<unsigned char>((value>>16)&0xFF), static_cast<unsigned char>((value>>24)&0xFF)};
-  m_f.write(reinterpret_cast<const char *>(allValue), 4);
+  if (!key) key="";
+  auto it=m_keyToIdMap.find(key);
+  if (it!=m_keyToIdMap.end()) {
+    writeULong(it->second+1);
+    return;
+  }
+  auto id=static_cast<unsigned long>(m_keyToIdMap.size());
+  m_keyToIdMap.insert(std::make_pair(std::string(key), id));
+  writeULong(0);
+  size_t len=strlen(key);
+  writeULong(static_cast<unsigned long>(len));
+  m_data.append(reinterpret_cast<unsigned char const *>(key), static_cast<unsigned long>(len));
 }
 
 void STOFFPropertyHandlerEncoder::writeProperty(const char *key, const librevenge::RVNGProperty &prop)
@@ -98,42 +171,67 @@ void STOFFPropertyHandlerEncoder::writeProperty(const char *key, const libreveng
     STOFF_DEBUG_MSG(("STOFFPropertyHandlerEncoder::writeProperty: key is NULL\n"));
     return;
   }
-  writeString(key);
+  writeKey(key);
+  // only use a typed tag if the property was created with this type: a string property
+  // whose value is "true" or "12" must stay a string
+  switch (STOFFPropertyHandlerInternal::getPropertyType(prop)) {
+  case STOFFPropertyHandlerInternal::P_Bool:
+    m_data.append('b');
+    m_data.append(static_cast<unsigned char>(prop.getStr()=="true" ? 1 : 0));
+    return;
+  case STOFFPropertyHandlerInternal::P_Int:
+    m_data.append('i');
+    writeLong(long(prop.getInt()));
+    return;
+  case STOFFPropertyHandlerInternal::P_Double: {
+    auto unit=prop.getUnit();
+    if (unit>librevenge::RVNG_GENERIC) break;
+    m_data.append('d');
+    m_data.append(static_cast<unsigned char>(unit));
+    writeDouble(prop.getDouble());
+    return;
+  }
+  case STOFFPropertyHandlerInternal::P_Other:
+  default:
+    break;
+  }
+  m_data.append('s');
   writeString(prop.getStr());
 }
 
 void STOFFPropertyHandlerEncoder::writePropertyList(const librevenge::RVNGPropertyList &xPropList)
 {
   librevenge::RVNGPropertyList::Iter i(xPropList);
-  long numElt = 0;
+  unsigned long numElt = 0;
   for (i.rewind(); i.next();) numElt++;
-  writeLong(numElt);
+  writeULong(numElt);
   for (i.rewind(); i.next();) {
     auto const *child=xPropList.child(i.key());
     if (!child) {
-      m_f << 'p';
       writeProperty(i.key(),*i());
       continue;
     }
-    m_f << 'v';
-    writeString(i.key());
+    writeKey(i.key());
+    m_data.append('v');
     writePropertyListVector(*child);
   }
 }
 
 void STOFFPropertyHandlerEncoder::writePropertyListVector(const librevenge::RVNGPropertyListVector &vect)
 {
-  writeLong(long(vect.count()));
+  writeULong(vect.count());
   for (unsigned long i=0; i < vect.count(); i++)
     writePropertyList(vect[i]);
 }
 
 bool STOFFPropertyHandlerEncoder::getData(librevenge::RVNGBinaryData &data)
 {
-  data.clear();
-  std::string d=m_f.str();
-  if (d.length() == 0) return false;
-  data.append(reinterpret_cast<const unsigned char *>(d.c_str()), d.length());
+  if (m_data.size() <= sizeof(STOFFPropertyHandlerInternal::s_header)) {
+    data.clear();
+    return false;
+  }
+  // librevenge::RVNGBinaryData shares its buffer, so this does not copy the data
+  data=m_data;
   return true;
 }
 
@@ -145,36 +243,41 @@ class STOFFPropertyHandlerDecoder
 {
 public:
   //! constructor given a STOFFPropertyHandler
-  explicit STOFFPropertyHandlerDecoder(STOFFPropertyHandler *hdl=nullptr):m_handler(hdl) {}
+  explicit STOFFPropertyHandlerDecoder(STOFFPropertyHandler *hdl=nullptr)
+    : m_handler(hdl)
+    , m_pos(nullptr)
+    , m_end(nullptr)
+    , m_keyList()
+  {
+  }
 
   //! tries to read the data
   bool readData(librevenge::RVNGBinaryData const &encoded)
   {
     try {
-      auto *inp = const_cast<librevenge::RVNGInputStream *>(encoded.getDataStream());
-      if (!inp) return false;
-
-      while (!inp->isEnd()) {
-        unsigned const char *c;
-        unsigned long numRead;
-
-        c = inp->read(1,numRead);
-        if (!c || numRead != 1) {
-          STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder: can not read data type \n"));
-          return false;
-        }
-        switch (*c) {
+      m_pos=encoded.getDataBuffer();
+      m_end=m_pos ? m_pos+encoded.size() : nullptr;
+      m_keyList.clear();
+      size_t const headerSize=sizeof(STOFFPropertyHandlerInternal::s_header);
+      if (!m_pos || encoded.size()<headerSize || std::memcmp(m_pos, STOFFPropertyHandlerInternal::s_header, headerSize)!=0) {
+        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder: unknown data format\n"));
+        return false;
+      }
+      m_pos+=headerSize;
+      while (m_pos<m_end) {
+        unsigned char c=*(m_pos++);
+        switch (c) {
         case 'E':
-          if (!readInsertElement(*inp)) return false;
+          if (!readInsertElement()) return false;
           break;
         case 'S':
-          if (!readInsertElementWithList(*inp)) return false;
+          if (!readInsertElementWithList()) return false;
           break;
         case 'T':
-          if (!readCharacters(*inp)) return false;
+          if (!readCharacters()) return false;
           break;
         default:
-          STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder: unknown type='%c' \n", *c));
+          STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder: unknown type='%c' \n", char(c)));
           return false;
         }
       }
@@ -187,45 +290,45 @@ public:
 
 protected:
   //! reads an simple element
-  bool readInsertElement(librevenge::RVNGInputStream &input)
+  bool readInsertElement()
   {
-    librevenge::RVNGString s;
-    if (!readString(input, s)) return false;
+    size_t id;
+    if (!readKey(id)) return false;
 
-    if (s.empty()) {
+    if (m_keyList[id].empty()) {
       STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readInsertElement find empty tag\n"));
       return false;
     }
-    if (m_handler) m_handler->insertElement(s.cstr());
+    if (m_handler) m_handler->insertElement(m_keyList[id].c_str());
     return true;
   }
 
   //! reads an element with a property list
-  bool readInsertElementWithList(librevenge::RVNGInputStream &input)
+  bool readInsertElementWithList()
   {
-    librevenge::RVNGString s;
-    if (!readString(input, s)) return false;
+    size_t id;
+    if (!readKey(id)) return false;
 
-    if (s.empty()) {
+    if (m_keyList[id].empty()) {
       STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readInsertElementWithProperty: find empty tag\n"));
       return false;
     }
     librevenge::RVNGPropertyList lists;
-    if (!readPropertyList(input, lists)) {
+    if (!readPropertyList(lists)) {
       STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readInsertElementWithProperty: can not read propertyList for tag %s\n",
-                       s.cstr()));
+                       m_keyList[id].c_str()));
       return false;
     }
 
-    if (m_handler) m_handler->insertElement(s.cstr(), lists);
+    if (m_handler) m_handler->insertElement(m_keyList[id].c_str(), lists);
     return true;
   }
 
   //! reads a set of characters
-  bool readCharacters(librevenge::RVNGInputStream &input)
+  bool readCharacters()
   {
     librevenge::RVNGString s;
-    if (!readString(input, s)) return false;
+    if (!readString(s)) return false;
     if (!s.size()) return true;
     if (m_handler) m_handler->characters(s);
     return true;
@@ -236,110 +339,170 @@ protected:
   //
 
   //! low level: reads a property vector: number of properties list followed by list of properties list
-  bool readPropertyListVector(librevenge::RVNGInputStream &input, librevenge::RVNGPropertyListVector &vect)
+  bool readPropertyListVector(librevenge::RVNGPropertyListVector &vect)
   {
-    long numElt;
-    if (!readLong(input, numElt)) return false;
+    unsigned long numElt;
+    if (!readULong(numElt)) return false;
 
-    if (numElt < 0) {
-      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyListVector: can not read numElt=%ld\n",
+    // each list needs at least one byte
+    if (numElt > static_cast<unsigned long>(m_end-m_pos)) {
+      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyListVector: can not read numElt=%lu\n",
                        numElt));
       return false;
     }
-    for (long i = 0; i < numElt; i++) {
+    for (unsigned long i = 0; i < numElt; i++) {
       librevenge::RVNGPropertyList lists;
-      if (readPropertyList(input, lists)) {
+      if (readPropertyList(lists)) {
         vect.append(lists);
         continue;
       }
-      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyListVector: can not read property list %ld\n", i));
+      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyListVector: can not read property list %lu\n", i));
       return false;
     }
     return true;
   }
 
   //! low level: reads a property list: number of properties followed by list of properties
-  bool readPropertyList(librevenge::RVNGInputStream &input, librevenge::RVNGPropertyList &lists)
+  bool readPropertyList(librevenge::RVNGPropertyList &lists)
   {
-    long numElt;
-    if (!readLong(input, numElt)) return false;
+    unsigned long numElt;
+    if (!readULong(numElt)) return false;
 
-    if (numElt < 0) {
-      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyList: can not read numElt=%ld\n",
+    // each property needs at least two bytes
+    if (numElt > static_cast<unsigned long>(m_end-m_pos)/2) {
+      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyList: can not read numElt=%lu\n",
                        numElt));
       return false;
     }
-    for (long i = 0; i < numElt; i++) {
-      unsigned const char *c;
-      unsigned long numRead;
-      c = input.read(1,numRead);
-      if (!c || numRead != 1) {
-        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder:readPropertyList can not read data type for child %ld\n", i));
+    for (unsigned long i = 0; i < numElt; i++) {
+      size_t id;
+      if (!readKey(id) || m_keyList[id].empty() || m_pos>=m_end) {
+        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder:readPropertyList can not read the key of child %lu\n", i));
         return false;
       }
-      switch (*c) {
-      case 'p':
-        if (readProperty(input, lists)) break;
-        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyList: can not read property %ld\n", i));
-        return false;
+      char const *key=m_keyList[id].c_str();
+      unsigned char c=*(m_pos++);
+      switch (c) {
+      case 's': {
+        librevenge::RVNGString val;
+        if (!readString(val)) break;
+        lists.insert(key, val);
+        continue;
+      }
+      case 'i': {
+        long val;
+        if (!readLong(val)) break;
+        lists.insert(key, int(val));
+        continue;
+      }
+      case 'b':
+        if (m_pos>=m_end) break;
+        lists.insert(key, *(m_pos++)!=0);
+        continue;
+      case 'd': {
+        double val;
+        if (m_pos>=m_end) break;
+        unsigned char unit=*(m_pos++);
+        if (unit>librevenge::RVNG_GENERIC || !readDouble(val)) break;
+        lists.insert(key, val, librevenge::RVNGUnit(unit));
+        continue;
+      }
       case 'v': {
-        librevenge::RVNGString key;
         librevenge::RVNGPropertyListVector vect;
-        if (!readString(input, key) || key.empty() || !readPropertyListVector(input, vect)) {
-          STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyList: can not read propertyVector for child %ld\n", i));
+        if (!readPropertyListVector(vect)) {
+          STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyList: can not read propertyVector for child %lu\n", i));
           return false;
         }
-        lists.insert(key.cstr(),vect);
-        break;
+        lists.insert(key,vect);
+        continue;
       }
       default:
-        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder:readPropertyList find unknown type %c for child %ld\n", char(*c), i));
+        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder:readPropertyList find unknown type %c for child %lu\n", char(c), i));
         return false;
       }
+      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readPropertyList: can not read property %lu\n", i));
+      return false;
     }
     return true;
   }
 
-  //! low level: reads a property and its value, adds it to \a list
-  bool readProperty(librevenge::RVNGInputStream &input, librevenge::RVNGPropertyList &list)
+  //! low level: reads a key: 0 followed by the new key or the key index+1
+  bool readKey(size_t &id)
   {
-    librevenge::RVNGString key, val;
-    if (!readString(input, key)) return false;
-    if (!readString(input, val)) return false;
-
-    list.insert(key.cstr(), val);
+    unsigned long val;
+    if (!readULong(val)) return false;
+    if (val) {
+      if (val>m_keyList.size()) {
+        STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readKey: unknown key %lu\n", val));
+        return false;
+      }
+      id=size_t(val-1);
+      return true;
+    }
+    unsigned long len;
+    if (!readULong(len) || len>static_cast<unsigned long>(m_end-m_pos)) {
+      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readKey: can not read a key\n"));
+      return false;
+    }
+    m_keyList.push_back(std::string(reinterpret_cast<char const *>(m_pos), size_t(len)));
+    m_pos+=len;
+    id=m_keyList.size()-1;
     return true;
   }
 
-  //! low level: reads a string : size and string
-  bool readString(librevenge::RVNGInputStream &input, librevenge::RVNGString &s)
+  //! low level: reads a string: size and string with its final null character
+  bool readString(librevenge::RVNGString &s)
   {
-    long numC = 0;
-    if (!readLong(input, numC)) return false;
+    unsigned long numC = 0;
+    if (!readULong(numC)) return false;
     if (numC==0) {
       s = librevenge::RVNGString("");
       return true;
     }
-    unsigned long numRead;
-    const unsigned char *dt = input.read(static_cast<unsigned long>(numC), numRead);
-    if (dt == nullptr || numRead != static_cast<unsigned long>(numC)) {
+    if (numC>static_cast<unsigned long>(m_end-m_pos) || m_pos[numC-1]!=0) {
       STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readString: can not read a string\n"));
       return false;
     }
-    s = librevenge::RVNGString(reinterpret_cast<const char *>(dt));
+    s = librevenge::RVNGString(reinterpret_cast<const char *>(m_pos));
+    m_pos+=numC;
+    return true;
+  }
+
+  //! low level: reads an unsigned variable length value
+  bool readULong(unsigned long &val)
+  {
+    val=0;
+    for (int shift=0; shift<int(8*sizeof(unsigned long)); shift+=7) {
+      if (m_pos>=m_end) break;
+      unsigned char c=*(m_pos++);
+      val|=static_cast<unsigned long>(c&0x7F)<<shift;
+      if ((c&0x80)==0) return true;
+    }
+    STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readULong: can not read a value\n"));
+    return false;
+  }
+
+  //! low level: reads a signed variable length value
+  bool readLong(long &val)
+  {
+    unsigned long value;
+    if (!readULong(value)) return false;
+    val=(value&1) ? -long(value>>1)-1 : long(value>>1);
     return true;
   }
 
-  //! low level: reads an long value
-  static bool readLong(librevenge::RVNGInputStream &input, long &val)
+  //! low level: reads a double
+  bool readDouble(double &val)
   {
-    unsigned long numRead = 0;
-    auto const *dt = input.read(4, numRead);
-    if (dt == nullptr || numRead != 4) {
-      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readLong: can not read long\n"));
+    if (m_end-m_pos<8) {
+      STOFF_DEBUG_MSG(("STOFFPropertyHandlerDecoder::readDouble: can not read a double\n"));
       return false;
     }
-    val = long((dt[3]<<24)|(dt[2]<<16)|(dt[1]<<8)|dt[0]);
+    uint64_t value=0;
+    for (int i=7; i>=0; --i)
+      value=(value<<8)|m_pos[i];
+    m_pos+=8;
+    std::memcpy(&val, &value, sizeof(val));
     return true;
   }
 private:
@@ -347,8 +510,14 @@ private:
   STOFFPropertyHandlerDecoder &operator=(STOFFPropertyHandlerDecoder const &);
 
 protected:
-  //! the streamfile
+  //! the handler
   STOFFPropertyHandler *m_handler;
+  //! the actual position in the data
+  unsigned char const *m_pos;
+  //! the end of the data
+  unsigned char const *m_end;
+  //! the list of keys
+  std::vector<std::string> m_keyList;
 };
 
 ////////////////////////////////////////////////////
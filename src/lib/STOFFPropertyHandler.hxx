@@ -36,8 +36,9 @@
 
 #  include <assert.h>
 #  include <ostream>
-#  include <sstream>
 #  include <string>
+#  include <unordered_map>
+#  include <vector>
 
 //! a generic property handler
 class STOFFPropertyHandler
@@ -65,16 +66,26 @@ public:
  *
  * In order to be read by writerperfect, we must code document consisting in
  * tag and propertyList in an intermediar format:
- *  - [string:s]: an int length(s) follow by the length(s) characters of string s
- *  - [property:p]: a string value p.getStr() ( for a basic property )
- *  - [propertyList:pList]: a int: \#pList followed by
- *      -+ 'p',pList[i].key(),pList[i] for a basic child
- *      -+ 'v',pList[i].key(),*(pList.child(pList[i].key())) for a vector child
- *  - [propertyListVector:v]: a int: \#v followed by v[0], v[1], ...
- *  - [binaryData:d]: a int32 d.size() followed by the data content
+ *  - [header]: a null byte, "STF" and the format version: 1
+ *  - [uint:n]: n written by group of 7 bits, the high bit being set if another group follows
+ *  - [int:n]: the uint 2*n if n>=0 or -2*n-1 if n<0
+ *  - [string:s]: an uint length(s)+1 follow by the characters of string s and a null character
+ *  - [key:k]: the uint id+1 if the key k has already been written,
+ *      if not, the uint 0, the uint length(k) and the characters of k, k is then the key number id
+ *  - [property:p]:
+ *      -+ 'd', a byte p.getUnit(), the 8 little endian bytes of p.getDouble() for a double property
+ *      -+ 'i', an int p.getInt() for an integer property
+ *      -+ 'b', a byte 0 or 1 for a boolean property
+ *      -+ 's', a string p.getStr() for other properties (string, binary data, ...)
  *
- *  - [insertElement:name]: char 'E', [string] name
- *  - [insertElement:name proplist:prop]: char 'S', [string] name, prop
+ *  note: the type is the type used to create the property, a string property is always stored as a string
+ *  - [propertyList:pList]: an uint: \#pList followed by
+ *      -+ [key] pList[i].key(),[property] pList[i] for a basic child
+ *      -+ [key] pList[i].key(),'v',*(pList.child(pList[i].key())) for a vector child
+ *  - [propertyListVector:v]: an uint: \#v followed by v[0], v[1], ...
+ *
+ *  - [insertElement:name]: char 'E', [key] name
+ *  - [insertElement:name proplist:prop]: char 'S', [key] name, prop
  *  - [characters:s ]: char 'T', [string] s
  *            - if len(s)==0, we write nothing
  *            - the string is written as is (ie. we do not escaped any characters).
@@ -95,19 +106,27 @@ public:
   bool getData(librevenge::RVNGBinaryData &data);
 
 protected:
-  //! adds a long value if f
+  //! adds an unsigned value
+  void writeULong(unsigned long val);
+  //! adds a signed value
   void writeLong(long val);
+  //! adds a double value
+  void writeDouble(double val);
   //! adds a string: size and string
   void writeString(const librevenge::RVNGString &name);
-  //! adds a property: a string key, a string corresponding to value
+  //! adds a key: its index if it is already written or the key
+  void writeKey(const char *key);
+  //! adds a property: a key, a type and the value
   void writeProperty(const char *key, const librevenge::RVNGProperty &prop);
   //! adds a property list: int \#prop followed by the different properties
   void writePropertyList(const librevenge::RVNGPropertyList &prop);
   //! adds a property vector: a int: \#vect followed by vect[0], vect[1], ...
   void writePropertyListVector(const librevenge::RVNGPropertyListVector &vect);
 
-  //! the streamfile
-  std::stringstream m_f;
+  //! the encoded data
+  librevenge::RVNGBinaryData m_data;
+  //! a map key to key index
+  std::unordered_map<std::string, unsigned long> m_keyToIdMap;
 };
 
 #endif
@@ -0,0 +1,175 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#include <chrono>
+#ifdef USE_THREADS
+#  include <thread>
+#endif
+
+#include "STOFFParseTrace.hxx"
+
+#include "STOFFResourceGovernor.hxx"
+
+namespace libstoff
+{
+//! the governor of the parse done by the current thread
+static thread_local ResourceGovernor *s_governor=nullptr;
+
+//! returns the current time in seconds
+static double getTime()
+{
+  std::chrono::duration<double> const time=std::chrono::steady_clock::now().time_since_epoch();
+  return time.count();
+}
+
+ResourceGovernor::ResourceGovernor(STOFFDocument::ParseOptions const &options)
+  : m_options(options)
+  , m_numThreads(1)
+  , m_deadline(0)
+  , m_memory(0)
+  , m_numCells(0)
+  , m_exceeded(false)
+  , m_canceled(false)
+  , m_statistics(createParseStatistics(options.m_statisticsCallback!=nullptr))
+{
+#ifdef USE_THREADS
+  m_numThreads=m_options.m_numThreads>0 ? m_options.m_numThreads : int(std::thread::hardware_concurrency());
+  if (m_numThreads<1)
+    m_numThreads=1;
+#else
+  if (m_options.m_numThreads!=1) {
+    STOFF_DEBUG_MSG(("ResourceGovernor::ResourceGovernor: the threads are not available\n"));
+  }
+#endif
+  if (m_options.m_limits.m_maxDuration>0)
+    m_deadline=getTime()+m_options.m_limits.m_maxDuration;
+}
+
+ResourceGovernor::~ResourceGovernor()
+{
+}
+
+ResourceGovernor *ResourceGovernor::get()
+{
+  return s_governor;
+}
+
+void ResourceGovernor::checkStopped() const
+{
+  if (m_canceled)
+    throw ParseCanceledException();
+  if (m_exceeded)
+    throw ResourceLimitException();
+}
+
+void ResourceGovernor::exceed(char const *what)
+{
+  if (!m_exceeded.exchange(true)) {
+    STOFF_DEBUG_MSG(("ResourceGovernor::exceed: the %s limit is exceeded, stop the parsing\n", what));
+  }
+  (void) what;
+  throw ResourceLimitException();
+}
+
+void ResourceGovernor::checkRecordLevel(int level)
+{
+  if (m_options.m_limits.m_maxRecordDepth>0 && level>m_options.m_limits.m_maxRecordDepth)
+    exceed("record depth");
+  checkDeadline();
+}
+
+void ResourceGovernor::checkDeadline()
+{
+  checkStopped();
+  if (m_deadline>0 && getTime()>m_deadline)
+    exceed("duration");
+}
+
+void ResourceGovernor::useMemory(unsigned long numBytes)
+{
+  checkStopped();
+  countParseAllocation(numBytes);
+  unsigned long const memory=(m_memory+=numBytes);
+  if (m_options.m_limits.m_maxMemory>0 && (memory<numBytes || memory>m_options.m_limits.m_maxMemory))
+    exceed("memory");
+}
+
+void ResourceGovernor::useCells(unsigned long numCells)
+{
+  checkStopped();
+  unsigned long const cells=(m_numCells+=numCells);
+  if (m_options.m_limits.m_maxCells>0 && (cells<numCells || cells>m_options.m_limits.m_maxCells))
+    exceed("cells");
+}
+
+void ResourceGovernor::checkImageSize(unsigned long width, unsigned long height)
+{
+  checkStopped();
+  if (m_options.m_limits.m_maxImagePixels>0 && width && static_cast<unsigned long long>(width)*height>m_options.m_limits.m_maxImagePixels)
+    exceed("image size");
+}
+
+void ResourceGovernor::checkProgress(char const *zone, long position, long size)
+{
+  checkStopped();
+  if (!m_options.m_progressCallback) return;
+  STOFFDocument::ParseProgress progress;
+  progress.m_zone=zone;
+  progress.m_position=position;
+  progress.m_size=size;
+  if (m_options.m_progressCallback(progress, m_options.m_progressData)) return;
+  if (!m_canceled.exchange(true)) {
+    STOFF_DEBUG_MSG(("ResourceGovernor::checkProgress: the parse is canceled\n"));
+  }
+  throw ParseCanceledException();
+}
+
+void ResourceGovernor::sendParseStatistics() const
+{
+  if (m_statistics)
+    libstoff::sendParseStatistics(*m_statistics, m_options.m_statisticsCallback, m_options.m_statisticsData);
+}
+
+ResourceGovernorScope::ResourceGovernorScope(ResourceGovernor *governor)
+  : m_previous(s_governor)
+{
+  s_governor=governor;
+}
+
+ResourceGovernorScope::~ResourceGovernorScope()
+{
+  s_governor=m_previous;
+}
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -0,0 +1,190 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifndef STOFF_RESOURCE_GOVERNOR
+#  define STOFF_RESOURCE_GOVERNOR
+
+#include <atomic>
+#include <memory>
+
+#include <libstaroffice/libstaroffice.hxx>
+
+#include "libstaroffice_internal.hxx"
+
+/** the resource governor: each parse done by STOFFDocument creates a
+    governor which keeps the options of the parse, then the readers
+    report the records, the cells and the large buffers which they
+    create. When a limit is exceeded, a ResourceLimitException is
+    thrown (a ParseCanceledException when the progress function cancels
+    the parse) and all the following checks throw again, so that the
+    parse stops even if a reader catches the exception.
+
+    \note when the current thread does not parse a document, the checks do nothing
+    and the default options are used */
+namespace libstoff
+{
+struct ParseStatistics;
+
+//! the options and the resources used by a parse
+class ResourceGovernor
+{
+public:
+  //! constructor
+  explicit ResourceGovernor(STOFFDocument::ParseOptions const &options);
+  //! destructor
+  ~ResourceGovernor();
+  //! returns the governor of the parse done by the current thread (or null)
+  static ResourceGovernor *get();
+  //! returns the options of the parse
+  STOFFDocument::ParseOptions const &getOptions() const
+  {
+    return m_options;
+  }
+  //! returns the maximum number of threads, always 1 if the threads are not available
+  int getNumThreads() const
+  {
+    return m_numThreads;
+  }
+  //! returns the statistics of the parse (or null if they are not collected)
+  ParseStatistics *getParseStatistics() const
+  {
+    return m_statistics.get();
+  }
+  //! returns true if a limit has been exceeded
+  bool isExceeded() const
+  {
+    return m_exceeded;
+  }
+  //! returns true if the progress function has canceled the parse
+  bool isCanceled() const
+  {
+    return m_canceled;
+  }
+  //! checks the nesting level of a record and the deadline
+  void checkRecordLevel(int level);
+  //! checks the deadline
+  void checkDeadline();
+  //! adds the size of a buffer created from the document data
+  void useMemory(unsigned long numBytes);
+  //! adds some spreadsheet or chart cells
+  void useCells(unsigned long numCells);
+  //! checks the number of pixels of a bitmap
+  void checkImageSize(unsigned long width, unsigned long height);
+  //! calls the progress function, cancels the parse if it returns false
+  void checkProgress(char const *zone, long position, long size);
+  //! sends the parse statistics to the statistics function (if it is set)
+  void sendParseStatistics() const;
+protected:
+  //! throws again if a limit has been exceeded or if the parse has been canceled
+  void checkStopped() const;
+  //! marks the governor as exceeded and throws a ResourceLimitException
+  void exceed(char const *what);
+
+  //! the options
+  STOFFDocument::ParseOptions m_options;
+  //! the maximum number of threads
+  int m_numThreads;
+  //! the time after which the parse must stop (if m_limits.m_maxDuration is set)
+  double m_deadline;
+  //! the memory used
+  std::atomic<unsigned long> m_memory;
+  //! the number of cells
+  std::atomic<unsigned long> m_numCells;
+  //! a flag to know if a limit has been exceeded
+  std::atomic<bool> m_exceeded;
+  //! a flag to know if the parse has been canceled
+  std::atomic<bool> m_canceled;
+  //! the parse statistics (if they are collected)
+  std::shared_ptr<ParseStatistics> m_statistics;
+private:
+  ResourceGovernor(ResourceGovernor const &) = delete;
+  ResourceGovernor &operator=(ResourceGovernor const &) = delete;
+};
+
+/** a class used to set the governor of the current thread, for instance
+    to give the governor of a parse to its background threads */
+class ResourceGovernorScope
+{
+public:
+  //! constructor: sets the governor of the current thread (can be null)
+  explicit ResourceGovernorScope(ResourceGovernor *governor);
+  //! destructor: restores the previous governor
+  ~ResourceGovernorScope();
+protected:
+  //! the previous governor
+  ResourceGovernor *m_previous;
+private:
+  ResourceGovernorScope(ResourceGovernorScope const &) = delete;
+  ResourceGovernorScope &operator=(ResourceGovernorScope const &) = delete;
+};
+
+//! checks the nesting level of a record and the deadline of the current parse
+inline void checkRecordLevel(int level)
+{
+  auto governor=ResourceGovernor::get();
+  if (governor) governor->checkRecordLevel(level);
+}
+//! checks the deadline of the current parse
+inline void checkDeadline()
+{
+  auto governor=ResourceGovernor::get();
+  if (governor) governor->checkDeadline();
+}
+//! adds the size of a buffer created from the document data to the current parse
+inline void useMemory(unsigned long numBytes)
+{
+  auto governor=ResourceGovernor::get();
+  if (governor) governor->useMemory(numBytes);
+}
+//! adds some spreadsheet or chart cells to the current parse
+inline void useCells(unsigned long numCells)
+{
+  auto governor=ResourceGovernor::get();
+  if (governor) governor->useCells(numCells);
+}
+//! checks the number of pixels of a bitmap read by the current parse
+inline void checkImageSize(unsigned long width, unsigned long height)
+{
+  auto governor=ResourceGovernor::get();
+  if (governor) governor->checkImageSize(width, height);
+}
+//! reports the progression of the current parse, see STOFFDocument::ParseProgress
+inline void checkProgress(char const *zone, long position, long size)
+{
+  auto governor=ResourceGovernor::get();
+  if (governor) governor->checkProgress(zone, position, size);
+}
+}
+#endif
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -153,6 +153,9 @@ public:
   /** adds an unicode character.
    *  By convention if \a character=0xfffd(undef), no character is added */
   void insertUnicode(uint32_t character) final;
+  /** adds a run of unicode characters.
+   *  By convention the undef characters(0xfffd) are skipped */
+  void insertUnicodeSpan(uint32_t const *characters, size_t numCharacters) final;
   //! adds a unicode string
   void insertUnicodeString(librevenge::RVNGString const &str) final;
 
@@ -32,11 +32,16 @@
 */
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <list>
+#include <mutex>
 #include <sstream>
-#include <set>
+#include <thread>
+#include <unordered_map>
 
 #include "STOFFStarMathToMMLConverter.hxx"
 
@@ -134,301 +139,363 @@ struct Node {
   std::vector<std::shared_ptr<Node> > m_childs;
 };
 
+//! a small output buffer used to create the MathML string, its memory is kept between two formulas
+class Output
+{
+public:
+  //! constructor
+  Output()
+    : m_buffer()
+  {
+  }
+  //! removes the content
+  void clear()
+  {
+    m_buffer.clear();
+  }
+  //! returns the content
+  std::string const &str() const
+  {
+    return m_buffer;
+  }
+  //! adds a string
+  Output &operator<<(char const *str)
+  {
+    m_buffer+=str;
+    return *this;
+  }
+  //! adds a string
+  Output &operator<<(std::string const &str)
+  {
+    m_buffer+=str;
+    return *this;
+  }
+  //! adds a double as a std::ostream does
+  Output &operator<<(double val)
+  {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", val);
+    m_buffer+=buffer;
+    return *this;
+  }
+protected:
+  //! the buffer
+  std::string m_buffer;
+};
+
+//! a sorted static table of keywords searched by dichotomy
+template <class T> class KeywordMap
+{
+public:
+  //! a keyword and its value
+  struct Entry {
+    //! the keyword
+    char const *first;
+    //! the value
+    T second;
+  };
+  //! constructor
+  template <size_t N> explicit KeywordMap(Entry const(&entries)[N])
+    : m_begin(entries)
+    , m_end(entries+N)
+  {
+#ifdef DEBUG
+    for (auto it=m_begin; it+1<m_end; ++it) {
+      if (std::strcmp(it->first, (it+1)->first)>=0) {
+        STOFF_DEBUG_MSG(("StarMathToMMLConverterInternal::KeywordMap: the table is not sorted near %s\n", it->first));
+      }
+    }
+#endif
+  }
+  //! returns the entry corresponding to a keyword or end()
+  Entry const *find(std::string const &key) const
+  {
+    auto it=std::lower_bound(m_begin, m_end, key, [](Entry const &entry, std::string const &k) {
+      return std::strcmp(entry.first, k.c_str())<0;
+    });
+    return (it!=m_end && key==it->first) ? it : m_end;
+  }
+  //! returns the end of the table
+  Entry const *end() const
+  {
+    return m_end;
+  }
+protected:
+  //! the first entry
+  Entry const *m_begin;
+  //! the end of the table
+  Entry const *m_end;
+};
+
+//! a sorted static set of keywords searched by dichotomy
+class KeywordSet
+{
+public:
+  //! constructor
+  template <size_t N> explicit KeywordSet(char const *const(&keywords)[N])
+    : m_begin(keywords)
+    , m_end(keywords+N)
+  {
+#ifdef DEBUG
+    for (auto it=m_begin; it+1<m_end; ++it) {
+      if (std::strcmp(*it, *(it+1))>=0) {
+        STOFF_DEBUG_MSG(("StarMathToMMLConverterInternal::KeywordSet: the table is not sorted near %s\n", *it));
+      }
+    }
+#endif
+  }
+  //! returns the position of a keyword or end()
+  char const *const *find(std::string const &key) const
+  {
+    auto it=std::lower_bound(m_begin, m_end, key, [](char const *keyword, std::string const &k) {
+      return std::strcmp(keyword, k.c_str())<0;
+    });
+    return (it!=m_end && key==*it) ? it : m_end;
+  }
+  //! returns the end of the set
+  char const *const *end() const
+  {
+    return m_end;
+  }
+protected:
+  //! the first keyword
+  char const *const *m_begin;
+  //! the end of the set
+  char const *const *m_end;
+};
+
+// the following tables must be sorted (strcmp order)
+//! the set of potential color
+static char const *const s_colorSet[]= {
+  "black", "blue", "cyan", "gray", "green", "lime", "magenta", "maroon", "navy", "olive", "purple",
+  "red", "silver", "teal", "yellow"
+};
+//! the font convert map
+static KeywordMap<char const *>::Entry const s_fontMap[]= {
+  {"fixed", "monospace"}, {"sans", "sans-serif"}, {"serif", "normal"}
+};
+//! the greek convert map
+static KeywordMap<char const *>::Entry const s_greekMap[]= {
+  {"ALPHA", "&Alpha;"}, {"BETA", "&Beta;"}, {"CHI", "&Chi;"}, {"DELTA", "&Delta;"},
+  {"EPSILON", "&Epsilon;"}, {"ETA", "&Eta;"}, {"GAMMA", "&Gamma;"}, {"IOTA", "&Iota;"},
+  {"KAPPA", "&Kappa;"}, {"LAMBDA", "&Lambda;"}, {"MU", "&Mu;"}, {"NU", "&Nu;"},
+  {"OMEGA", "&Omega;"}, {"OMICRON", "&Omicron;"}, {"PHI", "&Phi;"}, {"PI", "&Pi;"},
+  {"PSI", "&Psi;"}, {"RHO", "&Rho;"}, {"SIGMA", "&Sigma;"}, {"TAU", "&Tau;"}, {"THETA", "&Theta;"},
+  {"UPSILON", "&Upsilon;"}, {"XI", "&Xi;"}, {"ZETA", "&Zeta;"}, {"alpha", "&alpha;"},
+  {"beta", "&beta;"}, {"chi", "&chi;"}, {"delta", "&delta;"}, {"epsilon", "&epsilon;"},
+  {"eta", "&eta;"}, {"gamma", "&gamma;"}, {"iota", "&iota;"}, {"kappa", "&kappa;"},
+  {"lambda", "&lambda;"}, {"mu", "&mu;"}, {"nu", "&nu;"}, {"omega", "&omega;"},
+  {"omicron", "&omicron;"}, {"phi", "&varphi;"}, {"pi", "&pi;"}, {"psi", "&psi;"},
+  {"rho", "&rho;"}, {"sigma", "&sigma;"}, {"tau", "&tau;"}, {"theta", "&theta;"},
+  {"upsilon", "&upsilon;"}, {"varepsilon", "&varepsilon;"}, {"varphi", "&phi;"},
+  {"varpi", "&varpi;"}, {"varrho", "&varrho;"}, {"varsigma", "&varsigma;"},
+  {"vartheta", "&vartheta;"}, {"xi", "&xi;"}, {"zeta", "&zeta;"}
+};
+//! the special percent convert map
+static KeywordMap<char const *>::Entry const s_specialPercentMap[]= {
+  {"and", "&and;"}, {"angle", "&#x2993;"}, {"element", "&isin;"}, {"identical", "&equiv;"},
+  {"infinite", "&infin;"}, {"noelement", "&notin;"}, {"notequal", "&neq;"}, {"or", "&or;"},
+  {"perthousand", "&permil;"}, {"strictlygreaterthan", "&gt;"}, {"strictlylessthan", "&lt;"},
+  {"tendto", "&rarr;"}
+};
+//! the remaining special key word
+static KeywordMap<char const *>::Entry const s_otherSpecialMap[]= {
+  {"aleph", "&aleph;"}, {"backepsilon", "&#x3F6;"}, {"dotsaxis", "&#x22ef;"},
+  {"dotsdiag", "&#x22f0;"}, {"dotsdown", "&#x22f1;"}, {"dotslow", "&#x2026;"},
+  {"dotsup", "&#x22f0;"}, {"dotsvert", "&#x22ee;"}, {"downarrow", "&#x2193;"},
+  {"emptyset", "&emptyset;"}, {"exists", "&#x2203;"}, {"forall", "&#x2200;"}, {"hbar", "&#x210f;"},
+  {"im", "&#x2111;"}, {"infinity", "&#x221e;"}, {"infty", "&#x221e;"}, {"lambdabar", "&#x19b;"},
+  {"leftarrow", "&#x2190;"}, {"nabla", "&#x2207;"}, {"notexists", "&#x2204;"},
+  {"partial", "&#x2202;"}, {"re", "&#x211c;"}, {"rightarrow", "&#x2192;"}, {"setc", "&complexes;"},
+  {"setn", "&naturals;"}, {"setq", "&rationals;"}, {"setr", "&reals;"}, {"setz", "&integers;"},
+  {"uparrow", "&#x2191;"}, {"wp", "&#x2118;"}
+};
+//! the parenthesis left/right map
+static KeywordMap<char const *>::Entry const s_parenthesisMap[]= {
+  {"(", ")"}, {"[", "]"}, {"langle", "rangle"}, {"lbrace", "rbrace"}, {"lceil", "rceil"},
+  {"ldbracket", "rdbracket"}, {"ldline", "rdline"}, {"lfloor", "rfloor"}, {"lline", "rline"}
+};
+//! the parenthesis right map
+static char const *const s_parenthesisRightSet[]= {
+  ")", "]", "rangle", "rbrace", "rceil", "rdbracket", "rdline", "rfloor", "rline"
+};
+//! the parenthesis unicode map
+static KeywordMap<char const *>::Entry const s_parenthesisToStringMap[]= {
+  {"(", "("}, {")", ")"}, {"[", "["}, {"]", "]"}, {"langle", "&#x2329;"}, {"lbrace", "{"},
+  {"lceil", "&#x2308;"}, {"ldbracket", "&#x27e6;"}, {"ldline", "|"}, {"lfloor", "&#x230a;"},
+  {"lline", "|"}, {"rangle", "&#x232a;"}, {"rbrace", "}"}, {"rceil", "&#x2309;"},
+  {"rdbracket", "&#x27e7;"}, {"rdline", "|"}, {"rfloor", "&#x230b;"}, {"rline", "|"}
+};
+//! the unary operator
+static KeywordMap<char const *>::Entry const s_unaryOperatorMap[]= {
+  {"+", "+"}, {"+-", "&#xb1;"}, {"-", "-"}, {"-+", "&#x2213;"}, {"minusplus", "&#x2213;"},
+  {"neg", "&#xac;"}, {"plusminus", "&#xb1;"}, {"uoper", ""}
+};
+//! the function which have one argument
+static char const *const s_function1Set[]= {
+  "abs", "arccos", "arccot", "arcosh", "arcoth", "arcsin", "arctan", "arsinh", "artanh", "cos",
+  "cosh", "cot", "coth", "exp", "fact", "ln", "log", "sin", "sinh", "sqrt", "tan", "tanh"
+};
+//! the function which have two argument
+static char const *const s_function2Set[]= {
+  "binom", "nroot"
+};
+//! the function which have one to three argument (from to optional)
+static KeywordMap<char const *>::Entry const s_integralMap[]= {
+  {"coprod", "&#x2210;"}, {"iiint", "&#x222d;"}, {"iint", "&#x222c;"}, {"int", "&#x222b;"},
+  {"intd", "&#x222b;"}, {"lim", "lim"}, {"liminf", "liminf"}, {"limsup", "limsup"},
+  {"lint", "&#x222e;"}, {"llint", "&#x222f;"}, {"lllint", "&#x2230;"}, {"prod", "&#x220f;"},
+  {"sum", "&#x2211;"}
+};
+//! the accent which have one argument
+static KeywordMap<char const *>::Entry const s_accent1Map[]= {
+  {"acute", "&#xb4;"}, {"bar", "&#xaf;"}, {"breve", "&#x2d8;"}, {"check", "&#x2c7;"},
+  {"circle", "&#x2da;"}, {"dddot", "&#x20db;"}, {"ddot", "&#xa8;"}, {"dot", "&#x2d9;"},
+  {"grave", "`"}, {"hat", "^"}, {"tilde", "~"}, {"vec", "&#x20d7;"}, {"widehat", "^"},
+  {"widetilde", "~"}, {"widevec", "&#x20d7;"}
+};
+//! the accent which have one argument
+static char const *const s_accent1Set[]= {
+  "alignb", "alignc", "alignl", "alignm", "alignr", "alignt", "bold", "ital", "italic", "nbold",
+  "nitalic", "nospace", "overline", "overstrike", "phantom", "underline"
+};
+//! position symbol map
+static KeywordMap<int>::Entry const s_positionMap[]= {
+  {"^", 6}, {"_", 2}, {"csub", 1}, {"csup", 5}, {"lsub", 0}, {"lsup", 4}, {"overbrace", 7},
+  {"rsub", 2}, {"rsup", 6}, {"sub", 2}, {"sup", 6}, {"underbrace", 3}
+};
+//! multiplication symbol operator
+static KeywordMap<char const *>::Entry const s_multiplicationMap[]= {
+  {"&", "&#x2227;"}, {"*", "&#x2736;"}, {"/", "/"}
+};
+//! multiplication symbol string operator
+static KeywordMap<char const *>::Entry const s_multiplicationStringMap[]= {
+  {"and", "&#x2227;"}, {"bslash", "&#x2216;"}, {"cdot", "&#x22c5;"}, {"div", "&#xf7;"},
+  {"odivide", "&#x2298;"}, {"odot", "&#x2299;"}, {"ominus", "&#x2296;"}, {"oplus", "&#x2295;"},
+  {"or", "&#x2228;"}, {"otimes", "&#x2297;"}, {"over", ""}, {"slash", "/"}, {"times", "&#xd7;"},
+  {"widebslash", "&#x2216;"}, {"wideslash", ""}
+};
+//! addition symbol operator
+static char const *const s_additionSet[]= {
+  "+", "-"
+};
+//! addition symbol string operator
+static KeywordMap<char const *>::Entry const s_additionStringMap[]= {
+  {"bslash", "&#x2216;"}, {"circ", "&#x2218;"}, {"in", "&#x2208;"}, {"intersection", "&#x2229;"},
+  {"notin", "&#x2209;"}, {"nsubset", "&#x2284;"}, {"nsubseteq", "&#x2288;"},
+  {"nsupset", "&#x2285;"}, {"nsupseteq", "&#x2289;"}, {"owns", "&#x220b;"},
+  {"setminus", "&#x2216;"}, {"slash", "/"}, {"subset", "&#x2282;"}, {"subseteq", "&#x2286;"},
+  {"supset", "&#x2283;"}, {"supseteq", "&#x2287;"}, {"union", "&#x222a;"}
+};
+//! relation symbol operator
+static KeywordMap<char const *>::Entry const s_relationMap[]= {
+  {"<", "&lt;"}, {"<<", "&#x226a;"}, {"<=", "&#x2264;"}, {"<>", "&#x2260;"}, {"=", "="},
+  {">", "&gt;"}, {">=", "&#x2265;"}, {">>", "&#x226b;"}
+};
+//! relation symbol string operator
+static KeywordMap<char const *>::Entry const s_relationStringMap[]= {
+  {"approx", "&#x2248;"}, {"def", "&#x225d;"}, {"divides", "&#x2223;"}, {"dlarrow", "&#x21d0;"},
+  {"dlrarrow", "&#x21d4;"}, {"equiv", "&#x2261;"}, {"geslant", "&#x2265;"}, {"gg", "&#x226b;"},
+  {"gt", "&gt;"}, {"leslant", "&#x2264;"}, {"ll", "&#x226a;"}, {"lt", "&lt;"},
+  {"ndivides", "&#x2224;"}, {"neq", "&#x2260;"}, {"nprec", "&#x2280;"}, {"nsucc", "&#x2281;"},
+  {"ortho", "&#x22a5;"}, {"parallel", "&#x2225;"}, {"prec", "&#x227a;"},
+  {"preccurlyeq", "&#x227c;"}, {"precsim", "&#x227e;"}, {"prop", "&#x221d;"}, {"sim", "&#x223c;"},
+  {"simeq", "&#x2243;"}, {"succ", "&#x227b;"}, {"succcurlyeq", "&#x227d;"},
+  {"succsim", "&#x227f;"}, {"toward", "&#x2192;"}, {"transl", "&#x22b7;"}, {"transr", "&#x22b6;"}
+};
+
+//! the keyword tables, shared by all the parsers
+struct Tables {
+  //! returns the tables
+  static Tables const &get()
+  {
+    static Tables const tables;
+    return tables;
+  }
+  //! constructor
+  Tables()
+    : m_colorSet(s_colorSet)
+    , m_fontMap(s_fontMap)
+    , m_greekMap(s_greekMap)
+    , m_specialPercentMap(s_specialPercentMap)
+    , m_otherSpecialMap(s_otherSpecialMap)
+    , m_parenthesisMap(s_parenthesisMap)
+    , m_parenthesisRightSet(s_parenthesisRightSet)
+    , m_parenthesisToStringMap(s_parenthesisToStringMap)
+    , m_unaryOperatorMap(s_unaryOperatorMap)
+    , m_function1Set(s_function1Set)
+    , m_function2Set(s_function2Set)
+    , m_integralMap(s_integralMap)
+    , m_accent1Map(s_accent1Map)
+    , m_accent1Set(s_accent1Set)
+    , m_positionMap(s_positionMap)
+    , m_multiplicationMap(s_multiplicationMap)
+    , m_multiplicationStringMap(s_multiplicationStringMap)
+    , m_additionSet(s_additionSet)
+    , m_additionStringMap(s_additionStringMap)
+    , m_relationMap(s_relationMap)
+    , m_relationStringMap(s_relationStringMap)
+  {
+  }
+  //! the set of potential color
+  KeywordSet m_colorSet;
+  //! the font convert map
+  KeywordMap<char const *> m_fontMap;
+  //! the greek convert map
+  KeywordMap<char const *> m_greekMap;
+  //! the special percent convert map
+  KeywordMap<char const *> m_specialPercentMap;
+  //! the remaining special key word
+  KeywordMap<char const *> m_otherSpecialMap;
+  //! the parenthesis left/right map
+  KeywordMap<char const *> m_parenthesisMap;
+  //! the parenthesis right map
+  KeywordSet m_parenthesisRightSet;
+  //! the parenthesis unicode map
+  KeywordMap<char const *> m_parenthesisToStringMap;
+  //! the unary operator
+  KeywordMap<char const *> m_unaryOperatorMap;
+  //! the function which have one argument
+  KeywordSet m_function1Set;
+  //! the function which have two argument
+  KeywordSet m_function2Set;
+  //! the function which have one to three argument (from to optional)
+  KeywordMap<char const *> m_integralMap;
+  //! the accent which have one argument
+  KeywordMap<char const *> m_accent1Map;
+  //! the accent which have one argument
+  KeywordSet m_accent1Set;
+  //! position symbol map
+  KeywordMap<int> m_positionMap;
+  //! multiplication symbol operator
+  KeywordMap<char const *> m_multiplicationMap;
+  //! multiplication symbol string operator
+  KeywordMap<char const *> m_multiplicationStringMap;
+  //! addition symbol operator
+  KeywordSet m_additionSet;
+  //! addition symbol string operator
+  KeywordMap<char const *> m_additionStringMap;
+  //! relation symbol operator
+  KeywordMap<char const *> m_relationMap;
+  //! relation symbol string operator
+  KeywordMap<char const *> m_relationStringMap;
+};
+
 //! class to parse a StarMath string
 class Parser
 {
 public:
   //! constructor
   Parser()
-    : m_dataList()
+    : m_tables(Tables::get())
+    , m_dataList()
     , m_output()
 
     , m_fontSize(12)
     , m_bold(false)
     , m_italic(false)
     , m_fontName()
-    , m_colorSet()
-    , m_fontMap()
-    , m_greekMap()
-    , m_specialPercentMap()
-    , m_otherSpecialMap()
-    , m_parenthesisMap()
-    , m_parenthesisRightSet()
-    , m_parenthesisToStringMap()
-    , m_unaryOperatorMap()
-    , m_function1Set()
-    , m_function2Set()
-    , m_integralMap()
-    , m_accent1Map()
-    , m_accent1Set()
-    , m_positionMap()
-    , m_multiplicationMap()
-    , m_multiplicationStringMap()
-    , m_additionSet()
-    , m_additionStringMap()
-    , m_relationMap()
-    , m_relationStringMap()
   {
-    m_colorSet= {
-      "black", "blue", "green", "red", "cyan", "magenta", "yellow", "gray", "lime",
-      "maroon", "navy", "olive", "purple", "silver", "teal"
-    };
-    m_fontMap= {
-      {"sans", "sans-serif"}, {"fixed", "monospace"}, {"serif", "normal"}
-    };
-    // % character
-    m_greekMap= {
-      {"alpha","&alpha;"}, {"beta","&beta;"}, {"chi","&chi;"}, {"delta","&delta;"}, {"epsilon","&epsilon;"},
-      {"eta","&eta;"}, {"gamma","&gamma;"}, {"iota","&iota;"}, {"kappa","&kappa;"},
-      {"lambda","&lambda;"}, {"mu","&mu;"}, {"nu","&nu;"}, {"omega","&omega;"},
-      {"omicron","&omicron;"}, {"phi","&varphi;"}, {"pi","&pi;"}, {"psi","&psi;"},
-      {"rho","&rho;"}, {"sigma","&sigma;"}, {"tau","&tau;"}, {"theta","&theta;"},
-      {"upsilon","&upsilon;"}, {"varepsilon","&varepsilon;"}, {"varphi","&phi;"}, {"varpi","&varpi;"},
-      {"varrho","&varrho;"}, {"varsigma","&varsigma;"}, {"vartheta","&vartheta;"}, {"xi","&xi;"},
-      {"zeta","&zeta;"},
-      {"ALPHA","&Alpha;"}, {"BETA","&Beta;"}, {"CHI","&Chi;"}, {"DELTA","&Delta;"},
-      {"EPSILON","&Epsilon;"}, {"ETA","&Eta;"}, {"GAMMA","&Gamma;"}, {"IOTA","&Iota;"},
-      {"KAPPA","&Kappa;"}, {"LAMBDA","&Lambda;"}, {"MU","&Mu;"}, {"NU","&Nu;"},
-      {"OMEGA","&Omega;"}, {"OMICRON","&Omicron;"}, {"PHI","&Phi;"}, {"PI","&Pi;"},
-      {"PSI","&Psi;"}, {"RHO","&Rho;"}, {"SIGMA","&Sigma;"}, {"TAU","&Tau;"},
-      {"THETA","&Theta;"}, {"UPSILON","&Upsilon;"}, {"XI","&Xi;"}, {"ZETA","&Zeta;"}
-    };
-    m_specialPercentMap= {
-      { "and", "&and;"},
-      { "angle", "&#x2993;"},
-      { "element", "&isin;"},
-      { "identical", "&equiv;"},
-      { "infinite", "&infin;"},
-      { "noelement", "&notin;"},
-      { "notequal", "&neq;"},
-      { "or", "&or;"},
-      { "perthousand", "&permil;"},
-      { "strictlygreaterthan", "&gt;"},
-      { "strictlylessthan", "&lt;"},
-      { "tendto", "&rarr;"} // checkme
-    };
-    m_otherSpecialMap= {
-      { "emptyset", "&emptyset;" },
-      { "aleph", "&aleph;" },
-      { "setn", "&naturals;" },
-      { "setz", "&integers;" },
-      { "setq", "&rationals;" },
-      { "setr", "&reals;" },
-      { "setc", "&complexes;" },
-      { "infinity", "&#x221e;" },
-      { "infty", "&#x221e;" },
-      { "partial", "&#x2202;" },
-      { "nabla", "&#x2207;" },
-      { "exists", "&#x2203;" },
-      { "notexists", "&#x2204;" },
-      { "forall", "&#x2200;" },
-      { "hbar", "&#x210f;" },
-      { "lambdabar", "&#x19b;" },
-      { "re", "&#x211c;" },
-      { "im", "&#x2111;" },
-      { "wp", "&#x2118;" },
-      { "leftarrow", "&#x2190;" },
-      { "rightarrow", "&#x2192;" },
-      { "uparrow", "&#x2191;" },
-      { "downarrow", "&#x2193;" },
-      { "dotslow", "&#x2026;" },
-      { "dotsaxis", "&#x22ef;" },
-      { "dotsvert", "&#x22ee;" },
-      { "dotsup", "&#x22f0;" },
-      { "dotsdiag", "&#x22f0;" },
-      { "dotsdown", "&#x22f1;" },
-      { "backepsilon", "&#x3F6;" },
-    };
-    m_parenthesisMap= {
-      { "(", ")"},
-      { "[", "]"},
-      { "ldbracket", "rdbracket"},
-      { "lbrace", "rbrace"},
-      { "langle", "rangle"},
-      { "lceil", "rceil"},
-      { "lfloor", "rfloor"},
-      { "lline", "rline"},
-      { "ldline", "rdline"}
-      // and left right
-      // and { }
-    };
-    for (auto it : m_parenthesisMap)
-      m_parenthesisRightSet.insert(it.second);
-    m_parenthesisToStringMap = {
-      { "(", "("},
-      { ")", ")"},
-      { "[", "["},
-      { "]", "]"},
-      { "ldbracket", "&#x27e6;"},
-      { "rdbracket", "&#x27e7;"},
-      { "lbrace", "{"},
-      { "rbrace", "}"},
-      { "langle", "&#x2329;"},
-      { "rangle", "&#x232a;"},
-      { "lceil", "&#x2308;"},
-      { "rceil", "&#x2309;"},
-      { "lfloor", "&#x230a;"},
-      { "rfloor", "&#x230b;"},
-      { "lline", "|"},
-      { "rline", "|"},
-      { "ldline", "|"},
-      { "rdline", "|"}
-    };
-    m_unaryOperatorMap= {
-      { "+", "+"},
-      { "-", "-"},
-      { "plusminus", "&#xb1;"},
-      { "minusplus", "&#x2213;"},
-      { "+-", "&#xb1;"},
-      {"-+", "&#x2213;"},
-      { "neg", "&#xac;"},
-      { "uoper", ""}
-    };
-    m_function1Set= {
-      "abs", "fact", "sqrt", "ln",
-      "exp", "log", "sin", "cos", "tan",
-      "cot", "sinh", "cosh", "tanh", "coth",
-      "arcsin", "arccos", "arctan", "arccot", "arsinh",
-      "arcosh", "artanh", "arcoth",
-
-      // also matrix stack
-    };
-
-    m_function2Set= {
-      "nroot",
-      "binom"
-      // also func
-    };
-
-    // func 1-3 (ie. from, to optional)
-    m_integralMap= {
-      {"liminf", "liminf"},
-      {"limsup", "limsup"},
-      {"lim", "lim"},
-      {"sum", "&#x2211;"},
-      {"prod", "&#x220f;"},
-      {"coprod", "&#x2210;"},
-      {"int", "&#x222b;"},
-      {"intd", "&#x222b;"},
-      {"iint", "&#x222c;"},
-      {"iiint", "&#x222d;"},
-      {"lint", "&#x222e;"},
-      {"llint", "&#x222f;"},
-      {"lllint", "&#x2230;"}
-      // also oper
-    };
-
-    m_accent1Map= {
-      {"acute", "&#xb4;"}, {"grave", "`"}, {"breve", "&#x2d8;"}, {"circle", "&#x2da;"},
-      {"dot", "&#x2d9;"}, {"ddot", "&#xa8;"}, {"dddot", "&#x20db;"}, {"bar", "&#xaf;"}, {"vec", "&#x20d7;"},
-      {"tilde", "~"}, {"hat", "^"}, {"check", "&#x2c7;"},
-      { "widevec", "&#x20d7;"}, {"widetilde", "~"}, {"widehat", "^"}
-    };
-    m_accent1Set= {
-      "overline", "underline", "overstrike", "phantom",
-      "nospace",
-
-      "bold", "nbold", "ital", "italic", "nitalic",
-      "alignl", "alignr", "alignc",
-      "alignt", "alignm", "alignb"
-      // size, font, color
-    };
-    m_positionMap= {
-      { "lsub", 0},
-      { "csub", 1},
-      { "rsub", 2}, { "sub", 2}, {"_", 2},
-      { "underbrace", 3},
-      { "lsup", 4},
-      { "csup", 5},
-      { "rsup", 6}, { "sup", 6}, {"^", 6},
-      { "overbrace", 7}
-    };
-    m_multiplicationMap= {
-      {"*", "&#x2736;"},
-      {"/", "/"},
-      {"&", "&#x2227;"}
-    };
-    m_multiplicationStringMap= {
-      {"cdot", "&#x22c5;"},
-      {"times", "&#xd7;"},
-      {"over", ""},
-      {"div", "&#xf7;"},
-      {"slash", "/"},
-      {"wideslash", ""},
-      {"widebslash", "&#x2216;"},
-      {"and", "&#x2227;"},
-      {"or", "&#x2228;"},
-      {"bslash", "&#x2216;"},
-      {"odivide", "&#x2298;"},
-      {"odot", "&#x2299;"},
-      {"ominus", "&#x2296;"},
-      {"oplus", "&#x2295;"},
-      {"otimes", "&#x2297;"}
-      // "boper" oper <?>
-    };
-    m_additionSet= { "+", "-" };
-    m_additionStringMap= {
-      {"in", "&#x2208;"},
-      {"notin", "&#x2209;"},
-      {"owns", "&#x220b;"},
-      {"intersection", "&#x2229;"},
-      {"union", "&#x222a;"},
-      {"setminus", "&#x2216;"},
-      {"bslash", "&#x2216;"},
-      {"slash", "/"},
-      {"subset", "&#x2282;"},
-      {"subseteq", "&#x2286;"},
-      {"supset", "&#x2283;"},
-      {"supseteq", "&#x2287;"},
-      {"nsubset", "&#x2284;"},
-      {"nsubseteq", "&#x2288;"},
-      {"nsupset", "&#x2285;"},
-      {"nsupseteq", "&#x2289;"},
-      {"circ", "&#x2218;"}
-    };
-    m_relationMap= {
-      {"=", "="},
-      {"<>", "&#x2260;"},
-      {"<", "&lt;"},
-      {"<=", "&#x2264;"},
-      {">", "&gt;"},
-      {">=", "&#x2265;"},
-      {"<<", "&#x226a;"},
-      {">>", "&#x226b;"}
-    };
-    m_relationStringMap= {
-      {"neq", "&#x2260;"},
-      {"lt", "&lt;"},
-      {"leslant", "&#x2264;"},
-      {"gt", "&gt;"},
-      {"geslant", "&#x2265;"},
-      {"ll", "&#x226a;"},
-      {"gg", "&#x226b;"},
-      {"approx", "&#x2248;"},
-      {"sim", "&#x223c;"},
-      {"simeq", "&#x2243;"},
-      {"equiv", "&#x2261;"},
-      {"prop", "&#x221d;"},
-      {"parallel", "&#x2225;"},
-      {"ortho", "&#x22a5;"},
-      {"divides", "&#x2223;"},
-      {"ndivides", "&#x2224;"},
-      {"toward", "&#x2192;"},
-      {"dlarrow", "&#x21d0;"},
-      {"dlrarrow", "&#x21d4;"},
-      {"prec", "&#x227a;"},
-      {"succ", "&#x227b;"},
-      {"preccurlyeq", "&#x227c;"},
-      {"succcurlyeq", "&#x227d;"},
-      {"precsim", "&#x227e;"},
-      {"succsim", "&#x227f;"},
-      {"nprec", "&#x2280;"},
-      {"nsucc", "&#x2281;"},
-      {"def", "&#x225d;"},
-      {"transl", "&#x22b7;"},
-      {"transr", "&#x22b6;"}
-    };
-
   }
   //! try to parse a StarMath string
   bool parse(librevenge::RVNGString const &formula, librevenge::RVNGString &res);
@@ -501,10 +568,12 @@ protected:
       ++pos;
     }
   }
+  //! the keyword tables
+  Tables const &m_tables;
   //! the star math data
   std::vector<LexerData> m_dataList;
-  //! the output stream
-  std::stringstream m_output;
+  //! the output buffer
+  Output m_output;
   //! the current font size
   double m_fontSize;
   //! a flag to know if we are in bold or not
@@ -513,48 +582,6 @@ protected:
   bool m_italic;
   //! the font name
   std::string m_fontName;
-  //! the set of potential color
-  std::set<std::string> m_colorSet;
-  //! the font convert map
-  std::map<std::string, std::string> m_fontMap;
-  //! the greek convert map
-  std::map<std::string, std::string> m_greekMap;
-  //! the special percent convert map
-  std::map<std::string, std::string> m_specialPercentMap;
-  //! the remaining special key word
-  std::map<std::string, std::string> m_otherSpecialMap;
-  //! the parenthesis left/right map
-  std::map<std::string, std::string> m_parenthesisMap;
-  //! the parenthesis right map
-  std::set<std::string> m_parenthesisRightSet;
-  //! the parenthesis unicode map
-  std::map<std::string, std::string> m_parenthesisToStringMap;
-  //! the unary operator
-  std::map<std::string, std::string> m_unaryOperatorMap;
-  //! the function which have one argument
-  std::set<std::string> m_function1Set;
-  //! the function which have two argument
-  std::set<std::string> m_function2Set;
-  //! the function which have one to three argument (from to optional)
-  std::map<std::string, std::string> m_integralMap;
-  //! the accent which have one argument
-  std::map<std::string, std::string> m_accent1Map;
-  //! the accent which have one argument
-  std::set<std::string> m_accent1Set;
-  //! position symbol map
-  std::map<std::string, int> m_positionMap;
-  //! multiplication symbol operator
-  std::map<std::string, std::string> m_multiplicationMap;
-  //! multiplication symbol string operator
-  std::map<std::string, std::string> m_multiplicationStringMap;
-  //! addition symbol operator
-  std::set<std::string> m_additionSet;
-  //! addition symbol string operator
-  std::map<std::string, std::string> m_additionStringMap;
-  //! relation symbol operator
-  std::map<std::string, std::string> m_relationMap;
-  //! relation symbol string operator
-  std::map<std::string, std::string> m_relationStringMap;
 };
 
 std::shared_ptr<Node> Parser::expr() const
@@ -696,8 +723,8 @@ std::shared_ptr<Node> Parser::relationExpr(size_t &pos) const
     ignoreSpaces(pos, spaces);
     if (pos>=m_dataList.size()) break;
     auto const &data=m_dataList[pos];
-    if ((data.m_type==LexerData::Special && m_relationMap.find(data.m_string)!=m_relationMap.end()) ||
-        (data.m_type==LexerData::Unknown && m_relationStringMap.find(toLower(data.m_string))!=m_relationStringMap.end())) {
+    if ((data.m_type==LexerData::Special && m_tables.m_relationMap.find(data.m_string)!=m_tables.m_relationMap.end()) ||
+        (data.m_type==LexerData::Unknown && m_tables.m_relationStringMap.find(toLower(data.m_string))!=m_tables.m_relationStringMap.end())) {
       try {
         ++pos;
         term=additionExpr(pos);
@@ -740,8 +767,8 @@ std::shared_ptr<Node> Parser::additionExpr(size_t &pos) const
     ignoreSpaces(pos, spaces);
     if (pos>=m_dataList.size()) break;
     auto const &data=m_dataList[pos];
-    if ((data.m_type==LexerData::Special && m_additionSet.find(data.m_string)!=m_additionSet.end()) ||
-        (data.m_type==LexerData::Unknown && m_additionStringMap.find(toLower(data.m_string))!=m_additionStringMap.end())) {
+    if ((data.m_type==LexerData::Special && m_tables.m_additionSet.find(data.m_string)!=m_tables.m_additionSet.end()) ||
+        (data.m_type==LexerData::Unknown && m_tables.m_additionStringMap.find(toLower(data.m_string))!=m_tables.m_additionStringMap.end())) {
       try {
         ++pos;
         auto newChild=multiplicationExpr(pos);
@@ -780,8 +807,8 @@ std::shared_ptr<Node> Parser::multiplicationExpr(size_t &position) const
     ignoreSpaces(position, spaces);
     if (position+1>=m_dataList.size()) break;
     auto const &cData=m_dataList[position];
-    if ((cData.m_type==LexerData::Special && m_multiplicationMap.find(cData.m_string)!=m_multiplicationMap.end()) ||
-        (cData.m_type==LexerData::Unknown && m_multiplicationStringMap.find(toLower(cData.m_string))!=m_multiplicationStringMap.end())) {
+    if ((cData.m_type==LexerData::Special && m_tables.m_multiplicationMap.find(cData.m_string)!=m_tables.m_multiplicationMap.end()) ||
+        (cData.m_type==LexerData::Unknown && m_tables.m_multiplicationStringMap.find(toLower(cData.m_string))!=m_tables.m_multiplicationStringMap.end())) {
       try {
         ++position;
         auto newChild=positionExpr(position);
@@ -841,14 +868,14 @@ std::shared_ptr<Node> Parser::positionExpr(size_t &pos) const
     ignoreSpaces(pos, spaces);
     if (pos+1>=m_dataList.size()) break;
     auto const &data=m_dataList[pos];
-    if (m_positionMap.find(data.m_string)==m_positionMap.end() ||
+    if (m_tables.m_positionMap.find(data.m_string)==m_tables.m_positionMap.end() ||
         (std::isalpha(data.m_string[0]) && data.m_type!=LexerData::Unknown) ||
         (!std::isalpha(data.m_string[0]) && data.m_type!=LexerData::Special)) {
       pos=actPos;
       break;
     }
     try {
-      auto id=m_positionMap.find(data.m_string)->second;
+      auto id=m_tables.m_positionMap.find(data.m_string)->second;
       if (nodes[id])
         break;
       ++pos;
@@ -922,7 +949,7 @@ std::shared_ptr<Node> Parser::unaryOperatorExpr(size_t &pos, bool inPosition) co
   if (pos>=m_dataList.size())
     throw "Parser::unaryOperatorExpr: no data";
   auto data=m_dataList[pos];
-  if (data.m_type!=LexerData::String && m_unaryOperatorMap.find(toLower(data.m_string))!=m_unaryOperatorMap.end()) {
+  if (data.m_type!=LexerData::String && m_tables.m_unaryOperatorMap.find(toLower(data.m_string))!=m_tables.m_unaryOperatorMap.end()) {
     ++pos;
     auto term=unaryOperatorExpr(pos, inPosition);
     if (!term)
@@ -955,16 +982,16 @@ std::shared_ptr<Node> Parser::functionExpr(size_t &pos, bool inPosition) const
   bool specialAccent=false;
   int stackMatrixType=0;
   if (data.m_type==LexerData::Unknown) {
-    if (m_function1Set.find(toLower(data.m_string))!=m_function1Set.end())
+    if (m_tables.m_function1Set.find(toLower(data.m_string))!=m_tables.m_function1Set.end())
       numArg=1;
-    else if (m_function2Set.find(toLower(data.m_string))!=m_function2Set.end())
+    else if (m_tables.m_function2Set.find(toLower(data.m_string))!=m_tables.m_function2Set.end())
       numArg=2;
     else if (icmp(data.m_string,"func")) {
       isFunc=true;
       numArg=1;
     }
-    else if (m_accent1Map.find(toLower(data.m_string))!=m_accent1Map.end() ||
-             m_accent1Set.find(toLower(data.m_string))!=m_accent1Set.end()) {
+    else if (m_tables.m_accent1Map.find(toLower(data.m_string))!=m_tables.m_accent1Map.end() ||
+             m_tables.m_accent1Set.find(toLower(data.m_string))!=m_tables.m_accent1Set.end()) {
       type=Node::Accent;
       numArg=1;
     }
@@ -973,7 +1000,7 @@ std::shared_ptr<Node> Parser::functionExpr(size_t &pos, bool inPosition) const
       numArg=1;
       specialAccent=true;
     }
-    else if (m_integralMap.find(toLower(data.m_string))!=m_integralMap.end()) {
+    else if (m_tables.m_integralMap.find(toLower(data.m_string))!=m_tables.m_integralMap.end()) {
       type=Node::Integral;
       numArg=1;
     }
@@ -1134,7 +1161,7 @@ std::shared_ptr<Node> Parser::parenthesisExpr(size_t &position) const
     throw "Parser::parenthesisExpr: no data";
   auto data=m_dataList[position];
   if (data.m_type!=LexerData::String &&
-      (m_parenthesisMap.find(toLower(data.m_string))!=m_parenthesisMap.end() ||
+      (m_tables.m_parenthesisMap.find(toLower(data.m_string))!=m_tables.m_parenthesisMap.end() ||
        data.m_string=="{" || icmp(data.m_string,"left"))) {
     ++position;
     try {
@@ -1151,7 +1178,7 @@ std::shared_ptr<Node> Parser::parenthesisExpr(size_t &position) const
       else if (data.m_string=="{")
         node->m_data="}";
       else
-        node->m_data=m_parenthesisMap.find(toLower(data.m_string))->second;
+        node->m_data=m_tables.m_parenthesisMap.find(toLower(data.m_string))->second;
 
       auto newChild=sequenceExpr(position);
       if (newChild) {
@@ -1201,7 +1228,7 @@ std::shared_ptr<Node> Parser::leftParenthesisExpr(size_t &pos, std::function<std
     throw "Parser::leftParenthesisExpr: no data";
   auto data=m_dataList[pos];
   if (data.m_type!=LexerData::String && data.m_string.size()>=2 && data.m_string[0]=='\\' &&
-      m_parenthesisMap.find(toLower(data.m_string.c_str()+1))!=m_parenthesisMap.end()) {
+      m_tables.m_parenthesisMap.find(toLower(data.m_string.c_str()+1))!=m_tables.m_parenthesisMap.end()) {
     auto node=std::make_shared<Node>(Node::ParenthesisLeft, spaces);
     try {
       ++pos;
@@ -1217,7 +1244,7 @@ std::shared_ptr<Node> Parser::leftParenthesisExpr(size_t &pos, std::function<std
     throw "Parser::leftParenthesisExpr: left parenthesis is alone";
   }
   else if (data.m_type!=LexerData::String &&
-           (m_parenthesisRightSet.find(toLower(data.m_string))!=m_parenthesisRightSet.end() ||
+           (m_tables.m_parenthesisRightSet.find(toLower(data.m_string))!=m_tables.m_parenthesisRightSet.end() ||
             data.m_string=="}" || icmp(data.m_string,"right")))
     throw "Parser::leftParenthesisExpr: right parenthesis";
   return std::shared_ptr<Node>();
@@ -1234,7 +1261,7 @@ std::shared_ptr<Node> Parser::rightParenthesisExpr(size_t &pos, std::shared_ptr<
       break;
     auto data=m_dataList[pos];
     if (data.m_type!=LexerData::String && data.m_string.size()>=2 && data.m_string[0]=='\\' &&
-        m_parenthesisRightSet.find(toLower(data.m_string.c_str()+1))!=m_parenthesisRightSet.end()) {
+        m_tables.m_parenthesisRightSet.find(toLower(data.m_string.c_str()+1))!=m_tables.m_parenthesisRightSet.end()) {
       ++pos;
       auto node=std::make_shared<Node>(Node::ParenthesisRight, spaces);
       node->m_function=data.m_string.c_str()+1;
@@ -1258,12 +1285,12 @@ std::shared_ptr<Node> Parser::elementExpr(size_t &pos) const
   auto len=data.m_string.size();
   bool special=false;
   if (len>1 && data.m_type==LexerData::Unknown && data.m_string[0]=='%') {
-    special = m_greekMap.find(data.m_string.c_str()+1)!=m_greekMap.end() ||
-              m_specialPercentMap.find(toLower(data.m_string.c_str()+1))!=m_specialPercentMap.end() ||
-              (len>2 && data.m_string[1]=='i' && m_greekMap.find(data.m_string.c_str()+2)!=m_greekMap.end());
+    special = m_tables.m_greekMap.find(data.m_string.c_str()+1)!=m_tables.m_greekMap.end() ||
+              m_tables.m_specialPercentMap.find(toLower(data.m_string.c_str()+1))!=m_tables.m_specialPercentMap.end() ||
+              (len>2 && data.m_string[1]=='i' && m_tables.m_greekMap.find(data.m_string.c_str()+2)!=m_tables.m_greekMap.end());
   }
   else if (len>=1 && data.m_type!=LexerData::String)
-    special = m_otherSpecialMap.find(toLower(data.m_string))!=m_otherSpecialMap.end();
+    special = m_tables.m_otherSpecialMap.find(toLower(data.m_string))!=m_tables.m_otherSpecialMap.end();
   auto str=std::make_shared<Node>(special ? Node::Special :
                                   data.m_type==LexerData::Number ? Node::Number :
                                   data.m_type==LexerData::String ? Node::String : Node::Unknown, spaces);
@@ -1364,17 +1391,17 @@ bool Parser::convertInMML(Node const &node, bool addRow)
     auto len=node.m_data.size();
     bool done=true;
     if (len>1 && node.m_data[0]=='%') {
-      if (m_greekMap.find(node.m_data.c_str()+1)!=m_greekMap.end())
-        m_output << "<mi>" << m_greekMap.find(node.m_data.c_str()+1)->second << "</mi>";
-      else if (len>2 && node.m_data[1]=='i' && m_greekMap.find(node.m_data.c_str()+2)!=m_greekMap.end())
-        m_output << "<mi mathvariant='italic'>" << m_greekMap.find(node.m_data.c_str()+2)->second << "</mi>";
-      else if (m_specialPercentMap.find(toLower(node.m_data.c_str()+1))!=m_specialPercentMap.end())
-        m_output << "<mi>" << m_specialPercentMap.find(toLower(node.m_data.c_str()+1))->second << "</mi>";
+      if (m_tables.m_greekMap.find(node.m_data.c_str()+1)!=m_tables.m_greekMap.end())
+        m_output << "<mi>" << m_tables.m_greekMap.find(node.m_data.c_str()+1)->second << "</mi>";
+      else if (len>2 && node.m_data[1]=='i' && m_tables.m_greekMap.find(node.m_data.c_str()+2)!=m_tables.m_greekMap.end())
+        m_output << "<mi mathvariant='italic'>" << m_tables.m_greekMap.find(node.m_data.c_str()+2)->second << "</mi>";
+      else if (m_tables.m_specialPercentMap.find(toLower(node.m_data.c_str()+1))!=m_tables.m_specialPercentMap.end())
+        m_output << "<mi>" << m_tables.m_specialPercentMap.find(toLower(node.m_data.c_str()+1))->second << "</mi>";
       else
         done=false;
     }
-    else if (len>0 && m_otherSpecialMap.find(toLower(node.m_data))!=m_otherSpecialMap.end())
-      m_output << "<mi>" << m_otherSpecialMap.find(toLower(node.m_data))->second << "</mi>";
+    else if (len>0 && m_tables.m_otherSpecialMap.find(toLower(node.m_data))!=m_tables.m_otherSpecialMap.end())
+      m_output << "<mi>" << m_tables.m_otherSpecialMap.find(toLower(node.m_data))->second << "</mi>";
     else
       done=false;
     if (done)
@@ -1389,13 +1416,13 @@ bool Parser::convertInMML(Node const &node, bool addRow)
       break;
     }
     childDone=true;
-    if (m_accent1Map.find(toLower(node.m_function)) != m_accent1Map.end()) {
+    if (m_tables.m_accent1Map.find(toLower(node.m_function)) != m_tables.m_accent1Map.end()) {
       m_output << "<mover accent=\"true\">";
       convertInMML(*node.m_childs[0], true);
       if (icmp(node.m_function.substr(0,4), "wide"))
-        m_output << "<mo stretchy=\"true\">" << m_accent1Map.find(toLower(node.m_function))->second << "</mo>";
+        m_output << "<mo stretchy=\"true\">" << m_tables.m_accent1Map.find(toLower(node.m_function))->second << "</mo>";
       else
-        m_output << "<mo stretchy=\"false\">" << m_accent1Map.find(toLower(node.m_function))->second << "</mo>";
+        m_output << "<mo stretchy=\"false\">" << m_tables.m_accent1Map.find(toLower(node.m_function))->second << "</mo>";
       m_output << "</mover>";
       break;
     }
@@ -1426,7 +1453,7 @@ bool Parser::convertInMML(Node const &node, bool addRow)
       break;
     }
     else if (icmp(node.m_function,"color")) {
-      if (m_colorSet.find(toLower(node.m_data))!=m_colorSet.end()) {
+      if (m_tables.m_colorSet.find(toLower(node.m_data))!=m_tables.m_colorSet.end()) {
         m_output << "<mstyle color=\"" << toLower(node.m_data) << "\">";
         convertInMML(*node.m_childs[0]);
         m_output << "</mstyle>";
@@ -1454,8 +1481,8 @@ bool Parser::convertInMML(Node const &node, bool addRow)
     }
     else if (icmp(node.m_function,"font")) {
       auto oldName=m_fontName;
-      if (m_fontMap.find(toLower(node.m_data))!=m_fontMap.end()) {
-        m_fontName=m_fontMap.find(toLower(node.m_data))->second;
+      if (m_tables.m_fontMap.find(toLower(node.m_data))!=m_tables.m_fontMap.end()) {
+        m_fontName=m_tables.m_fontMap.find(toLower(node.m_data))->second;
         bool closeStyle=sendMathVariant();
         convertInMML(*node.m_childs[0]);
         if (closeStyle) m_output << "</mstyle>";
@@ -1523,7 +1550,7 @@ bool Parser::convertInMML(Node const &node, bool addRow)
     break;
   }
   case Node::Function: {
-    if (m_function1Set.find(toLower(node.m_function)) != m_function1Set.end() && node.m_childs.size()==1 && node.m_childs[0]) {
+    if (m_tables.m_function1Set.find(toLower(node.m_function)) != m_tables.m_function1Set.end() && node.m_childs.size()==1 && node.m_childs[0]) {
       // special function 1
       if (icmp(node.m_function, "abs")) {
         if (!addRow) m_output << "<mrow>";
@@ -1550,7 +1577,7 @@ bool Parser::convertInMML(Node const &node, bool addRow)
         break;
       }
     }
-    if (m_function2Set.find(toLower(node.m_function)) != m_function2Set.end() && node.m_childs.size()==2 && node.m_childs[0] && node.m_childs[1]) {
+    if (m_tables.m_function2Set.find(toLower(node.m_function)) != m_tables.m_function2Set.end() && node.m_childs.size()==2 && node.m_childs[0] && node.m_childs[1]) {
       if (icmp(node.m_function, "binom")) {
         m_output << "<mtable>";
         for (auto c : node.m_childs) {
@@ -1634,8 +1661,8 @@ bool Parser::convertInMML(Node const &node, bool addRow)
     if (!addRow) m_output << "<mrow>";
     if (icmp(node.m_function,"uoper"))
       m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_data) << "</mo>";
-    else if (m_unaryOperatorMap.find(toLower(node.m_function))!=m_unaryOperatorMap.end())
-      m_output << "<mo stretchy=\"false\">" << m_unaryOperatorMap.find(toLower(node.m_function))->second << "</mo>";
+    else if (m_tables.m_unaryOperatorMap.find(toLower(node.m_function))!=m_tables.m_unaryOperatorMap.end())
+      m_output << "<mo stretchy=\"false\">" << m_tables.m_unaryOperatorMap.find(toLower(node.m_function))->second << "</mo>";
     else
       m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_function) << "</mo>";
     convertInMML(*node.m_childs[0], true);
@@ -1661,17 +1688,17 @@ bool Parser::convertInMML(Node const &node, bool addRow)
       break;
     }
     convertInMML(*node.m_childs[0], true);
-    if (m_multiplicationStringMap.find(toLower(node.m_function))!=m_multiplicationStringMap.end()) {
-      auto op=m_multiplicationStringMap.find(toLower(node.m_function))->second;
+    if (m_tables.m_multiplicationStringMap.find(toLower(node.m_function))!=m_tables.m_multiplicationStringMap.end()) {
+      std::string op=m_tables.m_multiplicationStringMap.find(toLower(node.m_function))->second;
       if (!op.empty())
-        m_output << "<mo stretchy=\"false\">" << m_multiplicationStringMap.find(toLower(node.m_function))->second << "</mo>";
+        m_output << "<mo stretchy=\"false\">" << m_tables.m_multiplicationStringMap.find(toLower(node.m_function))->second << "</mo>";
       else if (icmp(op, "widebslah"))
         m_output << "<mo stretchy=\"false\">&#x2216;</mo>";
       else
         m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_function) << "</mo>";
     }
-    else if (m_multiplicationMap.find(node.m_function)!=m_multiplicationMap.end())
-      m_output << "<mo stretchy=\"false\">" << m_multiplicationMap.find(node.m_function)->second << "</mo>";
+    else if (m_tables.m_multiplicationMap.find(node.m_function)!=m_tables.m_multiplicationMap.end())
+      m_output << "<mo stretchy=\"false\">" << m_tables.m_multiplicationMap.find(node.m_function)->second << "</mo>";
     else if (icmp(node.m_function, "boper"))
       m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_data) << "</mo>";
     else
@@ -1685,8 +1712,8 @@ bool Parser::convertInMML(Node const &node, bool addRow)
       break;
     }
     convertInMML(*node.m_childs[0], true);
-    if (m_additionStringMap.find(toLower(node.m_function))!=m_additionStringMap.end())
-      m_output << "<mo stretchy=\"false\">" << m_additionStringMap.find(toLower(node.m_function))->second << "</mo>";
+    if (m_tables.m_additionStringMap.find(toLower(node.m_function))!=m_tables.m_additionStringMap.end())
+      m_output << "<mo stretchy=\"false\">" << m_tables.m_additionStringMap.find(toLower(node.m_function))->second << "</mo>";
     else
       m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_function) << "</mo>";
     convertInMML(*node.m_childs[1], true);
@@ -1698,10 +1725,10 @@ bool Parser::convertInMML(Node const &node, bool addRow)
       break;
     }
     convertInMML(*node.m_childs[0], true);
-    if (m_relationMap.find(node.m_function)!=m_relationMap.end())
-      m_output << "<mo stretchy=\"false\">" << m_relationMap.find(node.m_function)->second << "</mo>";
-    else if (m_relationStringMap.find(toLower(node.m_function))!=m_relationStringMap.end())
-      m_output << "<mo stretchy=\"false\">" << m_relationStringMap.find(toLower(node.m_function))->second << "</mo>";
+    if (m_tables.m_relationMap.find(node.m_function)!=m_tables.m_relationMap.end())
+      m_output << "<mo stretchy=\"false\">" << m_tables.m_relationMap.find(node.m_function)->second << "</mo>";
+    else if (m_tables.m_relationStringMap.find(toLower(node.m_function))!=m_tables.m_relationStringMap.end())
+      m_output << "<mo stretchy=\"false\">" << m_tables.m_relationStringMap.find(toLower(node.m_function))->second << "</mo>";
     else
       m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_function) << "</mo>";
     convertInMML(*node.m_childs[1], true);
@@ -1715,8 +1742,8 @@ bool Parser::convertInMML(Node const &node, bool addRow)
     if (!addRow) m_output << "<mrow>";
     std::string what(node.m_childs[0] ? (node.m_childs[1] ? "munderover" : "munder") : node.m_childs[1] ? "mover" : "");
     if (!what.empty()) m_output << "<" << what << ">";
-    if (m_integralMap.find(toLower(node.m_function))!=m_integralMap.end())
-      m_output << "<mo stretchy=\"false\">" << m_integralMap.find(toLower(node.m_function))->second << "</mo>";
+    if (m_tables.m_integralMap.find(toLower(node.m_function))!=m_tables.m_integralMap.end())
+      m_output << "<mo stretchy=\"false\">" << m_tables.m_integralMap.find(toLower(node.m_function))->second << "</mo>";
     else if (icmp(node.m_function,"oper"))
       m_output << "<mo stretchy=\"false\">" << getEscapedString(node.m_data) << "</mo>";
     else
@@ -1757,13 +1784,13 @@ bool Parser::convertInMML(Node const &node, bool addRow)
     }
     else {
       m_output << "<mfenced open=\"";
-      if (m_parenthesisToStringMap.find(toLower(left))!=m_parenthesisToStringMap.end())
-        m_output << m_parenthesisToStringMap.find(toLower(left))->second;
+      if (m_tables.m_parenthesisToStringMap.find(toLower(left))!=m_tables.m_parenthesisToStringMap.end())
+        m_output << m_tables.m_parenthesisToStringMap.find(toLower(left))->second;
       else if (!left.empty() && !icmp(left,"none"))
         m_output << getEscapedString(left);
       m_output << "\" close=\"";
-      if (m_parenthesisToStringMap.find(toLower(right))!=m_parenthesisToStringMap.end())
-        m_output << m_parenthesisToStringMap.find(toLower(right))->second;
+      if (m_tables.m_parenthesisToStringMap.find(toLower(right))!=m_tables.m_parenthesisToStringMap.end())
+        m_output << m_tables.m_parenthesisToStringMap.find(toLower(right))->second;
       else if (!right.empty() && !icmp(right,"none"))
         m_output << getEscapedString(right);
       m_output << "\">";
@@ -1908,6 +1935,11 @@ bool Parser::convertPositionInMML(Node const &node)
 
 bool Parser::parse(librevenge::RVNGString const &formula, librevenge::RVNGString &res)
 {
+  // reset the state of the previous formula
+  m_dataList.clear();
+  m_fontSize=12;
+  m_bold=m_italic=false;
+  m_fontName.clear();
   if (!convert(formula, m_dataList)) {
     STOFF_DEBUG_MSG(("STOFFStarMathToMMLConverterInternal::parser::convert: can not lex %s\n", formula.cstr()));
     return false;
@@ -2075,18 +2107,18 @@ bool Parser::convert(librevenge::RVNGString const &starMath, std::vector<LexerDa
       continue;
     }
     if (actData.m_string=="%" && dataList[i+1].m_type==LexerData::Unknown &&
-        (m_greekMap.find(dataList[i+1].m_string)!=m_greekMap.end() || // basic greek caracter
+        (m_tables.m_greekMap.find(dataList[i+1].m_string)!=m_tables.m_greekMap.end() || // basic greek caracter
          (dataList[i+1].m_string.size()>2 && dataList[i+1].m_string[0]=='i' &&
-          m_greekMap.find(dataList[i+1].m_string.c_str()+1)!=m_greekMap.end()) || // italic caracter
-         m_specialPercentMap.find(toLower(dataList[i+1].m_string))!=m_specialPercentMap.end())) { // other caracter
+          m_tables.m_greekMap.find(dataList[i+1].m_string.c_str()+1)!=m_tables.m_greekMap.end()) || // italic caracter
+         m_tables.m_specialPercentMap.find(toLower(dataList[i+1].m_string))!=m_tables.m_specialPercentMap.end())) { // other caracter
       LexerData newData;
       newData.m_string=actData.m_string+dataList[++i].m_string;
       lexList.push_back(newData);
       continue;
     }
     if (actData.m_string=="\\" && dataList[i+1].m_type!=LexerData::String) {
-      bool isSpecial=m_parenthesisMap.find(toLower(dataList[i+1].m_string))!=m_parenthesisMap.end() ||
-                     m_parenthesisRightSet.find(toLower(dataList[i+1].m_string))!=m_parenthesisRightSet.end();
+      bool isSpecial=m_tables.m_parenthesisMap.find(toLower(dataList[i+1].m_string))!=m_tables.m_parenthesisMap.end() ||
+                     m_tables.m_parenthesisRightSet.find(toLower(dataList[i+1].m_string))!=m_tables.m_parenthesisRightSet.end();
       if (isSpecial || dataList[i+1].m_string=="{" || dataList[i+1].m_string=="}") { // \{ and \} seems to be converted in caracter
         LexerData newData;
         if (!isSpecial) {
@@ -2095,7 +2127,7 @@ bool Parser::convert(librevenge::RVNGString const &starMath, std::vector<LexerDa
         }
         else {
           newData.m_string=actData.m_string+dataList[++i].m_string;
-          if (!std::isalpha(dataList[i+1].m_string[0])) // ()[]
+          if (!std::isalpha(static_cast<unsigned char>(dataList[i].m_string[0]))) // ()[]
             newData.m_type=LexerData::Special;
         }
         lexList.push_back(newData);
@@ -2107,12 +2139,219 @@ bool Parser::convert(librevenge::RVNGString const &starMath, std::vector<LexerDa
   return true;
 }
 }
-bool STOFFStarMathToMMLConverter::convertStarMath(librevenge::RVNGString const &starMath, librevenge::RVNGString &mml)
+
+namespace STOFFStarMathToMMLConverterInternal
+{
+//! a converted formula
+struct Result {
+  //! constructor
+  Result()
+    : m_ok(false)
+    , m_mml()
+  {
+  }
+  //! a flag to know if the conversion succeeds
+  bool m_ok;
+  //! the MathML formula
+  librevenge::RVNGString m_mml;
+};
+
+//! a process-wide cache of the converted formulas
+class Cache
+{
+public:
+  //! returns the cache
+  static Cache &get()
+  {
+    static Cache cache;
+    return cache;
+  }
+  //! sets the maximum number of formulas, 0 means disabled
+  void setMaxSize(size_t maxSize)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxSize=maxSize;
+    resize();
+  }
+  //! returns the number of hits and misses
+  void getStatistics(unsigned long &numHits, unsigned long &numMisses)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    numHits=m_numHits;
+    numMisses=m_numMisses;
+  }
+  //! try to find a formula, returns false if the formula is not in the cache
+  bool find(std::string const &formula, Result &result)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_maxSize)
+      return false;
+    auto it=m_formulaToEntryMap.find(formula);
+    if (it==m_formulaToEntryMap.end()) {
+      ++m_numMisses;
+      return false;
+    }
+    ++m_numHits;
+    m_entryList.splice(m_entryList.begin(), m_entryList, it->second);
+    result=it->second->second;
+    return true;
+  }
+  //! stores the result of a conversion
+  void store(std::string const &formula, Result const &result)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_maxSize || m_formulaToEntryMap.find(formula)!=m_formulaToEntryMap.end())
+      return;
+    m_entryList.push_front(std::make_pair(formula, result));
+    m_formulaToEntryMap[formula]=m_entryList.begin();
+    resize();
+  }
+protected:
+  //! constructor
+  Cache()
+    : m_mutex()
+    , m_maxSize(0)
+    , m_numHits(0)
+    , m_numMisses(0)
+    , m_entryList()
+    , m_formulaToEntryMap()
+  {
+  }
+  //! removes the least recently used formulas, the mutex must be locked
+  void resize()
+  {
+    while (m_entryList.size()>m_maxSize) {
+      m_formulaToEntryMap.erase(m_entryList.back().first);
+      m_entryList.pop_back();
+    }
+  }
+
+  //! a mutex to protect the data
+  std::mutex m_mutex;
+  //! the maximum number of formulas
+  size_t m_maxSize;
+  //! the number of formulas found in the cache
+  unsigned long m_numHits;
+  //! the number of formulas not found in the cache
+  unsigned long m_numMisses;
+  //! the list of formulas and results, the most recently used first
+  std::list<std::pair<std::string, Result> > m_entryList;
+  //! a map formula to its position in m_entryList
+  std::unordered_map<std::string, std::list<std::pair<std::string, Result> >::iterator> m_formulaToEntryMap;
+private:
+  Cache(Cache const &orig) = delete;
+  Cache &operator=(Cache const &orig) = delete;
+};
+}
+
+STOFFStarMathToMMLConverter::STOFFStarMathToMMLConverter()
+  : m_parser(new STOFFStarMathToMMLConverterInternal::Parser)
+{
+}
+
+STOFFStarMathToMMLConverter::~STOFFStarMathToMMLConverter()
+{
+}
+
+bool STOFFStarMathToMMLConverter::convert(librevenge::RVNGString const &starMath, librevenge::RVNGString &mml)
 {
   //std::cerr << "Try to convert " << starMath.cstr() << "\n";
-  STOFFStarMathToMMLConverterInternal::Parser parser;
-  bool ok=parser.parse(starMath, mml);
+  bool ok=m_parser->parse(starMath, mml);
   //std::cout << mml.cstr() << "\n";
   return ok;
 }
+
+bool STOFFStarMathToMMLConverter::convertStarMath(librevenge::RVNGString const &starMath, librevenge::RVNGString &mml)
+{
+  auto &cache=STOFFStarMathToMMLConverterInternal::Cache::get();
+  std::string const formula(starMath.cstr());
+  STOFFStarMathToMMLConverterInternal::Result result;
+  if (!cache.find(formula, result)) {
+    // the parser resets its state before each formula, so it can be reused by all the calls of a thread
+    static thread_local STOFFStarMathToMMLConverter converter;
+    result.m_ok=converter.convert(starMath, result.m_mml);
+    cache.store(formula, result);
+  }
+  if (result.m_ok)
+    mml=result.m_mml;
+  return result.m_ok;
+}
+
+void STOFFStarMathToMMLConverter::convertStarMathList(std::vector<librevenge::RVNGString> const &starMaths,
+    std::vector<librevenge::RVNGString> &mmls, std::vector<bool> &oks, int numThreads)
+{
+  mmls.assign(starMaths.size(), librevenge::RVNGString());
+  oks.assign(starMaths.size(), false);
+  // retrieve the formulas in the cache, the other formulas are converted only once
+  auto &cache=STOFFStarMathToMMLConverterInternal::Cache::get();
+  std::vector<std::string> formulas;
+  std::vector<std::vector<size_t> > formulaToPositionsList;
+  std::unordered_map<std::string, size_t> formulaToIdMap;
+  for (size_t i=0; i<starMaths.size(); ++i) {
+    std::string formula(starMaths[i].cstr());
+    auto it=formulaToIdMap.find(formula);
+    if (it!=formulaToIdMap.end()) {
+      formulaToPositionsList[it->second].push_back(i);
+      continue;
+    }
+    STOFFStarMathToMMLConverterInternal::Result result;
+    if (cache.find(formula, result)) {
+      mmls[i]=result.m_mml;
+      oks[i]=result.m_ok;
+      continue;
+    }
+    formulaToIdMap[formula]=formulas.size();
+    formulas.push_back(formula);
+    formulaToPositionsList.push_back(std::vector<size_t>(1,i));
+  }
+  if (formulas.empty())
+    return;
+
+  std::vector<STOFFStarMathToMMLConverterInternal::Result> results(formulas.size());
+  std::atomic<size_t> nextFormula(0);
+  auto worker=[&]() {
+    STOFFStarMathToMMLConverter converter;
+    while (true) {
+      size_t const id=nextFormula++;
+      if (id>=formulas.size()) break;
+      try {
+        results[id].m_ok=converter.convert(starMaths[formulaToPositionsList[id][0]], results[id].m_mml);
+      }
+      catch (...) {
+        results[id].m_ok=false;
+      }
+    }
+  };
+#ifdef USE_THREADS
+  size_t const numWorkers=numThreads>1 ? std::min(size_t(numThreads-1), formulas.size()-1) : 0;
+  std::vector<std::thread> threads;
+  for (size_t i=0; i<numWorkers; ++i)
+    threads.push_back(std::thread(worker));
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+#else
+  (void) numThreads;
+  worker();
+#endif
+
+  for (size_t id=0; id<formulas.size(); ++id) {
+    auto const &result=results[id];
+    cache.store(formulas[id], result);
+    for (auto pos : formulaToPositionsList[id]) {
+      mmls[pos]=result.m_mml;
+      oks[pos]=result.m_ok;
+    }
+  }
+}
+
+void STOFFStarMathToMMLConverter::setCacheSize(size_t numFormulas)
+{
+  STOFFStarMathToMMLConverterInternal::Cache::get().setMaxSize(numFormulas);
+}
+
+void STOFFStarMathToMMLConverter::getCacheStatistics(unsigned long &numHits, unsigned long &numMisses)
+{
+  STOFFStarMathToMMLConverterInternal::Cache::get().getStatistics(numHits, numMisses);
+}
 // vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -36,17 +36,47 @@
 
 #include "libstaroffice_internal.hxx"
 
-/** \brief  basic class to convert a StarMath formula in MML */
+namespace STOFFStarMathToMMLConverterInternal
+{
+class Parser;
+}
+
+/** \brief  basic class to convert a StarMath formula in MML
+
+    \note the keyword tables are shared by all the converters and the
+    parser of a converter is reused, so a converter must be kept to
+    convert many formulas */
 class STOFFStarMathToMMLConverter
 {
 public:
   //!constructor
-  STOFFStarMathToMMLConverter()
-  {
-  }
-
+  STOFFStarMathToMMLConverter();
+  //! destructor
+  ~STOFFStarMathToMMLConverter();
   //! try to convert a StarMath formula to a MML formula
+  bool convert(librevenge::RVNGString const &starMath, librevenge::RVNGString &mml);
+
+  //! try to convert a StarMath formula to a MML formula, using the formula cache
   static bool convertStarMath(librevenge::RVNGString const &starMath, librevenge::RVNGString &mml);
+  /** try to convert a list of StarMath formulas to MML formulas, using the formula cache.
+
+      The formulas which are repeated are only converted once and the remaining formulas
+      are converted by numThreads threads (if the library is built with threads).
+
+      \note this function is only used by mathbench: the library converts the formula
+      of each math object with convertStarMath when the object is read */
+  static void convertStarMathList(std::vector<librevenge::RVNGString> const &starMaths,
+                                  std::vector<librevenge::RVNGString> &mmls, std::vector<bool> &oks, int numThreads=1);
+  //! sets the maximum number of formulas kept in the process-wide cache, 0 disables the cache
+  static void setCacheSize(size_t numFormulas);
+  //! returns the number of formulas found and not found in the cache
+  static void getCacheStatistics(unsigned long &numHits, unsigned long &numMisses);
+protected:
+  //! the parser
+  std::shared_ptr<STOFFStarMathToMMLConverterInternal::Parser> m_parser;
+private:
+  STOFFStarMathToMMLConverter(STOFFStarMathToMMLConverter const &orig) = delete;
+  STOFFStarMathToMMLConverter &operator=(STOFFStarMathToMMLConverter const &orig) = delete;
 };
 
 #endif
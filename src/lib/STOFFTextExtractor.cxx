@@ -0,0 +1,148 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#include <librevenge/librevenge.h>
+
+#include "STOFFTextExtractor.hxx"
+
+STOFFTextExtractor::STOFFTextExtractor(librevenge::RVNGTextInterface *documentInterface)
+  : m_documentInterface(documentInterface)
+  , m_textBuffer()
+  , m_isDocumentStarted(false)
+  , m_isParagraphOpened(false)
+{
+}
+
+STOFFTextExtractor::~STOFFTextExtractor()
+{
+}
+
+void STOFFTextExtractor::startDocument()
+{
+  if (m_isDocumentStarted) {
+    STOFF_DEBUG_MSG(("STOFFTextExtractor::startDocument: the document is already started\n"));
+    return;
+  }
+  m_isDocumentStarted=true;
+  if (m_documentInterface)
+    m_documentInterface->startDocument(librevenge::RVNGPropertyList());
+}
+
+void STOFFTextExtractor::endDocument()
+{
+  if (!m_isDocumentStarted) {
+    STOFF_DEBUG_MSG(("STOFFTextExtractor::endDocument: the document is not started\n"));
+    return;
+  }
+  if (m_isParagraphOpened)
+    insertEOL();
+  m_isDocumentStarted=false;
+  if (m_documentInterface)
+    m_documentInterface->endDocument();
+}
+
+void STOFFTextExtractor::openParagraph()
+{
+  if (m_isParagraphOpened) return;
+  if (!m_isDocumentStarted)
+    startDocument();
+  m_isParagraphOpened=true;
+  if (m_documentInterface)
+    m_documentInterface->openParagraph(librevenge::RVNGPropertyList());
+}
+
+void STOFFTextExtractor::flushText()
+{
+  if (m_textBuffer.empty()) return;
+  if (m_documentInterface)
+    m_documentInterface->insertText(m_textBuffer);
+  m_textBuffer.clear();
+}
+
+void STOFFTextExtractor::insertUnicodeSpan(uint32_t const *characters, size_t numCharacters)
+{
+  if (!characters || !numCharacters) return;
+  openParagraph();
+  size_t first=0;
+  for (size_t c=0; c<numCharacters; ++c) {
+    uint32_t ch=characters[c];
+    if (ch!=0x9 && ch!=0xa && ch!=0xc)
+      continue;
+    if (c>first)
+      libstoff::appendUnicode(characters+first, c-first, m_textBuffer);
+    first=c+1;
+    if (ch==0x9)
+      insertTab();
+    else
+      insertEOL(true);
+  }
+  if (numCharacters>first)
+    libstoff::appendUnicode(characters+first, numCharacters-first, m_textBuffer);
+}
+
+void STOFFTextExtractor::insertUnicodeString(librevenge::RVNGString const &str)
+{
+  if (str.empty()) return;
+  openParagraph();
+  m_textBuffer.append(str);
+}
+
+void STOFFTextExtractor::insertTab()
+{
+  openParagraph();
+  flushText();
+  if (m_documentInterface)
+    m_documentInterface->insertTab();
+}
+
+void STOFFTextExtractor::insertEOL(bool softBreak)
+{
+  if (softBreak) {
+    openParagraph();
+    flushText();
+    if (m_documentInterface)
+      m_documentInterface->insertLineBreak();
+    return;
+  }
+  if (!m_isParagraphOpened) {
+    // an empty paragraph
+    openParagraph();
+  }
+  flushText();
+  m_isParagraphOpened=false;
+  if (m_documentInterface)
+    m_documentInterface->closeParagraph();
+}
+
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
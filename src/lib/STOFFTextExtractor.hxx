@@ -0,0 +1,90 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+
+#ifndef STOFF_TEXT_EXTRACTOR
+#  define STOFF_TEXT_EXTRACTOR
+
+#include <vector>
+
+#include "libstaroffice_internal.hxx"
+
+/** a light class used to retrieve only the text content of a document: the text and the paragraph boundaries.
+
+    \note contrary to a listener, this class ignores all the styles, so the objects must send their content
+    without resolving their styles nor calling StarAttribute::addTo.
+ */
+class STOFFTextExtractor
+{
+public:
+  //! constructor
+  explicit STOFFTextExtractor(librevenge::RVNGTextInterface *documentInterface);
+  //! destructor
+  ~STOFFTextExtractor();
+  //! starts the document
+  void startDocument();
+  //! ends the document
+  void endDocument();
+  //! adds a run of unicode characters: 0x9 is a tab, 0xa/0xc a line break
+  void insertUnicodeSpan(uint32_t const *characters, size_t numCharacters);
+  //! adds a list of unicode characters
+  void insertUnicodeList(std::vector<uint32_t> const &list)
+  {
+    if (!list.empty())
+      insertUnicodeSpan(&list[0], list.size());
+  }
+  //! adds a unicode string
+  void insertUnicodeString(librevenge::RVNGString const &str);
+  //! adds a tab
+  void insertTab();
+  //! adds an end of line ( by default an hard one, ie. a paragraph boundary)
+  void insertEOL(bool softBreak=false);
+protected:
+  //! opens the paragraph if needed
+  void openParagraph();
+  //! sends the text buffer
+  void flushText();
+  //! the document interface
+  librevenge::RVNGTextInterface *m_documentInterface;
+  //! the text buffer
+  librevenge::RVNGString m_textBuffer;
+  //! a flag to know if the document is opened
+  bool m_isDocumentStarted;
+  //! a flag to know if a paragraph is opened
+  bool m_isParagraphOpened;
+private:
+  STOFFTextExtractor(STOFFTextExtractor const &orig) = delete;
+  STOFFTextExtractor &operator=(STOFFTextExtractor const &orig) = delete;
+};
+#endif
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
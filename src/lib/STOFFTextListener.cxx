@@ -315,6 +315,19 @@ void STOFFTextListener::insertUnicode(uint32_t val)
   libstoff::appendUnicode(val, m_ps->m_textBuffer);
 }
 
+void STOFFTextListener::insertUnicodeSpan(uint32_t const *characters, size_t numCharacters)
+{
+  if (!characters || !numCharacters) return;
+  _flushDeferredTabs();
+  if (!m_ps->m_isSpanOpened) _openSpan();
+  if (libstoff::appendUnicode(characters, numCharacters, m_ps->m_textBuffer)) {
+    static int numErrors=0;
+    if (++numErrors<10) {
+      STOFF_DEBUG_MSG(("STOFFTextListener::insertUnicodeSpan: find some odd chars\n"));
+    }
+  }
+}
+
 void STOFFTextListener::insertUnicodeString(librevenge::RVNGString const &str)
 {
   _flushDeferredTabs();
@@ -1038,29 +1051,26 @@ void STOFFTextListener::_flushDeferredTabs()
 
 void STOFFTextListener::_flushText()
 {
-  if (m_ps->m_textBuffer.len() == 0) return;
+  if (m_ps->m_textBuffer.empty()) return;
 
   // when some many ' ' follows each other, call insertSpace
-  librevenge::RVNGString tmpText;
-  int numConsecutiveSpaces = 0;
-  librevenge::RVNGString::Iter i(m_ps->m_textBuffer);
-  for (i.rewind(); i.next();) {
-    if (*(i()) == 0x20) // this test is compatible with unicode format
-      numConsecutiveSpaces++;
-    else
-      numConsecutiveSpaces = 0;
-
-    if (numConsecutiveSpaces > 1) {
-      if (tmpText.len() > 0) {
-        m_documentInterface->insertText(tmpText);
-        tmpText.clear();
-      }
+  // note: as ' ' can not appear in a utf8 multibyte sequence, we can look directly for it in the buffer
+  char const *text=m_ps->m_textBuffer.cstr();
+  size_t const len=size_t(m_ps->m_textBuffer.size());
+  size_t first=0, pos=0;
+  while (pos<len) {
+    auto const *space=static_cast<char const *>(std::memchr(text+pos, ' ', len-pos));
+    if (!space) break;
+    pos=size_t(space-text)+1;
+    if (pos>=len || text[pos]!=' ') continue;
+    // the first space is kept in the text, the following ones are sent with insertSpace
+    if (pos>first)
+      m_documentInterface->insertText(librevenge::RVNGString(std::string(text+first, pos-first).c_str()));
+    for (; pos<len && text[pos]==' '; ++pos)
       m_documentInterface->insertSpace();
-    }
-    else
-      tmpText.append(i());
+    first=pos;
   }
-  m_documentInterface->insertText(tmpText);
+  m_documentInterface->insertText(librevenge::RVNGString(text+first));
   m_ps->m_textBuffer.clear();
 }
 
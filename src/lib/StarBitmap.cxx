@@ -35,6 +35,8 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -50,13 +52,55 @@
 
 #include "StarItemPool.hxx"
 #include "StarZone.hxx"
-#include "STOFFStringStream.hxx"
+#include "STOFFInflateStream.hxx"
+#include "STOFFPNGEncoder.hxx"
+#include "STOFFParseTrace.hxx"
+#include "STOFFResourceGovernor.hxx"
 
 #include "StarBitmap.hxx"
 
 /** Internal: the structures of a StarBitmap */
 namespace StarBitmapInternal
 {
+////////////////////////////////////////////////////////////
+//! internal: a table used to unpack the 1 bit rows: byte -> 8 palette indices
+struct BitsTable {
+  //! constructor
+  BitsTable()
+  {
+    for (int b=0; b<256; ++b) {
+      for (int i=0; i<8; ++i)
+        m_table[b][i]=uint8_t((b>>(7-i))&1);
+    }
+  }
+  //! returns the table
+  static BitsTable const &get()
+  {
+    static BitsTable const table;
+    return table;
+  }
+  //! the table
+  uint8_t m_table[256][8];
+};
+
+////////////////////////////////////////////////////////////
+//! internal: the buffers used to unpack and reduce the rows
+struct RowBuffers {
+  //! constructor
+  RowBuffers()
+    : m_colors()
+    , m_indices()
+    , m_sums()
+  {
+  }
+  //! the unpacked colors
+  std::vector<uint32_t> m_colors;
+  //! the unpacked palette indices
+  std::vector<uint8_t> m_indices;
+  //! the sums of the components of a reduced row
+  std::vector<uint64_t> m_sums;
+};
+
 ////////////////////////////////////////////////////////////
 //! internal: the bitmap information
 struct Bitmap {
@@ -69,51 +113,249 @@ struct Bitmap {
     , m_compression(0)
     , m_sizeImage(0)
     , m_hasAlphaColor(false)
+    , m_littleEndian(true)
     , m_colorsList()
     , m_indexDataList()
-    , m_colorDataList()
+    , m_rowSize(0)
+    , m_rowsData()
   {
     m_pixelsPerMeter[0]=m_pixelsPerMeter[1]=0;
     m_numColors[0]=m_numColors[1]=0;
+    for (int i=0; i<3; ++i) {
+      m_RGBMask[i]=0;
+      m_RGBShift[i]=0;
+    }
+  }
+  //! returns true if the pixels are defined by a palette index
+  bool isIndexed() const
+  {
+    return !m_indexDataList.empty() || (!m_rowsData.empty() && m_bitCount<=8);
   }
-  //! try to return a ppm data (without alpha)
-  bool getPPMData(librevenge::RVNGBinaryData &data) const
+  //! returns true if the bitmap contains some data
+  bool checkData() const
   {
-    if (!m_width || !m_height || ((m_colorsList.empty() || m_indexDataList.empty()) && m_colorDataList.empty()))
+    if (!m_width || !m_height)
       return false;
-    data.clear();
-    std::stringstream f;
-    f << "P6\n" << m_width << " " << m_height << " 255\n";
-    auto const header = f.str();
-    data.append(reinterpret_cast<const unsigned char *>(header.c_str()), header.size());
-    if (!m_colorDataList.empty()) {
-      if (m_colorDataList.size()!=size_t(m_width*m_height)) {
-        STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getPPMData: color data list's size is bad\n"));
+    if (!m_indexDataList.empty()) {
+      if (m_colorsList.empty() || m_indexDataList.size()/m_width!=m_height || m_indexDataList.size()%m_width!=0) {
+        STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::checkData: index data list's size is bad\n"));
+        return false;
+      }
+      return true;
+    }
+    if (m_rowsData.empty())
+      return false;
+    if (!m_rowSize || m_rowsData.size()/m_rowSize<m_height || (m_bitCount<=8 && m_colorsList.empty())) {
+      STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::checkData: the rows data seems bad\n"));
+      return false;
+    }
+    return true;
+  }
+  //! try to unpack the palette indices of a row, row must contain m_width indices
+  bool getIndexRow(uint32_t y, uint8_t *row) const
+  {
+    if (y>=m_height) return false;
+    if (!m_indexDataList.empty()) {
+      std::memcpy(row, &m_indexDataList[size_t(y)*size_t(m_width)], size_t(m_width));
+      return true;
+    }
+    uint8_t const *src=&m_rowsData[size_t(y)*m_rowSize];
+    switch (m_bitCount) {
+    case 1: {
+      auto const &table=BitsTable::get().m_table;
+      uint32_t x=0;
+      for (; x+8<=m_width; x+=8)
+        std::memcpy(row+x, table[*(src++)], 8);
+      if (x<m_width)
+        std::memcpy(row+x, table[*src], size_t(m_width-x));
+      return true;
+    }
+    case 4: {
+      uint32_t x=0;
+      for (; x+2<=m_width; x+=2, ++src) {
+        row[x]=uint8_t(*src>>4);
+        row[x+1]=uint8_t(*src&0xf);
+      }
+      if (x<m_width)
+        row[x]=uint8_t(*src>>4);
+      return true;
+    }
+    case 8:
+      std::memcpy(row, src, size_t(m_width));
+      return true;
+    default:
+      break;
+    }
+    STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getIndexRow: unexpected bit count %d\n", int(m_bitCount)));
+    return false;
+  }
+  //! try to unpack the colors of a row, row must contain m_width colors
+  bool getColorRow(uint32_t y, uint32_t *row, std::vector<uint8_t> &buffer) const
+  {
+    if (isIndexed()) {
+      buffer.resize(size_t(m_width));
+      if (!getIndexRow(y, &buffer[0]))
         return false;
+      size_t const numColors=m_colorsList.size();
+      for (uint32_t x=0; x<m_width; ++x) {
+        if (buffer[x]>=numColors) {
+          STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getColorRow: find bad index=%d\n", int(buffer[x])));
+          return false;
+        }
+        row[x]=m_colorsList[buffer[x]].value();
       }
-      for (auto const &c : m_colorDataList) {
-        uint32_t col=c.value();
+      return true;
+    }
+    if (y>=m_height) return false;
+    uint8_t const *src=&m_rowsData[size_t(y)*m_rowSize];
+    switch (m_bitCount) {
+    case 16:
+      for (uint32_t x=0; x<m_width; ++x, src+=2) {
+        uint32_t val=m_littleEndian ? uint32_t(src[0]|(src[1]<<8)) : uint32_t((src[0]<<8)|src[1]);
+        row[x]=STOFFColor(static_cast<unsigned char>((val&m_RGBMask[0])>>m_RGBShift[0]), static_cast<unsigned char>((val&m_RGBMask[1])>>m_RGBShift[1]),
+                          static_cast<unsigned char>((val&m_RGBMask[2])>>m_RGBShift[2])).value();
+      }
+      return true;
+    case 24:
+      for (uint32_t x=0; x<m_width; ++x, src+=3)
+        row[x]=STOFFColor(src[0],src[1],src[2]).value();
+      return true;
+    case 32:
+      for (uint32_t x=0; x<m_width; ++x, src+=4)
+        row[x]=STOFFColor(src[0],src[1],src[2],src[3]).value();
+      return true;
+    default:
+      break;
+    }
+    STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getColorRow: unexpected bit count %d\n", int(m_bitCount)));
+    return false;
+  }
+  //! returns the number of pixels merged in each direction to respect the maximum picture dimension
+  uint32_t getReductionFactor() const
+  {
+    int const maxDim=libstoff::getMaximumPictureDimension();
+    uint32_t const dim=std::max(m_width, m_height);
+    if (maxDim<=0 || dim<=uint32_t(maxDim))
+      return 1;
+    return (dim+uint32_t(maxDim)-1)/uint32_t(maxDim);
+  }
+  /** try to return the RGB components of the row y of the reduced picture,
+      each pixel being the mean of a factor*factor box of the original picture */
+  bool getRGBRow(uint32_t y, uint32_t factor, std::vector<unsigned char> &row, RowBuffers &buffers) const
+  {
+    auto const width=uint32_t((uint64_t(m_width)+factor-1)/factor);
+    row.resize(3*size_t(width));
+    buffers.m_colors.resize(size_t(m_width));
+    if (factor==1) {
+      if (!getColorRow(y, &buffers.m_colors[0], buffers.m_indices))
+        return false;
+      size_t wPos=0;
+      for (auto col : buffers.m_colors) {
         for (int comp=0, depl=16; comp<3; ++comp, depl-=8)
-          data.append(static_cast<unsigned char>((col>>depl)&0xFF));
+          row[wPos++]=static_cast<unsigned char>((col>>depl)&0xFF);
       }
       return true;
     }
-    if (m_indexDataList.size()/m_width!=m_height || m_indexDataList.size()%m_width!=0) {
-      STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getPPMData: index data list's size is bad\n"));
+    auto &sums=buffers.m_sums;
+    sums.assign(3*size_t(width), 0);
+    auto const firstRow=uint64_t(y)*factor;
+    auto const lastRow=std::min(uint64_t(m_height), firstRow+factor);
+    for (auto r=firstRow; r<lastRow; ++r) {
+      if (!getColorRow(uint32_t(r), &buffers.m_colors[0], buffers.m_indices))
+        return false;
+      for (uint32_t x=0; x<m_width; ++x) {
+        uint32_t const col=buffers.m_colors[x];
+        size_t const wPos=3*size_t(x/factor);
+        sums[wPos]+=(col>>16)&0xFF;
+        sums[wPos+1]+=(col>>8)&0xFF;
+        sums[wPos+2]+=col&0xFF;
+      }
+    }
+    for (uint32_t x=0; x<width; ++x) {
+      uint64_t const numPixels=(lastRow-firstRow)*(std::min(uint64_t(m_width), uint64_t(x+1)*factor)-uint64_t(x)*factor);
+      for (size_t c=3*size_t(x); c<3*size_t(x)+3; ++c)
+        row[c]=static_cast<unsigned char>(sums[c]/numPixels);
+    }
+    return true;
+  }
+  //! try to return a ppm data (without alpha), the picture is reduced by factor in each direction
+  bool getPPMData(librevenge::RVNGBinaryData &data, uint32_t factor=1) const
+  {
+    if (!checkData() || !factor)
+      return false;
+    data.clear();
+    auto const width=uint32_t((uint64_t(m_width)+factor-1)/factor);
+    auto const height=uint32_t((uint64_t(m_height)+factor-1)/factor);
+    std::stringstream f;
+    f << "P6\n" << width << " " << height << " 255\n";
+    auto const header = f.str();
+    data.append(reinterpret_cast<const unsigned char *>(header.c_str()), header.size());
+    RowBuffers buffers;
+    std::vector<unsigned char> row;
+    for (uint32_t y=0; y<height; ++y) {
+      if (!getRGBRow(y, factor, row, buffers))
+        return false;
+      data.append(&row[0], row.size());
+    }
+    return true;
+  }
+#ifdef USE_ZIP
+  //! try to return a png data (without alpha), the picture is reduced by factor in each direction
+  bool getPNGData(librevenge::RVNGBinaryData &data, uint32_t factor=1) const
+  {
+    if (!checkData() || !factor)
       return false;
+    data.clear();
+    STOFFPNGEncoder encoder(data);
+    if (!isIndexed() || factor>1) {
+      // the fourth byte of a 32 bits pixel is not an alpha value, so create a RGB picture
+      auto const width=uint32_t((uint64_t(m_width)+factor-1)/factor);
+      auto const height=uint32_t((uint64_t(m_height)+factor-1)/factor);
+      if (!encoder.begin(width, height, 2, 8, m_colorsList))
+        return false;
+      RowBuffers buffers;
+      std::vector<unsigned char> row;
+      for (uint32_t y=0; y<height; ++y) {
+        if (!getRGBRow(y, factor, row, buffers) || !encoder.addRow(&row[0]))
+          return false;
+      }
+      return encoder.end();
     }
-    auto numColors=int(m_colorsList.size());
-    for (auto const &index : m_indexDataList) {
-      if (index<0 || index>=numColors) {
-        STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getPPMData: find bad index=%d\n", index));
+    auto const numColors=int(m_colorsList.size());
+    int const bitDepth=numColors<=2 ? 1 : numColors<=4 ? 2 : numColors<=16 ? 4 : 8;
+    int const numByPixels=8/bitDepth;
+    if (!encoder.begin(m_width, m_height, 3, bitDepth, m_colorsList))
+      return false;
+    std::vector<uint8_t> indices(static_cast<size_t>(m_width));
+    std::vector<unsigned char> row((size_t(m_width)*size_t(bitDepth)+7)/8);
+    for (uint32_t y=0; y<m_height; ++y) {
+      if (!getIndexRow(y, &indices[0]))
         return false;
+      if (bitDepth==8) {
+        std::memcpy(&row[0], &indices[0], indices.size());
+        for (auto index : indices) {
+          if (int(index)<numColors) continue;
+          STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getPNGData: find bad index=%d\n", int(index)));
+          return false;
+        }
       }
-      uint32_t col=m_colorsList[size_t(index)].value();
-      for (int comp=0, depl=16; comp<3; ++comp, depl-=8)
-        data.append(static_cast<unsigned char>((col>>depl)&0xFF));
+      else {
+        std::fill(row.begin(), row.end(), 0);
+        for (uint32_t x=0; x<m_width; ++x) {
+          int const index=indices[x];
+          if (index>=numColors) {
+            STOFF_DEBUG_MSG(("StarBitmapInternal::Bitmap::getPNGData: find bad index=%d\n", index));
+            return false;
+          }
+          row[x/uint32_t(numByPixels)]|=static_cast<unsigned char>(index<<(8-bitDepth*(1+int(x%uint32_t(numByPixels)))));
+        }
+      }
+      if (!encoder.addRow(&row[0]))
+        return false;
     }
-    return true;
+    return encoder.end();
   }
+#endif
 
   //! operator<<
   friend std::ostream &operator<<(std::ostream &o, Bitmap const &info)
@@ -146,14 +388,22 @@ struct Bitmap {
   uint32_t m_pixelsPerMeter[2];
   //! a flag to know if the color has alpha component
   bool m_hasAlphaColor;
+  //! a flag to know if the 16 bits pixels are stored in little endian
+  bool m_littleEndian;
   //! the number of used column (used, other)
   uint32_t m_numColors[2];
+  //! the RGB mask of the 16 bits pixels
+  uint32_t m_RGBMask[3];
+  //! the RGB shift of the 16 bits pixels
+  int m_RGBShift[3];
   //! the bitmap color list
   std::vector<STOFFColor> m_colorsList;
-  //! the index bitmap data
-  std::vector<int> m_indexDataList;
-  //! the color bitmap data
-  std::vector<STOFFColor> m_colorDataList;
+  //! the index bitmap data: the decoded RLE bitmaps or the patterns
+  std::vector<uint8_t> m_indexDataList;
+  //! the size of a row in m_rowsData
+  size_t m_rowSize;
+  //! the uncompressed DIB rows, unpacked row by row when the picture is created
+  std::vector<uint8_t> m_rowsData;
 };
 ////////////////////////////////////////
 //! Internal: the state of a StarBitmap
@@ -200,7 +450,19 @@ StarBitmap::StarBitmap(uint32_t const((&pixels)[32]), STOFFColor const((&colors)
 
 bool StarBitmap::getData(librevenge::RVNGBinaryData &data, std::string &type) const
 {
-  if (!m_state->m_bitmap.getPPMData(data))
+  if (libstoff::skipPictures())
+    return false;
+  uint32_t const factor=m_state->m_bitmap.getReductionFactor();
+#ifdef USE_ZIP
+  if (libstoff::convertBitmapsToPNG()) {
+    if (m_state->m_bitmap.getPNGData(data, factor)) {
+      type="image/png";
+      return true;
+    }
+    STOFF_DEBUG_MSG(("StarBitmap::getData: can not create a png picture, try to create a ppm picture\n"));
+  }
+#endif
+  if (!m_state->m_bitmap.getPPMData(data, factor))
     return false;
   type="image/ppm";
   return true;
@@ -213,6 +475,7 @@ STOFFVec2i StarBitmap::getBitmapSize() const
 
 bool StarBitmap::readBitmap(StarZone &zone, bool inFileHeader, long lastPos, librevenge::RVNGBinaryData &result, std::string &type)
 {
+  libstoff::ParseStatisticsScope statistics("StarBitmap::readBitmap", zone.input().get());
   result.clear();
   type="";
   STOFFInputStreamPtr input=zone.input();
@@ -267,7 +530,8 @@ bool StarBitmap::readBitmap(StarZone &zone, bool inFileHeader, long lastPos, lib
     f << "size[coded]=" << codeSize << ",";
     f << "size[uncoded]=" << uncodeSize << ",";
     if (bitmap.m_compression) f << "compression=" << bitmap.m_compression << ",";
-    if (input->tell()+long(codeSize)>lastPos || uncodeSize==0 || uncodeSize>10000000) {
+    // zlib can not compress more than 1032:1
+    if (input->tell()+long(codeSize)>lastPos || uncodeSize==0 || uncodeSize>0x7fffffff || uncodeSize/1032>codeSize) {
       STOFF_DEBUG_MSG(("StarBitmap::readBitmap: bad code size\n"));
       f << "###codeSize=" << codeSize << ",";
       ascFile.addPos(pos);
@@ -277,35 +541,9 @@ bool StarBitmap::readBitmap(StarZone &zone, bool inFileHeader, long lastPos, lib
     lastPos=input->tell()+long(codeSize);
 #ifdef USE_ZIP
     ascFile.skipZone(input->tell(),lastPos-1);
-    unsigned long readBytes=0;
-    uint8_t const *data=input->read(size_t(codeSize),readBytes);
-    if (!data || static_cast<uint32_t>(readBytes)!=codeSize) {
-      STOFF_DEBUG_MSG(("StarBitmap::readBitmap: can not read compressed data\n"));
-      f << "###compressed";
-      ascFile.addPos(pos);
-      ascFile.addNote(f.str().c_str());
-      input->seek(lastPos, librevenge::RVNG_SEEK_SET);
-      return true;
-    }
-
-    int ret;
-    z_stream strm;
-
-    /* allocate inflate state */
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.avail_in = 0;
-    strm.next_in = Z_NULL;
-#if defined(__clang__)
-#  pragma clang diagnostic push
-#  pragma clang diagnostic ignored "-Wold-style-cast"
-#endif
-    ret = inflateInit(&strm);//,-MAX_WBITS);
-#if defined(__clang__)
-#  pragma clang diagnostic pop
-#endif
-    if (ret != Z_OK) {
+    // the data are decompressed when readBitmapData reads them
+    std::shared_ptr<STOFFInflateStream> newStream(new STOFFInflateStream(input, input->tell(), lastPos, uncodeSize));
+    if (!newStream->isValid()) {
       STOFF_DEBUG_MSG(("StarBitmap::readBitmap: can not init stream\n"));
       f << "###inflateInit";
       ascFile.addPos(pos);
@@ -313,31 +551,7 @@ bool StarBitmap::readBitmap(StarZone &zone, bool inFileHeader, long lastPos, lib
       input->seek(lastPos, librevenge::RVNG_SEEK_SET);
       return true;
     }
-    strm.avail_in = unsigned(codeSize);
-    strm.next_in = reinterpret_cast<Bytef *>(const_cast<uint8_t *>(data));
-
-    std::vector<unsigned char> converted;
-    converted.resize(size_t(uncodeSize),0);
-
-    strm.avail_out = uncodeSize;
-    strm.next_out = reinterpret_cast<Bytef *>(&converted[0]);
-    ret = inflate(&strm, Z_FINISH);
-    switch (ret) {
-    case Z_NEED_DICT:
-    case Z_DATA_ERROR:
-    case Z_MEM_ERROR:
-      STOFF_DEBUG_MSG(("StarBitmap::readBitmap: can not decode stream\n"));
-      f << "###inflateDecode,err=" << ret << ",";
-      ascFile.addPos(pos);
-      ascFile.addNote(f.str().c_str());
-      input->seek(lastPos, librevenge::RVNG_SEEK_SET);
-      (void)inflateEnd(&strm);
-      return true;
-    default:
-      break;
-    }
-    (void)inflateEnd(&strm);
-    std::shared_ptr<librevenge::RVNGInputStream> newStream(new STOFFStringStream(&converted[0], unsigned(converted.size())));
+    input->seek(lastPos, librevenge::RVNG_SEEK_SET);
     dInput.reset(new STOFFInputStream(newStream, input->readInverted()));
     dataPos=offset=0;
     endDataPos=dInput->size();
@@ -420,6 +634,15 @@ bool StarBitmap::readBitmap(StarZone &zone, bool inFileHeader, long lastPos, lib
 #endif
     }
     input->seek(actPos, librevenge::RVNG_SEEK_SET);
+    if (libstoff::skipPictures()) {
+      result.clear();
+      type="";
+    }
+    else if (bitmap.getReductionFactor()>1 && !getData(result, type)) {
+      STOFF_DEBUG_MSG(("StarBitmap::readBitmap: can not reduce the bitmap\n"));
+      result.clear();
+      type="";
+    }
   }
   if (pos!=lastPos && bitmap.m_compression==0x1004453) {
     STOFF_DEBUG_MSG(("StarBitmap::readBitmap: find extra data\n"));
@@ -512,8 +735,8 @@ bool StarBitmap::readBitmapData(STOFFInputStreamPtr &input, StarBitmapInternal::
 {
   // bitmap2.cxx Bitmap::ImplReadDIBBits
 
-  uint32_t RGBMask[3]= {0,0,0};
-  int RGBShift[3]= {0,0,0};
+  libstoff::checkImageSize(bitmap.m_width, bitmap.m_height);
+  bitmap.m_littleEndian=input->readInverted();
   if (bitmap.m_bitCount==16 || bitmap.m_bitCount==32) { // RGBMask
     if (bitmap.m_compression==3) { // BITFIELDS
       if (input->tell()<12) {
@@ -522,22 +745,22 @@ bool StarBitmap::readBitmapData(STOFFInputStreamPtr &input, StarBitmapInternal::
       }
       input->seek(-12, librevenge::RVNG_SEEK_CUR);
       for (int i=0; i<3; ++i) {
-        *input >> RGBMask[i];
+        *input >> bitmap.m_RGBMask[i];
         uint32_t decal=0x80000000ul;
         for (int j=31; j>=7; --j, decal>>=1) {
-          if ((RGBMask[i]&decal)==0) continue;
-          RGBShift[i]=j-7;
+          if ((bitmap.m_RGBMask[i]&decal)==0) continue;
+          bitmap.m_RGBShift[i]=j-7;
           break;
         }
       }
     }
     else {
-      RGBMask[0]= bitmap.m_bitCount == 16 ? 0x00007c00UL : 0x00ff0000UL;
-      RGBMask[1]= bitmap.m_bitCount == 16 ? 0x000003e0UL : 0x0000ff00UL;
-      RGBMask[2]= bitmap.m_bitCount == 16 ? 0x0000001fUL : 0x000000ffUL;
-      RGBShift[0]= bitmap.m_bitCount == 16 ? 10 : 16;
-      RGBShift[1]= bitmap.m_bitCount == 16 ? 5 : 8;
-      RGBShift[2]= 0; // checkme
+      bitmap.m_RGBMask[0]= bitmap.m_bitCount == 16 ? 0x00007c00UL : 0x00ff0000UL;
+      bitmap.m_RGBMask[1]= bitmap.m_bitCount == 16 ? 0x000003e0UL : 0x0000ff00UL;
+      bitmap.m_RGBMask[2]= bitmap.m_bitCount == 16 ? 0x0000001fUL : 0x000000ffUL;
+      bitmap.m_RGBShift[0]= bitmap.m_bitCount == 16 ? 10 : 16;
+      bitmap.m_RGBShift[1]= bitmap.m_bitCount == 16 ? 5 : 8;
+      bitmap.m_RGBShift[2]= 0; // checkme
     }
   }
 
@@ -553,17 +776,26 @@ bool StarBitmap::readBitmapData(STOFFInputStreamPtr &input, StarBitmapInternal::
       STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: bitmap dimensions are too big\n"));
       return false;
     }
+    long const actPos=input->tell();
+    unsigned long readBytes=0;
+    uint8_t const *data=lastPos>actPos ? input->read(size_t(lastPos-actPos), readBytes) : nullptr;
+    if (!data || !readBytes) {
+      STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: can not read the lre data\n"));
+      return false;
+    }
+    uint8_t const *ptr=data, *end=data+readBytes;
+    libstoff::useMemory(static_cast<unsigned long>(lastWPos));
     bitmap.m_indexDataList.resize(size_t(lastWPos),0);
     uint32_t x=0, y=0;
     while (true) {
-      if (input->tell() > lastPos - 1) {
+      if (ptr>=end) {
         STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: at the end of the bitmap record already\n"));
         return false;
       }
       if (y>=bitmap.m_height) break;
-      auto nCount=int(input->readULong(1));
+      auto nCount=int(*(ptr++));
       if (!nCount) {
-        auto nBytes=int(input->readULong(1));
+        auto nBytes=ptr<end ? int(*(ptr++)) : 0;
         if (nBytes==0) { // new line
           ++y;
           x=0;
@@ -573,8 +805,8 @@ bool StarBitmap::readBitmapData(STOFFInputStreamPtr &input, StarBitmapInternal::
         if (nBytes==1) // end decoding
           break;
         if (nBytes==2) {
-          x = uint32_t(x+input->readULong(1));
-          y = uint32_t(y+input->readULong(1));
+          x = uint32_t(x+(ptr<end ? *(ptr++) : 0));
+          y = uint32_t(y+(ptr<end ? *(ptr++) : 0));
           if (x>=bitmap.m_width) {
             STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: x seems bad\n"));
           }
@@ -586,43 +818,45 @@ bool StarBitmap::readBitmapData(STOFFInputStreamPtr &input, StarBitmapInternal::
           continue;
         }
         int nRead=(bit4 ? (nBytes+1)/2 : nBytes);
-        if (input->tell()+nRead> lastPos) {
+        if (end-ptr<nRead) {
           STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: can not read some lre count(1)\n"));
           return false;
         }
         for (int i=0; i<nBytes; ++i) {
-          auto val=int(input->readULong(1));
+          auto val=*(ptr++);
           if (bit4) {
-            if (++x<=bitmap.m_width && wPos<lastWPos) bitmap.m_indexDataList[wPos++]=(val>>4)&0xf;
-            if (++i<nBytes && ++x<=bitmap.m_width && wPos<lastWPos) bitmap.m_indexDataList[wPos++]=val&0xf;
+            if (++x<=bitmap.m_width && wPos<lastWPos) bitmap.m_indexDataList[wPos++]=uint8_t((val>>4)&0xf);
+            if (++i<nBytes && ++x<=bitmap.m_width && wPos<lastWPos) bitmap.m_indexDataList[wPos++]=uint8_t(val&0xf);
           }
           else if (++x<=bitmap.m_width && wPos<lastWPos)
             bitmap.m_indexDataList[wPos++]=val;
         }
-        if (nRead&1)
-          input->seek(1, librevenge::RVNG_SEEK_CUR);
+        if ((nRead&1) && ptr<end)
+          ++ptr;
         continue;
       }
-      if (input->tell()+1 > lastPos) {
+      if (ptr>=end) {
         STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: can not read some lre count(2)\n"));
         return false;
       }
-      auto val=int(input->readULong(1));
+      auto val=*(ptr++);
       if (bit4) {
+        auto const val1=uint8_t((val>>4)&0xf), val2=uint8_t(val&0xf);
         for (int i=0; i<nCount; ++i) {
           if (++x>bitmap.m_width||wPos>=lastWPos) break;
-          bitmap.m_indexDataList[wPos++]=(val>>4)&0xf;
+          bitmap.m_indexDataList[wPos++]=val1;
           if (++i>=nCount || ++x>bitmap.m_width||wPos>=lastWPos) break;
-          bitmap.m_indexDataList[wPos++]=val&0xf;
+          bitmap.m_indexDataList[wPos++]=val2;
         }
       }
       else {
-        for (int i=0; i<nCount; ++i) {
-          if (++x>bitmap.m_width||wPos>=lastWPos) break;
-          bitmap.m_indexDataList[wPos++]=val;
-        }
+        size_t const num=std::min(std::min(size_t(nCount), size_t(x<bitmap.m_width ? bitmap.m_width-x : 0)), lastWPos-wPos);
+        std::fill_n(bitmap.m_indexDataList.begin()+long(wPos), num, val);
+        wPos+=num;
+        x+=uint32_t(num<size_t(nCount) ? num+1 : num);
       }
     }
+    input->seek(actPos+long(ptr-data), librevenge::RVNG_SEEK_SET);
     return true;
   }
   uint32_t alignWidth=bitmap.m_width*bitmap.m_bitCount;
@@ -638,78 +872,29 @@ bool StarBitmap::readBitmapData(STOFFInputStreamPtr &input, StarBitmapInternal::
     return false;
   }
   switch (bitmap.m_bitCount) {
-  case 1: {
-    bitmap.m_indexDataList.resize(size_t(bitmap.m_height*bitmap.m_width));
-    size_t wPos=0;
-    for (uint32_t y=0; y<bitmap.m_height; ++y) {
-      actPos=input->tell();
-      int decal=7;
-      unsigned char val=0;
-      for (uint32_t x=0; x<bitmap.m_width; ++x) {
-        if (decal==7)
-          val=static_cast<unsigned char>(input->readULong(1));
-        bitmap.m_indexDataList[wPos++]=int((val>>decal)&1);
-        if (decal--==0)
-          decal=7;
-      }
-      input->seek(actPos+long(alignWidth), librevenge::RVNG_SEEK_SET);
-    }
-    break;
-  }
-  case 4: {
-    bitmap.m_indexDataList.resize(size_t(bitmap.m_height*bitmap.m_width));
-    size_t wPos=0;
-    for (uint32_t y=0; y<bitmap.m_height; ++y) {
-      actPos=input->tell();
-      unsigned char val=0;
-      for (uint32_t x=0; x<bitmap.m_width; ++x) {
-        if ((x%2)==0)
-          val=static_cast<unsigned char>(input->readULong(1));
-        bitmap.m_indexDataList[wPos++]=int(((x%2) ? val : (val>>4))&0xf);
-      }
-      input->seek(actPos+long(alignWidth), librevenge::RVNG_SEEK_SET);
-    }
-    break;
-  }
-  case 8: {
-    bitmap.m_indexDataList.resize(size_t(bitmap.m_height*bitmap.m_width));
-    size_t wPos=0;
-    for (uint32_t y=0; y<bitmap.m_height; ++y) {
-      actPos=input->tell();
-      for (uint32_t x=0; x<bitmap.m_width; ++x)
-        bitmap.m_indexDataList[wPos++]=int(input->readULong(1));
-      input->seek(actPos+long(alignWidth), librevenge::RVNG_SEEK_SET);
-    }
-    break;
-  }
-  case 16: {
-    bitmap.m_colorDataList.resize(size_t(bitmap.m_height*bitmap.m_width));
-    size_t wPos=0;
-    for (uint32_t y=0; y<bitmap.m_height; ++y) {
-      actPos=input->tell();
-      for (uint32_t x=0; x<bitmap.m_width; ++x) {
-        auto val=static_cast<uint16_t>(input->readULong(2));
-        bitmap.m_colorDataList[wPos++]=
-          STOFFColor(static_cast<unsigned char>((val&RGBMask[0])>>RGBShift[0]), static_cast<unsigned char>((val&RGBMask[1])>>RGBShift[1]),
-                     static_cast<unsigned char>((val&RGBMask[2])>>RGBShift[2]));
-      }
-      input->seek(actPos+long(alignWidth), librevenge::RVNG_SEEK_SET);
-    }
-    break;
-  }
+  case 1:
+  case 4:
+  case 8:
+  case 16:
   case 24:
   case 32: {
-    unsigned char col[4]= {0,0,0,255};
-    int const numComponent= bitmap.m_bitCount==24 ? 3 : 4;
-    bitmap.m_colorDataList.resize(size_t(bitmap.m_height*bitmap.m_width));
-    size_t wPos=0;
-    for (uint32_t y=0; y<bitmap.m_height; ++y) {
-      actPos=input->tell();
-      for (uint32_t x=0; x<bitmap.m_width; ++x) {
-        for (int c=0; c<numComponent; ++c) col[c]=static_cast<unsigned char>(input->readULong(1));
-        bitmap.m_colorDataList[wPos++]=STOFFColor(col[0],col[1],col[2],col[3]);
+    // only store the rows, they are unpacked when the picture is created
+    // read the rows by blocks, so that a compressed stream only needs to decompress a small part of the data
+    // and the buffer only grows when some rows are really read (the size of a compressed zone can be wrong)
+    bitmap.m_rowSize=size_t(alignWidth);
+    bitmap.m_rowsData.clear();
+    uint32_t const numRowsByBlock=std::max<uint32_t>(1, 65536/alignWidth);
+    for (uint32_t y=0; y<bitmap.m_height; y+=numRowsByBlock) {
+      size_t const blockSize=size_t(std::min(numRowsByBlock, bitmap.m_height-y))*bitmap.m_rowSize;
+      unsigned long readBytes=0;
+      uint8_t const *data=input->read(blockSize, readBytes);
+      if (!data || size_t(readBytes)!=blockSize) {
+        STOFF_DEBUG_MSG(("StarBitmap::readBitmapData: can not read the rows\n"));
+        bitmap.m_rowsData.clear();
+        return false;
       }
-      input->seek(actPos+long(alignWidth), librevenge::RVNG_SEEK_SET);
+      libstoff::useMemory(static_cast<unsigned long>(blockSize));
+      bitmap.m_rowsData.insert(bitmap.m_rowsData.end(), data, data+blockSize);
     }
     break;
   }
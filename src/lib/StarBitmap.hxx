@@ -73,9 +73,10 @@ public:
 
   /** try to read a bitmap
 
-   \note only fill data and type if the bitmap has a file header*/
+   \note only fill data and type if the bitmap has a file header, data contains
+   the reduced picture if the bitmap is bigger than the maximum picture dimension */
   bool readBitmap(StarZone &zone, bool inFileHeader, long lastPos, librevenge::RVNGBinaryData &data, std::string &type);
-  //! try to convert the read data in ppm
+  //! try to convert the read data in png or in ppm, reducing it if needed, see STOFFDocument::ParseOptions
   bool getData(librevenge::RVNGBinaryData &data, std::string &type) const;
   //! try to return the bitmap size (in point)
   STOFFVec2i getBitmapSize() const;
@@ -39,6 +39,7 @@
 
 #include <librevenge/librevenge.h>
 
+#include "STOFFResourceGovernor.hxx"
 #include "STOFFStringStream.hxx"
 
 #include "StarEncryption.hxx"
@@ -202,6 +203,7 @@ STOFFInputStreamPtr StarEncryption::decodeStream(STOFFInputStreamPtr input, uint
     STOFF_DEBUG_MSG(("StarEncryption::decodeStream: can not read the original stream\n"));
     return res;
   }
+  libstoff::useMemory(numRead);
   auto *finalData=new uint8_t[numRead];
   if (!finalData) return res;
   uint8_t *finalDataPtr=finalData;
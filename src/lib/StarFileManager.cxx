@@ -31,12 +31,19 @@
 * instead of those above.
 */
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include <librevenge/librevenge.h>
 
@@ -55,6 +62,7 @@
 #include "STOFFGraphicEncoder.hxx"
 #include "STOFFGraphicListener.hxx"
 #include "STOFFPageSpan.hxx"
+#include "STOFFResourceGovernor.hxx"
 #include "STOFFSpreadsheetEncoder.hxx"
 #include "STOFFSpreadsheetListener.hxx"
 
@@ -284,6 +292,403 @@ struct State {
   }
 };
 
+struct OLEDirectoryTask;
+//! the OLEDirectoryTask read by the current thread
+static thread_local OLEDirectoryTask *s_readTask=nullptr;
+//! the directory read by the current OLEDirectoryTask
+static thread_local STOFFOLEParser::OleDirectory const *s_readDirectory=nullptr;
+//! the mutex used to protect the OLEDirectoryTask::m_waitingFor chains
+static std::mutex s_waitingMutex;
+
+////////////////////////////////////////
+//! Internal: a task used to read an ole directory, see StarFileManager::BackgroundReader
+struct OLEDirectoryTask {
+  //! constructor
+  OLEDirectoryTask()
+    : m_reserved(false)
+    , m_mutex()
+    , m_condition()
+    , m_done(false)
+    , m_ok(false)
+    , m_image()
+    , m_object()
+    , m_waitingFor(nullptr)
+  {
+  }
+  //! tries to reserve the task, returns false if another thread has already reserved it
+  bool reserve()
+  {
+    return !m_reserved.exchange(true);
+  }
+  //! reads the directory and stores the result
+  void run(std::shared_ptr<STOFFOLEParser> oleParser, std::shared_ptr<STOFFOLEParser::OleDirectory> ole)
+  {
+    auto const previousTask=s_readTask;
+    auto const previousDirectory=s_readDirectory;
+    if (previousTask) {
+      // the previous task waits for this one
+      std::lock_guard<std::mutex> lock(s_waitingMutex);
+      previousTask->m_waitingFor=this;
+    }
+    s_readTask=this;
+    s_readDirectory=ole.get();
+    STOFFEmbeddedObject image;
+    std::shared_ptr<StarObject> object;
+    bool ok=false;
+    try {
+      ok=StarFileManager::readOLEDirectory(oleParser, ole, image, object);
+    }
+    catch (...) {
+      STOFF_DEBUG_MSG(("StarFileManagerInternal::OLEDirectoryTask::run: exception catched when reading %s\n", ole ? ole->m_dir.c_str() : "###"));
+      ok=false;
+    }
+    s_readTask=previousTask;
+    s_readDirectory=previousDirectory;
+    if (previousTask) {
+      std::lock_guard<std::mutex> lock(s_waitingMutex);
+      previousTask->m_waitingFor=nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ok=ok;
+    m_image=image;
+    m_object=object;
+    m_done=true;
+    m_condition.notify_all();
+  }
+  /** waits until the task is done, returns false if the wait would create a deadlock,
+      ie. if the task is waiting, directly or not, for the task read by the current thread */
+  bool wait()
+  {
+    auto current=s_readTask;
+    if (current) {
+      std::lock_guard<std::mutex> lock(s_waitingMutex);
+      for (auto task=this; task; task=task->m_waitingFor) {
+        if (task==current)
+          return false;
+      }
+      current->m_waitingFor=this;
+    }
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this] { return m_done; });
+    }
+    if (current) {
+      std::lock_guard<std::mutex> lock(s_waitingMutex);
+      current->m_waitingFor=nullptr;
+    }
+    return true;
+  }
+  //! a flag to know if the task is reserved
+  std::atomic<bool> m_reserved;
+  //! the mutex used to protect the result
+  std::mutex m_mutex;
+  //! the condition used to signal the end of the task
+  std::condition_variable m_condition;
+  //! a flag to know if the task is done
+  bool m_done;
+  //! the result of readOLEDirectory
+  bool m_ok;
+  //! the embedded object
+  STOFFEmbeddedObject m_image;
+  //! the object (for chart and math)
+  std::shared_ptr<StarObject> m_object;
+  //! the task waited by the thread which reads this task (protected by s_waitingMutex)
+  OLEDirectoryTask *m_waitingFor;
+};
+
+//! Internal: adds some data to two 64 bits hash: a FNV-1a and a polynomial one
+static void updateHash(unsigned char const *data, size_t length, uint64_t (&hash)[2])
+{
+  for (size_t i=0; i<length; ++i) {
+    hash[0]=(hash[0]^data[i])*0x100000001b3ULL;
+    hash[1]=hash[1]*31+data[i];
+  }
+}
+
+//! Internal: adds a value to two 64 bits hash
+static void updateHash(uint64_t value, uint64_t (&hash)[2])
+{
+  unsigned char buffer[8];
+  for (int i=0; i<8; ++i, value>>=8)
+    buffer[i]=static_cast<unsigned char>(value&0xff);
+  updateHash(buffer, 8, hash);
+}
+
+//! Internal: adds a string and its length to two 64 bits hash
+static void updateHash(std::string const &str, uint64_t (&hash)[2])
+{
+  updateHash(uint64_t(str.size()), hash);
+  updateHash(reinterpret_cast<unsigned char const *>(str.c_str()), str.size(), hash);
+}
+
+//! Internal: adds the name and the content of a stream to two 64 bits hash, returns false if the stream can not be read
+static bool updateHash(STOFFInputStreamPtr input, std::string const &name, std::string const &streamName, uint64_t (&hash)[2])
+{
+  auto stream=input ? input->getSubStreamByName(streamName) : STOFFInputStreamPtr();
+  if (!stream)
+    return false;
+  updateHash(name, hash);
+  updateHash(uint64_t(stream->size()), hash);
+  stream->seek(0, librevenge::RVNG_SEEK_SET);
+  while (!stream->isEnd()) {
+    unsigned long numRead=0;
+    auto const *data=stream->read(65536, numRead);
+    if (!data || !numRead)
+      return false;
+    updateHash(data, size_t(numRead), hash);
+  }
+  return true;
+}
+
+//! Internal: a process-wide cache of the embedded objects created by readOLEDirectory, see StarFileManager::setObjectCacheSize
+class ObjectCache
+{
+public:
+  //! returns the cache
+  static ObjectCache &get()
+  {
+    static ObjectCache cache;
+    return cache;
+  }
+  //! sets the maximum number of objects kept in memory
+  void setMaxSize(size_t maxSize)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxSize=maxSize;
+    resize();
+  }
+  //! sets the directory where the objects are stored, empty means no directory
+  void setDirectory(std::string const &directory)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory=directory;
+  }
+  //! returns true if the objects are stored in memory or in a directory
+  bool isEnabled()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxSize || !m_directory.empty();
+  }
+  //! returns the number of hits and misses
+  void getStatistics(unsigned long &numHits, unsigned long &numMisses)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    numHits=m_numHits;
+    numMisses=m_numMisses;
+  }
+  /** returns the key of a directory: a hash of the options which change the
+      conversion and of the name and the content of the directory's streams and
+      sub directories, or an empty string if a stream can not be read */
+  static std::string getKey(STOFFOLEParser &oleParser, STOFFOLEParser::OleDirectory const &ole)
+  {
+    uint64_t hash[2]= {0xcbf29ce484222325ULL, 0};
+    updateHash(std::string("StarFileManager::readOLEDirectory:1"), hash);
+#ifdef VERSION
+    updateHash(std::string(VERSION), hash);
+#endif
+    updateHash(uint64_t(libstoff::convertBitmapsToPNG() ? 1 : 0), hash);
+    updateHash(uint64_t(libstoff::getMaximumPictureDimension()), hash);
+    updateHash(uint64_t(libstoff::skipPictures() ? 1 : 0), hash);
+    updateHash(uint64_t(libstoff::getDrawingResolution()), hash);
+    std::string const prefix=ole.m_dir+"/";
+    for (auto const &dir : oleParser.getDirectoryList()) {
+      if (!dir || (dir.get()!=&ole && dir->m_dir.compare(0, prefix.size(), prefix)!=0))
+        continue;
+      // the name of the directory is not used, so that a copy of an object has the same key
+      std::string const dirName=dir.get()==&ole ? "" : dir->m_dir.substr(prefix.size());
+      updateHash(dirName, hash);
+      if (dir->m_hasCompObj && !updateHash(dir->m_input, "CompObj", dir->m_dir.empty() ? "CompObj" : dir->m_dir+"/CompObj", hash))
+        return "";
+      for (auto const &content : dir->m_contentList) {
+        if (!updateHash(dir->m_input, content.getOleName().substr(dir->m_dir.empty() ? 0 : dir->m_dir.size()+1), content.getOleName(), hash))
+          return "";
+      }
+    }
+    std::stringstream s;
+    s << std::hex << std::setfill('0') << std::setw(16) << hash[0] << std::setw(16) << hash[1];
+    return s.str();
+  }
+  //! try to find an object, in memory then in the directory, returns false if the object is not in the cache
+  bool find(std::string const &key, STOFFEmbeddedObject &object)
+  {
+    std::string directory;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it=m_keyToEntryMap.find(key);
+      if (it!=m_keyToEntryMap.end()) {
+        ++m_numHits;
+        m_entryList.splice(m_entryList.begin(), m_entryList, it->second);
+        object=it->second->second;
+        return true;
+      }
+      directory=m_directory;
+    }
+    bool const ok=!directory.empty() && readFile(directory+"/"+key+".stoff", object);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!ok) {
+      ++m_numMisses;
+      return false;
+    }
+    ++m_numHits;
+    storeInMemory(key, object);
+    return true;
+  }
+  //! stores an object in memory and in the directory
+  void store(std::string const &key, STOFFEmbeddedObject const &object)
+  {
+    std::string directory;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      storeInMemory(key, object);
+      directory=m_directory;
+    }
+    if (!directory.empty())
+      writeFile(directory+"/"+key+".stoff", object);
+  }
+protected:
+  //! constructor
+  ObjectCache()
+    : m_mutex()
+    , m_maxSize(0)
+    , m_directory()
+    , m_numHits(0)
+    , m_numMisses(0)
+    , m_entryList()
+    , m_keyToEntryMap()
+  {
+  }
+  //! stores an object in memory, the mutex must be locked
+  void storeInMemory(std::string const &key, STOFFEmbeddedObject const &object)
+  {
+    if (!m_maxSize || m_keyToEntryMap.find(key)!=m_keyToEntryMap.end())
+      return;
+    m_entryList.push_front(std::make_pair(key, object));
+    m_keyToEntryMap[key]=m_entryList.begin();
+    resize();
+  }
+  //! removes the least recently used objects, the mutex must be locked
+  void resize()
+  {
+    while (m_entryList.size()>m_maxSize) {
+      m_keyToEntryMap.erase(m_entryList.back().first);
+      m_entryList.pop_back();
+    }
+  }
+  /** reads an object stored by writeFile:
+      - a null byte, "STC" and the format version: 1
+      - the number of representations, then for each representation,
+        the length and the characters of its type, the length and the content of its data
+      - the length and the characters of the link,
+      where a length is a 4 bytes little endian integer */
+  static bool readFile(std::string const &fileName, STOFFEmbeddedObject &object)
+  {
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+      return false;
+    std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t pos=0;
+    auto readLength=[&content, &pos](size_t &length) {
+      if (pos+4>content.size()) return false;
+      length=0;
+      for (int i=3; i>=0; --i)
+        length=(length<<8)|uint8_t(content[pos+size_t(i)]);
+      pos+=4;
+      return length<=content.size()-pos;
+    };
+    if (content.size()<5 || std::memcmp(content.data(), "\0STC\1", 5)!=0)
+      return false;
+    pos=5;
+    STOFFEmbeddedObject res;
+    size_t numData, length;
+    bool ok=readLength(numData);
+    for (size_t i=0; ok && i<numData; ++i) {
+      ok=readLength(length);
+      if (!ok) break;
+      std::string type(content.data()+pos, length);
+      pos+=length;
+      ok=readLength(length);
+      if (!ok) break;
+      res.add(librevenge::RVNGBinaryData(reinterpret_cast<unsigned char const *>(content.data()+pos), length), type);
+      pos+=length;
+    }
+    if (!ok || !readLength(length) || pos+length!=content.size()) {
+      STOFF_DEBUG_MSG(("StarFileManagerInternal::ObjectCache::readFile: the file %s is bad\n", fileName.c_str()));
+      return false;
+    }
+    res.m_filenameLink=std::string(content.data()+pos, length).c_str();
+    libstoff::useMemory(static_cast<unsigned long>(content.size()));
+    object=res;
+    return true;
+  }
+  //! writes an object in a temporary file, then renames it
+  static bool writeFile(std::string const &fileName, STOFFEmbeddedObject const &object)
+  {
+    std::stringstream s;
+    s << fileName << "." << std::this_thread::get_id() << ".tmp";
+    std::string const tmpName=s.str();
+    {
+      std::ofstream file(tmpName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file) {
+        STOFF_DEBUG_MSG(("StarFileManagerInternal::ObjectCache::writeFile: can not create %s\n", tmpName.c_str()));
+        return false;
+      }
+      auto writeLength=[&file](size_t length) {
+        char buffer[4];
+        for (int i=0; i<4; ++i, length>>=8)
+          buffer[i]=char(length&0xff);
+        file.write(buffer, 4);
+      };
+      file.write("\0STC\1", 5);
+      size_t const numData=std::max(object.m_dataList.size(), object.m_typeList.size());
+      writeLength(numData);
+      for (size_t i=0; i<numData; ++i) {
+        std::string const type=i<object.m_typeList.size() ? object.m_typeList[i] : "";
+        writeLength(type.size());
+        file.write(type.c_str(), std::streamsize(type.size()));
+        if (i>=object.m_dataList.size() || object.m_dataList[i].empty()) {
+          writeLength(0);
+          continue;
+        }
+        auto const &data=object.m_dataList[i];
+        writeLength(data.size());
+        file.write(reinterpret_cast<char const *>(data.getDataBuffer()), std::streamsize(data.size()));
+      }
+      writeLength(object.m_filenameLink.size());
+      file.write(object.m_filenameLink.cstr(), std::streamsize(object.m_filenameLink.size()));
+      if (!file) {
+        STOFF_DEBUG_MSG(("StarFileManagerInternal::ObjectCache::writeFile: can not write %s\n", tmpName.c_str()));
+        file.close();
+        std::remove(tmpName.c_str());
+        return false;
+      }
+    }
+    // another process may have stored the same object
+    if (std::rename(tmpName.c_str(), fileName.c_str())!=0) {
+      std::remove(tmpName.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  //! a mutex to protect the data
+  std::mutex m_mutex;
+  //! the maximum number of objects kept in memory
+  size_t m_maxSize;
+  //! the directory where the objects are stored
+  std::string m_directory;
+  //! the number of objects found in the cache
+  unsigned long m_numHits;
+  //! the number of objects not found in the cache
+  unsigned long m_numMisses;
+  //! the list of keys and objects, the most recently used first
+  std::list<std::pair<std::string, STOFFEmbeddedObject> > m_entryList;
+  //! a map key to its position in m_entryList
+  std::unordered_map<std::string, std::list<std::pair<std::string, STOFFEmbeddedObject> >::iterator> m_keyToEntryMap;
+private:
+  ObjectCache(ObjectCache const &orig) = delete;
+  ObjectCache &operator=(ObjectCache const &orig) = delete;
+};
+
 }
 
 ////////////////////////////////////////////////////////////
@@ -298,21 +703,116 @@ StarFileManager::~StarFileManager()
 {
 }
 
+StarFileManager::BackgroundReader::BackgroundReader(std::shared_ptr<STOFFOLEParser> oleParser)
+  : m_oleParser(oleParser)
+  , m_governor(libstoff::ResourceGovernor::get())
+  , m_directoryList()
+  , m_nextDirectory(0)
+  , m_stop(false)
+  , m_threadList()
+{
+#ifdef USE_THREADS
+  int const numThreads=libstoff::getMaximumNumberOfThreads();
+  if (!m_oleParser || numThreads<=1)
+    return;
+  for (auto &dir : m_oleParser->getDirectoryList()) {
+    // the sub directories are read by their parent
+    if (!dir || dir->m_parsed || std::atomic_load(&dir->m_task) || dir->m_dir.empty() || dir->m_dir.find('/')!=std::string::npos)
+      continue;
+    if (dir->m_kind!=STOFFDocument::STOFF_K_CHART && dir->m_kind!=STOFFDocument::STOFF_K_DRAW &&
+        dir->m_kind!=STOFFDocument::STOFF_K_MATH && dir->m_kind!=STOFFDocument::STOFF_K_SPREADSHEET)
+      continue;
+    std::atomic_store(&dir->m_task, std::make_shared<StarFileManagerInternal::OLEDirectoryTask>());
+    m_directoryList.push_back(dir);
+  }
+  // the calling thread continues to read the main document
+  size_t const numWorkers=std::min(size_t(numThreads-1), m_directoryList.size());
+  for (size_t i=0; i<numWorkers; ++i)
+    m_threadList.push_back(std::thread(&StarFileManager::BackgroundReader::run, this));
+#endif
+}
+
+StarFileManager::BackgroundReader::~BackgroundReader()
+{
+  m_stop=true;
+  for (auto &thread : m_threadList) {
+    if (thread.joinable())
+      thread.join();
+  }
+}
+
+void StarFileManager::BackgroundReader::run()
+{
+  libstoff::ResourceGovernorScope governorScope(m_governor);
+  while (!m_stop) {
+    size_t const id=m_nextDirectory++;
+    if (id>=m_directoryList.size())
+      break;
+    auto &dir=m_directoryList[id];
+    auto task=std::atomic_load(&dir->m_task);
+    if (task && task->reserve())
+      task->run(m_oleParser, dir);
+  }
+}
+
 bool StarFileManager::readOLEDirectory(std::shared_ptr<STOFFOLEParser> oleParser, std::shared_ptr<STOFFOLEParser::OleDirectory> ole, STOFFEmbeddedObject &image, std::shared_ptr<StarObject> &res)
 {
   image=STOFFEmbeddedObject();
-  if (!oleParser || !ole || ole->m_inUse) {
+  if (ole && ole.get()!=StarFileManagerInternal::s_readDirectory) {
+    // the result is stored in the directory task, so that the objects
+    // which are referenced many times are only read once
+    auto task=std::atomic_load(&ole->m_task);
+    if (!task) {
+      auto newTask=std::make_shared<StarFileManagerInternal::OLEDirectoryTask>();
+      if (std::atomic_compare_exchange_strong(&ole->m_task, &task, newTask))
+        task=newTask;
+    }
+    if (task->reserve())
+      task->run(oleParser, ole);
+    else if (!task->wait()) {
+      // the objects reference each other
+      STOFF_DEBUG_MSG(("StarFileManager::readOLEDirectory: find a loop when reading %s\n", ole->m_dir.c_str()));
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(task->m_mutex);
+    image=task->m_image;
+    res=task->m_object;
+    return task->m_ok;
+  }
+  if (!oleParser || !ole || ole->m_inUse.exchange(true)) {
     STOFF_DEBUG_MSG(("StarFileManager::readOLEDirectory: can not read an ole\n"));
     return false;
   }
-  ole->m_inUse=true;
   StarObject object(nullptr, oleParser, ole); // do we need password here ?
+  // the objects which are only converted in pictures can be retrieved from the cache
+  auto &cache=StarFileManagerInternal::ObjectCache::get();
+  auto const kind=object.getDocumentKind();
+  std::string cacheKey;
+  if (kind!=STOFFDocument::STOFF_K_CHART && kind!=STOFFDocument::STOFF_K_MATH && kind!=STOFFDocument::STOFF_K_TEXT && cache.isEnabled())
+    cacheKey=cache.getKey(*oleParser, *ole);
+  if (!cacheKey.empty() && cache.find(cacheKey, image)) {
+    std::string const prefix=ole->m_dir+"/";
+    for (auto &dir : oleParser->getDirectoryList()) {
+      if (dir && (dir==ole || dir->m_dir.compare(0, prefix.size(), prefix)==0))
+        dir->m_parsed=true;
+    }
+    ole->m_inUse=false;
+    return !image.isEmpty();
+  }
+  // when the pictures are reduced, the preview is sufficient
+  bool const usePreview=libstoff::getMaximumPictureDimension()>0;
+  bool hasPreview=false;
   if (object.getDocumentKind()==STOFFDocument::STOFF_K_CHART) {
     auto chart=std::make_shared<StarObjectChart>(object, false);
     ole->m_parsed=true;
     if (chart->parse())
       res=chart;
   }
+  else if ((object.getDocumentKind()==STOFFDocument::STOFF_K_DRAW || object.getDocumentKind()==STOFFDocument::STOFF_K_SPREADSHEET) &&
+           usePreview && object.getPreview(image)) {
+    ole->m_parsed=true;
+    hasPreview=true;
+  }
   else if (object.getDocumentKind()==STOFFDocument::STOFF_K_DRAW) {
     StarObjectDraw draw(object, false);
     ole->m_parsed=true;
@@ -391,7 +891,7 @@ bool StarFileManager::readOLEDirectory(std::shared_ptr<STOFFOLEParser> oleParser
 
       if (base=="StarImageDocument" || base=="StarImageDocument 4.0") {
         librevenge::RVNGBinaryData data;
-        if (readImageDocument(stream,data,name) && !data.empty())
+        if (readImageDocument(stream,data,name) && !data.empty() && !libstoff::skipPictures())
           image.add(data);
         continue;
       }
@@ -421,16 +921,39 @@ bool StarFileManager::readOLEDirectory(std::shared_ptr<STOFFOLEParser> oleParser
     }
   }
   // finally look if some content have image
-  for (auto &content : ole->m_contentList) {
-    librevenge::RVNGBinaryData data;
-    std::string type;
-    if (content.getImageData(data,type))
-      image.add(data, type);
+  if (!hasPreview && !libstoff::skipPictures() && !(usePreview && object.getPreview(image))) {
+    for (auto &content : ole->m_contentList) {
+      librevenge::RVNGBinaryData data;
+      std::string type;
+      if (content.getImageData(data,type))
+        image.add(data, type);
+    }
+  }
+  if (!cacheKey.empty() && !image.isEmpty()) {
+    // do not store an object whose reading has been interrupted
+    auto governor=libstoff::ResourceGovernor::get();
+    if (!governor || (!governor->isExceeded() && !governor->isCanceled()))
+      cache.store(cacheKey, image);
   }
   ole->m_inUse=false;
   return !image.isEmpty();
 }
 
+void StarFileManager::setObjectCacheSize(size_t numObjects)
+{
+  StarFileManagerInternal::ObjectCache::get().setMaxSize(numObjects);
+}
+
+void StarFileManager::setObjectCacheDirectory(std::string const &directory)
+{
+  StarFileManagerInternal::ObjectCache::get().setDirectory(directory);
+}
+
+void StarFileManager::getObjectCacheStatistics(unsigned long &numHits, unsigned long &numMisses)
+{
+  StarFileManagerInternal::ObjectCache::get().getStatistics(numHits, numMisses);
+}
+
 void StarFileManager::checkUnparsed(STOFFInputStreamPtr input, std::shared_ptr<STOFFOLEParser> oleParser, char const *password)
 {
   if (!input || !oleParser) {
@@ -549,23 +1072,33 @@ bool StarFileManager::readEmbeddedPicture(std::shared_ptr<STOFFOLEParser> olePar
     STOFF_DEBUG_MSG(("StarFileManager::readEmbeddedPicture: called without OLE parser\n"));
     return false;
   }
-  auto dir=oleParser->getDirectory("EmbeddedPictures");
-  if (!dir || !dir->m_input || !dir->m_input->isStructured()) {
-    STOFF_DEBUG_MSG(("StarFileManager::readEmbeddedPicture: can not find the embedded picture directory\n"));
+  if (libstoff::skipPictures())
     return false;
-  }
   std::string name("EmbeddedPictures/");
   name+=fileName;
-  auto ole= dir->m_input->getSubStreamByName(name.c_str());
-  if (!ole) {
-    STOFF_DEBUG_MSG(("StarFileManager::readEmbeddedPicture: can not find the picture %s\n", name.c_str()));
-    return false;
+  // the same picture is often used in many pages, so look first if it is already decoded
+  STOFFEmbeddedObject picture;
+  if (!oleParser->getPicture(name, picture)) {
+    auto dir=oleParser->getDirectory("EmbeddedPictures");
+    if (!dir || !dir->m_input || !dir->m_input->isStructured()) {
+      STOFF_DEBUG_MSG(("StarFileManager::readEmbeddedPicture: can not find the embedded picture directory\n"));
+      return false;
+    }
+    auto ole= dir->m_input->getSubStreamByName(name.c_str());
+    if (!ole) {
+      STOFF_DEBUG_MSG(("StarFileManager::readEmbeddedPicture: can not find the picture %s\n", name.c_str()));
+      return false;
+    }
+    librevenge::RVNGBinaryData data;
+    std::string type;
+    if (readEmbeddedPicture(ole,data,type,name))
+      picture.add(data, type);
+    oleParser->storePicture(name, picture);
   }
-  librevenge::RVNGBinaryData data;
-  std::string type;
-  if (!readEmbeddedPicture(ole,data,type,name))
+  if (picture.isEmpty())
     return false;
-  image.add(data, type);
+  for (size_t i=0; i<picture.m_dataList.size(); ++i)
+    image.add(picture.m_dataList[i], i<picture.m_typeList.size() ? picture.m_typeList[i] : "image/pict");
   return true;
 }
 
@@ -656,10 +1189,21 @@ try
   if (header==0x4142 || header==0x4d42) {
     dataType="image/bm";
     extension="bm";
+    bool checkBitmap=libstoff::getMaximumPictureDimension()>0;
 #ifdef DEBUG_WITH_FILES
-    StarBitmap bitmap;
-    bitmap.readBitmap(zone, true, input->size(), data, dataType);
+    checkBitmap=true;
 #endif
+    if (checkBitmap) {
+      StarBitmap bitmap;
+      if (bitmap.readBitmap(zone, true, input->size(), data, dataType) && !data.empty() && dataType!="image/bm") {
+        // the bitmap is too big, readBitmap has reduced it
+        f << extension << ",reduced,";
+        ascii.addPos(0);
+        ascii.addNote(f.str().c_str());
+        return true;
+      }
+      dataType="image/bm";
+    }
   }
   else if (header==0x5653) {
 #ifdef DEBUG_WITH_FILES
@@ -38,6 +38,9 @@
 #ifndef STAR_FILE_MANAGER
 #  define STAR_FILE_MANAGER
 
+#include <atomic>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "STOFFDebug.hxx"
@@ -50,6 +53,11 @@ namespace StarFileManagerInternal
 struct State;
 }
 
+namespace libstoff
+{
+class ResourceGovernor;
+}
+
 class StarObject;
 class StarZone;
 
@@ -71,13 +79,66 @@ public:
   //! check for unparsed zone
   static void checkUnparsed(STOFFInputStreamPtr input, std::shared_ptr<STOFFOLEParser> oleParser, char const *password);
 
-  //! try to read a Ole directory
+  /** \brief a class used to read the embedded objects in background threads
+
+      The constructor schedules the reading of the chart, draw, math and spreadsheet
+      directories stored at the root of the file, readOLEDirectory then waits for their
+      results. The destructor waits for the directories which are being read, the remaining
+      directories are read in the calling thread when needed.
+
+      \note nothing is done if libstoff::getMaximumNumberOfThreads() returns 1
+   */
+  class BackgroundReader
+  {
+  public:
+    //! constructor: starts the reading
+    explicit BackgroundReader(std::shared_ptr<STOFFOLEParser> oleParser);
+    //! destructor: stops the threads
+    ~BackgroundReader();
+  protected:
+    //! the threads function
+    void run();
+
+    //! the ole parser
+    std::shared_ptr<STOFFOLEParser> m_oleParser;
+    //! the resource governor of the parse which has created the reader
+    libstoff::ResourceGovernor *m_governor;
+    //! the list of directories to read
+    std::vector<std::shared_ptr<STOFFOLEParser::OleDirectory> > m_directoryList;
+    //! the next directory to read
+    std::atomic<size_t> m_nextDirectory;
+    //! a flag used to stop the threads
+    std::atomic<bool> m_stop;
+    //! the threads
+    std::vector<std::thread> m_threadList;
+  private:
+    BackgroundReader(BackgroundReader const &orig) = delete;
+    BackgroundReader &operator=(BackgroundReader const &orig) = delete;
+  };
+
+  /** try to read a Ole directory
+
+      \note the result is kept in the directory, so a directory is read only once, until
+      STOFFOLEParser::resetDirectoryTasks is called. If another thread is reading the directory,
+      the function waits for its result, excepted if the objects reference each other. */
   static bool readOLEDirectory(std::shared_ptr<STOFFOLEParser> oleParser, std::shared_ptr<STOFFOLEParser::OleDirectory> ole, STOFFEmbeddedObject &image, std::shared_ptr<StarObject> &object);
+  /** sets the maximum number of embedded objects kept in the process-wide memory cache, 0 disables the memory cache.
+
+      \note the drawings, the spreadsheets and the other OLE objects which are converted in pictures
+      by readOLEDirectory are stored in the cache, using a hash of their streams as key. So an
+      unchanged object is not read again, even if it is stored in another document */
+  static void setObjectCacheSize(size_t numObjects);
+  //! sets the directory where the embedded objects are also stored, an empty string disables the disk cache
+  static void setObjectCacheDirectory(std::string const &directory);
+  //! returns the number of embedded objects found and not found in the cache
+  static void getObjectCacheStatistics(unsigned long &numHits, unsigned long &numMisses);
 
   //! try to read a image zone: "StarImageDocument" or "StarImageDocument 4.0
   static bool readImageDocument(STOFFInputStreamPtr input, librevenge::RVNGBinaryData &data, std::string const &fileName);
 
-  //! try to read a embedded picture file: Embedded/PicXXXXXX
+  /** try to read a embedded picture file: Embedded/PicXXXXXX
+
+      \note the decoded pictures are kept in the ole parser, so a picture is decoded only once */
   static bool readEmbeddedPicture(std::shared_ptr<STOFFOLEParser> oleParser, std::string const &fileName, STOFFEmbeddedObject &image);
   //! try to read a embedded picture file: Embedded/PicXXXXXX
   static bool readEmbeddedPicture(STOFFInputStreamPtr input, librevenge::RVNGBinaryData &data, std::string &dataType, std::string const &fileName);
@@ -1080,12 +1080,11 @@ bool StarGAttributeNamedArrow::read(StarZone &zone, int nVers, long endPos, Star
       nPoints=0;
     }
     f << "pts=[";
-    m_polygon.m_points.resize(size_t(nPoints));
+    m_polygon.resize(size_t(nPoints));
     for (size_t i=0; i<size_t(nPoints); ++i) {
       int dim[2];
       for (int &j : dim) j=int(input->readLong(4));
-      m_polygon.m_points[i].m_point=STOFFVec2i(dim[0],dim[1]);
-      m_polygon.m_points[i].m_flags=int(input->readULong(4));
+      m_polygon.setPoint(i, STOFFVec2i(dim[0],dim[1]), int(input->readULong(4)));
     }
     f << "],";
   }
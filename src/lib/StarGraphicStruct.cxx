@@ -31,6 +31,7 @@
 * instead of those above.
 */
 
+#include <cstring>
 #include <math.h>
 #include <sstream>
 
@@ -38,6 +39,8 @@
 
 #include "libstaroffice_internal.hxx"
 
+#include "STOFFInputStream.hxx"
+
 #include "StarBitmap.hxx"
 #include "StarFileManager.hxx"
 #include "StarObject.hxx"
@@ -679,34 +682,154 @@ bool StarGraphicStruct::StarGraphic::read(StarZone &zone, long endPos)
 }
 
 // StarPolygon
+bool StarPolygon::readPoints(STOFFInputStreamPtr input, size_t numPoints)
+{
+  if (!numPoints) return true;
+  if (!input || numPoints>size_t(input->size()/8)) {
+    STOFF_DEBUG_MSG(("StarGraphicStruct::StarPolygon::readPoints: the number of points seems bad\n"));
+    return false;
+  }
+  unsigned long numRead=0;
+  uint8_t const *data=input->read(8*numPoints, numRead);
+  if (!data || size_t(numRead)!=8*numPoints) {
+    STOFF_DEBUG_MSG(("StarGraphicStruct::StarPolygon::readPoints: can not read the points\n"));
+    return false;
+  }
+  bool const littleEndian=input->readInverted();
+  size_t const first=m_coordinates.size();
+  m_coordinates.resize(first+2*numPoints);
+  int32_t *ptr=&m_coordinates[first];
+  for (size_t i=0; i<2*numPoints; ++i, data+=4) {
+    uint32_t const val=littleEndian ?
+                       (uint32_t(data[0])|(uint32_t(data[1])<<8)|(uint32_t(data[2])<<16)|(uint32_t(data[3])<<24)) :
+                       (uint32_t(data[3])|(uint32_t(data[2])<<8)|(uint32_t(data[1])<<16)|(uint32_t(data[0])<<24));
+    *(ptr++)=static_cast<int32_t>(val);
+  }
+  m_flags.resize(m_flags.size()+numPoints, 0);
+  return true;
+}
+
+bool StarPolygon::readFlags(STOFFInputStreamPtr input, size_t numPoints)
+{
+  if (!numPoints) return true;
+  if (!input || numPoints>m_flags.size()) {
+    STOFF_DEBUG_MSG(("StarGraphicStruct::StarPolygon::readFlags: the number of points seems bad\n"));
+    return false;
+  }
+  unsigned long numRead=0;
+  uint8_t const *data=input->read(numPoints, numRead);
+  if (!data || size_t(numRead)!=numPoints) {
+    STOFF_DEBUG_MSG(("StarGraphicStruct::StarPolygon::readFlags: can not read the flags\n"));
+    return false;
+  }
+  std::memcpy(&m_flags[m_flags.size()-numPoints], data, numPoints);
+  return true;
+}
+
+STOFFBox2i StarPolygon::getBoundingBox() const
+{
+  if (m_flags.empty()) return STOFFBox2i();
+  int32_t minPt[2]= {m_coordinates[0], m_coordinates[1]};
+  int32_t maxPt[2]= {m_coordinates[0], m_coordinates[1]};
+  for (size_t i=2; i<m_coordinates.size(); ++i) {
+    int32_t const val=m_coordinates[i];
+    if (val<minPt[i&1])
+      minPt[i&1]=val;
+    else if (val>maxPt[i&1])
+      maxPt[i&1]=val;
+  }
+  return STOFFBox2i(STOFFVec2i(int(minPt[0]),int(minPt[1])), STOFFVec2i(int(maxPt[0]),int(maxPt[1])));
+}
+
+bool StarPolygon::getSimplified(StarPolygon &result, double tolerance) const
+{
+  size_t const numPoints=m_flags.size();
+  if (numPoints<3 || tolerance<=0 || hasSpecialPoints())
+    return false;
+  std::vector<bool> keep(numPoints, false);
+  keep[0]=keep[numPoints-1]=true;
+  double const tolerance2=tolerance*tolerance;
+  // the ranges [first,last] to check, use a stack to avoid deep recursion on long polylines
+  std::vector<std::pair<size_t,size_t> > stack;
+  stack.push_back(std::make_pair(size_t(0), numPoints-1));
+  while (!stack.empty()) {
+    size_t const first=stack.back().first, last=stack.back().second;
+    stack.pop_back();
+    if (last<=first+1) continue;
+    double const x0=m_coordinates[2*first], y0=m_coordinates[2*first+1];
+    double const dx=m_coordinates[2*last]-x0, dy=m_coordinates[2*last+1]-y0;
+    double const len2=dx*dx+dy*dy;
+    double maxDist2=-1;
+    size_t farthest=first;
+    for (size_t i=first+1; i<last; ++i) {
+      double const px=m_coordinates[2*i]-x0, py=m_coordinates[2*i+1]-y0;
+      double dist2;
+      if (len2<=0) // a closed chain: use the distance to the first point
+        dist2=px*px+py*py;
+      else {
+        double const cross=px*dy-py*dx;
+        dist2=cross*cross/len2;
+      }
+      if (dist2>maxDist2) {
+        maxDist2=dist2;
+        farthest=i;
+      }
+    }
+    if (maxDist2<tolerance2) continue;
+    keep[farthest]=true;
+    stack.push_back(std::make_pair(first, farthest));
+    stack.push_back(std::make_pair(farthest, last));
+  }
+  size_t numKept=0;
+  for (size_t i=0; i<numPoints; ++i) {
+    if (keep[i]) ++numKept;
+  }
+  if (numKept==numPoints)
+    return false;
+  result.m_coordinates.clear();
+  result.m_coordinates.reserve(2*numKept);
+  for (size_t i=0; i<numPoints; ++i) {
+    if (!keep[i]) continue;
+    result.m_coordinates.push_back(m_coordinates[2*i]);
+    result.m_coordinates.push_back(m_coordinates[2*i+1]);
+  }
+  result.m_flags.assign(numKept, 0);
+  return true;
+}
+
 void StarPolygon::addToPath(librevenge::RVNGPropertyListVector &path, bool isClosed, double relUnit, STOFFVec2f const &decal) const
 {
   librevenge::RVNGPropertyList element;
-  for (size_t i=0; i<m_points.size(); ++i) {
-    if (m_points[i].m_flags==2 && i+2<m_points.size() && m_points[i].m_flags==2) {
-      element.insert("svg:x1",relUnit*(m_points[i].m_point[0]-double(decal[0])), librevenge::RVNG_POINT);
-      element.insert("svg:y1",relUnit*(m_points[i].m_point[1]-double(decal[1])), librevenge::RVNG_POINT);
-      element.insert("svg:x2",relUnit*(m_points[++i].m_point[0]-double(decal[0])), librevenge::RVNG_POINT);
-      element.insert("svg:y2",relUnit*(m_points[i].m_point[1]-double(decal[1])), librevenge::RVNG_POINT);
-      element.insert("svg:x",relUnit*(m_points[++i].m_point[0]-double(decal[0])), librevenge::RVNG_POINT);
-      element.insert("svg:y",relUnit*(m_points[i].m_point[1]-double(decal[1])), librevenge::RVNG_POINT);
+  size_t const numPoints=m_flags.size();
+  double const dx=double(decal[0]), dy=double(decal[1]);
+  for (size_t i=0; i<numPoints; ++i) {
+    if (m_flags[i]==2 && i+2<numPoints && m_flags[i]==2) {
+      element.insert("svg:x1",relUnit*(m_coordinates[2*i]-dx), librevenge::RVNG_POINT);
+      element.insert("svg:y1",relUnit*(m_coordinates[2*i+1]-dy), librevenge::RVNG_POINT);
+      ++i;
+      element.insert("svg:x2",relUnit*(m_coordinates[2*i]-dx), librevenge::RVNG_POINT);
+      element.insert("svg:y2",relUnit*(m_coordinates[2*i+1]-dy), librevenge::RVNG_POINT);
+      ++i;
+      element.insert("svg:x",relUnit*(m_coordinates[2*i]-dx), librevenge::RVNG_POINT);
+      element.insert("svg:y",relUnit*(m_coordinates[2*i+1]-dy), librevenge::RVNG_POINT);
       element.insert("librevenge:path-action", "C");
     }
-    else if (m_points[i].m_flags==2 && i+1<m_points.size()) {
+    else if (m_flags[i]==2 && i+1<numPoints) {
       /* unsure, let asume that this means the previous point is symetric,
          but maybe we can also have a Bezier patch */
-      element.insert("svg:x1",relUnit*(m_points[i].m_point[0]-double(decal[0])), librevenge::RVNG_POINT);
-      element.insert("svg:y1",relUnit*(m_points[i].m_point[1]-double(decal[1])), librevenge::RVNG_POINT);
-      element.insert("svg:x",relUnit*(m_points[++i].m_point[0]-double(decal[0])), librevenge::RVNG_POINT);
-      element.insert("svg:y",relUnit*(m_points[i].m_point[1]-double(decal[1])), librevenge::RVNG_POINT);
+      element.insert("svg:x1",relUnit*(m_coordinates[2*i]-dx), librevenge::RVNG_POINT);
+      element.insert("svg:y1",relUnit*(m_coordinates[2*i+1]-dy), librevenge::RVNG_POINT);
+      ++i;
+      element.insert("svg:x",relUnit*(m_coordinates[2*i]-dx), librevenge::RVNG_POINT);
+      element.insert("svg:y",relUnit*(m_coordinates[2*i+1]-dy), librevenge::RVNG_POINT);
       element.insert("librevenge:path-action", "S");
     }
     else {
-      if (m_points[i].m_flags==2) {
+      if (m_flags[i]==2) {
         STOFF_DEBUG_MSG(("StarGraphicStruct::StarPolygon::addToPath: find unexpected flags\n"));
       }
-      element.insert("svg:x",relUnit*(m_points[i].m_point[0]-double(decal[0])), librevenge::RVNG_POINT);
-      element.insert("svg:y",relUnit*(m_points[i].m_point[1]-double(decal[1])), librevenge::RVNG_POINT);
+      element.insert("svg:x",relUnit*(m_coordinates[2*i]-dx), librevenge::RVNG_POINT);
+      element.insert("svg:y",relUnit*(m_coordinates[2*i+1]-dy), librevenge::RVNG_POINT);
       element.insert("librevenge:path-action", (i==0 ? "M" : "L"));
     }
     path.append(element);
@@ -717,6 +840,17 @@ void StarPolygon::addToPath(librevenge::RVNGPropertyListVector &path, bool isClo
   }
 }
 
+void StarPolygon::addToPoints(librevenge::RVNGPropertyListVector &points, float relUnit, STOFFVec2f const &offset) const
+{
+  librevenge::RVNGPropertyList element;
+  int32_t const *ptr=m_coordinates.empty() ? nullptr : &m_coordinates[0];
+  for (size_t i=0; i<m_flags.size(); ++i, ptr+=2) {
+    element.insert("svg:x",double(relUnit*float(ptr[0])+offset[0]), librevenge::RVNG_POINT);
+    element.insert("svg:y",double(relUnit*float(ptr[1])+offset[1]), librevenge::RVNG_POINT);
+    points.append(element);
+  }
+}
+
 bool StarPolygon::convert(librevenge::RVNGString &path, librevenge::RVNGString &viewbox, double relUnit, STOFFVec2f const &decal) const
 {
   librevenge::RVNGPropertyListVector pathVect;
@@ -735,8 +869,26 @@ bool StarPolygon::convert(librevenge::RVNGString &path, librevenge::RVNGString &
 std::ostream &operator<<(std::ostream &o, StarPolygon const &poly)
 {
   o << "points=[";
-  for (auto const &pt : poly.m_points)
-    o << pt << ",";
+  for (size_t i=0; i<poly.m_flags.size(); ++i) {
+    o << poly.getPoint(i);
+    switch (poly.m_flags[i]) {
+    case 0:
+      break;
+    case 1: // smooth
+      o << ":s";
+      break;
+    case 2: // control
+      o << ":c";
+      break;
+    case 3: // symetric
+      o << ":S";
+      break;
+    default:
+      STOFF_DEBUG_MSG(("StarGraphicStruct::StarPolygon::operator<< unexpected flag\n"));
+      o << ":[##" << int(poly.m_flags[i]) << "]";
+    }
+    o << ",";
+  }
   o << "],";
   return o;
 }
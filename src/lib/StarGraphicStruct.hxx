@@ -118,55 +118,24 @@ public:
   std::shared_ptr<StarBitmap> m_bitmap;
 };
 
-//! Class to store a polygon
+/** Class to store a polygon
+
+    \note the coordinates and the flags are stored in flat arrays, so that
+    a polygon with many points can be read and sent quickly */
 class StarPolygon
 {
 public:
-  //! a structure to keep a point and a flag
-  struct Point {
-    //! constructor
-    explicit Point(STOFFVec2i point=STOFFVec2i(), int flag=0)
-      : m_point(point)
-      , m_flags(flag)
-    {
-    }
-    //! operator<<
-    friend std::ostream &operator<<(std::ostream &o, Point const &point)
-    {
-      o << point.m_point;
-      switch (point.m_flags) {
-      case 0:
-        break;
-      case 1: // smooth
-        o << ":s";
-        break;
-      case 2: // control
-        o << ":c";
-        break;
-      case 3: // symetric
-        o << ":S";
-        break;
-      default:
-        STOFF_DEBUG_MSG(("StarObjectSmallGraphicStruct::StarPolygon::Point::operator<< unexpected flag\n"));
-        o << ":[##" << point.m_flags << "]";
-      }
-      return o;
-    }
-    //! the point
-    STOFFVec2i m_point;
-    //! the flags
-    int m_flags;
-  };
   //! contructor
   StarPolygon()
-    : m_points()
+    : m_coordinates()
+    , m_flags()
   {
   }
   //! check if a polygon has special point
   bool hasSpecialPoints() const
   {
-    for (auto const &pt : m_points) {
-      if (pt.m_flags)
+    for (auto flag : m_flags) {
+      if (flag)
         return true;
     }
     return false;
@@ -174,21 +143,69 @@ public:
   //! returns true if the polygon is empty
   bool empty() const
   {
-    return m_points.empty();
+    return m_flags.empty();
   }
   //! returns true if the polygon is empty
   size_t size() const
   {
-    return m_points.size();
+    return m_flags.size();
+  }
+  //! resizes the polygon
+  void resize(size_t numPoints)
+  {
+    m_coordinates.resize(2*numPoints, 0);
+    m_flags.resize(numPoints, 0);
+  }
+  //! adds a point
+  void addPoint(STOFFVec2i const &point, int flag=0)
+  {
+    m_coordinates.push_back(int32_t(point[0]));
+    m_coordinates.push_back(int32_t(point[1]));
+    m_flags.push_back(static_cast<uint8_t>(flag>=0 && flag<256 ? flag : 255));
   }
+  //! sets the ith point and its flag
+  void setPoint(size_t i, STOFFVec2i const &point, int flag=0)
+  {
+    if (i>=m_flags.size()) resize(i+1);
+    m_coordinates[2*i]=int32_t(point[0]);
+    m_coordinates[2*i+1]=int32_t(point[1]);
+    m_flags[i]=static_cast<uint8_t>(flag>=0 && flag<256 ? flag : 255);
+  }
+  //! returns the ith point
+  STOFFVec2i getPoint(size_t i) const
+  {
+    return STOFFVec2i(int(m_coordinates[2*i]), int(m_coordinates[2*i+1]));
+  }
+  //! returns the ith flag: 0 normal, 1 smooth, 2 control, 3 symmetric
+  int getFlag(size_t i) const
+  {
+    return int(m_flags[i]);
+  }
+  /** try to read numPoints points and to append them to the polygon
+
+      \note each point is stored as two 4 bytes integers, the points are read in one block */
+  bool readPoints(STOFFInputStreamPtr input, size_t numPoints);
+  //! try to read the flags of the last numPoints points, one byte by flag
+  bool readFlags(STOFFInputStreamPtr input, size_t numPoints);
+  //! returns the bounding box of the points, including the control points
+  STOFFBox2i getBoundingBox() const;
+  /** try to simplify a polygon which has no special points using the Douglas-Peucker algorithm:
+      the points whose distance to the simplified polyline is less than tolerance are removed.
+
+      \return false if the polygon can not be simplified */
+  bool getSimplified(StarPolygon &result, double tolerance) const;
   //! add the polygon to a path
   void addToPath(librevenge::RVNGPropertyListVector &path, bool isClosed, double relUnit, STOFFVec2f const &decal) const;
+  //! add the polygon's points to a list of points: svg:x=relUnit*x+offset[0], ...
+  void addToPoints(librevenge::RVNGPropertyListVector &points, float relUnit, STOFFVec2f const &offset) const;
   //! convert a path in a string and update the bdbox
   bool convert(librevenge::RVNGString &path, librevenge::RVNGString &viewbox, double relUnit, STOFFVec2f const &decal) const;
   //! operator<<
   friend std::ostream &operator<<(std::ostream &o, StarPolygon const &poly);
-  //! the list of points
-  std::vector<Point> m_points;
+  //! the coordinates: x0, y0, x1, y1, ...
+  std::vector<int32_t> m_coordinates;
+  //! the flags: 0 normal, 1 smooth, 2 control, 3 symmetric
+  std::vector<uint8_t> m_flags;
 };
 
 }
@@ -49,6 +49,7 @@
 #include "STOFFGraphicStyle.hxx"
 #include "STOFFListener.hxx"
 #include "STOFFParagraph.hxx"
+#include "STOFFParseTrace.hxx"
 
 #include "StarItemPool.hxx"
 
@@ -990,6 +991,7 @@ std::shared_ptr<StarAttribute> StarItemPool::readAttribute(StarZone &zone, int w
 
 bool StarItemPool::read(StarZone &zone)
 {
+  libstoff::ParseStatisticsScope statistics("StarItemPool::read", zone.input().get());
   STOFFInputStreamPtr input=zone.input();
   long pos=input->tell();
   long endPos=zone.getRecordLevel()>0 ?  zone.getRecordLastPosition() : input->size();
@@ -1291,7 +1293,7 @@ bool StarItemPool::readV2(StarZone &zone, StarItemPool *master)
   }
   if (!string.empty()) {
     m_state->setPoolName(libstoff::getString(string));
-    f << "name[ext]=" << libstoff::getString(string).cstr() << ",";
+    STOFF_DEBUG_TRACE(f << "name[ext]=" << libstoff::getString(string).cstr() << ",");
   }
   zone.closeSfxRecord(type1, "PoolDef");
 
@@ -1520,7 +1522,7 @@ bool StarItemPool::readV1(StarZone &zone, StarItemPool * /*master*/)
   }
   if (!string.empty()) {
     m_state->setPoolName(libstoff::getString(string));
-    f << "name[ext]=" << libstoff::getString(string).cstr() << ",";
+    STOFF_DEBUG_TRACE(f << "name[ext]=" << libstoff::getString(string).cstr() << ",");
   }
   uint32_t attribSize;
   *input>>attribSize;
@@ -1983,7 +1985,7 @@ bool StarItemPool::readStyles(StarZone &zone, StarObject &doc)
               dataOk=false;
               break;
             }
-            f2 << "[" << libstoff::getString(text).cstr();
+            STOFF_DEBUG_TRACE(f2 << "[" << libstoff::getString(text).cstr());
             auto cond=int(input->readULong(4));
             if (cond) f2 << "cond=" << std::hex << cond << std::dec << ",";
             if (cond & 0x8000) {
@@ -1991,7 +1993,7 @@ bool StarItemPool::readStyles(StarZone &zone, StarObject &doc)
                 dataOk=false;
                 break;
               }
-              f2 << libstoff::getString(text).cstr() << ",";
+              STOFF_DEBUG_TRACE(f2 << libstoff::getString(text).cstr() << ",");
             }
             else if (input->tell()+4<=endDataPos)
               f2 << "subCond=" << std::hex << input->readULong(4) << std::dec << ",";
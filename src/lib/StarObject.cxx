@@ -804,11 +804,13 @@ bool StarObject::readSfxPreview(STOFFInputStreamPtr input, std::string const &na
   ascii.open(name);
   input->seek(0, librevenge::RVNG_SEEK_SET);
   StarFileManager fileManager;
+  bool ok=true;
   if (!fileManager.readSVGDI(zone)) {
     STOFF_DEBUG_MSG(("StarObject::readSfxPreview: can not find the first image\n"));
     input->seek(0, librevenge::RVNG_SEEK_SET);
+    ok=false;
   }
-  if (input->isEnd()) return true;
+  if (input->isEnd()) return ok;
 
   long pos=input->tell();
   libstoff::DebugStream f;
@@ -818,7 +820,35 @@ bool StarObject::readSfxPreview(STOFFInputStreamPtr input, std::string const &na
   ascii.addPos(pos);
   ascii.addNote(f.str().c_str());
 
-  return true;
+  return ok;
+}
+
+bool StarObject::getPreview(STOFFEmbeddedObject &preview)
+{
+  if (!m_directory || !m_directory->m_input)
+    return false;
+  for (auto &content : m_directory->m_contentList) {
+    if (content.getBaseName()!="SfxPreview") continue;
+    auto name = content.getOleName();
+    STOFFInputStreamPtr ole = m_directory->m_input->getSubStreamByName(name.c_str());
+    if (!ole) {
+      STOFF_DEBUG_MSG(("StarObject::getPreview: can not find the preview\n"));
+      return false;
+    }
+    ole->setReadInverted(true);
+    content.setParsed(true);
+    if (!readSfxPreview(ole, name))
+      return false;
+    librevenge::RVNGBinaryData data;
+    ole->seek(0, librevenge::RVNG_SEEK_SET);
+    if (!ole->readEndDataBlock(data) || data.empty()) {
+      STOFF_DEBUG_MSG(("StarObject::getPreview: can not read the preview\n"));
+      return false;
+    }
+    preview.add(data, "image/svg");
+    return true;
+  }
+  return false;
 }
 
 bool StarObject::readSfxWindows(STOFFInputStreamPtr input, libstoff::DebugFile &ascii)
@@ -75,6 +75,8 @@ public:
 
   //! try to parse data
   bool parse();
+  //! try to retrieve the preview stored in "SfxPreview", a SVGDI picture
+  bool getPreview(STOFFEmbeddedObject &preview);
   //! returns the document kind
   STOFFDocument::Kind getDocumentKind() const;
   //! returns the document password (the password given by the user)
@@ -46,6 +46,7 @@
 #include "STOFFGraphicListener.hxx"
 #include "STOFFOLEParser.hxx"
 #include "STOFFPageSpan.hxx"
+#include "STOFFResourceGovernor.hxx"
 #include "STOFFSpreadsheetListener.hxx"
 
 #include "StarAttribute.hxx"
@@ -946,6 +947,7 @@ bool StarObjectChart::readSCHMemChart(StarZone &zone)
   }
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
+  libstoff::useCells(static_cast<unsigned long>(nCol)*static_cast<unsigned long>(nRow));
   if (nCol && nRow) {
     for (int c=0; c < int(nCol); ++c) {
       pos=input->tell();
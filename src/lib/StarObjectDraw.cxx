@@ -65,11 +65,14 @@ struct State {
     : m_model()
     , m_numPages()
   {
+    for (int &page : m_pageRange) page=0;
   }
   //! the model
   std::shared_ptr<StarObjectModel> m_model;
   //! the list of pages number
   int m_numPages;
+  //! the range of pages to read: 0 means no limit
+  int m_pageRange[2];
 };
 
 }
@@ -88,6 +91,12 @@ StarObjectDraw::~StarObjectDraw()
   cleanPools();
 }
 
+void StarObjectDraw::setPageRange(int firstPage, int lastPage)
+{
+  m_drawState->m_pageRange[0]=firstPage;
+  m_drawState->m_pageRange[1]=lastPage;
+}
+
 ////////////////////////////////////////////////////////////
 //
 // send data
@@ -119,6 +128,13 @@ bool StarObjectDraw::sendPages(STOFFGraphicListenerPtr listener)
   return m_drawState->m_model->sendPages(listener);
 }
 
+bool StarObjectDraw::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  if (!m_drawState->m_model)
+    return false;
+  return m_drawState->m_model->sendTextContent(extractor);
+}
+
 ////////////////////////////////////////////////////////////
 // main zone
 ////////////////////////////////////////////////////////////
@@ -206,6 +222,7 @@ try
   }
   input->seek(0, librevenge::RVNG_SEEK_SET);
   std::shared_ptr<StarObjectModel> model(new StarObjectModel(*this, true));
+  model->setPageRange(m_drawState->m_pageRange[0], m_drawState->m_pageRange[1]);
   if (!model->read(zone)) {
     STOFF_DEBUG_MSG(("StarObjectDraw::readDrawDocument: can not read the main zone\n"));
     ascFile.addPos(0);
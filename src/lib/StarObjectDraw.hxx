@@ -52,6 +52,7 @@ struct State;
 
 class StarObject;
 class StarZone;
+class STOFFTextExtractor;
 
 /** \brief the main class to read a StarOffice draw
  *
@@ -67,6 +68,8 @@ public:
   ~StarObjectDraw() override;
   //! try to parse the current object
   bool parse();
+  //! sets the range of pages to read (1-based), 0 means no limit, must be called before parse
+  void setPageRange(int firstPage, int lastPage);
 
   /** try to update the page span (to create draw document)*/
   bool updatePageSpans(std::vector<STOFFPageSpan> &pageSpan, int &numPages) const;
@@ -74,6 +77,8 @@ public:
   bool sendPages(STOFFGraphicListenerPtr listener);
   //! try to send the master pages
   bool sendMasterPages(STOFFGraphicListenerPtr listener);
+  //! try to send only the text content of the different pages
+  bool sendTextContent(STOFFTextExtractor &extractor) const;
 
 protected:
   //! try to read a spreadsheet zone: StarDrawDocument .sdd
@@ -31,20 +31,31 @@
 * instead of those above.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
+#include <thread>
 
 #include <librevenge/librevenge.h>
 
 #include "STOFFFrameStyle.hxx"
+#include "STOFFGraphicEncoder.hxx"
 #include "STOFFGraphicListener.hxx"
 #include "STOFFListener.hxx"
 #include "STOFFOLEParser.hxx"
 #include "STOFFPageSpan.hxx"
+#include "STOFFParseTrace.hxx"
+#include "STOFFResourceGovernor.hxx"
+#include "STOFFTextExtractor.hxx"
 
 #include "StarAttribute.hxx"
 #include "StarItemPool.hxx"
@@ -174,6 +185,7 @@ public:
     , m_layerSet()
     , m_objectList()
     , m_background()
+    , m_skipped(false)
   {
     for (int &border : m_borders) border=0;
   }
@@ -183,6 +195,29 @@ public:
     if (m_masterPage || m_masterPageDescList.empty()) return -1;
     return m_masterPageDescList[0].m_masterId;
   }
+  //! returns true if the page is a content page, ie. not the handout page or a notes page
+  bool isContentPage() const
+  {
+    int id=getMasterPageId();
+    return id>0 && (id&1)==1;
+  }
+  /** returns true if an object can be ignored: an object outside the page or whose
+      width and height are less than dotSize (in the model unit) */
+  bool isHidden(StarObjectSmallGraphic const &object, double dotSize) const
+  {
+    STOFFBox2i box;
+    if (!object.getBoundingBox(box))
+      return false;
+    STOFFVec2i const size=box.size();
+    if (size[0]<dotSize && size[1]<dotSize)
+      return true;
+    for (int c=0; c<2; ++c) {
+      if (m_size[c]<=0 || m_size[c]==0x7fffffff) continue;
+      if (box[1][c]<-dotSize || box[0][c]>m_size[c]+dotSize)
+        return true;
+    }
+    return false;
+  }
   //! update pagespan properties
   void updatePageSpan(STOFFPageSpan &page, double relUnit) const
   {
@@ -218,6 +253,7 @@ public:
     o << "layer=[" << page.m_layer << "],";
     o << "layerSet=[" << page.m_layerSet << "],";
     if (page.m_background) o << "hasBackground,";
+    if (page.m_skipped) o << "skipped,";
 #if 1
     for (auto &obj : page.m_objectList) {
       if (obj)
@@ -247,6 +283,8 @@ public:
   std::vector<std::shared_ptr<StarObjectSmallGraphic> > m_objectList;
   //! the background object
   std::shared_ptr<StarObjectSmallGraphic> m_background;
+  //! a flag to know if the page content is skipped, ie. if the page is not in the page range
+  bool m_skipped;
 };
 
 ////////////////////////////////////////
@@ -262,7 +300,20 @@ struct State {
     , m_pageToSendList()
     , m_masterPageToSendSet()
     , m_idToObjectMap()
+    , m_numContentPages(0)
+    , m_idToMasterPagePositionMap()
+  {
+    for (int &page : m_pageRange) page=0;
+  }
+  //! returns true if only some pages must be read
+  bool hasPageRange() const
+  {
+    return m_pageRange[0]>0 || m_pageRange[1]>0;
+  }
+  //! returns true if the content page pageNumber (1-based) is in the page range
+  bool isInPageRange(int pageNumber) const
   {
+    return pageNumber>=m_pageRange[0] && (m_pageRange[1]<=0 || pageNumber<=m_pageRange[1]);
   }
   //! small operator<< to print the content of the state
   friend std::ostream &operator<<(std::ostream &o, State const &state)
@@ -330,9 +381,127 @@ struct State {
   std::set<int> m_masterPageToSendSet;
   //! a map objectId to object
   std::map<int, std::shared_ptr<StarObjectSmallGraphic> > m_idToObjectMap;
+  //! the range of content pages to read (1-based): 0 means no limit
+  int m_pageRange[2];
+  //! the number of content pages found while reading
+  int m_numContentPages;
+  //! a map master page id to the position of its unread zone
+  std::map<int, long> m_idToMasterPagePositionMap;
+};
 
+#ifdef USE_THREADS
+////////////////////////////////////////
+//! Internal: a page sent in a background thread, see sendPagesInParallel
+struct PageTask {
+  //! constructor
+  PageTask()
+    : m_encoder()
+    , m_done(false)
+    , m_sendInListener(false)
+    , m_exception()
+  {
+  }
+  //! the encoder used to store the page content
+  STOFFGraphicEncoder m_encoder;
+  //! a flag to know if the page is sent
+  bool m_done;
+  //! a flag to know if the page must be sent again directly in the listener
+  bool m_sendInListener;
+  //! the exception thrown when sending the page (if any)
+  std::exception_ptr m_exception;
 };
 
+/** Internal: sends the pages to the encoders of some background threads and
+    inserts their contents in the listener in the page order.
+
+    \note a page which contains some lists is sent again by the listener, so that
+    the list ids are the same as in a serial conversion */
+static void sendPagesInParallel(StarObjectModel &model, std::vector<int> const &pageList, STOFFGraphicListenerPtr listener, int numThreads)
+{
+  size_t const numPages=pageList.size();
+  std::vector<std::unique_ptr<PageTask> > taskList;
+  for (size_t i=0; i<numPages; ++i)
+    taskList.push_back(std::unique_ptr<PageTask>(new PageTask));
+  // the calling thread inserts the pages, only a few pages are stored in advance
+  size_t const numWorkers=std::min(size_t(numThreads-1), numPages);
+  size_t const maxStoredPages=2*numWorkers;
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t numInserted=0;
+  bool stop=false;
+  std::atomic<size_t> nextPage(0);
+  auto governor=libstoff::ResourceGovernor::get();
+  auto worker=[&]() {
+    libstoff::ResourceGovernorScope governorScope(governor);
+    while (true) {
+      size_t const id=nextPage++;
+      if (id>=numPages) break;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return stop || id<numInserted+maxStoredPages; });
+        if (stop) break;
+      }
+      auto &task=*taskList[id];
+      try {
+        auto pageListener=listener->createPageContentListener(task.m_encoder);
+        pageListener->startDocument();
+        model.sendPage(pageList[id], pageListener, false);
+        pageListener->endDocument();
+        task.m_sendInListener=!pageListener->canInsertPageContent();
+      }
+      catch (...) {
+        STOFF_DEBUG_MSG(("StarObjectModelInternal::sendPagesInParallel: exception catched when sending page %d\n", pageList[id]));
+        task.m_exception=std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      task.m_done=true;
+      condition.notify_all();
+    }
+  };
+  std::vector<std::thread> threadList;
+  for (size_t i=0; i<numWorkers; ++i)
+    threadList.push_back(std::thread(worker));
+  auto stopWorkers=[&]() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop=true;
+      condition.notify_all();
+    }
+    for (auto &thread : threadList) {
+      if (thread.joinable())
+        thread.join();
+    }
+  };
+  try {
+    for (size_t i=0; i<numPages; ++i) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return taskList[i]->m_done; });
+      }
+      // as in sendPages, an error in a page stops the conversion
+      if (taskList[i]->m_exception)
+        std::rethrow_exception(taskList[i]->m_exception);
+      libstoff::checkDeadline();
+      if (i)
+        listener->insertBreak(STOFFListener::PageBreak);
+      if (taskList[i]->m_sendInListener)
+        model.sendPage(pageList[i], listener, false);
+      else
+        listener->insertPageContent(taskList[i]->m_encoder);
+      std::lock_guard<std::mutex> lock(mutex);
+      taskList[i].reset();
+      ++numInserted;
+      condition.notify_all();
+    }
+  }
+  catch (...) {
+    stopWorkers();
+    throw;
+  }
+  stopWorkers();
+}
+#endif
+
 }
 
 ////////////////////////////////////////////////////////////
@@ -357,6 +526,12 @@ std::ostream &operator<<(std::ostream &o, StarObjectModel const &model)
 ////////////////////////////////////////////////////////////
 // send data
 ////////////////////////////////////////////////////////////
+void StarObjectModel::setPageRange(int firstPage, int lastPage)
+{
+  m_modelState->m_pageRange[0]=firstPage>0 ? firstPage : 0;
+  m_modelState->m_pageRange[1]=lastPage>0 ? lastPage : 0;
+}
+
 bool StarObjectModel::updatePageSpans(std::vector<STOFFPageSpan> &pageSpan, int &number, bool usePage0) const
 {
   m_modelState->m_pageToSendList.clear();
@@ -378,8 +553,8 @@ bool StarObjectModel::updatePageSpans(std::vector<STOFFPageSpan> &pageSpan, int
     if (!m_modelState->m_pageList[i])
       continue;
     auto const &page=*m_modelState->m_pageList[i];
+    if (!page.isContentPage() || page.m_skipped) continue;
     int id=page.getMasterPageId();
-    if (id<=0 || (id&1)!=1) continue;
     m_modelState->m_pageToSendList.push_back(int(i));
     STOFFPageSpan ps;
     page.updatePageSpan(ps, relUnit);
@@ -421,10 +596,19 @@ bool StarObjectModel::sendObject(int id, STOFFListenerPtr listener, StarState co
 
 bool StarObjectModel::sendPages(STOFFListenerPtr listener)
 {
+  libstoff::ParseStatisticsScope statistics("StarObjectModel::sendPages", nullptr);
   if (!listener) {
     STOFF_DEBUG_MSG(("StarObjectModel::sendPages: can not find the listener\n"));
     return false;
   }
+#ifdef USE_THREADS
+  int const numThreads=libstoff::getMaximumNumberOfThreads();
+  auto graphicListener=std::dynamic_pointer_cast<STOFFGraphicListener>(listener);
+  if (graphicListener && numThreads>1 && m_modelState->m_pageToSendList.size()>1) {
+    StarObjectModelInternal::sendPagesInParallel(*this, m_modelState->m_pageToSendList, graphicListener, numThreads);
+    return true;
+  }
+#endif
   bool first=true;
   for (auto &page : m_modelState->m_pageToSendList) {
     if (!first)
@@ -477,22 +661,57 @@ bool StarObjectModel::sendPage(int pageId, STOFFListenerPtr listener, bool maste
   }
   if (pageId>=int(pageList.size()) || !pageList[size_t(pageId)])
     return false;
+  libstoff::checkDeadline();
+  if (!masterPage)
+    libstoff::checkProgress("Page", long(pageId), long(pageList.size()));
   StarObjectModelInternal::Page &page=*pageList[size_t(pageId)];
   STOFFFrameStyle frame;
   frame.m_position.m_anchorTo=STOFFPosition::Page;
   if (!masterPage) frame.m_position.m_propertyList.insert("text:anchor-page-number", pageId+1);
+  // if an output resolution is set, ignore the objects which are outside the page or smaller than a dot
+  double dotSize=0;
+  int const resolution=libstoff::getDrawingResolution();
+  if (resolution>0) {
+    auto pool=findItemPool(StarItemPool::T_XOutdevPool, false);
+    double const relUnit=pool ? pool->getRelativeUnit() : 0.028346457;
+    if (relUnit>0) dotSize=72./(relUnit*resolution);
+  }
+  int numHidden=0;
   for (auto pag : page.m_objectList) {
-    if (pag)
-      pag->send(listener, frame, *this, masterPage);
+    if (!pag) continue;
+    if (dotSize>0 && page.isHidden(*pag, dotSize)) {
+      ++numHidden;
+      continue;
+    }
+    pag->send(listener, frame, *this, masterPage);
+  }
+  if (numHidden) {
+    STOFF_DEBUG_MSG(("StarObjectModel::sendPage: ignore %d objects in page %d\n", numHidden, pageId));
   }
   return true;
 }
 
+bool StarObjectModel::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  bool sent=false;
+  for (auto const &p : m_modelState->m_pageList) {
+    // same page selection as updatePageSpans
+    if (!p || !p->isContentPage() || p->m_skipped) continue;
+    for (auto const &obj : p->m_objectList) {
+      if (obj)
+        obj->sendTextContent(extractor);
+    }
+    sent=true;
+  }
+  return sent;
+}
+
 ////////////////////////////////////////////////////////////
 // the parser
 ////////////////////////////////////////////////////////////
 bool StarObjectModel::read(StarZone &zone)
 {
+  libstoff::ParseStatisticsScope statistics("StarObjectModel::read", zone.input().get());
   STOFFInputStreamPtr input=zone.input();
   // first check magic
   std::string magic("");
@@ -726,6 +945,17 @@ bool StarObjectModel::read(StarZone &zone)
         continue;
       }
     }
+    if (magic=="DrMP" && m_modelState->hasPageRange() && zone.openSDRHeader(magic)) {
+      // the master pages used by the selected pages are read at the end
+      auto id=int(m_modelState->m_masterPageList.size());
+      m_modelState->m_idToMasterPagePositionMap[id]=pos;
+      m_modelState->m_masterPageList.push_back(std::shared_ptr<StarObjectModelInternal::Page>());
+      ascFile.addPos(pos);
+      ascFile.addNote("Entries(SdrPageDef):master,skipped");
+      input->seek(zone.getRecordLastPosition(), librevenge::RVNG_SEEK_SET);
+      zone.closeSDRHeader("SdrModel");
+      continue;
+    }
     if ((magic=="DrPg" || magic=="DrMP")) {
       auto page=readSdrPage(zone);
       if (page) {
@@ -753,6 +983,28 @@ bool StarObjectModel::read(StarZone &zone)
     ascFile.addNote(f.str().c_str());
     zone.closeSDRHeader("SdrModel");
   }
+  if (!m_modelState->m_idToMasterPagePositionMap.empty()) {
+    // now read the master pages used by the selected pages
+    pos=input->tell();
+    std::set<int> masterIds;
+    for (auto const &page : m_modelState->m_pageList) {
+      if (page && page->isContentPage() && !page->m_skipped)
+        masterIds.insert(page->getMasterPageId());
+    }
+    for (auto id : masterIds) {
+      auto it=m_modelState->m_idToMasterPagePositionMap.find(id);
+      if (it==m_modelState->m_idToMasterPagePositionMap.end())
+        continue;
+      input->seek(it->second, librevenge::RVNG_SEEK_SET);
+      auto page=readSdrPage(zone);
+      if (page)
+        m_modelState->m_masterPageList[size_t(id)]=page;
+      else {
+        STOFF_DEBUG_MSG(("StarObjectModel::read: can not read the master page %d\n", id));
+      }
+    }
+    input->seek(pos, librevenge::RVNG_SEEK_SET);
+  }
 
   zone.closeRecord("SdrModelA1");
   // in DrawingLayer, find also 0500000001 and 060000000[01]00
@@ -1056,8 +1308,17 @@ std::shared_ptr<StarObjectModelInternal::Page> StarObjectModel::readSdrPage(Star
     ascFile.addPos(pos);
     ascFile.addNote(f.str().c_str());
   }
+  if (ok && !page->m_masterPage && m_modelState->hasPageRange()) {
+    page->m_skipped=!page->isContentPage() || !m_modelState->isInPageRange(++m_modelState->m_numContentPages);
+    if (page->m_skipped) {
+      // only keep the page dimensions and its master page
+      ascFile.addPos(input->tell());
+      ascFile.addNote("SdrPageDef[skipped]:");
+      input->seek(lastPos, librevenge::RVNG_SEEK_SET);
+    }
+  }
   // SdrObjList::Load
-  while (ok) {
+  while (ok && !page->m_skipped) {
     pos=input->tell();
     if (pos+4>lastPos)
       break;
@@ -1083,7 +1344,7 @@ std::shared_ptr<StarObjectModelInternal::Page> StarObjectModel::readSdrPage(Star
     input->seek(pos, librevenge::RVNG_SEEK_SET);
     break;
   }
-  if (ok && version>=16) {
+  if (ok && !page->m_skipped && version>=16) {
     pos=input->tell();
     f.str("");
     f << "SdrPageDef[background-" << zone.getRecordLevel() << "]:";
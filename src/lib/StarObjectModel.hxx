@@ -55,6 +55,7 @@ struct State;
 
 class StarState;
 class StarZone;
+class STOFFTextExtractor;
 
 /** \brief the main class to read a SdrModel zone
  *
@@ -68,6 +69,10 @@ public:
   StarObjectModel(StarObject const &orig, bool duplicateState);
   //! destructor
   ~StarObjectModel() override;
+  /** sets the range of content pages to read (1-based), 0 means no limit.
+
+      \note the other pages are kept without their objects and only the master pages used by the selected pages are read, so this must be called before read */
+  void setPageRange(int firstPage, int lastPage);
   //! try to read a SdrModel zone: "DrMd"
   bool read(StarZone &zone);
   /** try to update the object id of page 0
@@ -85,6 +90,8 @@ public:
   bool sendPage(int pageId, STOFFListenerPtr listener, bool masterPage=false);
   //! try to send an object
   bool sendObject(int id, STOFFListenerPtr listener, StarState const &state);
+  //! try to send only the text content of the different pages
+  bool sendTextContent(STOFFTextExtractor &extractor) const;
 
   //! small operator<< to print the content of the model
   friend std::ostream &operator<<(std::ostream &o, StarObjectModel const &model);
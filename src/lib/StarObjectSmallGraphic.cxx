@@ -44,6 +44,7 @@
 #include "STOFFGraphicStyle.hxx"
 #include "STOFFListener.hxx"
 #include "STOFFSubDocument.hxx"
+#include "STOFFTextExtractor.hxx"
 #include "STOFFTextListener.hxx"
 
 #include "StarAttribute.hxx"
@@ -187,6 +188,18 @@ public:
     }
     return true;
   }
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const
+  {
+    if (m_textZone)
+      m_textZone->sendTextContent(extractor);
+    else {
+      for (auto const &z : m_zones) {
+        if (z.m_text)
+          z.m_text->sendTextContent(extractor);
+      }
+    }
+  }
   //! the version
   int m_version;
   //! the list of zones: version<=3
@@ -272,6 +285,15 @@ public:
     }
     return false;
   }
+  //! try to send only the text content
+  virtual void sendTextContent(STOFFTextExtractor &/*extractor*/) const
+  {
+  }
+  //! try to return the bounding box of the graphic
+  virtual bool getBoundingBox(STOFFBox2i &/*box*/) const
+  {
+    return false;
+  }
   //! the type
   int m_identifier;
 };
@@ -317,6 +339,15 @@ public:
     s << "###type=" << m_identifier << ",";
     return s.str();
   }
+  //! try to return the bounding box of the graphic
+  bool getBoundingBox(STOFFBox2i &box) const override
+  {
+    // an empty rectangle is stored with negative dimensions
+    if (m_bdbox==STOFFBox2i() || m_bdbox.size()[0]<0 || m_bdbox.size()[1]<0)
+      return false;
+    box=m_bdbox;
+    return true;
+  }
   //! return a pool corresponding to an object
   StarState getState(StarObject &object, STOFFListenerPtr listener, STOFFFrameStyle const &/*pos*/) const
   {
@@ -463,10 +494,35 @@ public:
     , m_hasRefPoint(false)
     , m_groupDrehWink(0)
     , m_groupShearWink(0)
+    , m_childBox()
+    , m_hasChildBox(false)
   {
   }
   //! destructor
   ~SdrGraphicGroup() final;
+  //! try to return the bounding box of the graphic
+  bool getBoundingBox(STOFFBox2i &box) const final
+  {
+    if (!m_hasChildBox)
+      return SdrGraphic::getBoundingBox(box);
+    box=m_childBox;
+    return true;
+  }
+  //! computes the bounding box of the child, must be called when all the child are read
+  void updateChildBox()
+  {
+    m_hasChildBox=false;
+    for (auto const &child : m_child) {
+      STOFFBox2i box;
+      // if a child has no bounding box, we can not check the group
+      if (!child || !child->getBoundingBox(box)) {
+        m_hasChildBox=false;
+        return;
+      }
+      m_childBox=m_hasChildBox ? m_childBox.getUnion(box) : box;
+      m_hasChildBox=true;
+    }
+  }
   //! basic print function
   std::string print() const final
   {
@@ -493,6 +549,14 @@ public:
     listener->closeGroup();
     return true;
   }
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const final
+  {
+    for (auto const &child : m_child) {
+      if (child)
+        child->sendTextContent(extractor);
+    }
+  }
   //! print object data
   friend std::ostream &operator<<(std::ostream &o, SdrGraphicGroup const &graph)
   {
@@ -516,6 +580,10 @@ public:
   int m_groupDrehWink;
   //! the shear wink
   int m_groupShearWink;
+  //! the union of the child bounding boxes
+  STOFFBox2i m_childBox;
+  //! a flag to know if m_childBox is set
+  bool m_hasChildBox;
 };
 
 SdrGraphicGroup::~SdrGraphicGroup()
@@ -596,6 +664,12 @@ public:
     listener->insertTextBox(frame, doc, state.m_graphic);
     return true;
   }
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const override
+  {
+    if (m_outlinerParaObject)
+      m_outlinerParaObject->sendTextContent(extractor);
+  }
   //! print object data
   friend std::ostream &operator<<(std::ostream &o, SdrGraphicText const &graph)
   {
@@ -639,6 +713,18 @@ public:
   }
   //! destructor
   ~SdrGraphicRect() override;
+  //! try to return the bounding box of the graphic
+  bool getBoundingBox(STOFFBox2i &box) const override
+  {
+    bool const hasRect=m_textRectangle!=STOFFBox2i() && m_textRectangle.size()[0]>=0 && m_textRectangle.size()[1]>=0;
+    if (!SdrGraphic::getBoundingBox(box)) {
+      if (!hasRect) return false;
+      box=m_textRectangle;
+    }
+    else if (hasRect)
+      box=box.getUnion(m_textRectangle);
+    return true;
+  }
   //! try to send the graphic to the listener
   bool send(STOFFListenerPtr listener, STOFFFrameStyle const &pos, StarObject &object, bool inMasterPage) override
   {
@@ -733,7 +819,7 @@ public:
     shape.m_command=STOFFGraphicShape::C_Polyline;
     StarGraphicStruct::StarPolygon polygon;
     for (auto const &p : m_captionPolygon)
-      polygon.m_points.push_back(StarGraphicStruct::StarPolygon::Point(p, 0));
+      polygon.addPoint(p);
     librevenge::RVNGPropertyListVector path;
     polygon.addToPath(path, false, state.m_global->m_relativeUnit, state.m_global->m_offset);
     shape.m_propertyList.insert("svg:d", path);
@@ -916,7 +1002,7 @@ public:
     size_t numFlags=m_edgePolygonFlags.size();
     StarGraphicStruct::StarPolygon polygon;
     for (size_t p=0; p<m_edgePolygon.size(); ++p)
-      polygon.m_points.push_back(StarGraphicStruct::StarPolygon::Point(m_edgePolygon[p], p<numFlags ? m_edgePolygonFlags[p] : 0));
+      polygon.addPoint(m_edgePolygon[p], p<numFlags ? m_edgePolygonFlags[p] : 0);
     librevenge::RVNGPropertyListVector path;
     polygon.addToPath(path, false, state.m_global->m_relativeUnit, state.m_global->m_offset);
     shape.m_propertyList.insert("svg:d", path);
@@ -1279,10 +1365,38 @@ public:
   explicit SdrGraphicPath(int id)
     : SdrGraphicText(id)
     , m_pathPolygons()
+    , m_pathBox()
   {
   }
   //! try to send the graphic to the listener
   bool send(STOFFListenerPtr listener, STOFFFrameStyle const &pos, StarObject &object, bool /*inMasterPage*/) final;
+  //! try to return the bounding box of the graphic
+  bool getBoundingBox(STOFFBox2i &box) const final
+  {
+    bool hasPoints=false;
+    for (auto const &poly : m_pathPolygons) {
+      if (poly.empty()) continue;
+      hasPoints=true;
+      break;
+    }
+    if (!SdrGraphic::getBoundingBox(box)) {
+      if (!hasPoints) return false;
+      box=m_pathBox;
+    }
+    else if (hasPoints)
+      box=box.getUnion(m_pathBox);
+    return true;
+  }
+  //! computes the bounding box of the points, must be called when all the polygons are read
+  void updatePathBox()
+  {
+    bool first=true;
+    for (auto const &poly : m_pathPolygons) {
+      if (poly.empty()) continue;
+      m_pathBox=first ? poly.getBoundingBox() : m_pathBox.getUnion(poly.getBoundingBox());
+      first=false;
+    }
+  }
   //! basic print function
   std::string print() const final
   {
@@ -1302,6 +1416,8 @@ public:
   }
   //! the path polygon
   std::vector<StarGraphicStruct::StarPolygon> m_pathPolygons;
+  //! the bounding box of the path points
+  STOFFBox2i m_pathBox;
 };
 
 bool SdrGraphicPath::send(STOFFListenerPtr listener, STOFFFrameStyle const &pos, StarObject &object, bool inMasterPage)
@@ -1332,7 +1448,7 @@ bool SdrGraphicPath::send(STOFFListenerPtr listener, STOFFFrameStyle const &pos,
       shape.m_command=STOFFGraphicShape::C_Polyline;
       for (size_t i=0; i<2; ++i) {
         librevenge::RVNGPropertyList list;
-        auto pt=state.convertPointInPoint(m_pathPolygons[i].m_points[0].m_point);
+        auto pt=state.convertPointInPoint(m_pathPolygons[i].getPoint(0));
         list.insert("svg:x",pt[0], librevenge::RVNG_POINT);
         list.insert("svg:y",pt[1], librevenge::RVNG_POINT);
         vect.append(list);
@@ -1375,22 +1491,27 @@ bool SdrGraphicPath::send(STOFFListenerPtr listener, STOFFFrameStyle const &pos,
       break;
     }
   }
+  // if an output resolution is set, remove the points which are closer than half a dot to the final polyline
+  double tolerance=0;
+  int const resolution=libstoff::getDrawingResolution();
+  if (resolution>0 && state.m_global->m_relativeUnit>0)
+    tolerance=36./(state.m_global->m_relativeUnit*resolution);
+  StarGraphicStruct::StarPolygon simplified;
   if (!hasSpecialPoint && m_pathPolygons.size()==1) {
     shape.m_command=isClosed ? STOFFGraphicShape::C_Polygon : STOFFGraphicShape::C_Polyline;
-    librevenge::RVNGPropertyList list;
-    for (size_t i=0; i<m_pathPolygons[0].size(); ++i) {
-      auto pt=state.convertPointInPoint(m_pathPolygons[0].m_points[i].m_point);
-      list.insert("svg:x",pt[0], librevenge::RVNG_POINT);
-      list.insert("svg:y",pt[1], librevenge::RVNG_POINT);
-      vect.append(list);
-    }
+    auto const &poly=m_pathPolygons[0].getSimplified(simplified, tolerance) ? simplified : m_pathPolygons[0];
+    poly.addToPoints(vect, float(state.m_global->m_relativeUnit), state.m_global->m_offset);
     shape.m_propertyList.insert("svg:points", vect);
   }
   else {
     shape.m_command=STOFFGraphicShape::C_Path;
     librevenge::RVNGPropertyListVector path;
-    for (auto const poly : m_pathPolygons)
-      poly.addToPath(path, isClosed, state.m_global->m_relativeUnit, state.m_global->m_offset);
+    for (auto const &poly : m_pathPolygons) {
+      if (poly.getSimplified(simplified, tolerance))
+        simplified.addToPath(path, isClosed, state.m_global->m_relativeUnit, state.m_global->m_offset);
+      else
+        poly.addToPath(path, isClosed, state.m_global->m_relativeUnit, state.m_global->m_offset);
+    }
     shape.m_propertyList.insert("svg:d", path);
   }
   updateTransformProperties(shape.m_propertyList, state.m_global->m_relativeUnit);
@@ -1738,6 +1859,17 @@ bool StarObjectSmallGraphic::send(STOFFListenerPtr listener, STOFFFrameStyle con
   return m_graphicState->m_graphic->send(listener, pos, object, inMasterPage);
 }
 
+void StarObjectSmallGraphic::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  if (m_graphicState->m_graphic)
+    m_graphicState->m_graphic->sendTextContent(extractor);
+}
+
+bool StarObjectSmallGraphic::getBoundingBox(STOFFBox2i &box) const
+{
+  return m_graphicState->m_graphic && m_graphicState->m_graphic->getBoundingBox(box);
+}
+
 ////////////////////////////////////////////////////////////
 // the parser
 ////////////////////////////////////////////////////////////
@@ -2064,9 +2196,9 @@ bool StarObjectSmallGraphic::readSVDRObjectAttrib(StarZone &zone, StarObjectSmal
   input->seek(lastPos, librevenge::RVNG_SEEK_SET);
   zone.closeRecord("SVDR");
 
-  std::string extra=f.str();
-  f.str("");
-  f << "SVDR[" << zone.getRecordLevel() << "]:attrib," << graphic << extra;
+  STOFF_DEBUG_TRACE(std::string extra=f.str();
+                    f.str("");
+                    f << "SVDR[" << zone.getRecordLevel() << "]:attrib," << graphic << extra);
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
   return true;
@@ -2159,9 +2291,9 @@ bool StarObjectSmallGraphic::readSVDRObjectCircle(StarZone &zone, StarObjectSmal
   }
   zone.closeRecord("SVDR");
 
-  std::string extra=f.str();
-  f.str("");
-  f << "SVDR[" << zone.getRecordLevel() << "]:" << graphic << extra;
+  STOFF_DEBUG_TRACE(std::string extra=f.str();
+                    f.str("");
+                    f << "SVDR[" << zone.getRecordLevel() << "]:" << graphic << extra);
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
 
@@ -2601,6 +2733,7 @@ bool StarObjectSmallGraphic::readSVDRObjectGroup(StarZone &zone, StarObjectSmall
     }
     graphic.m_child.push_back(child);
   }
+  graphic.updateChildBox();
   if (ok && vers>=2) {
     graphic.m_groupDrehWink=int(input->readLong(4));
     if (graphic.m_groupDrehWink)
@@ -2660,9 +2793,9 @@ bool StarObjectSmallGraphic::readSVDRObjectMeasure(StarZone &zone, StarObjectSma
     graphic.m_measureItem=item;
   zone.closeRecord("SVDR");
 
-  std::string extra=f.str();
-  f.str("");
-  f << "SVDR[" << zone.getRecordLevel() << "]:" << graphic << extra;
+  STOFF_DEBUG_TRACE(std::string extra=f.str();
+                    f.str("");
+                    f << "SVDR[" << zone.getRecordLevel() << "]:" << graphic << extra);
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
 
@@ -2732,9 +2865,9 @@ bool StarObjectSmallGraphic::readSVDRObjectOLE(StarZone &zone, StarObjectSmallGr
   input->seek(lastPos, librevenge::RVNG_SEEK_SET);
   zone.closeRecord("SVDR");
 
-  std::string extra=f.str();
-  f.str("");
-  f << "SVDR[" << zone.getRecordLevel() << "]:" << graphic << extra;
+  STOFF_DEBUG_TRACE(std::string extra=f.str();
+                    f.str("");
+                    f << "SVDR[" << zone.getRecordLevel() << "]:" << graphic << extra);
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
 
@@ -2773,11 +2906,10 @@ bool StarObjectSmallGraphic::readSVDRObjectPath(StarZone &zone, StarObjectSmallG
         break;
       }
       graphic.m_pathPolygons.push_back(StarGraphicStruct::StarPolygon());
-      auto &polygon=graphic.m_pathPolygons.back();
-      for (int pt=0; pt<int(n); ++pt) {
-        int dim[2];
-        for (int &i : dim) i=int(input->readLong(4));
-        polygon.m_points.push_back(StarGraphicStruct::StarPolygon::Point(STOFFVec2i(dim[0],dim[1])));
+      if (!graphic.m_pathPolygons.back().readPoints(input, size_t(n))) {
+        f << "###points,";
+        ok=false;
+        break;
       }
     }
   }
@@ -2802,14 +2934,11 @@ bool StarObjectSmallGraphic::readSVDRObjectPath(StarZone &zone, StarObjectSmallG
       }
       graphic.m_pathPolygons.push_back(StarGraphicStruct::StarPolygon());
       auto &polygon=graphic.m_pathPolygons.back();
-      polygon.m_points.resize(size_t(n));
-      for (size_t pt=0; pt<size_t(n); ++pt) {
-        int dim[2];
-        for (int &i : dim) i=int(input->readLong(4));
-        polygon.m_points[pt].m_point=STOFFVec2i(dim[0],dim[1]);
+      if (!polygon.readPoints(input, size_t(n)) || !polygon.readFlags(input, size_t(n))) {
+        f << "###points,";
+        ok=false;
+        break;
       }
-      for (size_t pt=0; pt<size_t(n); ++pt)
-        polygon.m_points[pt].m_flags=int(input->readULong(1));
     }
     if (recOpened) {
       if (input->tell()!=zone.getRecordLastPosition()) {
@@ -2829,6 +2958,7 @@ bool StarObjectSmallGraphic::readSVDRObjectPath(StarZone &zone, StarObjectSmallG
     input->seek(lastPos, librevenge::RVNG_SEEK_SET);
   }
   zone.closeRecord("SVDR");
+  graphic.updatePathBox();
   f << graphic;
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
@@ -3610,9 +3740,9 @@ std::shared_ptr<StarObjectSmallGraphicInternal::SDRUserData> StarObjectSmallGrap
       }
       input->seek(endPos, librevenge::RVNG_SEEK_SET);
     }
-    std::string extra=f.str();
-    f.str("");
-    f << "Entries(SDUD):" << *graphic << extra;
+    STOFF_DEBUG_TRACE(std::string extra=f.str();
+                      f.str("");
+                      f << "Entries(SDUD):" << *graphic << extra);
   }
   else {
     res=std::make_shared<StarObjectSmallGraphicInternal::SDUDGraphic>(identifier);
@@ -70,6 +70,7 @@ struct State;
 }
 
 class STOFFFrameStyle;
+class STOFFTextExtractor;
 
 class StarZone;
 
@@ -89,6 +90,10 @@ public:
   bool readSdrObject(StarZone &zone);
   //! try to send a object to the listener
   bool send(STOFFListenerPtr listener, STOFFFrameStyle const &pos, StarObject &object, bool inPageMaster=false);
+  //! try to send only the text content of a object
+  void sendTextContent(STOFFTextExtractor &extractor) const;
+  //! try to return the bounding box of the object in the model unit
+  bool getBoundingBox(STOFFBox2i &box) const;
   //! small operator<< to print the content of the small graphic object
   friend std::ostream &operator<<(std::ostream &o, StarObjectSmallGraphic const &graphic);
 
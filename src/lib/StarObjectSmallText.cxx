@@ -42,6 +42,7 @@
 #include "STOFFFont.hxx"
 #include "STOFFListener.hxx"
 #include "STOFFParagraph.hxx"
+#include "STOFFTextExtractor.hxx"
 
 #include "StarAttribute.hxx"
 #include "StarObject.hxx"
@@ -192,8 +193,17 @@ bool Paragraph::send(STOFFListenerPtr &listener, StarState &mainState, StarState
       listener->insertTab();
     else if (m_text[c]==0xa)
       listener->insertEOL(true);
-    else
-      listener->insertUnicode(m_text[c]);
+    else {
+      // send all the characters until the next font change, tab or line break
+      size_t last=c+1;
+      for (; last<m_text.size(); ++last) {
+        if (m_text[last]==0x9 || m_text[last]==0xa) break;
+        size_t lastSrcPos=last<m_textSourcePosition.size() ? m_textSourcePosition[last] : m_textSourcePosition.empty() ? 0 : 10000;
+        if (posSetIt!=modPosSet.end() && *posSetIt <= lastSrcPos) break;
+      }
+      listener->insertUnicodeSpan(&m_text[c], last-c);
+      c=last-1;
+    }
   }
   return true;
 }
@@ -245,6 +255,14 @@ bool StarObjectSmallText::send(std::shared_ptr<STOFFListener> listener, int leve
   return true;
 }
 
+void StarObjectSmallText::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  for (auto const &para : m_textState->m_paragraphList) {
+    extractor.insertUnicodeList(para.m_text);
+    extractor.insertEOL();
+  }
+}
+
 ////////////////////////////////////////////////////////////
 // the parser
 ////////////////////////////////////////////////////////////
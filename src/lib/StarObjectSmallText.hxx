@@ -48,6 +48,7 @@ namespace StarObjectSmallTextInternal
 struct State;
 }
 
+class STOFFTextExtractor;
 class StarZone;
 
 /** \brief the main class to read a small StarOffice text zone
@@ -68,6 +69,8 @@ public:
 
   //! try to send a small text zone
   bool send(std::shared_ptr<STOFFListener> listener, int level=-1);
+  //! try to send only the text content of a small text zone
+  void sendTextContent(STOFFTextExtractor &extractor) const;
 protected:
   //
   // low level
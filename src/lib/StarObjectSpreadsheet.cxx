@@ -57,9 +57,12 @@
 #include "STOFFGraphicStyle.hxx"
 #include "STOFFOLEParser.hxx"
 #include "STOFFPageSpan.hxx"
+#include "STOFFParseTrace.hxx"
+#include "STOFFResourceGovernor.hxx"
 #include "STOFFSubDocument.hxx"
 #include "STOFFSpreadsheetListener.hxx"
 #include "STOFFTable.hxx"
+#include "STOFFTextExtractor.hxx"
 
 #include "StarFormatManager.hxx"
 
@@ -621,6 +624,8 @@ bool StarObjectSpreadsheet::send(STOFFSpreadsheetListenerPtr listener)
   }
 
   for (size_t t=0; t<m_spreadsheetState->m_tableList.size(); ++t) {
+    libstoff::checkDeadline();
+    libstoff::checkProgress("Sheet", long(t), long(m_spreadsheetState->m_tableList.size()));
     if (t) listener->insertBreak(STOFFListener::PageBreak);
     if (!m_spreadsheetState->m_tableList[t]) continue;
     StarObjectSpreadsheetInternal::Table &sheet=*m_spreadsheetState->m_tableList[t];
@@ -663,6 +668,31 @@ bool StarObjectSpreadsheet::send(STOFFSpreadsheetListenerPtr listener)
   return true;
 }
 
+bool StarObjectSpreadsheet::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  if (m_spreadsheetState->m_tableList.empty()) {
+    STOFF_DEBUG_MSG(("StarObjectSpreadsheet::sendTextContent: can not find the table\n"));
+    return false;
+  }
+  for (auto const &sheet : m_spreadsheetState->m_tableList) {
+    if (!sheet) continue;
+    for (auto const &rIt : sheet->m_rowToRowContentMap) {
+      for (auto const &cIt : rIt.second.m_colToCellMap) {
+        if (!cIt.second) continue;
+        auto const &cell=*cIt.second;
+        if (cell.m_content.m_contentType==STOFFCellContent::C_TEXT_BASIC) {
+          if (cell.m_content.m_text.empty()) continue;
+          extractor.insertUnicodeList(cell.m_content.m_text);
+          extractor.insertEOL();
+        }
+        else if (cell.m_content.m_contentType==STOFFCellContent::C_TEXT && cell.m_textZone)
+          cell.m_textZone->sendTextContent(extractor);
+      }
+    }
+  }
+  return true;
+}
+
 bool StarObjectSpreadsheet::sendRow(int table, int row, STOFFSpreadsheetListenerPtr listener)
 {
   if (!listener || table<0 || table>=int(m_spreadsheetState->m_tableList.size()) || !m_spreadsheetState->m_tableList[size_t(table)]) {
@@ -899,7 +929,7 @@ try
           ascFile.addNote(f.str().c_str());
           continue;
         }
-        f << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << libstoff::getString(string).cstr() << ",");
         StarObjectSpreadsheetInternal::Cell cell;
         if (version >= 3) {
           uint32_t nPos;
@@ -1003,7 +1033,7 @@ try
             f << "###string";
           }
           else {
-            if (!string.empty()) f << libstoff::getString(string).cstr() << ",";
+            STOFF_DEBUG_TRACE(if (!string.empty()) f << libstoff::getString(string).cstr() << ",");
             bool bColHeaders, bRowHeaders;
             *input >> bColHeaders >> bRowHeaders;
             if (bColHeaders) f << "col[headers],";
@@ -1021,7 +1051,7 @@ try
               break;
             }
             if (string.empty()) continue;
-            f << (j==0 ? "appl" : j==1 ? "topic" : "item") << "=" << libstoff::getString(string).cstr() << ",";
+            STOFF_DEBUG_TRACE(f << (j==0 ? "appl" : j==1 ? "topic" : "item") << "=" << libstoff::getString(string).cstr() << ",");
           }
           if (!parsed)
             break;
@@ -1046,7 +1076,7 @@ try
               break;
             }
             if (string.empty()) continue;
-            f << (j==0 ? "file" : j==1 ? "filter" : "source") << "=" << libstoff::getString(string).cstr() << ",";
+            STOFF_DEBUG_TRACE(f << (j==0 ? "file" : j==1 ? "filter" : "source") << "=" << libstoff::getString(string).cstr() << ",");
           }
           if (!parsed)
             break;
@@ -1059,7 +1089,7 @@ try
               break;
             }
             else if (!string.empty())
-              f << "options=" << libstoff::getString(string).cstr() << ",";
+              STOFF_DEBUG_TRACE(f << "options=" << libstoff::getString(string).cstr() << ",");
           }
           break;
         }
@@ -1111,7 +1141,7 @@ try
               break;
             }
             if (string.empty()) continue;
-            f << (j==0 ? "title" : "message") << "=" << libstoff::getString(string).cstr() << ",";
+            STOFF_DEBUG_TRACE(f << (j==0 ? "title" : "message") << "=" << libstoff::getString(string).cstr() << ",");
           }
           if (!parsed) break;
           bool showError;
@@ -1125,7 +1155,7 @@ try
               break;
             }
             if (string.empty()) continue;
-            f << (j==0 ? "error[title]" : "error[message]") << "=" << libstoff::getString(string).cstr() << ",";
+            STOFF_DEBUG_TRACE(f << (j==0 ? "error[title]" : "error[message]") << "=" << libstoff::getString(string).cstr() << ",");
           }
           if (!parsed) break;
           f << "style[error]=" << input->readULong(2) << ",";
@@ -1157,7 +1187,7 @@ try
                 break;
               }
               if (string.empty()) continue;
-              f << (j==0 ? "name" : "object") << "=" << libstoff::getString(string).cstr() << ",";
+              STOFF_DEBUG_TRACE(f << (j==0 ? "name" : "object") << "=" << libstoff::getString(string).cstr() << ",");
             }
             if (!parsed) break;
             f << "type=" << input->readULong(2) << ",";
@@ -1172,8 +1202,8 @@ try
                 break;
               }
               if (string.empty()) continue;
-              static char const *wh[]= {"serviceName","source","name","user","pass"};
-              f << wh[j] << "=" << libstoff::getString(string).cstr() << ",";
+              STOFF_DEBUG_TRACE(static char const *wh[]= {"serviceName","source","name","user","pass"};
+                                f << wh[j] << "=" << libstoff::getString(string).cstr() << ",");
             }
             break;
           default:
@@ -1195,7 +1225,7 @@ try
               f << "###string";
               break;
             }
-            if (!string.empty()) f << libstoff::getString(string).cstr() << ",";
+            STOFF_DEBUG_TRACE(if (!string.empty()) f << libstoff::getString(string).cstr() << ",");
             bool isDataLayout, dupFlag, subTotalDef;
             uint16_t orientation, function, showEmptyMode, subTotalCount, extra;
             int32_t hierarchy;
@@ -1229,7 +1259,7 @@ try
                 f << "###string";
                 break;
               }
-              if (!string.empty()) f << libstoff::getString(string).cstr() << ",";
+              STOFF_DEBUG_TRACE(if (!string.empty()) f << libstoff::getString(string).cstr() << ",");
               uint16_t visibleMode, showDetailMode;
               *input >> visibleMode >> showDetailMode >> extra;
               if (visibleMode) f << "visibleMode=" << visibleMode << ",";
@@ -1257,7 +1287,7 @@ try
                 break;
               }
               if (string.empty()) continue;
-              f << (j==0 ? "tableName" : "tableTab") << "=" << libstoff::getString(string).cstr() << ",";
+              STOFF_DEBUG_TRACE(f << (j==0 ? "tableName" : "tableTab") << "=" << libstoff::getString(string).cstr() << ",");
             }
           }
           break;
@@ -1335,7 +1365,7 @@ try
         break;
       }
       else if (!string.empty())
-        f << "passwd=" << libstoff::getString(string).cstr() << ","; // the uncrypted table password, safe to ignore
+        STOFF_DEBUG_TRACE(f << "passwd=" << libstoff::getString(string).cstr() << ","); // the uncrypted table password, safe to ignore
       if (input->tell()<endPos) f << "language=" << input->readULong(2) << ",";
       if (input->tell()<endPos) f << "autoCalc=" << input->readULong(1) << ",";
       if (input->tell()<endPos) f << "visibleTab=" << input->readULong(2) << ",";
@@ -1480,7 +1510,7 @@ try
         break;
       }
       else if (!string.empty())
-        f << "name=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << "name=" << libstoff::getString(string).cstr() << ",");
       if (input->tell()<endPos)
         f << "opt[helplines]=" << input->readULong(1) << ",";
       if (input->tell()<endPos) {
@@ -1623,7 +1653,7 @@ try
         break;
       }
       else if (!string.empty())
-        f << "author=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << "author=" << libstoff::getString(string).cstr() << ",");
       *input >> bIsRange;
       if (bIsRange) f << "isRange,";
       if (!zone.openSCRecord()) {
@@ -1783,6 +1813,7 @@ bool StarObjectSpreadsheet::readSfxStyleSheets(STOFFInputStreamPtr input, std::s
 ////////////////////////////////////////////////////////////
 bool StarObjectSpreadsheet::readSCTable(StarZone &zone, StarObjectSpreadsheetInternal::Table &table)
 {
+  libstoff::ParseStatisticsScope statistics("StarObjectSpreadsheet::readSCTable", zone.input().get());
   STOFFInputStreamPtr input=zone.input();
   long pos=input->tell();
 
@@ -1946,8 +1977,8 @@ bool StarObjectSpreadsheet::readSCTable(StarZone &zone, StarObjectSpreadsheetInt
           break;
         }
         if (!string.empty()) {
-          static char const *wh[]= {"name", "comment", "pass"};
-          f << wh[i] << "=" << libstoff::getString(string).cstr() << ",";
+          STOFF_DEBUG_TRACE(static char const *wh[]= {"name", "comment", "pass"};
+                            f << wh[i] << "=" << libstoff::getString(string).cstr() << ",");
           if (i==0 && !m_spreadsheetState->m_tableList.empty() && m_spreadsheetState->m_tableList.back())
             m_spreadsheetState->m_tableList.back()->m_name=libstoff::getString(string);
         }
@@ -2036,8 +2067,8 @@ bool StarObjectSpreadsheet::readSCTable(StarZone &zone, StarObjectSpreadsheetInt
           break;
         }
         if (string.empty()) continue;
-        static char const *wh[]= {"doc", "flt", "tab"};
-        f << "link[" << wh[i] << "]=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(static char const *wh[]= {"doc", "flt", "tab"};
+                          f << "link[" << wh[i] << "]=" << libstoff::getString(string).cstr() << ",");
       }
       if (!ok) break;
       if (input->tell()<endDataPos)
@@ -2049,7 +2080,7 @@ bool StarObjectSpreadsheet::readSCTable(StarZone &zone, StarObjectSpreadsheetInt
           break;
         }
         if (string.empty()) continue;
-        f << "link[opt]=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << "link[opt]=" << libstoff::getString(string).cstr() << ",");
       }
       break;
     }
@@ -2210,6 +2241,7 @@ bool StarObjectSpreadsheet::readSCData(StarZone &zone, StarObjectSpreadsheetInte
   f << "count=" << count << ",";
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
+  libstoff::useCells(static_cast<unsigned long>(count));
 
   long lastPos=zone.getRecordLastPosition();
   int const version=table.getLoadingVersion();
@@ -2268,7 +2300,7 @@ bool StarObjectSpreadsheet::readSCData(StarZone &zone, StarObjectSpreadsheetInte
       format.m_format=STOFFCell::F_TEXT;
       cell.m_content.m_contentType=STOFFCellContent::C_TEXT_BASIC;
       cell.m_content.m_text=text;
-      f << "val=" << libstoff::getString(text).cstr() << ",";
+      STOFF_DEBUG_TRACE(f << "val=" << libstoff::getString(text).cstr() << ",");
       break;
     }
     case 3: { // TODO
@@ -2313,7 +2345,7 @@ bool StarObjectSpreadsheet::readSCData(StarZone &zone, StarObjectSpreadsheetInte
             format.m_format=STOFFCell::F_TEXT;
             cell.m_content.m_contentType=STOFFCellContent::C_TEXT_BASIC;
             cell.m_content.m_text=text;
-            f << "val=" << libstoff::getString(text).cstr() << ",";
+            STOFF_DEBUG_TRACE(f << "val=" << libstoff::getString(text).cstr() << ",");
           }
         }
         ascFile.addPos(pos);
@@ -2433,7 +2465,7 @@ bool StarObjectSpreadsheet::readSCChangeTrack(StarZone &zone, int /*version*/, l
       break;
     }
     else if (!string.empty())
-      f << "string" << i << "=" << libstoff::getString(string).cstr() << ",";
+      STOFF_DEBUG_TRACE(f << "string" << i << "=" << libstoff::getString(string).cstr() << ",");
   }
   zone.closeSCRecord("SCChangeTrack");
 
@@ -2492,7 +2524,7 @@ bool StarObjectSpreadsheet::readSCChangeTrack(StarZone &zone, int /*version*/, l
         continue;
       }
       if (!string.empty())
-        f << "comment" << i << "=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << "comment" << i << "=" << libstoff::getString(string).cstr() << ",");
       if (s==0 && type!=8) {
         f << "###type";
         STOFF_DEBUG_MSG(("StarObjectSpreadsheet::readSCChangeTrack:the type seems bad\n"));
@@ -2531,7 +2563,7 @@ bool StarObjectSpreadsheet::readSCChangeTrack(StarZone &zone, int /*version*/, l
             break;
           }
           if (string.empty()) continue;
-          f << (j==0 ? "oldValue" : "newValue") << "=" << libstoff::getString(string).cstr() << ",";
+          STOFF_DEBUG_TRACE(f << (j==0 ? "oldValue" : "newValue") << "=" << libstoff::getString(string).cstr() << ",");
         }
         if (!ok) break;
         uint32_t oldContent, newContent;
@@ -2621,7 +2653,7 @@ bool StarObjectSpreadsheet::readSCDBData(StarZone &zone, int /*version*/, long l
     ascFile.addNote(f.str().c_str());
     return false;
   }
-  f << "name=" << libstoff::getString(string).cstr() << ",";
+  STOFF_DEBUG_TRACE(f << "name=" << libstoff::getString(string).cstr() << ",");
   uint16_t nTable, nStartCol, nStartRow, nEndCol, nEndRow;
   *input >> nTable >> nStartCol >> nStartRow >> nEndCol >> nEndRow;
   if (nTable) f << "table=" << nTable << ",";
@@ -2670,7 +2702,7 @@ bool StarObjectSpreadsheet::readSCDBData(StarZone &zone, int /*version*/, long l
       return false;
     }
     if (!string.empty())
-      f << (i==0 ? "dbName" : "dbStatement") << "=" << libstoff::getString(string).cstr() << ",";
+      STOFF_DEBUG_TRACE(f << (i==0 ? "dbName" : "dbStatement") << "=" << libstoff::getString(string).cstr() << ",");
   }
   *input >> bDBNative;
   if (bDBNative) f << "dbNative,";
@@ -2709,11 +2741,11 @@ bool StarObjectSpreadsheet::readSCDBData(StarZone &zone, int /*version*/, long l
     *input>>val >> queryConnect;
     if (!doQuery) continue;
     f << "query" << i << "=[";
-    f << libstoff::getString(string).cstr() << ",";
+    STOFF_DEBUG_TRACE(f << libstoff::getString(string).cstr() << ",");
     f << "field=" << queryField << ",";
     f << "op=" << int(queryOp) << ",";
     if (queryByString) f << "byString,";
-    if (!string.empty()) f << libstoff::getString(string).cstr() << ",";
+    STOFF_DEBUG_TRACE(if (!string.empty()) f << libstoff::getString(string).cstr() << ",");
     if (val<0 || val>0) f << "val=" << val << ",";
     f << "connect=" << int(queryConnect) << ",";
     f << "],";
@@ -2850,7 +2882,7 @@ bool StarObjectSpreadsheet::readSCDBPivot(StarZone &zone, int version, long last
         return false;
       }
       if (!string.empty())
-        f << (i==0 ? "name": "tag") << "=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << (i==0 ? "name": "tag") << "=" << libstoff::getString(string).cstr() << ",");
     }
     uint16_t count;
     *input >> count;
@@ -2863,7 +2895,7 @@ bool StarObjectSpreadsheet::readSCDBPivot(StarZone &zone, int version, long last
         return false;
       }
       if (!string.empty())
-        f << "colName" << i << "=" << libstoff::getString(string).cstr() << ",";
+        STOFF_DEBUG_TRACE(f << "colName" << i << "=" << libstoff::getString(string).cstr() << ",");
     }
   }
   if (input->tell()!=lastPos) {
@@ -2913,7 +2945,7 @@ bool StarObjectSpreadsheet::readSCMatrix(StarZone &zone, int /*version*/, long l
         ok=false;
         break;
       }
-      f << libstoff::getString(string).cstr() << ",";
+      STOFF_DEBUG_TRACE(f << libstoff::getString(string).cstr() << ",");
       break;
     }
     default:
@@ -2980,7 +3012,7 @@ bool StarObjectSpreadsheet::readSCQueryParam(StarZone &zone, int /*version*/, lo
     f << "connect=" << int(connect) << ",";
     f << "field=" << nField << ",";
     f << "val=" << val << ",";
-    if (!string.empty()) f << libstoff::getString(string).cstr() << ",";
+    STOFF_DEBUG_TRACE(if (!string.empty()) f << libstoff::getString(string).cstr() << ",");
     f << "],";
   }
   zone.closeSCRecord("SCQueryParam");
@@ -54,6 +54,7 @@ struct State;
 class StarAttribute;
 class StarZone;
 class STOFFPageSpan;
+class STOFFTextExtractor;
 
 /** \brief the main class to read a StarOffice sdc file
  *
@@ -71,6 +72,10 @@ public:
   bool parse();
   //! try to send the spreadsheet
   bool send(STOFFSpreadsheetListenerPtr listener);
+  /** try to send only the text content of the cells
+
+   \note the content of a group of identical rows is only sent once */
+  bool sendTextContent(STOFFTextExtractor &extractor) const;
   /** try to send a spreadsheet row.
 
    \note this function does not call openSheetRow,closeSheetRow */
@@ -43,9 +43,11 @@
 #include "STOFFList.hxx"
 #include "STOFFOLEParser.hxx"
 #include "STOFFPageSpan.hxx"
+#include "STOFFParseTrace.hxx"
 #include "STOFFParagraph.hxx"
 #include "STOFFSection.hxx"
 #include "STOFFSubDocument.hxx"
+#include "STOFFTextExtractor.hxx"
 #include "STOFFTextListener.hxx"
 
 #include "SWFieldManager.hxx"
@@ -294,6 +296,12 @@ struct SectionZone final : public Zone {
   }
   //! try to send the data to a listener
   bool send(STOFFListenerPtr listener, StarState &state) const final;
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const final
+  {
+    if (m_content)
+      m_content->sendTextContent(extractor);
+  }
   //! the section name
   librevenge::RVNGString m_name;
   //! the section condition
@@ -345,6 +353,12 @@ struct TextZone final : public Zone {
   void inventoryPage(StarState &state) const final;
   //! try to send the data to a listener
   bool send(STOFFListenerPtr listener, StarState &state) const final;
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const final
+  {
+    extractor.insertUnicodeList(m_text);
+    extractor.insertEOL();
+  }
   //! the text
   std::vector<uint32_t> m_text;
   //! the text initial position
@@ -633,8 +647,17 @@ bool TextZone::send(STOFFListenerPtr listener, StarState &state) const
       listener->insertTab();
     else if (m_text[c]==0xa)
       listener->insertEOL(true);
-    else
-      listener->insertUnicode(m_text[c]);
+    else {
+      // send all the characters until the next font change, format, link/refMark end, tab or line break
+      size_t last=c+1;
+      for (; last<m_text.size(); ++last) {
+        if (m_text[last]==0x9 || m_text[last]==0xa || int(last)==endLinkPos || int(last)==endRefMarkPos) break;
+        size_t lastSrcPos=last<m_textSourcePosition.size() ? m_textSourcePosition[last] : m_textSourcePosition.empty() ? 0 : 10000;
+        if ((posSetIt!=modPosSet.end() && *posSetIt <= lastSrcPos) || posToFormat.find(lastSrcPos)!=posToFormat.end()) break;
+      }
+      listener->insertUnicodeSpan(&m_text[c], last-c);
+      c=last-1;
+    }
   }
   if (endLinkPos>=0) // check that not link is opened
     listener->closeLink();
@@ -657,6 +680,12 @@ struct Table final : public Zone {
   }
   //! try to send the data to a listener
   bool send(STOFFListenerPtr listener, StarState &state) const final;
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const final
+  {
+    if (m_table)
+      m_table->sendTextContent(extractor);
+  }
   //! the table
   std::shared_ptr<StarTable> m_table;
 };
@@ -704,6 +733,14 @@ bool Content::send(STOFFListenerPtr listener, StarState &state, bool isFlyer) co
   return true;
 }
 
+void Content::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  for (auto const &zone : m_zoneList) {
+    if (zone)
+      zone->sendTextContent(extractor);
+  }
+}
+
 ////////////////////////////////////////
 //! Internal: the state of a StarObjectText
 struct State {
@@ -781,6 +818,7 @@ bool StarObjectText::updatePageSpans(std::vector<STOFFPageSpan> &pageSpan, int &
 
 bool StarObjectText::sendPages(STOFFTextListenerPtr listener)
 {
+  libstoff::ParseStatisticsScope statistics("StarObjectText::sendPages", nullptr);
   if (!listener) {
     STOFF_DEBUG_MSG(("StarObjectText::sendPages: can not find the listener\n"));
     return false;
@@ -812,6 +850,16 @@ bool StarObjectText::sendPages(STOFFTextListenerPtr listener)
   return true;
 }
 
+bool StarObjectText::sendTextContent(STOFFTextExtractor &extractor)
+{
+  if (!m_textState->m_mainContent) {
+    STOFF_DEBUG_MSG(("StarObjectText::sendTextContent: can not find any content\n"));
+    return true;
+  }
+  m_textState->m_mainContent->sendTextContent(extractor);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////
 // the parser
 ////////////////////////////////////////////////////////////
@@ -1179,7 +1227,7 @@ bool StarObjectText::readSWGraphNode(StarZone &zone, std::shared_ptr<StarObjectT
           for (int p=0; p<numPoints; ++p) {
             int dim[2];
             for (int &j : dim) j=int(input->readLong(4));
-            graphZone->m_contour.m_points.push_back(StarGraphicStruct::StarPolygon::Point(STOFFVec2i(dim[0],dim[1])));
+            graphZone->m_contour.addPoint(STOFFVec2i(dim[0],dim[1]));
             f << STOFFVec2i(dim[0],dim[1]) << ",";
           }
           f << "],";
@@ -1229,7 +1277,7 @@ bool StarObjectText::readSWImageMap(StarZone &zone)
     return true;
   }
   if (!string.empty())
-    f << "url=" << libstoff::getString(string).cstr() << ",";
+    STOFF_DEBUG_TRACE(f << "url=" << libstoff::getString(string).cstr() << ",");
   if (zone.isCompatibleWith(0x11,0x22, 0x101)) {
     for (int i=0; i<2; ++i) {
       if (!zone.readString(string)) {
@@ -1242,7 +1290,7 @@ bool StarObjectText::readSWImageMap(StarZone &zone)
         return true;
       }
       if (string.empty()) continue;
-      f << (i==0 ? "target" : "dummy") << "=" << libstoff::getString(string).cstr() << ",";
+      STOFF_DEBUG_TRACE(f << (i==0 ? "target" : "dummy") << "=" << libstoff::getString(string).cstr() << ",");
     }
   }
   if (flag&0x20) {
@@ -1266,7 +1314,7 @@ bool StarObjectText::readSWImageMap(StarZone &zone)
           return true;
         }
         if (!string.empty())
-          f << (i==0 ? "target" : i==1 ? "dummy1" : "dummy2") << "=" << libstoff::getString(string).cstr() << ",";
+          STOFF_DEBUG_TRACE(f << (i==0 ? "target" : i==1 ? "dummy1" : "dummy2") << "=" << libstoff::getString(string).cstr() << ",");
         if (i==1)
           f << "nCount=" << input->readULong(2) << ",";
       }
@@ -1391,7 +1439,7 @@ bool StarObjectText::readSWSection(StarZone &zone, std::shared_ptr<StarObjectTex
       section->m_name=libstoff::getString(text);
     else
       section->m_condition=libstoff::getString(text);
-    f << (i==0 ? "name" : "cond") << "=" << libstoff::getString(text).cstr() << ",";
+    STOFF_DEBUG_TRACE(f << (i==0 ? "name" : "cond") << "=" << libstoff::getString(text).cstr() << ",");
   }
   int fl=section->m_flags=zone.openFlagZone();
   if (fl&0x10) f << "hidden,";
@@ -1483,7 +1531,7 @@ bool StarObjectText::readSWTextZone(StarZone &zone, std::shared_ptr<StarObjectTe
     return true;
   }
   else if (!textZone->m_text.empty())
-    f << libstoff::getString(textZone->m_text).cstr();
+    STOFF_DEBUG_TRACE(f << libstoff::getString(textZone->m_text).cstr());
 
   ascFile.addPos(pos);
   ascFile.addNote(f.str().c_str());
@@ -1841,7 +1889,7 @@ try
         break;
       }
       else if (!string.empty())
-        f << libstoff::getString(string).cstr();
+        STOFF_DEBUG_TRACE(f << libstoff::getString(string).cstr());
       break;
     case '5': {
       // sw_sw3misc.cxx InLineNumberInfo
@@ -1860,7 +1908,7 @@ try
         break;
       }
       else if (!string.empty())
-        f << libstoff::getString(string).cstr();
+        STOFF_DEBUG_TRACE(f << libstoff::getString(string).cstr());
       break;
     }
     case '6':
@@ -1877,7 +1925,7 @@ try
           break;
         }
         else if (!string.empty())
-          f << (i==0 ? "sAutoMarkURL" : "s2") << "=" << libstoff::getString(string).cstr() << ",";
+          STOFF_DEBUG_TRACE(f << (i==0 ? "sAutoMarkURL" : "s2") << "=" << libstoff::getString(string).cstr() << ",");
       }
       break;
     case '7': { // config, ignored by LibreOffice, and find no code
@@ -1906,7 +1954,7 @@ try
           f << "###passwd";
         }
         else
-          f << "cryptedPasswd=" << libstoff::getString(string).cstr() << ",";
+          STOFF_DEBUG_TRACE(f << "cryptedPasswd=" << libstoff::getString(string).cstr() << ",");
       }
       break;
     case 'Z':
@@ -43,6 +43,7 @@
 #include "libstaroffice_internal.hxx"
 #include "StarObject.hxx"
 
+class STOFFTextExtractor;
 class StarState;
 
 namespace StarObjectTextInternal
@@ -57,6 +58,10 @@ struct Zone {
   virtual ~Zone();
   //! try to send the data to a listener
   virtual bool send(STOFFListenerPtr listener, StarState &state) const=0;
+  //! try to send only the text content
+  virtual void sendTextContent(STOFFTextExtractor &/*extractor*/) const
+  {
+  }
   //! try to inventory the different pages
   virtual void inventoryPage(StarState &/*state*/) const
   {
@@ -75,6 +80,8 @@ struct Content {
   ~Content();
   //! try to send the data to a listener
   bool send(STOFFListenerPtr listener, StarState &state, bool isFlyer=false) const;
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const;
   //! try to inventory the different pages
   void inventoryPages(StarState &state) const;
   //! the section name
@@ -112,6 +119,8 @@ public:
   bool updatePageSpans(std::vector<STOFFPageSpan> &pageSpan, int &numPages);
   //! try to send the different page
   bool sendPages(STOFFTextListenerPtr listener);
+  //! try to send only the text content: no page, style, frame, ...
+  bool sendTextContent(STOFFTextExtractor &extractor);
 
   //! try to read a image map zone : 'X'
   static bool readSWImageMap(StarZone &zone);
@@ -51,6 +51,7 @@
 #include "STOFFDebug.hxx"
 #include "STOFFListener.hxx"
 #include "STOFFTable.hxx"
+#include "STOFFTextExtractor.hxx"
 
 #include "SWFieldManager.hxx"
 
@@ -76,6 +77,8 @@ struct TableBox {
   bool read(Table &table, StarZone &zone, StarObjectText &object, STOFFBox2i &cPos);
   //! try to send the data to a listener
   bool send(STOFFListenerPtr listener, StarState &state) const;
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const;
   //! update the position to correspond to cover the m_position[0],right/bottom
   void updatePosition(Table &table, StarState const &state, float xOrigin, STOFFVec2i const &RBpos=STOFFVec2i(-1,-1));
   //! the position
@@ -109,6 +112,14 @@ struct TableLine {
   }
   //! try to read the data
   bool read(Table &table, StarZone &zone, StarObjectText &object, STOFFBox2i &cPos);
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const
+  {
+    for (auto const &box : m_boxList) {
+      if (box)
+        box->sendTextContent(extractor);
+    }
+  }
   //! update the position to correspond to cover the m_position[0],right/bottom
   void updatePosition(Table &table, StarState const &state, float xOrigin, STOFFVec2i const &RBpos=STOFFVec2i(-1,-1));
   //! the position
@@ -319,6 +330,16 @@ bool TableBox::read(Table &table, StarZone &zone, StarObjectText &object, STOFFB
   return true;
 }
 
+void TableBox::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  if (m_content)
+    m_content->sendTextContent(extractor);
+  for (auto const &line : m_lineList) {
+    if (line)
+      line->sendTextContent(extractor);
+  }
+}
+
 bool TableBox::send(STOFFListenerPtr listener, StarState &state) const
 {
   if (!listener) {
@@ -677,4 +698,12 @@ bool StarTable::send(STOFFListenerPtr listener, StarState &state) const
   return m_table->send(listener, state);
 }
 
+void StarTable::sendTextContent(STOFFTextExtractor &extractor) const
+{
+  for (auto const &line : m_table->m_lineList) {
+    if (line)
+      line->sendTextContent(extractor);
+  }
+}
+
 // vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -43,6 +43,7 @@
 
 #include "libstaroffice_internal.hxx"
 
+class STOFFTextExtractor;
 class StarObject;
 class StarObjectText;
 class StarState;
@@ -65,6 +66,8 @@ public:
   bool read(StarZone &zone, StarObjectText &object);
   //! try to send the data to a listener
   bool send(STOFFListenerPtr listener, StarState &state) const;
+  //! try to send only the text content
+  void sendTextContent(STOFFTextExtractor &extractor) const;
 
   //! the table
   std::shared_ptr<StarTableInternal::Table> m_table;
@@ -39,6 +39,8 @@
 
 #include <librevenge/librevenge.h>
 
+#include "STOFFParseTrace.hxx"
+#include "STOFFResourceGovernor.hxx"
 #include "StarEncryption.hxx"
 
 #include "StarZone.hxx"
@@ -59,23 +61,37 @@ StarZone::StarZone(STOFFInputStreamPtr inputStream, std::string const &ascName,
   , m_zoneName(zoneName)
   , m_typeStack()
   , m_positionStack()
+  , m_beginStack()
+  , m_statisticsBegin()
   , m_beginToEndMap()
   , m_flagEndZone()
   , m_poolList()
 {
   if (password)
     m_encryption.reset(new StarEncryption(password));
+  if (libstoff::collectParseStatistics())
+    m_statisticsBegin.reset(new libstoff::ParseCounters(m_input.get()));
 }
 
 StarZone::~StarZone()
 {
   m_ascii.reset();
+  if (m_statisticsBegin) {
+    try {
+      libstoff::addParseStatistic(m_zoneName, *m_statisticsBegin, m_input.get());
+    }
+    catch (...) {
+    }
+  }
 }
 
 void StarZone::setInput(STOFFInputStreamPtr ip)
 {
   m_input=ip;
   m_ascii.setStream(ip);
+  // the bytes are counted in the new input
+  if (m_statisticsBegin)
+    m_statisticsBegin->m_position=ip ? ip->tell() : 0;
 }
 
 bool StarZone::readString(std::vector<uint32_t> &string, std::vector<size_t> &srcPositions, int encoding, bool chckEncryption) const
@@ -358,8 +374,7 @@ bool StarZone::openSCHHeader()
     m_input->seek(pos, librevenge::RVNG_SEEK_SET);
     return false;
   }
-  m_typeStack.push('@');
-  m_positionStack.push(endPos);
+  pushRecord('@', pos, endPos);
   return true;
 }
 
@@ -389,8 +404,7 @@ bool StarZone::openVersionCompatHeader()
     m_input->seek(pos, librevenge::RVNG_SEEK_SET);
     return false;
   }
-  m_typeStack.push('*');
-  m_positionStack.push(endPos);
+  pushRecord('*', pos, endPos);
   return true;
 }
 
@@ -409,8 +423,7 @@ bool StarZone::openSDRHeader(std::string &magic)
   for (int i=0; i<4; ++i) magic+=char(m_input->readULong(1));
   // special case: ok to have only magic if ...
   if (magic=="DrXX") {
-    m_typeStack.push('_');
-    m_positionStack.push(m_input->tell());
+    pushRecord('_', pos, m_input->tell());
     return true;
   }
   m_headerVersionStack.push(int(m_input->readULong(2)));
@@ -428,8 +441,7 @@ bool StarZone::openSDRHeader(std::string &magic)
     m_input->seek(pos, librevenge::RVNG_SEEK_SET);
     return false;
   }
-  m_typeStack.push('_');
-  m_positionStack.push(endPos);
+  pushRecord('_', pos, endPos);
   return true;
 }
 
@@ -444,14 +456,19 @@ bool StarZone::closeSDRHeader(std::string const &debugName)
 ////////////////////////////////////////////////////////////
 bool StarZone::openDummyRecord()
 {
-  m_typeStack.push('@');
-  if (!m_positionStack.empty())
-    m_positionStack.push(m_positionStack.top());
-  else
-    m_positionStack.push(m_input->size());
+  pushRecord('@', m_input->tell(), !m_positionStack.empty() ? m_positionStack.top() : m_input->size());
   return true;
 }
 
+void StarZone::pushRecord(char type, long beginPos, long endPos)
+{
+  libstoff::checkRecordLevel(int(m_positionStack.size())+1);
+  libstoff::checkProgress(m_zoneName.c_str(), beginPos, m_input->size());
+  m_typeStack.push(type);
+  m_positionStack.push(endPos);
+  m_beginStack.push(std::make_pair(beginPos, libstoff::isParseTraceEnabled() ? libstoff::getParseTraceTime() : 0));
+}
+
 bool StarZone::openRecord()
 {
   long pos=m_input->tell();
@@ -475,8 +492,7 @@ bool StarZone::openRecord()
     STOFF_DEBUG_MSG(("StarZone::openRecord: argh endPosition is not in the current group\n"));
     return false;
   }
-  m_typeStack.push(' ');
-  m_positionStack.push(endPos);
+  pushRecord(' ', pos, endPos);
   return true;
 }
 
@@ -499,8 +515,7 @@ bool StarZone::openSCRecord()
     STOFF_DEBUG_MSG(("StarZone::openSCRecord: argh endPosition is not in the current group\n"));
     return false;
   }
-  m_typeStack.push('_');
-  m_positionStack.push(endPos);
+  pushRecord('_', pos, endPos);
   return true;
 }
 
@@ -542,8 +557,7 @@ bool StarZone::openSWRecord(char &type)
     STOFF_DEBUG_MSG(("StarZone::openSWRecord: argh endPosition is not in the current group\n"));
     return false;
   }
-  m_typeStack.push(type);
-  m_positionStack.push(endPos);
+  pushRecord(type, pos, endPos);
   return true;
 }
 
@@ -570,8 +584,7 @@ bool StarZone::openSfxRecord(char &type)
     STOFF_DEBUG_MSG(("StarZone::openSfxRecord: argh endPosition is not in the current group\n"));
     return false;
   }
-  m_typeStack.push(type);
-  m_positionStack.push(endPos);
+  pushRecord(type, pos, endPos);
   return true;
 }
 
@@ -582,9 +595,15 @@ bool StarZone::closeRecord(char type, std::string const &debugName)
     char typ=m_typeStack.top();
     long pos=m_positionStack.top();
 
+    auto begin=m_beginStack.top();
     m_typeStack.pop();
     m_positionStack.pop();
+    m_beginStack.pop();
     if (typ!=type) continue;
+    libstoff::countParseRecord();
+    if (begin.second>0)
+      libstoff::sendParseTrace(m_zoneName, debugName, begin.first, (pos ? pos : m_input->tell())-begin.first,
+                               int(m_typeStack.size())+1, libstoff::getParseTraceTime()-begin.second);
     if (!pos || type=='@')
       return true;
     long actPos=m_input->tell();
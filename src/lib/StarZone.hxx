@@ -47,6 +47,10 @@
 #include "StarEncoding.hxx"
 
 class StarEncryption;
+namespace libstoff
+{
+struct ParseCounters;
+}
 
 /** \brief a zone in a StarOffice file
  *
@@ -269,6 +273,8 @@ protected:
   bool readRecordSizes(long pos);
   //! try to close a record
   bool closeRecord(char type, std::string const &debugName);
+  //! stores a new opened record
+  void pushRecord(char type, long beginPos, long endPos);
 
   //
   // data
@@ -299,6 +305,10 @@ protected:
   std::stack<char> m_typeStack;
   //! the position stack
   std::stack<long> m_positionStack;
+  //! the record beginning position and time stack (the time is only set if the parse trace is enabled)
+  std::stack<std::pair<long,double> > m_beginStack;
+  //! the counters at the zone creation (if the parse statistics are collected)
+  std::unique_ptr<libstoff::ParseCounters> m_statisticsBegin;
   //! other position to end position zone
   std::map<long, long> m_beginToEndMap;
   //! end of a cflags zone
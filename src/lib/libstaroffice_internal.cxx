@@ -44,6 +44,8 @@
 
 #include <librevenge-stream/librevenge-stream.h>
 
+#include "STOFFResourceGovernor.hxx"
+
 #include "libstaroffice_internal.hxx"
 
 /** namespace used to regroup all libwpd functions, enumerations which we have redefined for internal usage */
@@ -117,6 +119,80 @@ void appendUnicode(uint32_t val, librevenge::RVNGString &buffer)
   outbuf[len] = 0;
   buffer.append(outbuf);
 }
+
+int appendUnicode(uint32_t const *characters, size_t numCharacters, librevenge::RVNGString &buffer)
+{
+  if (!characters || !numCharacters) return 0;
+  // transcode all the characters in a local buffer, then append it in one call
+  std::string res;
+  res.reserve(numCharacters+numCharacters/2);
+  int numOdd=0;
+  for (size_t c=0; c<numCharacters; ++c) {
+    uint32_t val=characters[c];
+    if (val<0x80) {
+      if (val<0x20 && val!=0x9 && val!=0xa && val!=0xd) {
+        ++numOdd;
+        continue;
+      }
+      res+=char(val);
+    }
+    else if (val<0x800) {
+      res+=char(0xc0 | (val>>6));
+      res+=char(0x80 | (val&0x3f));
+    }
+    else if (val<0x10000) {
+      if (val==0xfffd) continue; // undef character, we skip it
+      res+=char(0xe0 | (val>>12));
+      res+=char(0x80 | ((val>>6)&0x3f));
+      res+=char(0x80 | (val&0x3f));
+    }
+    else {
+      librevenge::RVNGString unicode;
+      appendUnicode(val, unicode);
+      res+=unicode.cstr();
+    }
+  }
+  if (!res.empty())
+    buffer.append(res.c_str());
+  return numOdd;
+}
+}
+
+namespace libstoff
+{
+int getMaximumNumberOfThreads()
+{
+  auto governor=ResourceGovernor::get();
+  return governor ? governor->getNumThreads() : 1;
+}
+
+bool convertBitmapsToPNG()
+{
+#ifdef USE_ZIP
+  auto governor=ResourceGovernor::get();
+  return governor ? governor->getOptions().m_convertBitmapsToPNG : true;
+#else
+  return false;
+#endif
+}
+
+int getMaximumPictureDimension()
+{
+  auto governor=ResourceGovernor::get();
+  return governor && governor->getOptions().m_maxPictureDimension>0 ? governor->getOptions().m_maxPictureDimension : 0;
+}
+
+bool skipPictures()
+{
+  auto governor=ResourceGovernor::get();
+  return governor && governor->getOptions().m_skipPictures;
+}
+
+int getDrawingResolution()
+{
+  auto governor=ResourceGovernor::get();
+  return governor && governor->getOptions().m_drawingResolution>0 ? governor->getOptions().m_drawingResolution : 0;
+}
 }
 
 namespace libstoff
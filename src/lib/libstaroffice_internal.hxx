@@ -151,6 +151,14 @@ class GenericException
 class WrongPasswordException
 {
 };
+
+class ResourceLimitException
+{
+};
+
+class ParseCanceledException
+{
+};
 }
 
 /* ---------- input ----------------- */
@@ -159,6 +167,10 @@ namespace libstoff
 uint8_t readU8(librevenge::RVNGInputStream *input);
 //! adds an unicode character to a string
 void appendUnicode(uint32_t val, librevenge::RVNGString &buffer);
+/** adds a list of unicode characters to a string, skipping the undef (0xfffd) and odd control characters
+
+ \note returns the number of odd characters which have been skipped */
+int appendUnicode(uint32_t const *characters, size_t numCharacters, librevenge::RVNGString &buffer);
 //! transform a unicode string in a RNVGString
 librevenge::RVNGString getString(std::vector<uint32_t> const &unicode);
 
@@ -171,6 +183,31 @@ bool checkAddOverflow(T x, T y)
 }
 }
 
+/* ---------- threads ----------------- */
+namespace libstoff
+{
+//! returns the maximum number of threads used to read the current document, always 1 if the threads are not available
+int getMaximumNumberOfThreads();
+}
+
+/* ---------- bitmaps ----------------- */
+namespace libstoff
+{
+//! returns true if the bitmaps of the current document must be converted in PNG, always false if zlib is not available
+bool convertBitmapsToPNG();
+//! returns the maximum width and height of the pictures of the current document in pixels, 0 means no limit
+int getMaximumPictureDimension();
+//! returns true if the pictures of the current document must be ignored
+bool skipPictures();
+}
+
+/* ---------- drawings ----------------- */
+namespace libstoff
+{
+//! returns the resolution in dots per inch used to simplify the drawings of the current document, 0 means no simplification
+int getDrawingResolution();
+}
+
 /* ---------- small enum/class ------------- */
 namespace libstoff
 {
@@ -0,0 +1,28 @@
+#!/bin/sh
+# checks that the regression files converted with a cache of the embedded
+# objects give the same sd2raw output as the files converted without cache:
+# the first conversion stores the objects, the second one reuses them
+
+SD2RAW=${SD2RAW:-../conv/sd2raw/sd2raw}
+REGRESSION=${srcdir:-.}/../../regression
+CACHE=cachetest.dir
+
+rm -rf "$CACHE"
+mkdir "$CACHE" || exit 1
+status=0
+for file in "$REGRESSION"/*/*.sd[acdw]; do
+  "$SD2RAW" "$file" >cachetest-0.raw 2>/dev/null
+  "$SD2RAW" -C "$CACHE" "$file" >cachetest-1.raw 2>/dev/null
+  "$SD2RAW" -C "$CACHE" "$file" >cachetest-2.raw 2>/dev/null
+  if ! cmp -s cachetest-0.raw cachetest-1.raw || ! cmp -s cachetest-0.raw cachetest-2.raw; then
+    echo "cachetest: the outputs of $file differ"
+    status=1
+  fi
+done
+# some regression files contain embedded drawings or spreadsheets
+if [ -z "$(ls "$CACHE")" ]; then
+  echo "cachetest: no object has been stored"
+  status=1
+fi
+rm -rf "$CACHE" cachetest-0.raw cachetest-1.raw cachetest-2.raw
+exit $status
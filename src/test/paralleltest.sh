@@ -0,0 +1,19 @@
+#!/bin/sh
+# checks that the regression files converted with several threads give
+# the same sd2raw output as the files converted with one thread: the
+# embedded objects and the pages are then read and sent in parallel
+
+SD2RAW=${SD2RAW:-../conv/sd2raw/sd2raw}
+REGRESSION=${srcdir:-.}/../../regression
+
+status=0
+for file in "$REGRESSION"/*/*.sd[acdw]; do
+  "$SD2RAW" -j 1 "$file" >paralleltest-1.raw 2>/dev/null
+  "$SD2RAW" -j 4 "$file" >paralleltest-4.raw 2>/dev/null
+  if ! cmp -s paralleltest-1.raw paralleltest-4.raw; then
+    echo "paralleltest: the outputs of $file differ"
+    status=1
+  fi
+done
+rm -f paralleltest-1.raw paralleltest-4.raw
+exit $status
@@ -0,0 +1,336 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+/* checks that the pictures created by STOFFPNGEncoder can be decoded:
+   the chunks and their crc, the header and the palette, the IDAT chunks
+   size and the rows once inflated and unfiltered */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include <librevenge/librevenge.h>
+
+#include "STOFFPNGEncoder.hxx"
+
+namespace
+{
+int check(std::string const &what, bool ok)
+{
+  if (ok) return 0;
+  fprintf(stderr, "pngtest: %s failed\n", what.c_str());
+  return 1;
+}
+
+uint32_t readULong(unsigned char const *ptr)
+{
+  return (uint32_t(ptr[0])<<24)|(uint32_t(ptr[1])<<16)|(uint32_t(ptr[2])<<8)|uint32_t(ptr[3]);
+}
+
+//! a simple picture: its format and its packed rows
+struct Picture {
+  Picture(uint32_t width, uint32_t height, int colorType, int bitDepth)
+    : m_width(width)
+    , m_height(height)
+    , m_colorType(colorType)
+    , m_bitDepth(bitDepth)
+    , m_rowSize((size_t(width)*size_t(numChannels()*bitDepth)+7)/8)
+    , m_palette()
+    , m_data(m_rowSize*height, 0)
+  {
+  }
+  int numChannels() const
+  {
+    return m_colorType==2 ? 3 : m_colorType==6 ? 4 : 1;
+  }
+  uint32_t m_width;
+  uint32_t m_height;
+  int m_colorType;
+  int m_bitDepth;
+  size_t m_rowSize;
+  std::vector<STOFFColor> m_palette;
+  std::vector<unsigned char> m_data;
+};
+
+//! the result of the decoding
+struct Decoded {
+  Decoded()
+    : m_width(0)
+    , m_height(0)
+    , m_colorType(0)
+    , m_bitDepth(0)
+    , m_palette()
+    , m_compressed()
+    , m_numIDAT(0)
+    , m_maxIDATSize(0)
+    , m_usedFilters(0)
+  {
+  }
+  uint32_t m_width;
+  uint32_t m_height;
+  int m_colorType;
+  int m_bitDepth;
+  std::vector<unsigned char> m_palette;
+  std::vector<unsigned char> m_compressed;
+  int m_numIDAT;
+  uint32_t m_maxIDATSize;
+  //! a bit field of the filters found in the rows
+  unsigned m_usedFilters;
+};
+
+//! reads the chunks of a PNG file, returns an error message or an empty string
+std::string readChunks(librevenge::RVNGBinaryData const &data, Decoded &decoded)
+{
+  static unsigned char const signature[]= {0x89, 'P', 'N', 'G', 0xd, 0xa, 0x1a, 0xa};
+  unsigned char const *ptr=data.getDataBuffer();
+  size_t const size=data.size();
+  if (!ptr || size<8 || memcmp(ptr, signature, 8)!=0) return "signature";
+  size_t pos=8;
+  bool hasEnd=false;
+  while (pos<size) {
+    if (hasEnd) return "data after IEND";
+    if (pos+12>size) return "truncated chunk";
+    uint32_t const length=readULong(ptr+pos);
+    if (length>size-pos-12) return "bad chunk length";
+    std::string const type(reinterpret_cast<char const *>(ptr+pos+4), 4);
+    unsigned char const *content=ptr+pos+8;
+    uLong crc=crc32(0L, Z_NULL, 0);
+    crc=crc32(crc, ptr+pos+4, uInt(length+4));
+    if (readULong(content+length)!=uint32_t(crc)) return "bad crc in "+type;
+    if (type=="IHDR") {
+      if (pos!=8 || length!=13) return "bad IHDR";
+      decoded.m_width=readULong(content);
+      decoded.m_height=readULong(content+4);
+      decoded.m_bitDepth=content[8];
+      decoded.m_colorType=content[9];
+      if (content[10] || content[11] || content[12]) return "bad IHDR methods";
+    }
+    else if (pos==8)
+      return "IHDR is not the first chunk";
+    else if (type=="PLTE") {
+      if (decoded.m_numIDAT) return "PLTE after IDAT";
+      decoded.m_palette.assign(content, content+length);
+    }
+    else if (type=="IDAT") {
+      ++decoded.m_numIDAT;
+      if (length>decoded.m_maxIDATSize) decoded.m_maxIDATSize=length;
+      decoded.m_compressed.insert(decoded.m_compressed.end(), content, content+length);
+    }
+    else if (type=="IEND")
+      hasEnd=true;
+    else
+      return "unexpected chunk "+type;
+    pos+=12+length;
+  }
+  if (!hasEnd) return "no IEND";
+  if (!decoded.m_numIDAT) return "no IDAT";
+  return "";
+}
+
+//! inflates the IDAT data and unfilters the rows, returns an error message or an empty string
+std::string decodeRows(Decoded &decoded, size_t rowSize, size_t bytesPerPixel, std::vector<unsigned char> &rows)
+{
+  std::vector<unsigned char> raw((rowSize+1)*decoded.m_height+1);
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream)!=Z_OK) return "inflateInit";
+  stream.next_in=&decoded.m_compressed[0];
+  stream.avail_in=uInt(decoded.m_compressed.size());
+  stream.next_out=&raw[0];
+  stream.avail_out=uInt(raw.size());
+  int const ret=inflate(&stream, Z_FINISH);
+  size_t const numRead=raw.size()-stream.avail_out;
+  bool const allUsed=stream.avail_in==0;
+  inflateEnd(&stream);
+  if (ret!=Z_STREAM_END) return "inflate";
+  if (!allUsed) return "data after the zlib stream";
+  if (numRead!=(rowSize+1)*decoded.m_height) return "bad decompressed size";
+
+  rows.assign(rowSize*decoded.m_height, 0);
+  std::vector<unsigned char> zero(rowSize, 0);
+  for (size_t r=0; r<decoded.m_height; ++r) {
+    unsigned char const *src=&raw[r*(rowSize+1)];
+    unsigned char *row=&rows[r*rowSize];
+    unsigned char const *prev=r ? row-rowSize : &zero[0];
+    int const filter=*(src++);
+    if (filter>4) return "bad filter";
+    decoded.m_usedFilters|=1u<<filter;
+    for (size_t i=0; i<rowSize; ++i) {
+      int const left=i>=bytesPerPixel ? row[i-bytesPerPixel] : 0;
+      int const up=prev[i];
+      int const upLeft=i>=bytesPerPixel ? prev[i-bytesPerPixel] : 0;
+      int pred=0;
+      switch (filter) {
+      case 1:
+        pred=left;
+        break;
+      case 2:
+        pred=up;
+        break;
+      case 3:
+        pred=(left+up)/2;
+        break;
+      case 4: {
+        int const p=left+up-upLeft;
+        int const pa=abs(p-left), pb=abs(p-up), pc=abs(p-upLeft);
+        pred=(pa<=pb && pa<=pc) ? left : pb<=pc ? up : upLeft;
+        break;
+      }
+      default:
+        break;
+      }
+      row[i]=static_cast<unsigned char>(src[i]+pred);
+    }
+  }
+  return "";
+}
+
+//! encodes and decodes a picture, returns the number of errors
+int checkPicture(std::string const &name, Picture const &picture, Decoded &decoded)
+{
+  librevenge::RVNGBinaryData data;
+  STOFFPNGEncoder encoder(data);
+  if (!encoder.begin(picture.m_width, picture.m_height, picture.m_colorType, picture.m_bitDepth, picture.m_palette))
+    return check(name+": begin", false);
+  for (uint32_t r=0; r<picture.m_height; ++r) {
+    if (!encoder.addRow(&picture.m_data[r*picture.m_rowSize]))
+      return check(name+": addRow", false);
+  }
+  if (!encoder.end()) return check(name+": end", false);
+
+  std::string error=readChunks(data, decoded);
+  if (!error.empty()) return check(name+": "+error, false);
+  int numErrors=0;
+  numErrors+=check(name+": size", decoded.m_width==picture.m_width && decoded.m_height==picture.m_height);
+  numErrors+=check(name+": format", decoded.m_colorType==picture.m_colorType && decoded.m_bitDepth==picture.m_bitDepth);
+  numErrors+=check(name+": IDAT size", decoded.m_maxIDATSize<=65536);
+  if (picture.m_colorType==3) {
+    std::vector<unsigned char> palette;
+    for (auto const &c : picture.m_palette) {
+      palette.push_back(c.getRed());
+      palette.push_back(c.getGreen());
+      palette.push_back(c.getBlue());
+    }
+    numErrors+=check(name+": palette", decoded.m_palette==palette);
+  }
+  else
+    numErrors+=check(name+": no palette", decoded.m_palette.empty());
+  std::vector<unsigned char> rows;
+  error=decodeRows(decoded, picture.m_rowSize, size_t(picture.numChannels()), rows);
+  if (!error.empty()) return numErrors+check(name+": "+error, false);
+  numErrors+=check(name+": rows", rows==picture.m_data);
+  return numErrors;
+}
+}
+
+int main()
+{
+  int numErrors=0;
+
+  // a noisy picture: its compressed data must be split in several IDAT chunks
+  Picture noise(512, 256, 2, 8);
+  srand(1);
+  for (auto &c : noise.m_data) c=static_cast<unsigned char>(rand()&0xff);
+  Decoded noiseDecoded;
+  numErrors+=checkPicture("noise", noise, noiseDecoded);
+  numErrors+=check("noise: several IDAT", noiseDecoded.m_numIDAT>1);
+
+  // some gradients: the rows must be stored with different filters
+  Picture gradient(97, 64, 6, 8);
+  for (uint32_t r=0; r<gradient.m_height; ++r) {
+    unsigned char *row=&gradient.m_data[r*gradient.m_rowSize];
+    for (uint32_t c=0; c<gradient.m_width; ++c) {
+      if (r<16) { // horizontal gradient
+        row[4*c]=static_cast<unsigned char>(3*c);
+        row[4*c+1]=static_cast<unsigned char>(5*c+7);
+      }
+      else if (r<32) { // vertical gradient
+        row[4*c]=static_cast<unsigned char>(7*r);
+        row[4*c+1]=static_cast<unsigned char>(c%2 ? 200 : 10);
+      }
+      else { // diagonal gradient
+        row[4*c]=static_cast<unsigned char>(r*c);
+        row[4*c+1]=static_cast<unsigned char>(r+2*c);
+      }
+      row[4*c+2]=static_cast<unsigned char>((r*13+c*c)&0xff);
+      row[4*c+3]=255;
+    }
+  }
+  Decoded gradientDecoded;
+  numErrors+=checkPicture("gradient", gradient, gradientDecoded);
+  int numFilters=0;
+  for (int f=0; f<5; ++f) {
+    if (gradientDecoded.m_usedFilters&(1u<<f)) ++numFilters;
+  }
+  numErrors+=check("gradient: filters", numFilters>=3);
+
+  // the palette pictures with a width which is not a multiple of 8
+  for (int depth=1; depth<=8; depth*=2) {
+    Picture palette(37, 11, 3, depth);
+    int const numColors=1<<depth;
+    for (int i=0; i<numColors && i<256; ++i)
+      palette.m_palette.push_back(STOFFColor(static_cast<unsigned char>(i), static_cast<unsigned char>(255-i), static_cast<unsigned char>(i*7)));
+    for (uint32_t r=0; r<palette.m_height; ++r) {
+      unsigned char *row=&palette.m_data[r*palette.m_rowSize];
+      for (uint32_t c=0; c<palette.m_width; ++c) {
+        unsigned const index=(r*3+c)%unsigned(numColors);
+        size_t const bit=size_t(c)*size_t(depth);
+        row[bit/8]=static_cast<unsigned char>(row[bit/8]|(index<<(8-depth-int(bit%8))));
+      }
+    }
+    Decoded paletteDecoded;
+    numErrors+=checkPicture("palette"+std::to_string(depth), palette, paletteDecoded);
+    numErrors+=check("palette"+std::to_string(depth)+": no filter", paletteDecoded.m_usedFilters==1);
+  }
+
+  // the bad arguments
+  librevenge::RVNGBinaryData data;
+  STOFFPNGEncoder badEncoder(data);
+  std::vector<STOFFColor> noPalette;
+  numErrors+=check("empty picture", !badEncoder.begin(0, 10, 2, 8, noPalette));
+  numErrors+=check("palette without color", !badEncoder.begin(10, 10, 3, 8, noPalette));
+  numErrors+=check("rgb depth", !badEncoder.begin(10, 10, 2, 4, noPalette));
+  numErrors+=check("addRow before begin", !badEncoder.addRow(nullptr));
+
+  if (numErrors) {
+    fprintf(stderr, "pngtest: %d errors\n", numErrors);
+    return 1;
+  }
+  return 0;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab:
@@ -0,0 +1,238 @@
+/* -*- Mode: C++; c-default-style: "k&r"; indent-tabs-mode: nil; tab-width: 2; c-basic-offset: 2 -*- */
+
+/* libstaroffice
+* Version: MPL 2.0 / LGPLv2+
+*
+* The contents of this file are subject to the Mozilla Public License Version
+* 2.0 (the "License"); you may not use this file except in compliance with
+* the License or as specified alternatively below. You may obtain a copy of
+* the License at http://www.mozilla.org/MPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* Major Contributor(s):
+* Copyright (C) 2002 William Lachance (wrlach@gmail.com)
+* Copyright (C) 2002,2004 Marc Maurer (uwog@uwog.net)
+* Copyright (C) 2004-2006 Fridrich Strba (fridrich.strba@bluewin.ch)
+* Copyright (C) 2006, 2007 Andrew Ziem
+* Copyright (C) 2011, 2012 Alonso Laurent (alonso@loria.fr)
+*
+*
+* All Rights Reserved.
+*
+* For minor contributions see the git repository.
+*
+* Alternatively, the contents of this file may be used under the terms of
+* the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+* in which case the provisions of the LGPLv2+ are applicable
+* instead of those above.
+*/
+
+/* checks that the documents encoded by STOFFPropertyHandlerEncoder are
+   decoded by STOFFPropertyHandler without changing their elements or
+   the type of their properties */
+
+#include <stdio.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+
+#include "STOFFPropertyHandler.hxx"
+
+namespace
+{
+//! returns the name of the type of a property
+std::string getTypeName(librevenge::RVNGProperty const &prop)
+{
+  static std::unique_ptr<librevenge::RVNGProperty const> const props[]= {
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newStringProp("")),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newBoolProp(false)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newIntProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newDoubleProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newInchProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newPercentProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newPointProp(0)),
+    std::unique_ptr<librevenge::RVNGProperty const>(librevenge::RVNGPropertyFactory::newTwipProp(0))
+  };
+  static char const *names[]= {"string", "bool", "int", "double", "inch", "percent", "point", "twip"};
+  for (size_t i=0; i<sizeof(names)/sizeof(names[0]); ++i) {
+    if (typeid(prop)==typeid(*props[i])) return names[i];
+  }
+  return "unknown";
+}
+
+//! writes a property list in a stream
+void print(std::ostream &o, librevenge::RVNGPropertyList const &list)
+{
+  o << "{";
+  librevenge::RVNGPropertyList::Iter i(list);
+  for (i.rewind(); i.next();) {
+    o << i.key() << "=";
+    auto const *child=list.child(i.key());
+    if (child) {
+      o << "[";
+      for (unsigned long c=0; c<child->count(); ++c)
+        print(o, (*child)[c]);
+      o << "]";
+    }
+    else if (i()) {
+      auto type=getTypeName(*i());
+      o << type << ":";
+      if (type=="string" || type=="bool" || type=="int")
+        o << i()->getStr().cstr();
+      else {
+        char buffer[40];
+        snprintf(buffer, sizeof(buffer), "%.17g", i()->getDouble());
+        o << buffer;
+      }
+    }
+    o << ",";
+  }
+  o << "}";
+}
+
+//! a property handler which stores the elements in a string
+class Recorder final : public STOFFPropertyHandler
+{
+public:
+  Recorder()
+    : STOFFPropertyHandler()
+    , m_stream()
+  {
+  }
+  void insertElement(const char *psName) final
+  {
+    m_stream << "E:" << psName << "\n";
+  }
+  void insertElement(const char *psName, const librevenge::RVNGPropertyList &xPropList) final
+  {
+    m_stream << "S:" << psName;
+    print(m_stream, xPropList);
+    m_stream << "\n";
+  }
+  void characters(librevenge::RVNGString const &sCharacters) final
+  {
+    // the encoder does not store the empty strings
+    if (sCharacters.empty()) return;
+    m_stream << "T:" << sCharacters.cstr() << "\n";
+  }
+  std::string str() const
+  {
+    return m_stream.str();
+  }
+private:
+  std::stringstream m_stream;
+};
+
+//! sends the same document to a handler and to an encoder
+template <class Handler> void sendDocument(Handler &handler)
+{
+  librevenge::RVNGPropertyList list;
+  list.insert("str", "a string");
+  list.insert("str:bool", "true");
+  list.insert("str:false", "false");
+  list.insert("str:int", "12");
+  list.insert("str:negative", "-3");
+  list.insert("str:empty", "");
+  list.insert("bool", true);
+  list.insert("bool:false", false);
+  list.insert("int", 42);
+  list.insert("int:negative", -123456789);
+  list.insert("double", 0.1, librevenge::RVNG_GENERIC);
+  list.insert("inch", 1.25);
+  list.insert("percent", 0.5, librevenge::RVNG_PERCENT);
+  list.insert("point", -12.75, librevenge::RVNG_POINT);
+  list.insert("twip", 1440., librevenge::RVNG_TWIP);
+  handler.insertElement("Start", list);
+
+  librevenge::RVNGPropertyListVector vect;
+  for (int i=0; i<3; ++i) {
+    librevenge::RVNGPropertyList child;
+    child.insert("id", i);
+    child.insert("name", i==1 ? "1" : "child");
+    vect.append(child);
+  }
+  librevenge::RVNGPropertyList parent;
+  parent.insert("children", vect);
+  parent.insert("str", "a string");
+  handler.insertElement("Parent", parent);
+
+  handler.characters("some text");
+  handler.characters("");
+  handler.insertElement("Start", librevenge::RVNGPropertyList());
+  handler.insertElement("End");
+}
+
+int check(char const *what, bool ok)
+{
+  if (ok) return 0;
+  fprintf(stderr, "propertytest: %s failed\n", what);
+  return 1;
+}
+}
+
+int main()
+{
+  Recorder expected;
+  sendDocument(expected);
+
+  STOFFPropertyHandlerEncoder encoder;
+  sendDocument(encoder);
+  librevenge::RVNGBinaryData data;
+  int numErrors=check("getData", encoder.getData(data));
+
+  Recorder decoded;
+  numErrors+=check("checkData", decoded.checkData(data));
+  numErrors+=check("readData", decoded.readData(data));
+  if (decoded.str()!=expected.str()) {
+    fprintf(stderr, "propertytest: the decoded document differs, expected\n%s\nfind\n%s\n",
+            expected.str().c_str(), decoded.str().c_str());
+    ++numErrors;
+  }
+
+  // a binary data property is stored as its base64 string
+  STOFFPropertyHandlerEncoder binaryEncoder;
+  librevenge::RVNGPropertyList binaryList;
+  unsigned char const binary[]= {0, 1, 2, 0xff};
+  librevenge::RVNGBinaryData binaryData(binary, sizeof(binary));
+  binaryList.insert("data", binaryData);
+  binaryEncoder.insertElement("Binary", binaryList);
+  librevenge::RVNGBinaryData encodedBinary;
+  numErrors+=check("getData(binary)", binaryEncoder.getData(encodedBinary));
+  Recorder binaryDecoded;
+  numErrors+=check("readData(binary)", binaryDecoded.readData(encodedBinary));
+  numErrors+=check("binary", binaryDecoded.str()==std::string("S:Binary{data=string:")+binaryData.getBase64Data().cstr()+",}\n");
+
+  // an empty encoder does not create data
+  STOFFPropertyHandlerEncoder emptyEncoder;
+  librevenge::RVNGBinaryData emptyData(binary, sizeof(binary));
+  numErrors+=check("getData(empty)", !emptyEncoder.getData(emptyData) && emptyData.empty());
+
+  // the truncated data must be rejected without crashing
+  for (unsigned long len=0; len+1<data.size(); ++len) {
+    librevenge::RVNGBinaryData truncated(data.getDataBuffer(), len);
+    Recorder recorder;
+    if (recorder.checkData(truncated)) {
+      // only a cut between two elements gives a valid document
+      recorder.readData(truncated);
+      if (expected.str().compare(0, recorder.str().size(), recorder.str())!=0) {
+        fprintf(stderr, "propertytest: the truncated data at %lu gives a bad document\n", len);
+        ++numErrors;
+      }
+    }
+  }
+  numErrors+=check("header", !Recorder().checkData(librevenge::RVNGBinaryData(binary, sizeof(binary))));
+
+  if (numErrors) return 1;
+  printf("propertytest: ok\n");
+  return 0;
+}
+// vim: set filetype=cpp tabstop=2 shiftwidth=2 cindent autoindent smartindent noexpandtab: